@@ -40,6 +40,7 @@
 #include "ProblemSize.h"
 #include "QPEngine.h"
 #include "Problem.h"
+#include "ProblemCache.h"
 #include "RandomBrancher.h"
 #include "RCHandler.h"        //Rchand (new)
 #include "Relaxation.h"
@@ -253,16 +254,41 @@ EnginePtr getEngine(EnvPtr env, ProblemPtr p, int &err)
 
 
 void loadProblem(EnvPtr env, MINOTAUR_AMPL::AMPLInterface* iface,
-                 ProblemPtr &oinst, double *obj_sense)
+                 ProblemPtr &oinst, double *obj_sense, UInt *ndefs)
 {
   Timer *timer     = env->getNewTimer();
   OptionDBPtr options = env->getOptions();
   JacobianPtr jac;
   HessianOfLagPtr hess;
   const std::string me("bnb main: ");
+  std::string fname = options->findString("problem_file")->getValue();
+  std::string cache = options->findString("problem_cache")->getValue();
+  ProblemCache pcache(env);
 
   timer->start();
-  oinst = iface->readInstance(options->findString("problem_file")->getValue());
+  oinst = 0;
+  // a .sol file can be written only after reading the .nl file.
+  if (!cache.empty() &&
+      true==options->findBool("use_native_cgraph")->getValue()) {
+    if (false==options->findFlag("AMPL")->getValue() &&
+        false==options->findBool("write_sol_file")->getValue()) {
+      oinst = pcache.read(cache, fname, ndefs);
+    }
+  } else if (!cache.empty()) {
+    env->getLogger()->msgStream(LogInfo) << me 
+      << "problem_cache needs use_native_cgraph. Not used." << std::endl;
+    cache.clear();
+  }
+  if (!oinst) {
+    oinst = iface->readInstance(fname);
+    *ndefs = iface->getNumDefs();
+    oinst->setInitialPoint(iface->getInitialPoint(), 
+        oinst->getNumVars()-*ndefs);
+    if (!cache.empty() && 0!=pcache.write(oinst, cache, fname, *ndefs)) {
+      env->getLogger()->msgStream(LogInfo) << me 
+        << "could not save problem in " << cache << std::endl;
+    }
+  }
   env->getLogger()->msgStream(LogInfo) << me 
     << "time used in reading instance = " << std::fixed 
     << std::setprecision(2) << timer->query() << std::endl;
@@ -291,10 +317,6 @@ void loadProblem(EnvPtr env, MINOTAUR_AMPL::AMPLInterface* iface,
     oinst->setHessian(hess);
   }
 
-  // set initial point
-  oinst->setInitialPoint(iface->getInitialPoint(), 
-      oinst->getNumVars()-iface->getNumDefs());
-
   if (oinst->getObjective() &&
       oinst->getObjective()->getObjectiveType()==Maximize) {
     *obj_sense = -1.0;
@@ -502,6 +524,7 @@ int main(int argc, char** argv)
   HandlerVector handlers;
   int err = 0;
   double obj_sense = 1.0;
+  UInt ndefs = 0;
  
   env->startTimer(err);
   if (err) {
@@ -521,9 +544,9 @@ int main(int argc, char** argv)
     goto CLEANUP;
   }
 
-  loadProblem(env, iface, oinst, &obj_sense);
+  loadProblem(env, iface, oinst, &obj_sense, &ndefs);
   orig_v = new VarVector(oinst->varsBegin(), oinst->varsEnd());
-  pres = presolve(env, oinst, iface->getNumDefs(), handlers);
+  pres = presolve(env, oinst, ndefs, handlers);
   for (HandlerVector::iterator it=handlers.begin(); it!=handlers.end(); ++it) {
     delete (*it);
   }
@@ -35,6 +35,7 @@
 #include "Presolver.h"
 #include "ProblemSize.h"
 #include "Problem.h"
+#include "ProblemCache.h"
 #include "QuadHandler.h"
 #include "Relaxation.h"
 #include "ReliabilityBrancher.h"
@@ -92,11 +93,14 @@ NLPEnginePtr getNLPEngine(EnvPtr env)
 
 
 void loadProblem(EnvPtr env, MINOTAUR_AMPL::AMPLInterface* iface,
-                 ProblemPtr &inst, double *obj_sense)
+                 ProblemPtr &inst, double *obj_sense, UInt *ndefs)
 {
   OptionDBPtr options = env->getOptions();
   Timer *timer     = env->getNewTimer();
   const std::string me("mntr-glob: ");
+  std::string fname = options->findString("problem_file")->getValue();
+  std::string cache = options->findString("problem_cache")->getValue();
+  ProblemCache pcache(env);
 
   if (options->findBool("use_native_cgraph")->getValue()==false) {
     options->findBool("use_native_cgraph")->setValue(true); 
@@ -106,7 +110,27 @@ void loadProblem(EnvPtr env, MINOTAUR_AMPL::AMPLInterface* iface,
 
   // load the problem.
   timer->start();
-  inst = iface->readInstance(options->findString("problem_file")->getValue());
+  inst = 0;
+  // a .sol file can be written only after reading the .nl file.
+  if (!cache.empty() &&
+      true==options->findBool("use_native_cgraph")->getValue()) {
+    if (false==options->findFlag("AMPL")->getValue() &&
+        false==options->findBool("write_sol_file")->getValue()) {
+      inst = pcache.read(cache, fname, ndefs);
+    }
+  } else if (!cache.empty()) {
+    env->getLogger()->msgStream(LogInfo) << me 
+      << "problem_cache needs use_native_cgraph. Not used." << std::endl;
+    cache.clear();
+  }
+  if (!inst) {
+    inst = iface->readInstance(fname);
+    *ndefs = iface->getNumDefs();
+    if (!cache.empty() && 0!=pcache.write(inst, cache, fname, *ndefs)) {
+      env->getLogger()->msgStream(LogInfo) << me 
+        << "could not save problem in " << cache << std::endl;
+    }
+  }
   env->getLogger()->msgStream(LogInfo) << me 
     << "time used in reading instance = " << std::fixed 
     << std::setprecision(2) << timer->query() << std::endl;
@@ -421,6 +445,7 @@ int main(int argc, char** argv)
   HandlerVector handlers;
   double obj_sense = 1.0;
   int err = 0;
+  UInt ndefs = 0;
   ProblemPtr newp;
 
   // start timing.
@@ -441,7 +466,7 @@ int main(int argc, char** argv)
     goto CLEANUP;
   }
 
-  loadProblem(env, iface, inst, &obj_sense);
+  loadProblem(env, iface, inst, &obj_sense, &ndefs);
 
   // Get the right engine.
   engine = getEngine(env);
@@ -451,7 +476,7 @@ int main(int argc, char** argv)
   // get presolver.
   handlers.clear();
   orig_v = new VarVector(inst->varsBegin(), inst->varsEnd());
-  pres = createPres(env, inst, iface->getNumDefs(), handlers);
+  pres = createPres(env, inst, ndefs, handlers);
   if (env->getOptions()->findBool("presolve")->getValue() == true) {
     pres->solve();
   }
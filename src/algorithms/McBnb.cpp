@@ -689,6 +689,8 @@ int main(int argc, char** argv)
     parbab->parsolveSync(parNodeRlxr, nodePrcssr, numThreads);
   } else if (true==env->getOptions()->findBool("mcbnb_oppor_mode")->getValue()) {
     parbab->parsolveOppor(parNodeRlxr, nodePrcssr, numThreads);
+  } else if (true==env->getOptions()->findBool("mcbnb_steal_mode")->getValue()) {
+    parbab->parsolveSteal(parNodeRlxr, nodePrcssr, numThreads);
   } else {
     parbab->parsolve(parNodeRlxr, nodePrcssr, numThreads);
   }
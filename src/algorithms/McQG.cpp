@@ -508,7 +508,7 @@ void writeBnbStatus(EnvPtr env, BranchAndBound *bab, double obj_sense)
 }
 
 void writeParBnbStatus(EnvPtr env, ParQGBranchAndBound *parbab, double obj_sense,
-                       double wallTimeStart)
+                       Timer *wtimer)
 {
 
   const std::string me("mcqg main: ");
@@ -525,7 +525,7 @@ void writeParBnbStatus(EnvPtr env, ParQGBranchAndBound *parbab, double obj_sense
       << std::endl
       << me << "gap percentage = " << parbab->getPerGap() << std::endl
       << me << "time used (s) = " << std::fixed << std::setprecision(2) 
-      << parbab->getWallTime() - wallTimeStart << std::endl
+      << wtimer->query() << std::endl
       << me << "status of branch-and-bound: " 
       << getSolveStatusString(parbab->getStatus()) << std::endl;
     env->stopTimer(err); assert(0==err);
@@ -538,7 +538,7 @@ void writeParBnbStatus(EnvPtr env, ParQGBranchAndBound *parbab, double obj_sense
       << me << "gap = " << INFINITY << std::endl
       << me << "gap percentage = " << INFINITY << std::endl
       << me << "time used (s) = " << std::fixed << std::setprecision(2) 
-      << env->getTime(err) << std::endl 
+      << wtimer->query() << std::endl 
       << me << "status of branch-and-bound: " 
       << getSolveStatusString(NotStarted) << std::endl;
     env->stopTimer(err); assert(0==err);
@@ -617,7 +617,7 @@ int main(int argc, char** argv)
   ProblemPtr oinst;      // instance that needs to be solved.
   EnginePtr engine = 0;  // engine for solving relaxations. 
   ParQGBranchAndBound * parbab = 0;
-  double wallTimeStart = parbab->getWallTime();  //use Timer: to be done!!!
+  Timer *wtimer = env->getNewWallTimer();
   PresolverPtr pres = 0;
   const std::string me("mcqg main: ");
   VarVector *orig_v=0;
@@ -642,6 +642,7 @@ int main(int argc, char** argv)
   std::vector<double> nlpStats(9,0);
   bool prune = false;
   env->startTimer(err);
+  wtimer->start();
 
   if (err) {
     goto CLEANUP;
@@ -673,7 +674,7 @@ int main(int argc, char** argv)
       << "status of presolve: " 
       << getSolveStatusString(pres->getStatus()) << std::endl;
     writeSol(env, orig_v, pres, SolutionPtr(), pres->getStatus(), iface);
-    writeParBnbStatus(env, parbab, obj_sense, wallTimeStart);
+    writeParBnbStatus(env, parbab, obj_sense, wtimer);
     goto CLEANUP;
   }
 
@@ -758,7 +759,7 @@ int main(int argc, char** argv)
 
   writeSol(env, orig_v, pres, parbab->getSolution(), parbab->getStatus(), iface);
   writeParQGStats(env, parbab, numThreads, handlersCopy);
-  writeParBnbStatus(env, parbab, obj_sense, wallTimeStart);
+  writeParBnbStatus(env, parbab, obj_sense, wtimer);
 
 CLEANUP:
   if (engine) {
@@ -834,6 +835,7 @@ CLEANUP:
   if (orig_v) {
     delete orig_v;
   }
+  delete wtimer;
   if (env) {
     delete env;
   }
@@ -25,6 +25,7 @@
 #include <Option.h>
 #include <Operations.h>
 #include <Problem.h>
+#include <ProblemCache.h>
 #include <Engine.h>
 #include <QPEngine.h>
 #include <LPEngine.h>
@@ -64,16 +65,41 @@ void writeSol(EnvPtr env, VarVector *orig_v, PresolverPtr pres,
 
 
 void loadProblem(EnvPtr env, MINOTAUR_AMPL::AMPLInterface* iface,
-                 ProblemPtr &oinst, double *obj_sense)
+                 ProblemPtr &oinst, double *obj_sense, UInt *ndefs)
 {
   Timer *timer     = env->getNewTimer();
   OptionDBPtr options = env->getOptions();
   JacobianPtr jac;
   HessianOfLagPtr hess;
   const std::string me("qg: ");
+  std::string fname = options->findString("problem_file")->getValue();
+  std::string cache = options->findString("problem_cache")->getValue();
+  ProblemCache pcache(env);
 
   timer->start();
-  oinst = iface->readInstance(options->findString("problem_file")->getValue());
+  oinst = 0;
+  // a .sol file can be written only after reading the .nl file.
+  if (!cache.empty() &&
+      true==options->findBool("use_native_cgraph")->getValue()) {
+    if (false==options->findFlag("AMPL")->getValue() &&
+        false==options->findBool("write_sol_file")->getValue()) {
+      oinst = pcache.read(cache, fname, ndefs);
+    }
+  } else if (!cache.empty()) {
+    env->getLogger()->msgStream(LogInfo) << me 
+      << "problem_cache needs use_native_cgraph. Not used." << std::endl;
+    cache.clear();
+  }
+  if (!oinst) {
+    oinst = iface->readInstance(fname);
+    *ndefs = iface->getNumDefs();
+    oinst->setInitialPoint(iface->getInitialPoint(), 
+        oinst->getNumVars()-*ndefs);
+    if (!cache.empty() && 0!=pcache.write(oinst, cache, fname, *ndefs)) {
+      env->getLogger()->msgStream(LogInfo) << me 
+        << "could not save problem in " << cache << std::endl;
+    }
+  }
   env->getLogger()->msgStream(LogInfo) << me 
     << "time used in reading instance = " << std::fixed 
     << std::setprecision(2) << timer->query() << std::endl;
@@ -98,10 +124,6 @@ void loadProblem(EnvPtr env, MINOTAUR_AMPL::AMPLInterface* iface,
     oinst->setHessian(hess);
   }
 
-  // set initial point
-  oinst->setInitialPoint(iface->getInitialPoint(), 
-      oinst->getNumVars()-iface->getNumDefs());
-
   if (oinst->getObjective() &&
       oinst->getObjective()->getObjectiveType()==Maximize) {
     *obj_sense = -1.0;
@@ -242,6 +264,7 @@ int main(int argc, char* argv[])
   ProblemPtr inst;
   
   double obj_sense =1.0;
+  UInt ndefs = 0;
   
   // the branch-and-bound
   BranchAndBound *bab = 0;
@@ -289,7 +312,7 @@ int main(int argc, char* argv[])
     goto CLEANUP;
   }
 
-  loadProblem(env, iface, inst, &obj_sense);
+  loadProblem(env, iface, inst, &obj_sense, &ndefs);
   // Initialize engines
   nlp_e = getNLPEngine(env, inst); //Engine for Original problem
 
@@ -299,7 +322,7 @@ int main(int argc, char* argv[])
 
   // get presolver.
   orig_v = new VarVector(inst->varsBegin(), inst->varsEnd());
-  pres = presolve(env, inst, iface->getNumDefs(), handlers);
+  pres = presolve(env, inst, ndefs, handlers);
   for (HandlerVector::iterator it=handlers.begin(); it!=handlers.end(); ++it) {
     delete (*it);
   }
@@ -40,6 +40,14 @@ namespace Minotaur {
        /// Find the minimum lower bound of all the active nodes.
        virtual double getBestLB() const = 0;
 
+       /**
+        * \brief Get all active nodes, starting with the one that would be
+        * selected last.
+        *
+        * \param[out] nodes The nodes are appended to this vector.
+        */
+       virtual void getColdNodes(NodePtrVector &nodes) const = 0;
+
        /// Find the maximum depth of all active nodes.
        virtual UInt getDeepestLevel() const = 0;
 
@@ -24,6 +24,7 @@
 #include "NodeRelaxer.h"
 #include "Option.h"
 #include "Problem.h"
+#include "Profiler.h"
 #include "Relaxation.h"
 #include "Solution.h"
 #include "SolutionPool.h"
@@ -111,6 +112,24 @@ double BranchAndBound::getLb()
 }
 
 
+NodePtr BranchAndBound::getNextCandidate_(NodePtr node)
+{
+  NodePtr next;
+  // The children have the same bound as node. If the tree-manager would
+  // prune them, it may delete node along with them, so node must be reset
+  // before. Otherwise, the relaxer can keep the modifications it has in
+  // common with the next node.
+  if (tm_->canPrune(node->getLb())) {
+    nodeRlxr_->reset(node, false);
+    next = tm_->getCandidate();
+  } else {
+    next = tm_->getCandidate();
+    nodeRlxr_->resetTo(node, next);
+  }
+  return next;
+}
+
+
 NodeProcessorPtr BranchAndBound::getNodeProcessor()
 {
   return nodePrcssr_;
@@ -213,8 +232,7 @@ NodePtr BranchAndBound::processRoot_(bool *should_prune, bool *should_dive)
     new_node = tm_->branch(branches, current_node, ws);
     assert((*should_dive && new_node) || (!(*should_dive) && !new_node));
     if (!(*should_dive)) {
-      nodeRlxr_->reset(current_node, false);
-      new_node = tm_->getCandidate();
+      new_node = getNextCandidate_(current_node);
       assert(new_node);
     }
   }
@@ -359,8 +377,8 @@ void BranchAndBound::solve()
   stats_ = new BabStats();
 
   // initialize solution pool
-  // TODO: use user options to set the pool size. For now it is 1.
-  solPool_ = (SolutionPoolPtr) new SolutionPool(env_, problem_, 1);
+  solPool_ = (SolutionPoolPtr) new SolutionPool(env_, problem_,
+    env_->getOptions()->findInt("sol_pool_size")->getValue());
 
   // call heuristics before the root, if needed 
   for (HeurVector::iterator it=preHeurs_.begin(); it!=preHeurs_.end(); ++it) {
@@ -387,6 +405,10 @@ void BranchAndBound::solve()
 #endif
     should_stop = true;
   } else if (shouldStop_()) {
+    if (!dived_prev) {
+      // undo the changes kept for the next node.
+      nodeRlxr_->reset(current_node, false);
+    }
     tm_->updateLb();
     should_stop = true;
   } else {
@@ -408,6 +430,7 @@ void BranchAndBound::solve()
 #endif
 
     should_dive = false;
+    ProfScope ps(env_->getProfiler(), "node");
     rel = nodeRlxr_->createNodeRelaxation(current_node, dived_prev, 
                                           should_prune);
     nodePrcssr_->process(current_node, rel, solPool_);
@@ -428,12 +451,14 @@ void BranchAndBound::solve()
       logger_->msgStream(LogDebug1) << me_ << "node pruned" << 
         std::endl;
 #endif
-      nodeRlxr_->reset(current_node, false);
-      tm_->pruneNode(current_node);
       if (!dived_prev) {
         tm_->removeActiveNode(current_node);
       }
+      // the next node is needed before the current node and its ancestors
+      // are deleted, so that the relaxer can keep the common modifications.
       new_node = tm_->getCandidate();
+      nodeRlxr_->resetTo(current_node, new_node);
+      tm_->pruneNode(current_node);
       dived_prev = false;
     } else {
 #if SPEW
@@ -453,10 +478,10 @@ void BranchAndBound::solve()
       if (should_dive) {
         dived_prev = true;
       } else {
-        nodeRlxr_->reset(current_node, false);
-        new_node = tm_->getCandidate(); // Can be NULL. The branches that were
-                                        // created could have large lb and tm 
-                                        // might have eliminated them.
+        new_node = getNextCandidate_(current_node); // Can be NULL. The
+                                        // branches that were created could
+                                        // have large lb and tm might have
+                                        // eliminated them.
         dived_prev = false;
       }
     }
@@ -480,6 +505,10 @@ void BranchAndBound::solve()
 #endif
       break;
     } else if (shouldStop_()) {
+      if (!dived_prev) {
+        // undo the changes kept for the next node.
+        nodeRlxr_->reset(current_node, false);
+      }
       tm_->updateLb();
       break;
     } else {
@@ -511,6 +540,7 @@ void BranchAndBound::writeStats(std::ostream &out)
     (*it)->writeStats(out);
   }
   solPool_->writeStats(out);
+  tm_->writeStats(out);
 }
 
 
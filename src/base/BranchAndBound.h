@@ -208,6 +208,15 @@ namespace Minotaur {
     /// The TreeManager used to manage the search tree.
     TreeManagerPtr tm_;
 
+    /**
+     * \brief Get the next node to process after branching on a node that
+     * we do not dive from, and reset the relaxation of the node.
+     *
+     * \param [in] node The node that was branched upon.
+     * \return The next candidate. Can be NULL.
+     */
+    NodePtr getNextCandidate_(NodePtr node);
+
     /**
      * \brief Process the root node.
      *
@@ -12,8 +12,10 @@
  * \author Ashutosh Mahajan, Argonne National Laboratory
  */
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <stack>
 
@@ -56,6 +58,26 @@ CGraph::~CGraph()
 }
 
 
+void CGraph::addHessCol_(CNode *node, const UIntMap &vcols, UIntQ *inds)
+{
+  UInt vind = node->getV()->getIndex();
+  UIntVector fwd, rev, out;
+
+  inds->clear();
+  fillHessInds2_(node, inds, &fwd, &rev);
+
+  // only the lower triangle is saved.
+  while (!inds->empty() && inds->back()>vind) {
+    inds->pop_back();
+  }
+  out.reserve(inds->size());
+  for (UIntQ::iterator it=inds->begin(); it!=inds->end(); ++it) {
+    out.push_back(tape_.getVarSlot(vcols.find(*it)->second));
+  }
+  tape_.addHessCol(fwd, rev, out);
+}
+
+
 void CGraph::addConst(const double eps, int &)
 {
   CNode *n = newNode(eps);
@@ -70,6 +92,26 @@ void CGraph::addConst(const double eps, int &)
 }
 
 
+void CGraph::buildTape_()
+{
+  CNodeQ vnodes;
+  UInt id = 1;
+
+  if (!oNode_) {
+    tape_.clear();
+    return;
+  }
+  for (VarNodeMap::iterator it=varNode_.begin(); it!=varNode_.end(); ++it) {
+    vnodes.push_back(it->second);
+  }
+  for (CNodeQ::iterator it=dq_.begin(); it!=dq_.end(); ++it, ++id) {
+    (*it)->setId(id);
+  }
+  tape_.build(vnodes, dq_, oNode_);
+  initWork_(&work_);
+}
+
+
 NonlinearFunctionPtr CGraph::clone(int *err) const
 {
   return clone_(err);
@@ -116,6 +158,9 @@ CGraphPtr CGraph::clone_(int *err) const
   cg->hOffs_ = hOffs_;
   cg->hStarts_ = hStarts_;
   cg->gOffs_ = gOffs_;
+  if (tape_.getNumHessCols()>0) {
+    cg->setupHessCols_();
+  }
 
   cg->changed_ = true;
   *err = 0;
@@ -164,6 +209,9 @@ NonlinearFunctionPtr CGraph::cloneWithVars(VariableConstIterator vbeg,
   cg->hOffs_ = hOffs_;
   cg->hStarts_ = hStarts_;
   cg->gOffs_ = gOffs_;
+  if (tape_.getNumHessCols()>0) {
+    cg->setupHessCols_();
+  }
 
   return cg;
 }
@@ -185,167 +233,109 @@ void CGraph::computeBounds(double *lb, double *ub, int *error)
 
 double CGraph::eval(const double *x, int *error)
 {
-  for (CNodeQ::iterator it=vq_.begin(); it!=vq_.end(); ++it) {
-    (*it)->eval(x, error);
-  }
+  double f = evalWork(x, &work_, error);
+  oNode_->setVal(f);
+  return f;
+}
 
-  for (CNodeQ::iterator it=dq_.begin(); it!=dq_.end(); ++it) {
-    (*it)->eval(x, error);
-    if (0!=*error) {
-      break;
-    }
-  }
-  return oNode_->getVal();
+
+double CGraph::evalWork(const double *x, NlWork *w, int *error) const
+{
+  assert(w->val.size()==tape_.getNumSlots());
+  return tape_.eval(x, &(w->val[0]), error);
 }
 
 
-void CGraph::evalGradient(const double *x, double *grad_f, int *error)
+void CGraph::evalBatch(const double *x, UInt n, UInt k, double *f,
+                       NlWork *w, int *error) const
 {
-  eval(x, error);
-  if (*error>0) {
-    return;
-  }
-  grad_(error);
-  if (*error>0) {
+  if (0==k) {
     return;
   }
-  for (CNodeQ::iterator it=vq_.begin(); it!=vq_.end(); ++it) {
-    grad_f[(*it)->getV()->getIndex()] += (*it)->getG();
+  if (w->bval.size() < tape_.getNumSlots()*k) {
+    w->bval.resize(tape_.getNumSlots()*k);
   }
+  tape_.evalBatch(x, n, k, &(w->bval[0]), f, error);
 }
 
 
-void CGraph::evalHessian(double mult, const double *x, 
-                         const LTHessStor *, double *values, int *error)
+void CGraph::evalGradient(const double *x, double *grad_f, int *error)
 {
-  UInt i = 0;
-  UInt vind;
-  VariablePtr v;
-  UInt nz = 0;
-  bool use2 = true;
-  std::stack<CNode *> st2;
-  // double thresh = vq_.size();
+  evalGradientWork(x, grad_f, &work_, error);
+  oNode_->setVal(work_.val[tape_.getOutSlot()]);
+}
 
-  // thresh = thresh*(thresh-1.0)/2.0 * 0.75;
 
-  // if (hNnz_>thresh) {
-  //   use2 = false;
-  // }
-  // use2 = true;
+void CGraph::evalGradientWork(const double *x, double *grad_f, NlWork *w,
+                              int *error) const
+{
+  double *g = &(w->g[0]);
 
-  // always eval. We do not assume that evaluations of x are already
-  // available. It creates a big mess and doesn't save much.
-  eval(x, error);
-  if (true==use2) {
-    for (CNodeQ::iterator it=dq_.begin(); it!=dq_.end(); ++it) {
-      (*it)->setB(false);
-      (*it)->setGi(0.0);
-      (*it)->setH(0.0);
-      (*it)->setTempI(0);
-    }
-    for (CNodeQ::iterator it=vq_.begin(); it!=vq_.end(); ++it) {
-      (*it)->setB(false);
-      (*it)->setGi(0.0);
-      (*it)->setH(0.0);
-      (*it)->setTempI(0);
-    }
-    grad_(error);
+  evalWork(x, w, error);
+  if (*error>0) {
+    return;
   }
-
-  //std::cout << std::endl << " evaling hessian ";
-  //write(std::cout);
-  //std::cout << std::endl;
-  for (VarNodeMap::iterator it=varNode_.begin(); it!=varNode_.end(); ++it, 
-       ++i) {
-    if (hStarts_[i]<hStarts_[i+1]) {
-      v = it->first;
-      vind = v->getIndex();
-      if (true==use2) {
-        fwdGrad2_(&st2, it->second); 
-        revHess2_(&st2, mult, vind, values, &nz, error);
-      } else {
-        fwdGrad_(it->second); 
-        revHess_(error);
-        for (CNodeQ::iterator it2=vq_.begin(); 
-             it2!=vq_.end() && (*it2)->getV()->getIndex() <= vind; ++it2) {
-          //std::cout << std::endl << v->getName() << " " 
-          //<< (*it2)->getV()->getName() << " " << (*it2)->getH() 
-          //<< " hinds = " << hInds_[nz] << " my index = " 
-          //<< (*it2)->getV()->getIndex() << std::endl;
-          if (hInds_[nz] == (*it2)->getV()->getIndex()) {
-            values[hOffs_[nz]] += mult * (*it2)->getH();
-            ++nz;
-            if (nz == hStarts_[i+1]) {
-              break;
-            }
-          }
-        }
-      }
-    }
+  tape_.grad(&(w->val[0]), g, error);
+  if (*error>0) {
+    return;
+  }
+  for (UInt i=0; i<tape_.getNumVars(); ++i) {
+    grad_f[tape_.getVarIndex(i)] += g[tape_.getVarSlot(i)];
   }
-  //for (UInt i=0; i<hNnz_; ++i) {
-  //  std::cout << "h[" << i << "] = " << values[i] << std::endl;
-  //}
-  //exit(0);
 }
 
 
-void CGraph::fillHessInds_(CNode *node, UIntQ *inds)
+void CGraph::evalGradientBatch(const double *x, UInt n, UInt k,
+                               double *grad_f, NlWork *w, int *error) const
 {
-  CNode **c1=0, **c2=0;
+  const double *g;
+  UInt ind;
 
-  for (CNodeQ::iterator it=dq_.begin(); it!=dq_.end(); ++it) {
-    (*it)->setTempI(0);
-    (*it)->setB(false);
+  if (0==k) {
+    return;
   }
-  for (CNodeQ::iterator it=vq_.begin(); it!=vq_.end(); ++it) {
-    (*it)->setTempI(0);
-    (*it)->setB(false);
+  gradBatch_(x, n, k, w, error);
+  if (*error>0) {
+    return;
   }
-  node->setTempI(1);
-  //std::cout << node->getV()->getName() << ": ";
-
-  for (CNodeQ::iterator it=dq_.begin(); it!=dq_.end(); ++it) {
-    switch((*it)->numChild()) {
-    case (0):
-      break;
-    case (1):
-      (*it)->setTempI((*it)->getL()->getTempI());
-      break;
-    case (2):
-      if ((*it)->getL()->getTempI()>0 || (*it)->getR()->getTempI()>0) {
-        (*it)->setTempI(1);
-      }
-      break;
-    default:
-      c1 = (*it)->getListL();
-      c2 = (*it)->getListR();
-      while (c1<c2) {
-        if ((*c1)->getTempI()>0) {
-          (*it)->setTempI(1);
-          break;
-        }
-        ++c1;
-      }
+  for (UInt i=0; i<tape_.getNumVars(); ++i) {
+    g = &(w->bg[tape_.getVarSlot(i)*k]);
+    ind = tape_.getVarIndex(i);
+    for (UInt j=0; j<k; ++j) {
+      grad_f[j*n+ind] += g[j];
     }
   }
+}
 
 
-  for (CNodeQ::reverse_iterator it=dq_.rbegin(); it!=dq_.rend(); ++it) {
-    (*it)->propHessSpa();
-  }
+void CGraph::evalHessian(double mult, const double *x, 
+                         const LTHessStor *stor, double *values, int *error)
+{
+  evalHessianWork(mult, x, stor, values, &work_, error);
+  oNode_->setVal(work_.val[tape_.getOutSlot()]);
+}
 
-  for (VarNodeMap::iterator it=varNode_.begin(); it!=varNode_.end(); ++it) {
-    if (it->second->getB()==true) {
-      //std::cout << (it)->second->getV()->getName() << " ";
-      inds->push_back(it->first->getIndex());
+
+void CGraph::evalHessianWork(double mult, const double *x, 
+                             const LTHessStor *, double *values, NlWork *w,
+                             int *error) const
+{
+  // always eval. We do not assume that evaluations of x are already
+  // available. It creates a big mess and doesn't save much.
+  evalWork(x, w, error);
+  tape_.grad(&(w->val[0]), &(w->g[0]), error);
+
+  for (UInt i=0; i<tape_.getNumHessCols(); ++i) {
+    if (hStarts_[i]<hStarts_[i+1]) {
+      tape_.evalHessCol(i, mult, &(w->val[0]), &(w->g[0]), &(w->gi[0]),
+                        &(w->h[0]), &hOffs_[hStarts_[i]], values, error);
     }
   }
-  //std::cout << "\n\n"; 
 }
 
 
-void CGraph::fillHessInds2_(CNode *node, UIntQ *inds)
+void CGraph::fillHessInds2_(CNode *node, UIntQ *inds, UIntVector *fwd,
+                            UIntVector *rev)
 {
   std::stack<CNode *>st, st2;
   CNode *n, *n2;
@@ -394,6 +384,8 @@ void CGraph::fillHessInds2_(CNode *node, UIntQ *inds)
     n->propHessSpa2(&nset);
     if (OpVar==n->getOp() && n->getB()==true) {
       inds->push_back(n->getV()->getIndex());
+    } else if (n->getId()>0) {
+      rev->push_back(n->getId()-1);
     }
     n->setB(false);
     n->setTempI(0);
@@ -402,9 +394,13 @@ void CGraph::fillHessInds2_(CNode *node, UIntQ *inds)
   while (!st2.empty()) {
     n = st2.top();
     st2.pop();
+    if (n->getId()>0) {
+      fwd->push_back(n->getId()-1);
+    }
     n->setB(false);
     n->setTempI(0);
   }
+  std::sort(fwd->begin(), fwd->end());
 }
 
 
@@ -418,8 +414,7 @@ void CGraph::fillHessStor(LTHessStor *stor)
   UIntQ::iterator it2, it_st;
   VariablePtr *stor_rows = stor->rows;
   UIntQ *st_inds = stor->colQs;
-  UInt vind;
-  bool use2 = true;
+  UIntMap vcols;
 
   hInds_.clear();
   hOffs_.clear();
@@ -432,32 +427,12 @@ void CGraph::fillHessStor(LTHessStor *stor)
     simplifyDq_();
     changed_ = false;
   }
-
-  if (use2) {
-    for (CNodeQ::iterator it=dq_.begin(); it!=dq_.end(); ++it) {
-      (*it)->setTempI(0);
-      (*it)->setB(false);
-      if ((*it)->numPar()==1) {
-        assert((*it)->getUPar());
-      }
-    }
-    for (CNodeQ::iterator it=vq_.begin(); it!=vq_.end(); ++it) {
-      (*it)->setTempI(0);
-      (*it)->setB(false);
-    }
-  }
-
+  prepHessCols_(&vcols);
 
   for (VarNodeMap::iterator it=varNode_.begin(); it!=varNode_.end(); ++it) {
     v = it->first;
-    vind = v->getIndex();
-    inds->clear();
     //std::cout << "variable " << v->getName() << std::endl;
-    if (use2) {
-      fillHessInds2_(it->second, inds);
-    } else {
-      fillHessInds_(it->second, inds);
-    }
+    addHessCol_(it->second, vcols, inds);
     //std::cout << "size = " << inds->size() << std::endl;
 
     while (*stor_rows != v) {
@@ -467,7 +442,7 @@ void CGraph::fillHessStor(LTHessStor *stor)
     it_st = st_inds->begin();
 
     // copy the indices from inds into st_inds
-    for (it2 = inds->begin(); it2 != inds->end() && vind >= *it2; ++it2) {
+    for (it2 = inds->begin(); it2 != inds->end(); ++it2) {
       while (true) {
         if (it_st == st_inds->end()) {
           st_inds->push_back(*it2);
@@ -494,21 +469,50 @@ void CGraph::fillHessStor(LTHessStor *stor)
 
 void CGraph::fillJac(const double *x, double *values, int *error)
 {
-  UInt *goff = &gOffs_[0];
+  fillJacWork(x, values, &work_, error);
+}
+
+
+void CGraph::fillJacWork(const double *x, double *values, NlWork *w,
+                         int *error) const
+{
+  const UInt *goff = &gOffs_[0];
+  double *g = &(w->g[0]);
 
   *error = 0;
-  eval(x, error);
+  evalWork(x, w, error);
   if (*error>0) {
     return;
   }
-  grad_(error);
+  tape_.grad(&(w->val[0]), g, error);
   if (*error>0) {
     return;
   }
 
-  for (VarNodeMap::iterator it=varNode_.begin(); it!=varNode_.end(); 
-       ++it,++goff) {
-    values[*goff] += it->second->getG();
+  for (UInt i=0; i<tape_.getNumVars(); ++i, ++goff) {
+    values[*goff] += g[tape_.getVarSlot(i)];
+  }
+}
+
+
+void CGraph::fillJacBatch(const double *x, UInt n, UInt k, double *values,
+                          UInt nz, NlWork *w, int *error) const
+{
+  const double *g;
+
+  *error = 0;
+  if (0==k) {
+    return;
+  }
+  gradBatch_(x, n, k, w, error);
+  if (*error>0) {
+    return;
+  }
+  for (UInt i=0; i<tape_.getNumVars(); ++i) {
+    g = &(w->bg[tape_.getVarSlot(i)*k]);
+    for (UInt j=0; j<k; ++j) {
+      values[j*nz+gOffs_[i]] += g[j];
+    }
   }
 }
 
@@ -641,82 +645,7 @@ void CGraph::finalize()
     dq_[i]->setIndex(index);
     index++;
   }
-}
-
-
-void CGraph::fwdGrad_(CNode *node) 
-{
-  for (CNodeQ::iterator it=dq_.begin(); it!=dq_.end(); ++it) {
-    (*it)->setGi(0.0);
-    (*it)->setG(0.0);
-    (*it)->setH(0.0);
-  }
-  for (CNodeQ::iterator it=vq_.begin(); it!=vq_.end(); ++it) {
-    (*it)->setGi(0.0);
-    (*it)->setG(0.0);
-    (*it)->setH(0.0);
-  }
-  node->setGi(1.0);
-
-  for (CNodeQ::iterator it=dq_.begin(); it!=dq_.end(); ++it) {
-    (*it)->fwdGrad();
-  }
-}
-
-
-void CGraph::fwdGrad2_(std::stack<CNode *> *st2, CNode *node) 
-{
-  
-  CNode *n, *n2;
-  CNodeSet nset; // different compare method.
-  CNodeSet::iterator sit; 
-  CNodeQ qq;
-
-  while(!(st2->empty())) {
-    st2->pop();
-  }
-
-  node->setGi(1.0);
-
-  node->setTempI(1);
-  nset.insert(node);
-  while (!nset.empty()) {
-    sit = nset.begin();
-    n = *sit;
-    nset.erase(sit);
-    qq.push_back(n);
-    switch(n->numPar()) {
-    case 0:
-      assert(n==oNode_);
-      break;
-    case 1:
-      n2 = n->getUPar();
-      if (0==n2->getTempI()) {
-        n2->setTempI(1);
-        nset.insert(n2);
-      }
-      break;
-    default:
-      {
-      CQIter2 *it = n->getParB();
-      while (it) {
-        n2 = it->node;
-        if (0==n2->getTempI()) {
-          n2->setTempI(1);
-          nset.insert(n2);
-        }
-        it = it->next;
-      }
-      }
-    }
-  }
-
-  for (CNodeQ::iterator it=qq.begin(); it!=qq.end(); ++it) {
-    n = *it;
-    n->fwdGrad();
-    st2->push(n);
-  }
-  qq.clear();
+  buildTape_();
 }
 
 
@@ -1071,22 +1000,6 @@ FunctionType CGraph::getType() const
 }
 
 
-void CGraph::grad_(int *error)
-{
-  for (CNodeQ::iterator it=dq_.begin(); it!=dq_.end(); ++it) {
-    (*it)->setG(0.0);
-  }
-  for (CNodeQ::iterator it=vq_.begin(); it!=vq_.end(); ++it) {
-    (*it)->setG(0.0);
-  }
-
-  oNode_->setG(1.0);
-  for (CNodeQ::reverse_iterator it=dq_.rbegin(); it!=dq_.rend(); ++it) {
-    (*it)->grad(error);
-  }
-}
-
-
 VariablePtr CGraph::getVar(const CNode *cnode) const
 {
   //ugly and stupid.
@@ -1109,6 +1022,36 @@ void CGraph::getVars(VariableSet *vars)
 }
 
 
+void CGraph::gradBatch_(const double *x, UInt n, UInt k, NlWork *w,
+                        int *error) const
+{
+  const UInt nslots = tape_.getNumSlots();
+  DoubleVector f(k);
+
+  if (w->bval.size() < nslots*k) {
+    w->bval.resize(nslots*k);
+  }
+  if (w->bg.size() < nslots*k) {
+    w->bg.resize(nslots*k);
+  }
+  tape_.evalBatch(x, n, k, &(w->bval[0]), &f[0], error);
+  if (*error>0) {
+    return;
+  }
+  tape_.gradBatch(k, &(w->bval[0]), &(w->bg[0]), error);
+}
+
+
+void CGraph::initWork_(NlWork *w) const
+{
+  w->val.assign(tape_.getNumSlots(), 0.0);
+  tape_.initVal(&(w->val[0]));
+  w->g.assign(tape_.getNumSlots(), 0.0);
+  w->gi.assign(tape_.getNumSlots(), 0.0);
+  w->h.assign(tape_.getNumSlots(), 0.0);
+}
+
+
 bool CGraph::isIdenticalTo(CGraphPtr cg)
 {
   CNodeVector::iterator it1, it2;
@@ -1262,6 +1205,37 @@ CNode* CGraph::newNode(VariablePtr v)
 }
 
 
+NlWork* CGraph::newWork() const
+{
+  NlWork *w = new NlWork();
+  initWork_(w);
+  return w;
+}
+
+
+void CGraph::prepHessCols_(UIntMap *vcols)
+{
+  UInt i = 0;
+
+  tape_.clearHessCols();
+  for (CNodeQ::iterator it=dq_.begin(); it!=dq_.end(); ++it) {
+    (*it)->setTempI(0);
+    (*it)->setB(false);
+    if ((*it)->numPar()==1) {
+      assert((*it)->getUPar());
+    }
+  }
+  for (CNodeQ::iterator it=vq_.begin(); it!=vq_.end(); ++it) {
+    (*it)->setTempI(0);
+    (*it)->setB(false);
+  }
+  for (VarNodeMap::iterator it=varNode_.begin(); it!=varNode_.end(); ++it,
+       ++i) {
+    (*vcols)[it->first->getIndex()] = i;
+  }
+}
+
+
 #ifdef NDEBUG
 void CGraph::prepJac(VarSetConstIter vb, VarSetConstIter )
 #else
@@ -1304,19 +1278,11 @@ void CGraph::removeVar(VariablePtr v, double val)
     vars_.erase(v);
     varNode_.erase(it);
     changed_ = true;
+    buildTape_();
   }
 }
 
 
-void CGraph::revHess_(int *error)
-{
-  oNode_->setG(1.0);
-  for (CNodeQ::reverse_iterator it=dq_.rbegin(); it!=dq_.rend(); ++it) {
-    (*it)->grad(error); // reverse mode gradient.
-    (*it)->hess(error);
-  }
-}
-
 void CGraph::resetNodeIndex()
 {
   UInt index =0;
@@ -1336,37 +1302,14 @@ void CGraph::resetNodeIndex()
   } 
 }
 
-void CGraph::revHess2_(std::stack<CNode *> *st2, double mult, UInt vind,
-                       double *values, UInt *nz, int *error)
+void CGraph::setupHessCols_()
 {
-  CNodeRSet nset;
-  CNodeRSet::iterator sit; 
-  CNode *n;
+  UIntQ inds;
+  UIntMap vcols;
 
-  nset.insert(oNode_);
-  oNode_->setG(1.0);
-  while (!nset.empty()) {
-    sit = nset.begin();
-    n = *sit;
-    nset.erase(sit);
-    n->hess2(&nset, error);
-    if (OpVar==n->getOp() && n->getB()==true && vind >= n->getV()->getIndex()) {
-      values[hOffs_[*nz]] += mult * n->getH();
-      (*nz) += 1;
-    }
-    n->setB(false);
-    n->setGi(0.0);
-    n->setH(0.0);
-    n->setTempI(0);
-    //std::cout << nset.size() << std::endl;
-  }
-  while (!st2->empty()) {
-    n = st2->top();
-    st2->pop();
-    n->setB(false);
-    n->setGi(0.0);
-    n->setH(0.0);
-    n->setTempI(0);
+  prepHessCols_(&vcols);
+  for (VarNodeMap::iterator it=varNode_.begin(); it!=varNode_.end(); ++it) {
+    addHessCol_(it->second, vcols, &inds);
   }
 }
 
@@ -1383,6 +1326,7 @@ void CGraph::simplifyDq_()
       ++it;
     }
   }
+  buildTape_();
 }
 
 
@@ -1553,6 +1497,7 @@ void CGraph::subst(VariablePtr out, VariablePtr in, double rat)
   }
   delete nout;
   changed_ = true;
+  buildTape_();
 }
 
 
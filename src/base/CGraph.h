@@ -18,6 +18,7 @@
 #include <stack>
 
 #include "Types.h"
+#include "CTape.h"
 #include "NonlinearFunction.h"
 #include "OpCode.h"
 
@@ -29,6 +30,7 @@ typedef CGraph* CGraphPtr;
 typedef std::deque<CNode *> CNodeQ;
 typedef std::vector<CNode *> CNodeVector;
 typedef std::map<ConstVariablePtr, CNode*, CompareVariablePtr> VarNodeMap;
+typedef std::map<UInt, UInt> UIntMap;
 
 class CGraph : public NonlinearFunction {
 public:
@@ -56,14 +58,33 @@ public:
   // Evaluate at a given array.
   double eval(const double *x, int *err);
 
+  // base class method.
+  double evalWork(const double *x, NlWork *w, int *error) const;
+
+  // base class method.
+  void evalBatch(const double *x, UInt n, UInt k, double *f, NlWork *w,
+                 int *error) const;
+
   // Evaluate gradient at a given array.
   void evalGradient(const double *x, double *grad_f, int *error);
 
+  // base class method.
+  void evalGradientWork(const double *x, double *grad_f, NlWork *w,
+                        int *error) const;
+
+  // base class method.
+  void evalGradientBatch(const double *x, UInt n, UInt k, double *grad_f,
+                         NlWork *w, int *error) const;
+
   // Evaluate hessian of at a given vector.
   void evalHessian(double mult, const double *x, 
                    const LTHessStor *stor, double *values, 
                    int *error);
 
+  // base class method.
+  void evalHessianWork(double mult, const double *x, const LTHessStor *stor,
+                       double *values, NlWork *w, int *error) const;
+
   // Fill hessian sparsity.
   void fillHessStor(LTHessStor *stor);
 
@@ -73,9 +94,18 @@ public:
   // Add gradient values to sparse Jacobian
   void fillJac(const double *x, double *values, int *error);
 
+  // base class method.
+  void fillJacWork(const double *x, double *values, NlWork *w,
+                   int *error) const;
+
+  // base class method.
+  void fillJacBatch(const double *x, UInt n, UInt k, double *values,
+                    UInt nz, NlWork *w, int *error) const;
+
   /**
    * After adding all the nodes of the graph, finalize is called to create the
-   * forward and backward traversal queues, and related book-keeping.
+   * forward and backward traversal queues, related book-keeping, and the
+   * tape used for evaluating the function and its derivatives.
    */
   void finalize(); 
 
@@ -174,6 +204,9 @@ public:
    */
   CNode* newNode(VariablePtr v);
 
+  // base class method.
+  NlWork* newWork() const;
+
   // base class method.
   void prepJac(VarSetConstIter vbeg, VarSetConstIter vend);
 
@@ -226,34 +259,71 @@ private:
   
   CNode *zNode_;
 
+  /// Tape compiled from vq_ and dq_. Variables are in the order of varNode_.
+  CTape tape_;
+
+  /// Workspace used by eval(), evalGradient(), evalHessian() and fillJac().
+  NlWork work_;
+
   /// A map that tells which node corresponds to a given variable.
   VarNodeMap varNode_;
 
   /// All nodes with OpCode OpVar.
   CNodeQ vq_;
 
+  /**
+   * Find the lower-triangular sparsity of the Hessian column of a variable
+   * and add the corresponding column to tape_.
+   *
+   * \param [in] node The node of the variable.
+   * \param [in] vcols Column (position in varNode_) of each variable index.
+   * \param [out] inds Indices of variables in this column, not more than the
+   * index of this variable.
+   */
+  void addHessCol_(CNode *node, const UIntMap &vcols, UIntQ *inds);
+
+  /**
+   * Compile tape_ from the current vq_ and dq_ and resize work_. Must be
+   * called whenever vq_ or dq_ change. Renumbers the IDs of
+   * dependent nodes in the order of dq_.
+   */
+  void buildTape_();
+
   CGraphPtr clone_(int *err) const;
 
-  void fwdGrad_(CNode *node);
-  void fwdGrad2_(std::stack<CNode *> *st2, CNode *node);
+  /**
+   * Find the sparsity of the Hessian column of a variable.
+   *
+   * \param [in] node The node of the variable.
+   * \param [out] inds Indices of variables in this column.
+   * \param [out] fwd Tape instructions in the forward pass of this column.
+   * \param [out] rev Tape instructions in the reverse pass of this column.
+   */
+  void fillHessInds2_(CNode *node, UIntQ *inds, UIntVector *fwd,
+                      UIntVector *rev);
+
+  /**
+   * Evaluate tape_ and its gradient at k points, storing them in the batch
+   * arrays of w.
+   */
+  void gradBatch_(const double *x, UInt n, UInt k, NlWork *w,
+                  int *error) const;
 
-  void fillHessInds_(CNode *node, UIntQ *inds);
-  void fillHessInds2_(CNode *node, UIntQ *inds);
+  /// Size the arrays of a workspace for tape_ and set the constants.
+  void initWork_(NlWork *w) const;
 
   /// Recursive function to check whether CGraph represents a sum of squares.
   bool isSOSRec_(CNode *node) const;
 
-  void revHess_(int *error);
-  void revHess2_(std::stack<CNode *> *st2, double mult, UInt vind,
-                 double *values, UInt *nz, int *error);
-
   /**
-   *  Routine to propagate gradient by a reverse mode traversal.
+   * Clear Hessian columns of tape_ and the flags used in finding sparsity.
    *
-   *  \param [out] error Set to a nonzero if an error occurs. Otherwise, leave
-   *  it unchanged.
+   * \param [out] vcols Column (position in varNode_) of each variable index.
    */
-  void grad_(int *error);
+  void prepHessCols_(UIntMap *vcols);
+
+  /// Add Hessian columns to tape_ without filling any Hessian storage.
+  void setupHessCols_();
 
   void setupHess_(VariablePtr v, CNode *node, std::set<ConstVariablePair, 
                   CompareVariablePair> & vps);
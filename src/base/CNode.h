@@ -145,6 +145,9 @@ public:
   /// \return The value of the boolean flag.
   bool getB() const { return b_; };
 
+  /// Get the constant value of an OpNum node.
+  double getDouble() const { return d_; };
+
   /// \return The value of the gradient value.
   double getG() const { return g_; };
 
@@ -0,0 +1,1195 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2008 - 2017 The MINOTAUR Team.
+//
+
+
+/**
+ * \file CTape.cpp
+ * \brief Define class CTape for evaluating a compiled computational graph.
+ * \author The MINOTAUR Team
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <map>
+
+#include "MinotaurConfig.h"
+#include "CNode.h"
+#include "CTape.h"
+#include "Variable.h"
+
+#define DIV_BY_ZERO_TOL 1e-12
+
+using namespace Minotaur;
+
+typedef std::map<const CNode*, UInt> CNodeSlotMap;
+
+/// Find the slot of node n. If it has none, it is a constant and gets the
+/// next slot after cstart.
+static UInt getSlot(const CNode *n, UInt cstart, CNodeSlotMap *slots,
+                    std::vector<const CNode *> *consts)
+{
+  CNodeSlotMap::iterator mit = slots->find(n);
+  if (mit==slots->end()) {
+    mit = slots->insert(std::make_pair(n, cstart+consts->size())).first;
+    consts->push_back(n);
+  }
+  return mit->second;
+}
+
+
+CTape::CTape()
+  : nConst_(0),
+    nVar_(0),
+    oSlot_(0)
+{
+  clear();
+}
+
+
+CTape::~CTape()
+{
+  clear();
+}
+
+
+void CTape::addHessCol(const UIntVector &fwd, const UIntVector &rev,
+                       const UIntVector &out)
+{
+  hFwd_.insert(hFwd_.end(), fwd.begin(), fwd.end());
+  hFwdStart_.push_back(hFwd_.size());
+  hRev_.insert(hRev_.end(), rev.begin(), rev.end());
+  hRevStart_.push_back(hRev_.size());
+  hOut_.insert(hOut_.end(), out.begin(), out.end());
+  hOutStart_.push_back(hOut_.size());
+}
+
+
+void CTape::build(const CNodeQ &vnodes, const CNodeQ &dnodes,
+                  const CNode *onode)
+{
+  CNodeSlotMap slots;
+  std::vector<const CNode *> consts;
+  const CNode *n;
+  CNode **c;
+  UInt i, s;
+
+  clear();
+
+  // variables and instructions are numbered from zero first. Nodes not
+  // seen among them are constants, e.g. OpNum, OpInt or dependent nodes
+  // removed after their values became constant. Constants are numbered
+  // after them and then all slots are rotated so that constants come first.
+  nVar_ = vnodes.size();
+  i = 0;
+  for (CNodeQ::const_iterator it=vnodes.begin(); it!=vnodes.end(); ++it,
+       ++i) {
+    slots[*it] = i;
+    vInd_.push_back((*it)->getV()->getIndex());
+  }
+  for (CNodeQ::const_iterator it=dnodes.begin(); it!=dnodes.end(); ++it,
+       ++i) {
+    slots[*it] = i;
+  }
+  s = i;
+
+  op_.reserve(dnodes.size());
+  l_.reserve(dnodes.size());
+  r_.reserve(dnodes.size());
+  cStart_.reserve(dnodes.size()+1);
+  for (CNodeQ::const_iterator it=dnodes.begin(); it!=dnodes.end(); ++it) {
+    n = *it;
+    op_.push_back(n->getOp());
+    if (OpSumList==n->getOp()) {
+      c = n->getListL();
+      for (UInt j=0; j<n->numChild(); ++j, ++c) {
+        cInd_.push_back(getSlot(*c, s, &slots, &consts));
+      }
+      l_.push_back(cInd_[cStart_.back()]);
+      r_.push_back(cInd_.back());
+    } else {
+      l_.push_back(getSlot(n->getL(), s, &slots, &consts));
+      if (n->getR()) {
+        r_.push_back(getSlot(n->getR(), s, &slots, &consts));
+      } else {
+        r_.push_back(l_.back());
+      }
+    }
+    cStart_.push_back(cInd_.size());
+  }
+  oSlot_ = getSlot(onode, s, &slots, &consts);
+
+  nConst_ = consts.size();
+  cVal_.reserve(nConst_);
+  for (std::vector<const CNode *>::iterator it=consts.begin();
+       it!=consts.end(); ++it) {
+    cVal_.push_back((*it)->getVal());
+  }
+  for (UIntVector::iterator it=l_.begin(); it!=l_.end(); ++it) {
+    *it = (*it<s) ? (*it+nConst_) : (*it-s);
+  }
+  for (UIntVector::iterator it=r_.begin(); it!=r_.end(); ++it) {
+    *it = (*it<s) ? (*it+nConst_) : (*it-s);
+  }
+  for (UIntVector::iterator it=cInd_.begin(); it!=cInd_.end(); ++it) {
+    *it = (*it<s) ? (*it+nConst_) : (*it-s);
+  }
+  oSlot_ = (oSlot_<s) ? (oSlot_+nConst_) : (oSlot_-s);
+}
+
+
+void CTape::clear()
+{
+  cStart_.clear();
+  cStart_.push_back(0);
+  cInd_.clear();
+  cVal_.clear();
+  l_.clear();
+  nConst_ = 0;
+  nVar_ = 0;
+  oSlot_ = 0;
+  op_.clear();
+  r_.clear();
+  vInd_.clear();
+  clearHessCols();
+}
+
+
+void CTape::clearHessCols()
+{
+  hFwdStart_.clear();
+  hFwdStart_.push_back(0);
+  hFwd_.clear();
+  hOutStart_.clear();
+  hOutStart_.push_back(0);
+  hOut_.clear();
+  hRevStart_.clear();
+  hRevStart_.push_back(0);
+  hRev_.clear();
+}
+
+
+double CTape::eval(const double *x, double *val, int *error) const
+{
+  double *v = val+nConst_;
+  double *o = v+nVar_;
+  const UInt *l = l_.empty() ? 0 : &l_[0];
+  const UInt *r = r_.empty() ? 0 : &r_[0];
+  const UInt ninstr = op_.size();
+
+  for (UInt i=0; i<nVar_; ++i) {
+    v[i] = x[vInd_[i]];
+  }
+
+  errno = 0; //declared in cerrno
+  for (UInt i=0; i<ninstr; ++i) {
+    switch (op_[i]) {
+    case (OpAbs):
+      o[i] = fabs(val[l[i]]);
+      break;
+    case (OpAcos):
+      o[i] = acos(val[l[i]]);
+      break;
+    case (OpAcosh):
+      o[i] = acosh(val[l[i]]);
+      break;
+    case (OpAsin):
+      o[i] = asin(val[l[i]]);
+      break;
+    case (OpAsinh):
+      o[i] = asinh(val[l[i]]);
+      break;
+    case (OpAtan):
+      o[i] = atan(val[l[i]]);
+      break;
+    case (OpAtanh):
+      o[i] = atanh(val[l[i]]);
+      break;
+    case (OpCeil):
+      o[i] = ceil(val[l[i]]);
+      break;
+    case (OpCos):
+      o[i] = cos(val[l[i]]);
+      break;
+    case (OpCosh):
+      o[i] = cosh(val[l[i]]);
+      break;
+    case (OpCPow):
+      o[i] = pow(val[l[i]], val[r[i]]);
+      break;
+    case (OpDiv):
+      if (fabs(val[r[i]]) > DIV_BY_ZERO_TOL) {
+        o[i] = val[l[i]]/val[r[i]];
+      } else {
+        *error = 1;
+      }
+      break;
+    case (OpExp):
+      o[i] = exp(val[l[i]]);
+      break;
+    case (OpFloor):
+      o[i] = floor(val[l[i]]);
+      break;
+    case (OpIntDiv):
+      // always round towards zero
+      o[i] = val[l[i]]/val[r[i]];
+      if (o[i]>0) {
+        o[i] = floor(o[i]);
+      } else {
+        o[i] = ceil(o[i]);
+      }
+      break;
+    case (OpLog):
+      o[i] = log(val[l[i]]);
+      break;
+    case (OpLog10):
+      o[i] = log10(val[l[i]]);
+      break;
+    case (OpMinus):
+      o[i] = val[l[i]] - val[r[i]];
+      break;
+    case (OpMult):
+      o[i] = val[l[i]] * val[r[i]];
+      break;
+    case (OpPlus):
+      o[i] = val[l[i]] + val[r[i]];
+      break;
+    case (OpPow):
+    case (OpPowK):
+      o[i] = pow(val[l[i]], val[r[i]]);
+      break;
+    case (OpRound):
+      o[i] = floor(val[l[i]]+0.5);
+      break;
+    case (OpSin):
+      o[i] = sin(val[l[i]]);
+      break;
+    case (OpSinh):
+      o[i] = sinh(val[l[i]]);
+      break;
+    case (OpSqr):
+      o[i] = val[l[i]]*val[l[i]];
+      break;
+    case (OpSqrt):
+      o[i] = sqrt(val[l[i]]);
+      break;
+    case (OpSumList):
+      {
+      double d = 0.0;
+      for (UInt j=cStart_[i]; j<cStart_[i+1]; ++j) {
+        d += val[cInd_[j]];
+      }
+      o[i] = d;
+      }
+      break;
+    case (OpTan):
+      o[i] = tan(val[l[i]]);
+      break;
+    case (OpTanh):
+      o[i] = tanh(val[l[i]]);
+      break;
+    case (OpUMinus):
+      o[i] = -(val[l[i]]);
+      break;
+    case (OpInt):
+    case (OpNone):
+    case (OpNum):
+      break;
+    default:
+      assert(!"cannot evaluate!");
+    }
+    if (errno!=0) {
+      *error = errno;
+    }
+    if (0!=*error) {
+      break;
+    }
+  }
+  return val[oSlot_];
+}
+
+
+void CTape::evalBatch(const double *x, UInt n, UInt k, double *val,
+                      double *f, int *error) const
+{
+  const double *a, *b, *c;
+  double *o;
+  UInt j;
+
+  for (UInt i=0; i<nConst_; ++i) {
+    std::fill(val+i*k, val+(i+1)*k, cVal_[i]);
+  }
+  for (UInt i=0; i<nVar_; ++i) {
+    o = val+(nConst_+i)*k;
+    for (j=0; j<k; ++j) {
+      o[j] = x[j*n+vInd_[i]];
+    }
+  }
+
+  // Each instruction is applied to all k points before moving to the next
+  // one. The inner loops run over contiguous lanes and can be vectorized
+  // by the compiler.
+  errno = 0; //declared in cerrno
+  for (UInt i=0; i<op_.size(); ++i) {
+    a = val+l_[i]*k;
+    b = val+r_[i]*k;
+    o = val+getInstrSlot(i)*k;
+    switch (op_[i]) {
+    case (OpAbs):
+      for (j=0; j<k; ++j) {
+        o[j] = fabs(a[j]);
+      }
+      break;
+    case (OpAcos):
+      for (j=0; j<k; ++j) {
+        o[j] = acos(a[j]);
+      }
+      break;
+    case (OpAcosh):
+      for (j=0; j<k; ++j) {
+        o[j] = acosh(a[j]);
+      }
+      break;
+    case (OpAsin):
+      for (j=0; j<k; ++j) {
+        o[j] = asin(a[j]);
+      }
+      break;
+    case (OpAsinh):
+      for (j=0; j<k; ++j) {
+        o[j] = asinh(a[j]);
+      }
+      break;
+    case (OpAtan):
+      for (j=0; j<k; ++j) {
+        o[j] = atan(a[j]);
+      }
+      break;
+    case (OpAtanh):
+      for (j=0; j<k; ++j) {
+        o[j] = atanh(a[j]);
+      }
+      break;
+    case (OpCeil):
+      for (j=0; j<k; ++j) {
+        o[j] = ceil(a[j]);
+      }
+      break;
+    case (OpCos):
+      for (j=0; j<k; ++j) {
+        o[j] = cos(a[j]);
+      }
+      break;
+    case (OpCosh):
+      for (j=0; j<k; ++j) {
+        o[j] = cosh(a[j]);
+      }
+      break;
+    case (OpCPow):
+    case (OpPow):
+    case (OpPowK):
+      for (j=0; j<k; ++j) {
+        o[j] = pow(a[j], b[j]);
+      }
+      break;
+    case (OpDiv):
+      for (j=0; j<k; ++j) {
+        if (fabs(b[j]) <= DIV_BY_ZERO_TOL) {
+          *error = 1;
+        }
+      }
+      for (j=0; j<k; ++j) {
+        o[j] = a[j]/b[j];
+      }
+      break;
+    case (OpExp):
+      for (j=0; j<k; ++j) {
+        o[j] = exp(a[j]);
+      }
+      break;
+    case (OpFloor):
+      for (j=0; j<k; ++j) {
+        o[j] = floor(a[j]);
+      }
+      break;
+    case (OpIntDiv):
+      // always round towards zero
+      for (j=0; j<k; ++j) {
+        o[j] = a[j]/b[j];
+        o[j] = (o[j]>0) ? floor(o[j]) : ceil(o[j]);
+      }
+      break;
+    case (OpLog):
+      for (j=0; j<k; ++j) {
+        o[j] = log(a[j]);
+      }
+      break;
+    case (OpLog10):
+      for (j=0; j<k; ++j) {
+        o[j] = log10(a[j]);
+      }
+      break;
+    case (OpMinus):
+      for (j=0; j<k; ++j) {
+        o[j] = a[j] - b[j];
+      }
+      break;
+    case (OpMult):
+      for (j=0; j<k; ++j) {
+        o[j] = a[j] * b[j];
+      }
+      break;
+    case (OpPlus):
+      for (j=0; j<k; ++j) {
+        o[j] = a[j] + b[j];
+      }
+      break;
+    case (OpRound):
+      for (j=0; j<k; ++j) {
+        o[j] = floor(a[j]+0.5);
+      }
+      break;
+    case (OpSin):
+      for (j=0; j<k; ++j) {
+        o[j] = sin(a[j]);
+      }
+      break;
+    case (OpSinh):
+      for (j=0; j<k; ++j) {
+        o[j] = sinh(a[j]);
+      }
+      break;
+    case (OpSqr):
+      for (j=0; j<k; ++j) {
+        o[j] = a[j]*a[j];
+      }
+      break;
+    case (OpSqrt):
+      for (j=0; j<k; ++j) {
+        o[j] = sqrt(a[j]);
+      }
+      break;
+    case (OpSumList):
+      std::fill(o, o+k, 0.0);
+      for (UInt m=cStart_[i]; m<cStart_[i+1]; ++m) {
+        c = val+cInd_[m]*k;
+        for (j=0; j<k; ++j) {
+          o[j] += c[j];
+        }
+      }
+      break;
+    case (OpTan):
+      for (j=0; j<k; ++j) {
+        o[j] = tan(a[j]);
+      }
+      break;
+    case (OpTanh):
+      for (j=0; j<k; ++j) {
+        o[j] = tanh(a[j]);
+      }
+      break;
+    case (OpUMinus):
+      for (j=0; j<k; ++j) {
+        o[j] = -a[j];
+      }
+      break;
+    case (OpInt):
+    case (OpNone):
+    case (OpNum):
+      break;
+    default:
+      assert(!"cannot evaluate!");
+    }
+    if (errno!=0) {
+      *error = errno;
+    }
+    if (0!=*error) {
+      return;
+    }
+  }
+  std::copy(val+oSlot_*k, val+(oSlot_+1)*k, f);
+}
+
+
+void CTape::evalHessCol(UInt col, double mult, const double *val,
+                        const double *g, double *gi, double *h,
+                        const UInt *offs, double *values, int *error) const
+{
+  const UInt vslot = nConst_+col;
+  UInt i;
+
+  errno = 0;
+  gi[vslot] = 1.0;
+  for (UInt j=hFwdStart_[col]; j<hFwdStart_[col+1]; ++j) {
+    fwdGrad_(hFwd_[j], val, gi);
+  }
+  for (UInt j=hRevStart_[col]; j<hRevStart_[col+1]; ++j) {
+    hess_(hRev_[j], val, g, gi, h, error);
+  }
+  for (UInt j=hOutStart_[col]; j<hOutStart_[col+1]; ++j, ++offs) {
+    values[*offs] += mult * h[hOut_[j]];
+  }
+  if (errno != 0) {
+    *error = errno;
+  }
+
+  // reset only what this column touched.
+  gi[vslot] = 0.0;
+  h[vslot] = 0.0;
+  for (UInt j=hFwdStart_[col]; j<hFwdStart_[col+1]; ++j) {
+    gi[getInstrSlot(hFwd_[j])] = 0.0;
+  }
+  for (UInt j=hRevStart_[col]; j<hRevStart_[col+1]; ++j) {
+    i = hRev_[j];
+    h[getInstrSlot(i)] = 0.0;
+    if (OpSumList==op_[i]) {
+      for (UInt k=cStart_[i]; k<cStart_[i+1]; ++k) {
+        h[cInd_[k]] = 0.0;
+      }
+    } else {
+      h[l_[i]] = 0.0;
+      h[r_[i]] = 0.0;
+    }
+  }
+}
+
+
+void CTape::fwdGrad_(UInt i, const double *val, double *gi) const
+{
+  const UInt s = getInstrSlot(i);
+  const UInt l = l_[i];
+  const UInt r = r_[i];
+
+  switch (op_[i]) {
+  case (OpAbs):
+    if (val[l]>1e-10) {
+      gi[s] += 1.0;
+    } else if (val[l]<-1e-10) {
+      gi[s] -= 1.0;
+    }
+    break;
+  case (OpAcos):
+    gi[s] -= gi[l]/sqrt(1-val[l]*val[l]); // -1/sqrt(1-x^2)
+    break;
+  case (OpAcosh):
+    gi[s] += gi[l]/sqrt(val[l]*val[l] - 1.0); // 1/sqrt(x^2-1)
+    break;
+  case (OpAsin):
+    gi[s] += gi[l]/sqrt(1-val[l]*val[l]); // 1/sqrt(1-x^2)
+    break;
+  case (OpAsinh):
+    gi[s] += gi[l]/sqrt(val[l]*val[l] + 1.0); // 1/sqrt(x^2+1)
+    break;
+  case (OpAtan):
+    gi[s] += gi[l]/(1+val[l]*val[l]); // 1/(1+x^2)
+    break;
+  case (OpAtanh):
+    gi[s] += gi[l]/(1-val[l]*val[l]); // 1/(1-x^2)
+    break;
+  case (OpCeil):
+    if (fabs(val[l] - floor(0.5+val[l]))<1e-12) {
+      gi[s] += gi[l];
+    }
+    break;
+  case (OpCos):
+    gi[s] -= gi[l]*sin(val[l]);
+    break;
+  case (OpCosh):
+    gi[s] += gi[l]*sinh(val[l]);
+    break;
+  case (OpCPow):
+    gi[s] += gi[r]*log(val[l])*val[s]; // val[s] = a^(val[r])
+    break;
+  case (OpDiv):
+    gi[s] += gi[l]/val[r];
+    gi[s] -= gi[r]*val[l]/(val[r]*val[r]);
+    break;
+  case (OpExp):
+    gi[s] += gi[l]*val[s]; // val[s] = e^(val[l])
+    break;
+  case (OpFloor):
+    gi[s] += gi[l];
+    break;
+  case (OpIntDiv):
+    assert(!"derivative of OpIntDiv not implemented!");
+    break;
+  case (OpLog):
+    gi[s] += gi[l]/val[l];
+    break;
+  case (OpLog10):
+    gi[s] += gi[l]/val[l]/log(10.0);
+    break;
+  case (OpMinus):
+    gi[s] += gi[l];
+    gi[s] -= gi[r];
+    break;
+  case (OpMult):
+    gi[s] += gi[l]*val[r];
+    gi[s] += gi[r]*val[l];
+    break;
+  case (OpPlus):
+    gi[s] += gi[l];
+    gi[s] += gi[r];
+    break;
+  case (OpPow):
+    assert(!"derivative of OpPow not implemented!");
+    break;
+  case (OpPowK):
+    gi[s] += gi[l]*val[r]*pow(val[l],val[r]-1.0);
+    break;
+  case (OpRound):
+    assert(!"derivative of OpRound not implemented!");
+    break;
+  case (OpSin):
+    gi[s] += gi[l]*cos(val[l]);
+    break;
+  case (OpSinh):
+    gi[s] += gi[l]*cosh(val[l]);
+    break;
+  case (OpSqr):
+    gi[s] += 2.0*gi[l]*val[l];
+    break;
+  case (OpSqrt):
+    gi[s] += gi[l]*0.5/val[s]; // since val[s] = sqrt(val[l]).
+    break;
+  case (OpSumList):
+    for (UInt j=cStart_[i]; j<cStart_[i+1]; ++j) {
+      gi[s] += gi[cInd_[j]];
+    }
+    break;
+  case (OpTan):
+    {
+      double d = cos(val[l]);
+      gi[s] += gi[l]/(d*d);
+    }
+    break;
+  case (OpTanh):
+    {
+      double d = cosh(val[l]);
+      gi[s] += gi[l]/(d*d);
+    }
+    break;
+  case (OpUMinus):
+    gi[s] -= gi[l];
+    break;
+  default:
+    break;
+  }
+}
+
+
+void CTape::grad(const double *val, double *g, int *error) const
+{
+  const UInt *l = l_.empty() ? 0 : &l_[0];
+  const UInt *r = r_.empty() ? 0 : &r_[0];
+  const UInt nslots = getNumSlots();
+  UInt s;
+  double gs;
+
+  std::fill(g, g+nslots, 0.0);
+  g[oSlot_] = 1.0;
+
+  errno = 0; // declared in cerrno
+  for (UInt i=op_.size(); i>0; --i) {
+    s = getInstrSlot(i-1);
+    gs = g[s];
+    switch (op_[i-1]) {
+    case (OpAbs):
+      if (val[l[i-1]]>1e-10) {
+        g[l[i-1]] += gs;
+      } else if (val[l[i-1]]<-1e-10) {
+        g[l[i-1]] -= gs;
+      }
+      break;
+    case (OpAcos):
+      g[l[i-1]] -= gs/sqrt(1-val[l[i-1]]*val[l[i-1]]); // -1/sqrt(1-x^2)
+      break;
+    case (OpAcosh):
+      g[l[i-1]] += gs/sqrt(val[l[i-1]]*val[l[i-1]] - 1.0); // 1/sqrt(x^2-1)
+      break;
+    case (OpAsin):
+      g[l[i-1]] += gs/sqrt(1-val[l[i-1]]*val[l[i-1]]); // 1/sqrt(1-x^2)
+      break;
+    case (OpAsinh):
+      g[l[i-1]] += gs/sqrt(val[l[i-1]]*val[l[i-1]] + 1.0); // 1/sqrt(x^2+1)
+      break;
+    case (OpAtan):
+      g[l[i-1]] += gs/(1+val[l[i-1]]*val[l[i-1]]); // 1/(1+x^2)
+      break;
+    case (OpAtanh):
+      g[l[i-1]] += gs/(1-val[l[i-1]]*val[l[i-1]]); // 1/(1-x^2)
+      break;
+    case (OpCeil):
+      if (fabs(val[l[i-1]] - floor(0.5+val[l[i-1]]))<1e-12) {
+        g[l[i-1]] += gs;
+      }
+      break;
+    case (OpCos):
+      g[l[i-1]] -= gs*sin(val[l[i-1]]);
+      break;
+    case (OpCosh):
+      g[l[i-1]] += gs*sinh(val[l[i-1]]);
+      break;
+    case (OpCPow):
+      g[r[i-1]] += gs*log(val[l[i-1]])*val[s];
+      break;
+    case (OpDiv):
+      if (fabs(val[r[i-1]]) > DIV_BY_ZERO_TOL) {
+        g[l[i-1]] += gs/val[r[i-1]];
+        g[r[i-1]] -= gs*val[l[i-1]]/(val[r[i-1]]*val[r[i-1]]);
+      } else {
+        *error = 1;
+      }
+      break;
+    case (OpExp):
+      g[l[i-1]] += gs*val[s]; // val[s] = e^(val[l])
+      break;
+    case (OpFloor):
+      g[l[i-1]] += gs; // assuming that gradient is 1.
+      break;
+    case (OpIntDiv):
+      assert(!"derivative of OpIntDiv not implemented!");
+      break;
+    case (OpLog):
+      g[l[i-1]] += gs/val[l[i-1]];
+      break;
+    case (OpLog10):
+      g[l[i-1]] += gs/val[l[i-1]]/log(10.0);
+      break;
+    case (OpMinus):
+      g[l[i-1]] += gs;
+      g[r[i-1]] -= gs;
+      break;
+    case (OpMult):
+      g[l[i-1]] += gs*val[r[i-1]];
+      g[r[i-1]] += gs*val[l[i-1]];
+      break;
+    case (OpPlus):
+      g[l[i-1]] += gs;
+      g[r[i-1]] += gs;
+      break;
+    case (OpPow):
+      assert(!"derivative of OpPow not implemented!");
+      break;
+    case (OpPowK):
+      g[l[i-1]] += gs*val[r[i-1]]*pow(val[l[i-1]], val[r[i-1]]-1.0);
+      break;
+    case (OpRound):
+      assert(!"derivative of OpRound not implemented!");
+      break;
+    case (OpSin):
+      g[l[i-1]] += gs*cos(val[l[i-1]]);
+      break;
+    case (OpSinh):
+      g[l[i-1]] += gs*cosh(val[l[i-1]]);
+      break;
+    case (OpSqr):
+      g[l[i-1]] += 2.0*gs*val[l[i-1]];
+      break;
+    case (OpSqrt):
+      if (fabs(val[s]) > DIV_BY_ZERO_TOL) {
+        g[l[i-1]] += gs*0.5/val[s]; // same as gs*0.5/sqrt(val[l]).
+      } else {
+        *error = 1;
+      }
+      break;
+    case (OpSumList):
+      if (gs!=0.0) {
+        for (UInt j=cStart_[i-1]; j<cStart_[i]; ++j) {
+          g[cInd_[j]] += gs;
+        }
+      }
+      break;
+    case (OpTan):
+      {
+        double d = cos(val[l[i-1]]);
+        g[l[i-1]] += gs/(d*d);
+      }
+      break;
+    case (OpTanh):
+      {
+        double d = cosh(val[l[i-1]]);
+        g[l[i-1]] += gs/(d*d);
+      }
+      break;
+    case (OpUMinus):
+      g[l[i-1]] -= gs;
+      break;
+    default:
+      break;
+    }
+  }
+  if (errno != 0) {
+    *error = errno;
+  }
+}
+
+
+void CTape::gradBatch(UInt k, const double *val, double *g, int *error) const
+{
+  const double *a, *b, *vs;
+  double *ga, *gb, *gs;
+  UInt j, s;
+
+  std::fill(g, g+getNumSlots()*k, 0.0);
+  std::fill(g+oSlot_*k, g+(oSlot_+1)*k, 1.0);
+
+  errno = 0; // declared in cerrno
+  for (UInt i=op_.size(); i>0; --i) {
+    s = getInstrSlot(i-1);
+    a = val+l_[i-1]*k;
+    b = val+r_[i-1]*k;
+    vs = val+s*k;
+    ga = g+l_[i-1]*k;
+    gb = g+r_[i-1]*k;
+    gs = g+s*k;
+    switch (op_[i-1]) {
+    case (OpAbs):
+      for (j=0; j<k; ++j) {
+        if (a[j]>1e-10) {
+          ga[j] += gs[j];
+        } else if (a[j]<-1e-10) {
+          ga[j] -= gs[j];
+        }
+      }
+      break;
+    case (OpAcos):
+      for (j=0; j<k; ++j) {
+        ga[j] -= gs[j]/sqrt(1-a[j]*a[j]);
+      }
+      break;
+    case (OpAcosh):
+      for (j=0; j<k; ++j) {
+        ga[j] += gs[j]/sqrt(a[j]*a[j] - 1.0);
+      }
+      break;
+    case (OpAsin):
+      for (j=0; j<k; ++j) {
+        ga[j] += gs[j]/sqrt(1-a[j]*a[j]);
+      }
+      break;
+    case (OpAsinh):
+      for (j=0; j<k; ++j) {
+        ga[j] += gs[j]/sqrt(a[j]*a[j] + 1.0);
+      }
+      break;
+    case (OpAtan):
+      for (j=0; j<k; ++j) {
+        ga[j] += gs[j]/(1+a[j]*a[j]);
+      }
+      break;
+    case (OpAtanh):
+      for (j=0; j<k; ++j) {
+        ga[j] += gs[j]/(1-a[j]*a[j]);
+      }
+      break;
+    case (OpCeil):
+      for (j=0; j<k; ++j) {
+        if (fabs(a[j] - floor(0.5+a[j]))<1e-12) {
+          ga[j] += gs[j];
+        }
+      }
+      break;
+    case (OpCos):
+      for (j=0; j<k; ++j) {
+        ga[j] -= gs[j]*sin(a[j]);
+      }
+      break;
+    case (OpCosh):
+      for (j=0; j<k; ++j) {
+        ga[j] += gs[j]*sinh(a[j]);
+      }
+      break;
+    case (OpCPow):
+      for (j=0; j<k; ++j) {
+        gb[j] += gs[j]*log(a[j])*vs[j];
+      }
+      break;
+    case (OpDiv):
+      for (j=0; j<k; ++j) {
+        if (fabs(b[j]) <= DIV_BY_ZERO_TOL) {
+          *error = 1;
+        }
+      }
+      for (j=0; j<k; ++j) {
+        ga[j] += gs[j]/b[j];
+        gb[j] -= gs[j]*a[j]/(b[j]*b[j]);
+      }
+      break;
+    case (OpExp):
+      for (j=0; j<k; ++j) {
+        ga[j] += gs[j]*vs[j]; // vs = e^a
+      }
+      break;
+    case (OpFloor):
+      for (j=0; j<k; ++j) {
+        ga[j] += gs[j]; // assuming that gradient is 1.
+      }
+      break;
+    case (OpIntDiv):
+      assert(!"derivative of OpIntDiv not implemented!");
+      break;
+    case (OpLog):
+      for (j=0; j<k; ++j) {
+        ga[j] += gs[j]/a[j];
+      }
+      break;
+    case (OpLog10):
+      for (j=0; j<k; ++j) {
+        ga[j] += gs[j]/a[j]/log(10.0);
+      }
+      break;
+    case (OpMinus):
+      for (j=0; j<k; ++j) {
+        ga[j] += gs[j];
+        gb[j] -= gs[j];
+      }
+      break;
+    case (OpMult):
+      for (j=0; j<k; ++j) {
+        ga[j] += gs[j]*b[j];
+        gb[j] += gs[j]*a[j];
+      }
+      break;
+    case (OpPlus):
+      for (j=0; j<k; ++j) {
+        ga[j] += gs[j];
+        gb[j] += gs[j];
+      }
+      break;
+    case (OpPow):
+      assert(!"derivative of OpPow not implemented!");
+      break;
+    case (OpPowK):
+      for (j=0; j<k; ++j) {
+        ga[j] += gs[j]*b[j]*pow(a[j], b[j]-1.0);
+      }
+      break;
+    case (OpRound):
+      assert(!"derivative of OpRound not implemented!");
+      break;
+    case (OpSin):
+      for (j=0; j<k; ++j) {
+        ga[j] += gs[j]*cos(a[j]);
+      }
+      break;
+    case (OpSinh):
+      for (j=0; j<k; ++j) {
+        ga[j] += gs[j]*cosh(a[j]);
+      }
+      break;
+    case (OpSqr):
+      for (j=0; j<k; ++j) {
+        ga[j] += 2.0*gs[j]*a[j];
+      }
+      break;
+    case (OpSqrt):
+      for (j=0; j<k; ++j) {
+        if (fabs(vs[j]) <= DIV_BY_ZERO_TOL) {
+          *error = 1;
+        }
+      }
+      for (j=0; j<k; ++j) {
+        ga[j] += gs[j]*0.5/vs[j]; // vs = sqrt(a).
+      }
+      break;
+    case (OpSumList):
+      for (UInt m=cStart_[i-1]; m<cStart_[i]; ++m) {
+        ga = g+cInd_[m]*k;
+        for (j=0; j<k; ++j) {
+          ga[j] += gs[j];
+        }
+      }
+      break;
+    case (OpTan):
+      for (j=0; j<k; ++j) {
+        const double d = cos(a[j]);
+        ga[j] += gs[j]/(d*d);
+      }
+      break;
+    case (OpTanh):
+      for (j=0; j<k; ++j) {
+        const double d = cosh(a[j]);
+        ga[j] += gs[j]/(d*d);
+      }
+      break;
+    case (OpUMinus):
+      for (j=0; j<k; ++j) {
+        ga[j] -= gs[j];
+      }
+      break;
+    default:
+      break;
+    }
+  }
+  if (errno != 0) {
+    *error = errno;
+  }
+}
+
+
+void CTape::hess_(UInt i, const double *val, const double *g,
+                  const double *gi, double *h, int *error) const
+{
+  const UInt s = getInstrSlot(i);
+  const UInt l = l_[i];
+  const UInt r = r_[i];
+
+  switch (op_[i]) {
+  case (OpAbs):
+    break;
+  case (OpAcos):
+    h[l] += -h[s]/sqrt(1-val[l]*val[l])
+          - g[s] * gi[l] * val[l]/pow((1.0-val[l]*val[l]),1.5);
+    // -x/(1-x^2)^1.5
+    break;
+  case (OpAcosh):
+    h[l] +=  h[s]/sqrt(val[l]*val[l]-1.0)
+          - g[s] * gi[l] * val[l]/pow((val[l]*val[l]-1.0),1.5);
+    break;
+  case (OpAsin):
+    h[l] +=  h[s]/sqrt(1-val[l]*val[l])
+          + g[s] * gi[l] * val[l]/pow((1-val[l]*val[l]),1.5);
+    break;
+  case (OpAsinh):
+    h[l] +=  h[s]/sqrt(1+val[l]*val[l])
+          - g[s] * gi[l] * val[l]/pow((1+val[l]*val[l]),1.5);
+    break;
+  case (OpAtan):
+    {
+    double d = 1+val[l]*val[l];
+    h[l] +=  h[s]/d - 2.0 * g[s] * gi[l] * val[l]/(d*d);
+    }
+    break;
+  case (OpAtanh):
+    {
+    double d = (1.0 - val[l]*val[l]);
+    h[l] +=  h[s]/d + 2.0 * g[s] * gi[l] * val[l]/(d*d);
+    }
+    break;
+  case (OpCeil):
+    h[l] +=  h[s];
+    break;
+  case (OpCos):
+    h[l] += -h[s]*sin(val[l]) - g[s] * gi[l] * val[s]; // val[s] = cos().
+    break;
+  case (OpCosh):
+    h[l] += h[s]*sinh(val[l]) + g[s] * gi[l] * val[s]; // val[s] = cosh().
+    break;
+  case (OpCPow):
+    h[r] += h[s]*log(val[l])*val[s]
+          + g[s]*gi[r]*log(val[l])*log(val[l])*val[s];
+    break;
+  case (OpDiv):
+    if (fabs(val[r]) > DIV_BY_ZERO_TOL) {
+      h[l] += h[s]/val[r] - g[s] * gi[r] /(val[r]*val[r]);
+      h[r] += -h[s]*val[l]/(val[r]*val[r])
+            - g[s] * gi[l] /(val[r]*val[r])
+            + g[s] * gi[r] * val[l] * 2.0 /(val[r]*val[r]*val[r]);
+    } else {
+      *error = 1;
+    }
+    break;
+  case (OpExp):
+    h[l] += h[s]*val[s] + g[s] * gi[l] * val[s];
+    break;
+  case (OpFloor):
+    h[l] += h[s];
+    break;
+  case (OpIntDiv):
+    assert(!"derivative of OpIntDiv not implemented!");
+    break;
+  case (OpLog):
+    h[l] += h[s]/val[l] - g[s] * gi[l]  / (val[l] * val[l]); // -1/x^2
+    break;
+  case (OpLog10):
+    h[l] += h[s]/val[l]/log(10) - g[s] * gi[l] / (log(10)*val[l]*val[l]);
+    break;
+  case (OpMinus):
+    h[l] += h[s];
+    h[r] -= h[s];
+    break;
+  case (OpMult):
+    h[l] += h[s]*val[r] + g[s]*gi[r];
+    h[r] += h[s]*val[l] + g[s]*gi[l];
+    break;
+  case (OpPlus):
+    h[l] += h[s];
+    h[r] += h[s];
+    break;
+  case (OpPow):
+    assert(!"derivative of OpPow not implemented!");
+    break;
+  case (OpPowK):
+    h[l] += h[s] * val[r] * pow(val[l],val[r]-1.0)
+          + g[s]*gi[l]*val[r]*(val[r]-1.0)*pow(val[l], val[r]-2.0);
+    break;
+  case (OpRound):
+    assert(!"derivative of OpRound not implemented!");
+    break;
+  case (OpSin):
+    h[l] += h[s]*cos(val[l]) - g[s] * gi[l] * val[s]; // val[s] = sin().
+    break;
+  case (OpSinh):
+    h[l] += h[s]*cosh(val[l]) + g[s] * gi[l] * val[s]; // val[s] = sinh().
+    break;
+  case (OpSqr):
+    h[l] += 2.0*h[s]*val[l] + g[s] * 2.0 * gi[l];
+    break;
+  case (OpSqrt):
+    if (fabs(val[s]) > DIV_BY_ZERO_TOL) {
+      h[l] += h[s]*0.5/val[s] - g[s] * gi[l] * 0.25 /(val[s] * val[l]);
+      // -1/4/x^1.5
+    } else {
+      *error = 1;
+    }
+    break;
+  case (OpSumList):
+    if (h[s]!=0.0) {
+      for (UInt j=cStart_[i]; j<cStart_[i+1]; ++j) {
+        h[cInd_[j]] += h[s];
+      }
+    }
+    break;
+  case (OpTan):
+    {
+    double d = cos(val[l]);
+           d *= d;
+    h[l] += h[s]/d  + 2.0 * g[s] * gi[l] * tan(val[l])/d;
+    }
+    break;
+  case (OpTanh):
+    {
+    double d = cosh(val[l]);
+           d *= d;
+    h[l] += h[s]/d  - 2.0 * g[s] * gi[l] * tanh(val[l])/d;
+    }
+    break;
+  case (OpUMinus):
+    h[l] -= h[s];
+    break;
+  default:
+    break;
+  }
+}
+
+
+void CTape::initVal(double *val) const
+{
+  std::copy(cVal_.begin(), cVal_.end(), val);
+}
+
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
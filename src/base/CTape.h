@@ -0,0 +1,244 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2008 - 2017 The MINOTAUR Team.
+//
+
+
+/**
+ * \file CTape.h
+ * \brief Declare class CTape, a flat instruction tape compiled from the
+ * computational graph of a nonlinear function.
+ * \author The MINOTAUR Team
+ */
+
+#ifndef MINOTAURCTAPE_H
+#define MINOTAURCTAPE_H
+
+#include "OpCode.h"
+#include "Types.h"
+
+namespace Minotaur {
+
+class CNode;
+typedef std::deque<CNode *> CNodeQ;
+
+/**
+ * \brief CTape is a compact, contiguous representation of a CGraph that is
+ * used for evaluating the function and its derivatives.
+ *
+ * Every node of the graph is mapped to a slot of a scratch array. Slots
+ * [0, numConsts) hold constants, the next numVars slots hold the variables
+ * (in the order given to build()) and the remaining slots hold one result
+ * for each instruction. Instruction i writes slot getInstrSlot(i), and the
+ * instructions are stored in topological order as separate arrays of
+ * opcodes and operand slots. The tape itself does not store any values
+ * computed in an evaluation. All methods that evaluate take the scratch
+ * arrays as arguments and are const. The arrays must be of size
+ * getNumSlots() and the value array must be initialized by initVal().
+ */
+class CTape {
+public:
+  /// Default constructor.
+  CTape();
+
+  /// Destroy.
+  ~CTape();
+
+  /**
+   * \brief Add the instructions to evaluate the Hessian column of a
+   * variable. Columns must be added in the same order as variables were
+   * given to build().
+   *
+   * \param [in] fwd Instructions that depend on the variable, in increasing
+   * order.
+   * \param [in] rev Instructions that participate in the reverse pass, in
+   * the order in which they should be processed.
+   * \param [in] out Slots of variables whose second derivatives are
+   * added to the Hessian, in the order of Hessian offsets.
+   */
+  void addHessCol(const UIntVector &fwd, const UIntVector &rev,
+                  const UIntVector &out);
+
+  /**
+   * \brief Compile the tape.
+   *
+   * \param [in] vnodes The nodes of variables. The order determines the
+   * order of variable slots.
+   * \param [in] dnodes All dependent nodes in topological order.
+   * \param [in] onode The output node.
+   */
+  void build(const CNodeQ &vnodes, const CNodeQ &dnodes, const CNode *onode);
+
+  /// Remove all instructions and Hessian columns.
+  void clear();
+
+  /// Remove only the Hessian columns.
+  void clearHessCols();
+
+  /**
+   * \brief Evaluate the function.
+   *
+   * \param [in] x The point. Only x[getVarIndex(i)] are read.
+   * \param [in,out] val Values of all slots. Constants must be set.
+   * \param [out] error Set to nonzero if an error is encountered.
+   * \return The value of the output slot.
+   */
+  double eval(const double *x, double *val, int *error) const;
+
+  /**
+   * \brief Evaluate the function at several points at once.
+   *
+   * The value of slot s at point j is stored in val[s*k+j], so that each
+   * instruction works on k contiguous values.
+   *
+   * \param [in] x The points stored one after the other. Point j starts at
+   * x+j*n.
+   * \param [in] n The size of each point.
+   * \param [in] k The number of points.
+   * \param [out] val Values of all slots at all points. Must be of size
+   * getNumSlots()*k. It need not be initialized.
+   * \param [out] f The function value at each point. Size k.
+   * \param [out] error Set to nonzero if an error is encountered at any
+   * point.
+   */
+  void evalBatch(const double *x, UInt n, UInt k, double *val, double *f,
+                 int *error) const;
+
+  /**
+   * \brief Evaluate the contributions of a variable column to the Hessian.
+   * Assumes that eval() and grad() were called on val and g.
+   *
+   * \param [in] col The column, i.e. position of the variable.
+   * \param [in] mult Multiplier of the Hessian.
+   * \param [in] val Values of all slots.
+   * \param [in] g Reverse-mode gradients of all slots.
+   * \param [in,out] gi Forward-mode gradients. Must be zero on input and
+   * is zero on output.
+   * \param [in,out] h Second order adjoints. Must be zero on input and is
+   * zero on output.
+   * \param [in] offs Offsets into values for each output of this column.
+   * \param [in,out] values Hessian values to which we add.
+   * \param [out] error Set to nonzero if an error is encountered.
+   */
+  void evalHessCol(UInt col, double mult, const double *val, const double *g,
+                   double *gi, double *h, const UInt *offs, double *values,
+                   int *error) const;
+
+  /**
+   * \brief Evaluate reverse-mode gradient of the output with respect to all
+   * slots. Assumes that eval() was called on val.
+   *
+   * \param [in] val Values of all slots.
+   * \param [out] g Gradients of all slots.
+   * \param [out] error Set to nonzero if an error is encountered.
+   */
+  void grad(const double *val, double *g, int *error) const;
+
+  /**
+   * \brief Evaluate reverse-mode gradients at several points. Assumes that
+   * evalBatch() was called on val.
+   *
+   * \param [in] k The number of points.
+   * \param [in] val Values of all slots, as filled by evalBatch().
+   * \param [out] g Gradients of all slots, in the same layout as val.
+   * \param [out] error Set to nonzero if an error is encountered.
+   */
+  void gradBatch(UInt k, const double *val, double *g, int *error) const;
+
+  /// \return The slot that holds the output of instruction i.
+  UInt getInstrSlot(UInt i) const { return nConst_+nVar_+i; };
+
+  /// \return The number of Hessian columns added.
+  UInt getNumHessCols() const { return hFwdStart_.size()-1; };
+
+  /// \return The number of instructions.
+  UInt getNumInstrs() const { return op_.size(); };
+
+  /// \return The size of scratch arrays required for evaluation.
+  UInt getNumSlots() const { return nConst_+nVar_+op_.size(); };
+
+  /// \return The number of variable slots.
+  UInt getNumVars() const { return nVar_; };
+
+  /// \return The slot of the output node.
+  UInt getOutSlot() const { return oSlot_; };
+
+  /// \return The index (in x) of the variable at position i.
+  UInt getVarIndex(UInt i) const { return vInd_[i]; };
+
+  /// \return The slot of the variable at position i.
+  UInt getVarSlot(UInt i) const { return nConst_+i; };
+
+  /// Copy the constants into the first slots of val.
+  void initVal(double *val) const;
+
+private:
+  /// Offsets in cInd_ for children of each OpSumList instruction.
+  UIntVector cStart_;
+
+  /// Slots of children of OpSumList instructions.
+  UIntVector cInd_;
+
+  /// Values of constant slots.
+  DoubleVector cVal_;
+
+  /// Offsets in hFwd_ for each Hessian column.
+  UIntVector hFwdStart_;
+
+  /// Instructions processed in the forward pass of each Hessian column.
+  UIntVector hFwd_;
+
+  /// Offsets in hOut_ for each Hessian column.
+  UIntVector hOutStart_;
+
+  /// Slots of variables whose values are copied to the Hessian.
+  UIntVector hOut_;
+
+  /// Offsets in hRev_ for each Hessian column.
+  UIntVector hRevStart_;
+
+  /// Instructions processed in the reverse pass of each Hessian column.
+  UIntVector hRev_;
+
+  /// Slot of the left (or only) operand of each instruction.
+  UIntVector l_;
+
+  /// Number of constant slots.
+  UInt nConst_;
+
+  /// Number of variable slots.
+  UInt nVar_;
+
+  /// Slot of the output.
+  UInt oSlot_;
+
+  /// OpCode of each instruction.
+  std::vector<OpCode> op_;
+
+  /// Slot of the right operand of each instruction.
+  UIntVector r_;
+
+  /// Index (in x) of each variable slot.
+  UIntVector vInd_;
+
+  /// Add forward-mode derivative of instruction i.
+  void fwdGrad_(UInt i, const double *val, double *gi) const;
+
+  /// Push second order adjoint of instruction i to its operands.
+  void hess_(UInt i, const double *val, const double *g, const double *gi,
+             double *h, int *error) const;
+};
+}
+#endif
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
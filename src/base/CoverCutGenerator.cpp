@@ -33,16 +33,28 @@ using std::ostringstream;
 #include "Relaxation.h"
 #include "Option.h"
 
+#if USE_OPENMP
+#include <omp.h>
+#endif
 
 using namespace Minotaur;
 
 # define DEBUG_LEVEL -1
 
-CoverCutGenerator::CoverCutGenerator() {}
+CoverCutGenerator::CoverCutGenerator()
+  : master_(0),
+    nThreads_(1),
+    pending_(0),
+    stats_(0)
+{
+}
 
 // Currently unused, probably removed later.
 CoverCutGenerator::CoverCutGenerator(ProblemPtr , SolutionPtr , EnvPtr )
-// : stats_(0)
+  : master_(0),
+    nThreads_(1),
+    pending_(0),
+    stats_(0)
 {
   // Check if initialization is successful.
   //bool successinit = false;
@@ -53,7 +65,10 @@ CoverCutGenerator::CoverCutGenerator(ProblemPtr , SolutionPtr , EnvPtr )
 }
 
 CoverCutGenerator::CoverCutGenerator(RelaxationPtr rel, ConstSolutionPtr sol, EnvPtr env)
-// : stats_(0)
+  : master_(0),
+    nThreads_(1),
+    pending_(0),
+    stats_(0)
 {
   //ProblemPtr p;
   //p = rel;
@@ -79,6 +94,12 @@ bool CoverCutGenerator::initialize(RelaxationPtr p, ConstSolutionPtr s, EnvPtr e
   env_ = env;
   // Integrality tolerance is assigned.
   intTol_ = env_->getOptions()->findDouble("int_tol")->getValue();
+#if USE_OPENMP
+  int k = env_->getOptions()->findInt("cover_threads")->getValue();
+  if (k > 1) {
+    nThreads_ = k;
+  }
+#endif
   // Objective value change tolerance.
   objtol_ = 1e-6;
   // If no cut generation occured this will return 0s for each statistics.
@@ -137,6 +158,10 @@ void CoverCutGenerator::initStats()
   stats_->gns = 0;
   stats_->singlectwo = 0;
   stats_->basic = 0;
+  stats_->totalcuts = 0;
+  stats_->noviol = 0;
+  stats_->noinitcov = 0;
+  stats_->time = 0.0;
 }
 
 void CoverCutGenerator::generateKnapList()
@@ -150,6 +175,7 @@ void CoverCutGenerator::generateAllCuts()
     ConstraintIterator it;
     ConstraintIterator begin = knapsackListPtr_->getListBegin();
     ConstraintIterator end   = knapsackListPtr_->getListEnd(); 
+    std::vector<ConstraintPtr> rows;
     for (it=begin; it != end; ++it) {
       // If debug option is given write the constraint considered to output
       // file.
@@ -171,7 +197,14 @@ void CoverCutGenerator::generateAllCuts()
       bool has = hasCover(it);
       if (has) {
         numCons_ += 1;
-        generateCuts(*it);
+        rows.push_back(*it);
+      }
+    }
+    if (nThreads_ > 1 && rows.size() > 1 && DEBUG_LEVEL < 9) {
+      generateCutsPar_(rows);
+    } else {
+      for (UInt i=0; i<rows.size(); ++i) {
+        generateCuts(rows[i]);
       }
     }
     // Check if no constraint is considered for cut generation.
@@ -181,6 +214,71 @@ void CoverCutGenerator::generateAllCuts()
   }
 }
 
+
+// Each thread works on its own copy of the generator so that the lifting
+// problems and the scratch space are not shared. The cuts of each row are
+// added to the list after all rows are done, in the order of rows, so that
+// the same cuts are obtained irrespective of the number of threads.
+void CoverCutGenerator::generateCutsPar_(std::vector<ConstraintPtr> &rows)
+{
+#if USE_OPENMP
+  UInt nrows = rows.size();
+  UInt nt = std::min(nThreads_, nrows);
+  std::vector<CovCutPendingVector> found(nrows);
+  std::vector<CoverCutGeneratorPtr> workers(nt);
+
+  if (omp_in_parallel()) {
+    for (UInt i=0; i<nrows; ++i) {
+      generateCuts(rows[i]);
+    }
+    return;
+  }
+
+  for (UInt t=0; t<nt; ++t) {
+    workers[t] = new CoverCutGenerator();
+    workers[t]->env_ = env_;
+    workers[t]->p_ = p_;
+    workers[t]->s_ = s_;
+    workers[t]->knapsackListPtr_ = knapsackListPtr_;
+    workers[t]->numCons_ = 0;
+    workers[t]->intTol_ = intTol_;
+    workers[t]->objtol_ = objtol_;
+    workers[t]->master_ = this;
+    workers[t]->stats_ = new CovCutGenStats();
+    workers[t]->initStats();
+  }
+
+#pragma omp parallel num_threads(nt)
+  {
+    CoverCutGeneratorPtr w = workers[omp_get_thread_num()];
+#pragma omp for schedule(dynamic, 1)
+    for (int i=0; i<(int) nrows; ++i) {
+      w->pending_ = &(found[i]);
+      w->generateCuts(rows[i]);
+    }
+    w->pending_ = 0;
+  }
+  parKeys_.clear();
+
+  for (UInt i=0; i<nrows; ++i) {
+    for (CovCutPendingVector::iterator it=found[i].begin();
+         it!=found[i].end(); ++it) {
+      addCut(&(it->cov), it->rhs, it->type);
+    }
+  }
+  for (UInt t=0; t<nt; ++t) {
+    stats_->knaps += workers[t]->stats_->knaps;
+    stats_->noviol += workers[t]->stats_->noviol;
+    stats_->noinitcov += workers[t]->stats_->noinitcov;
+    delete workers[t];
+  }
+#else
+  for (UInt i=0; i<rows.size(); ++i) {
+    generateCuts(rows[i]);
+  }
+#endif
+}
+
 // Check if it is a GUB. If it is a GUB, we do not generate any cover cuts
 // by using it. May be we should eliminate such constraints as well.
 // x_1 + x_2 + x_3 <= 5
@@ -661,66 +759,36 @@ double CoverCutGenerator::lift(const ConstCoverSetPtr obj,
 
   // Number of variables.
   UInt n = obj->size();
-  // Objective functions coefficients.
-  double * c = new double[n];
-  CoverSetConstIterator it;
-  CoverSetConstIterator begin = obj->begin();
-  CoverSetConstIterator end   = obj->end();
-  UInt i = 0;
-  for (it=begin; it!=end; ++it) {
-    c[i] = it->second;
-    i += 1;
-  }
-  
-  // Constraint Coefficients.
-  double * a = new double[n];
-  CoverSetConstIterator itCoef;
-  CoverSetConstIterator beginCoef = constraint->begin();
-  CoverSetConstIterator endCoef   = constraint->end();
-  i = 0;
-  for (itCoef=beginCoef; itCoef!=endCoef; ++itCoef) {
-    a[i] = itCoef->second;
-    i += 1;
-  }
-  
+  UInt i;
+
   // First I have to order variables suitable for knapsack solver!!!.
-  double * temp = new double[n];
-  for(i = 0; i < n; ++i) {
-    if (a[i] != 0) {
-      temp[i] = c[i]/a[i];
-    } else {
-      temp[i] = 0;
-    }
-  }
- 
-  std::vector<id> ordered;
+  // Objective function and constraint coefficients are copied in the order
+  // of nonincreasing c_i/a_i to the scratch space.
+  ksOrder_.clear();
   for (i = 0; i < n; ++i) {
-    ordered.push_back(id(i,temp[i]));
+    double ai = (*constraint)[i].second;
+    ksOrder_.push_back(id(i, (ai != 0) ? (*obj)[i].second/ai : 0.0));
   }
-  // order the vector
-  // This can be made more efficient.
   CompareIntDouble compare;
-  sort(ordered.begin(), ordered.end(), compare);
-  double * tempa = new double[n];
-  double * tempc = new double[n];
+  sort(ksOrder_.begin(), ksOrder_.end(), compare);
 
+  ksA_.resize(n+1);
+  ksC_.resize(n+1);
+  ksX_.resize(n+1);
   for (i = 0; i<n; ++i) {
     // The index of variable in initial a and c vectors.
-    int index = ordered[i].first;
-    tempa[i] = a[index];
-    tempc[i] = c[index];
+    int index = ksOrder_[i].first;
+    ksA_[i] = (*constraint)[index].second;
+    ksC_[i] = (*obj)[index].second;
   }
-  // Now, we do not need a and c since we sopied them into tempa and tempc.
-  delete [] a;
-  delete [] c;
-  a = tempa;
-  c = tempc;
+  double *a = &(ksA_[0]);
+  double *c = &(ksC_[0]);
 
   // Solution.
   double gamma = 0.0;
 
   // Solution vector.
-  int * x = new int[n];
+  int * x = &(ksX_[0]);
 
   // Rhs value of constraint (b-a_i) where a_i is the variable to lift up.
   if (uplift == true) {
@@ -736,12 +804,6 @@ double CoverCutGenerator::lift(const ConstCoverSetPtr obj,
       printLiftProb(obj,constraint,variable,rhs,initialb,uplift,b,gamma,alpha);
     }
 
-    // Clean-up, deallocate memory.
-    delete [] tempa;
-    delete [] tempc;
-    delete [] temp;
-    delete [] x;
- 
     return alpha;
 
   } else {
@@ -762,12 +824,6 @@ double CoverCutGenerator::lift(const ConstCoverSetPtr obj,
     // Update initial bound of constraint.
     initialb += variable->second;
     
-    // Clean-up, deallocate memory.
-    delete [] tempa;
-    delete [] tempc;
-    delete [] temp;
-    delete [] x;
-  
     return ksi;
   
   } 
@@ -921,6 +977,29 @@ bool CoverCutGenerator::addCut(CoverSetPtr cov, double rhs, UInt cuttype)
     }
   }
 
+  // Cuts found by a thread are added to the list of the main generator
+  // later, in the order of rows, which also removes duplicates. Tell the
+  // caller now if the cut is a duplicate, as in the serial case.
+  if (pending_) {
+    CovCutPending cut;
+    std::vector<double> key;
+    bool cutexists;
+
+    cut.cov = *cov;
+    cut.rhs = rhs;
+    cut.type = cuttype;
+    pending_->push_back(cut);
+    cutKey_(cov, rhs, key);
+#if USE_OPENMP
+#pragma omp critical (CovCutKeys)
+#endif
+    {
+      cutexists = (master_->cutmap.find(key) != master_->cutmap.end()) ||
+                  (false == master_->parKeys_.insert(key).second);
+    }
+    return !cutexists;
+  }
+
   // Total number of cuts generated increased by one.
   stats_->totalcuts += 1;
   // I have to check violation and check integrality of coefficients as well.
@@ -960,32 +1039,30 @@ bool CoverCutGenerator::addCut(CoverSetPtr cov, double rhs, UInt cuttype)
 
 // Careful! It checks values according to indices of variable not to ID's.
 // This may cause a problem at the higher level when we check duplicacy in Cut manager.
-bool CoverCutGenerator::checkExists(CoverSetPtr cov, double rhs)
+// The key is the list of (index, coefficient/rhs) pairs of nonzero
+// coefficients sorted by index, so it does not grow with number of variables.
+void CoverCutGenerator::cutKey_(CoverSetPtr cov, double rhs,
+                                std::vector<double> &coeffs) const
 {
   // Iterators for variables in cut.
   CoverSetIterator it;
   CoverSetIterator begin = cov->begin();
   CoverSetIterator end = cov->end();
-  // Number of variables in the linear function.
-  UInt numvars = p_->getNumVars();
-  // Vector to include the coefficients.
-  std::vector<double> coeffs(numvars,0);
-  // Index of the variable in the problem.
-  UInt index;
-  // Current variable considered.
-  VariablePtr var;
+  // Nonzero coefficients and their indices.
+  std::vector<id> nz;
   // Coefficient divided by rhs of cover inequality.
   double dividedcoeff;
   // Add the coefficients to coefficient vector one by one.
   if (DEBUG_LEVEL >= 10) {
     cerr << "Coeffs: ";
   }
+  nz.reserve(cov->size());
   for (it=begin; it!=end; ++it) {
-    var = it->first;
-    index  = var->getIndex();
     // Serdar check this int, what it does, probably it should not be here.
     dividedcoeff = double(it->second) / rhs;
-    coeffs[index] = dividedcoeff;
+    if (dividedcoeff != 0.0) {
+      nz.push_back(id(it->first->getIndex(), dividedcoeff));
+    }
     if (DEBUG_LEVEL >=  10) {
       cerr << dividedcoeff << " ";
     } 
@@ -993,6 +1070,22 @@ bool CoverCutGenerator::checkExists(CoverSetPtr cov, double rhs)
   if (DEBUG_LEVEL >= 10) {
     cerr << endl;
   }
+  std::sort(nz.begin(), nz.end());
+  coeffs.clear();
+  coeffs.reserve(2*nz.size());
+  for (std::vector<id>::iterator nit=nz.begin(); nit!=nz.end(); ++nit) {
+    coeffs.push_back(nit->first);
+    coeffs.push_back(nit->second);
+  }
+}
+
+
+bool CoverCutGenerator::checkExists(CoverSetPtr cov, double rhs)
+{
+  // Vector to include the indices and the coefficients.
+  std::vector<double> coeffs;
+
+  cutKey_(cov, rhs, coeffs);
 
   // Check if the cut already exists.
   std::map< std::vector<double>, UInt>::iterator found = cutmap.find(coeffs);
@@ -1345,23 +1438,166 @@ void CoverCutGenerator::extendedCover(CoverSetPtr cover, ConstConstraintPtr cons
 }
 
 
-// This code is based on CglKnapsackCover Inequalities.
-// Assumption: Items are sorted in the order of c_1/a_1 >= c_2/a_2 >= ... c_n/a_n  
+// Profits of lifting problems are integers and weights are often small
+// integers too. A dynamic program then needs O(n b) or O(n sum c) steps no
+// matter how many nodes branch-and-bound would need.
 UInt CoverCutGenerator::binaryKnapsackSolver(UInt n, double b, 
                                              double const * c, double const * a, 
                                              double & z, int * x)
 {
-  // Set the solution as a vector of zeros. // change this to memset.
+  // Largest number of entries in the table of a dynamic program.
+  const double max_cells = 1048576.0;
+  double csum = 0.0;
+  double cap, ccells, acells;
+  bool intc = true;
+  bool inta = true;
+  UInt i;
+
+  z = 0.0;
+  memset(x, 0, n*sizeof(int));
+  for (i=0; i<n; ++i) {
+    if (c[i] > 0) {
+      csum += c[i];
+      intc = intc && fabs(c[i] - floor(c[i] + 0.5)) < 1e-9;
+      inta = inta && a[i] > 0 && fabs(a[i] - floor(a[i] + 0.5)) < 1e-9;
+    }
+  }
+  if (n == 0 || csum <= 0.0) {
+    return 1;
+  } else if (b >= numeric_limits<double>::infinity()) {
+    for (i=0; i<n; ++i) {
+      if (c[i] > 0) {
+        x[i] = 1;
+        z += c[i];
+      }
+    }
+    return 1;
+  }
+
+  cap = floor(b + 0.000001);
+  if (inta && cap < 0) {
+    return 1;
+  }
+  ccells = (intc) ? n*(floor(csum + 0.5) + 1) : max_cells + 1;
+  acells = (inta) ? n*(cap + 1) : max_cells + 1;
+  if (acells <= max_cells && acells <= ccells) {
+    dpCapKnap_(n, (UInt) cap, c, a, z, x);
+    return 1;
+  } else if (ccells <= max_cells) {
+    dpProfKnap_(n, (UInt) floor(csum + 0.5), b, c, a, z, x);
+    return 1;
+  }
+  return bbKnap_(n, b, c, a, z, x);
+}
+
+
+void CoverCutGenerator::dpCapKnap_(UInt n, UInt b, double const *c,
+                                   double const *a, double &z, int *x)
+{
+  // val[w] is the largest profit of items considered so far that weigh at
+  // most w. tab[i*(b+1)+w] is 1 if item i was used to improve val[w].
+  double *val;
+  char *tab;
+  UInt ai, w;
+
+  ksVal_.assign(b+1, 0.0);
+  ksTab_.assign(n*(b+1), 0);
+  val = &(ksVal_[0]);
+  tab = &(ksTab_[0]);
+  for (UInt i=0; i<n; ++i) {
+    if (c[i] <= 0 || a[i] > b + 0.5) {
+      continue;
+    }
+    ai = (UInt) floor(a[i] + 0.5);
+    for (w=b; w>=ai; --w) {
+      if (val[w-ai] + c[i] > val[w]) {
+        val[w] = val[w-ai] + c[i];
+        tab[i*(b+1)+w] = 1;
+      }
+    }
+  }
+
+  z = 0.0;
+  w = b;
+  for (UInt i=n; i>0; --i) {
+    if (tab[(i-1)*(b+1)+w]) {
+      x[i-1] = 1;
+      z += c[i-1];
+      w -= (UInt) floor(a[i-1] + 0.5);
+    }
+  }
+}
+
+
+void CoverCutGenerator::dpProfKnap_(UInt n, UInt csum, double b,
+                                    double const *c, double const *a,
+                                    double &z, int *x)
+{
+  // val[p] is the smallest weight of items considered so far whose profit
+  // is exactly p. tab[i*(csum+1)+p] is 1 if item i was used to improve
+  // val[p].
+  const double inf = numeric_limits<double>::infinity();
+  double *val;
+  char *tab;
+  UInt ci, p;
+
+  ksVal_.assign(csum+1, inf);
+  ksTab_.assign(n*(csum+1), 0);
+  val = &(ksVal_[0]);
+  tab = &(ksTab_[0]);
+  val[0] = 0.0;
+  for (UInt i=0; i<n; ++i) {
+    if (c[i] <= 0) {
+      continue;
+    }
+    ci = (UInt) floor(c[i] + 0.5);
+    for (p=csum; p>=ci; --p) {
+      if (val[p-ci] + a[i] < val[p]) {
+        val[p] = val[p-ci] + a[i];
+        tab[i*(csum+1)+p] = 1;
+      }
+    }
+  }
+
+  for (p=csum; p>0 && !(val[p] <= b + 0.000001); --p) {
+  }
+  z = 0.0;
+  for (UInt i=n; i>0 && p>0; --i) {
+    if (tab[(i-1)*(csum+1)+p]) {
+      x[i-1] = 1;
+      z += c[i-1];
+      p -= (UInt) floor(c[i-1] + 0.5);
+    }
+  }
+}
+
+
+// This code is based on CglKnapsackCover Inequalities.
+// Assumption: Items are sorted in the order of c_1/a_1 >= c_2/a_2 >= ... c_n/a_n  
+UInt CoverCutGenerator::bbKnap_(UInt n, double b, double const * c,
+                                double const * a, double & z, int * x)
+{
+  // Limit on the number of bounds computed.
+  const UInt max_iters = 100000;
+  // Upper bound at the root.
+  double rootub = numeric_limits<double>::infinity();
+  UInt iters = 0;
+  bool intc = true;
+
+  // Set the solution as a vector of zeros.
   memset(x, 0, (n)*sizeof(int));
+  for (UInt k=0; k<n && intc; ++k) {
+    intc = fabs(c[k] - floor(c[k] + 0.5)) < 1e-9;
+  }
   // Current solution vector.
-  UInt * xhat = new UInt[n+1];
-  // Set the solution as a vector of zeros.
-  memset(xhat,0,(n+1)*sizeof(int));
+  ksXhat_.assign(n+1, 0);
+  UInt * xhat = &(ksXhat_[0]);
   UInt j = 0;
  
   // set up: adding extra elements
-  double * cIn = new double[n+2];
-  double * aIn = new double[n+2];
+  ksVal_.resize(2*(n+2));
+  double * cIn = &(ksVal_[0]);
+  double * aIn = &(ksVal_[n+2]);
   UInt ii = 0;
   for (ii=1; ii<n+1; ii++) {
     cIn[ii]=c[ii-1];
@@ -1382,20 +1618,28 @@ UInt CoverCutGenerator::binaryKnapsackSolver(UInt n, double b,
     ii=j;
     double aSemiSum = aIn[j];
     double cSemiSum = cIn[j];
-    while (aSemiSum <= bhat && ii<n+2) {
+    while (aSemiSum <= bhat && ii<n+1) {
       ii++;
       aSemiSum += aIn[ii];
       cSemiSum += cIn[ii];
     }
-    if (ii==n+2) {
-      cout << "Exceeded iterator limit. Aborting...\n";
-      abort();
-    }
   
     // r = ii at this point
     aSemiSum -= aIn[ii];
     cSemiSum -= cIn[ii];
-    double u = cSemiSum + floor((bhat - aSemiSum)*cIn[ii]/aIn[ii]);
+    double u = (bhat - aSemiSum)*cIn[ii]/aIn[ii];
+    if (0 == iters) {
+      rootub = (ii > n) ? cSemiSum : cSemiSum + u;
+    }
+    // the bound can be rounded down only if all profits are integers.
+    u = cSemiSum + ((intc) ? floor(u) : u);
+    if (iters >= max_iters) {
+      // the best solution found may not be optimal, return the LP bound
+      // instead so that the lifted coefficients remain valid.
+      z = std::max(z, (intc) ? floor(rootub + 1e-9) : rootub);
+      return 0;
+    }
+    ++iters;
     // "if (z >= zhat + u) goto 5: backtrack;"
     if (!(z >= zhat + u)) {
       do {
@@ -1438,11 +1682,6 @@ UInt CoverCutGenerator::binaryKnapsackSolver(UInt n, double b,
     }
     // "if (no such i exists) return;"
     if (i==0) {
-      // clean up, deallocate memory.
-      delete [] cIn;
-      delete [] aIn;
-      delete [] xhat;
-
       return 1;
     }
     bhat += aIn[i];
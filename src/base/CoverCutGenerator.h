@@ -15,6 +15,7 @@
 #define MINOTAURCOVERCUTGENERATOR_H
 
 #include <map>
+#include <set>
 #include <fstream>
 using std::ofstream;
 #include <string>
@@ -76,6 +77,15 @@ namespace Minotaur {
   typedef CovCutGenStats const * ConstCovCutGenStatsPtr;
   typedef ofstream* OfstreamPtr;
 
+  /// A cover inequality found by a thread, added to the list later.
+  struct CovCutPending
+  {
+    CoverSet cov; /// Variables and coefficients of the inequality.
+    double rhs; /// Right hand side.
+    UInt type; /// Type of cut, see KnapCovType.
+  };
+  typedef std::vector<CovCutPending> CovCutPendingVector;
+
   /**
    * The CoverCutGenerator class generates a set of minimal covers 
    * for each knapsack constraint.
@@ -262,8 +272,15 @@ namespace Minotaur {
     // Generates an extended cover from a given cover set.
     void extendedCover(CoverSetPtr cover, ConstConstraintPtr cons); 
 
-    // Implementation based on Horowitz-Shahni algorithm implementation in
-    // CglKnapsackCover
+    /**
+     * Solve max c'x s.t. a'x <= b, x binary. Items must be ordered in
+     * nonincreasing c_i/a_i. Small problems with integer profits or integer
+     * weights and capacity are solved by dynamic programming. Others are
+     * solved by the Horowitz-Sahni branch-and-bound of CglKnapsackCover
+     * with a limit on iterations. Returns 1 if z is the optimal value and 0
+     * if the limit was reached, in which case z is an upper bound (the LP
+     * bound) and x is the best solution found.
+     */
     UInt binaryKnapsackSolver(UInt n, double b, double const * c,
                               double const *a, double & z, int * x);
 
@@ -327,6 +344,13 @@ namespace Minotaur {
   private:
     // Environment.
     EnvPtr env_;
+    // The generator that collects the cuts when this one is a worker of
+    // generateCutsPar_. NULL otherwise.
+    CoverCutGenerator *master_;
+    // Number of threads used to separate knapsack rows.
+    UInt nThreads_;
+    // If not NULL, cuts are saved here and added to the list later.
+    CovCutPendingVector *pending_;
 
     // Problem that cover cuts will be generated for.
     ProblemPtr p_;
@@ -358,6 +382,10 @@ namespace Minotaur {
     // Hash map that is used to check if a cut is already created or not.
     std::map< std::vector<double>, UInt> cutmap;  
 
+    // Keys of cuts found by workers of generateCutsPar_ that are not yet in
+    // cutmap. Used under a lock.
+    std::set< std::vector<double> > parKeys_;
+
     // Integer tolerance.
     double intTol_;
 
@@ -369,6 +397,29 @@ namespace Minotaur {
 
     // Output file name
     string  outfile_;
+    // Scratch space of knapsack solvers, reused in every call.
+    std::vector<double> ksA_;
+    std::vector<double> ksC_;
+    std::vector<id> ksOrder_;
+    std::vector<char> ksTab_;
+    std::vector<double> ksVal_;
+    std::vector<int> ksX_;
+    std::vector<UInt> ksXhat_;
+
+    // Branch-and-bound of binaryKnapsackSolver.
+    UInt bbKnap_(UInt n, double b, double const *c, double const *a,
+                 double &z, int *x);
+    // Key of a cut in cutmap: indices and coefficients/rhs of nonzeros.
+    void cutKey_(CoverSetPtr cov, double rhs,
+                 std::vector<double> &coeffs) const;
+    // Dynamic program over capacities. Weights must be positive integers.
+    void dpCapKnap_(UInt n, UInt b, double const *c, double const *a,
+                    double &z, int *x);
+    // Dynamic program over profits. Profits must be integers.
+    void dpProfKnap_(UInt n, UInt csum, double b, double const *c,
+                     double const *a, double &z, int *x);
+    // Generate cuts from the rows using several threads.
+    void generateCutsPar_(std::vector<ConstraintPtr> &rows);
   };
 }
 
@@ -192,6 +192,9 @@ void CutMan2::updatePool(ProblemPtr rel, ConstSolutionPtr sol)
     int toRel = 0;
     int deleted = 0;
     CutPtr cut;
+
+    // cuts moved to the relaxation are sent to the engine together.
+    rel->startConsBatch();
     for (std::list<CutPtr>::iterator it = pool_.begin(); it != pool_.end();)
     {
       cut = *it;
@@ -209,6 +212,7 @@ void CutMan2::updatePool(ProblemPtr rel, ConstSolutionPtr sol)
   	it = pool_.erase(it);
       } 
     }
+    rel->endConsBatch();
     stats_->numDeletedCuts += deleted;
     ctMngrtime_ += timer_->query();
     checkTime_ += timer_->query();
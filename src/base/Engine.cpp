@@ -23,6 +23,15 @@ Engine::~Engine()
 }
 
 
+void Engine::addConstraints(ConstraintConstIterator cbeg,
+                            ConstraintConstIterator cend)
+{
+  for (ConstraintConstIterator it=cbeg; it!=cend; ++it) {
+    addConstraint(*it);
+  }
+}
+
+
 std::string Engine::getStatusString()
 {
   switch (status_) {
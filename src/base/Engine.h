@@ -43,6 +43,18 @@ namespace Minotaur {
     /// Add a new constraint to the engine.
     virtual void addConstraint(ConstraintPtr) = 0;
 
+    /**
+     * \brief Add a block of new constraints to the engine.
+     *
+     * The constraints are the last ones in the problem, in the same order.
+     * Engines that can pass several rows to the solver in one call should
+     * override this. The default adds them one at a time.
+     * \param [in] cbeg Iterator to the first new constraint.
+     * \param [in] cend Iterator past the last new constraint.
+     */
+    virtual void addConstraints(ConstraintConstIterator cbeg,
+                                ConstraintConstIterator cend);
+
     /// Change a bound of a constraint. 
     virtual void changeBound(ConstraintPtr cons, BoundType lu, 
                              double new_val) = 0;
@@ -141,6 +153,8 @@ namespace Minotaur {
     /**
      * \brief Delete constraints from the engine.
      *
+     * All constraints are removed in one call. Their indices are the ones
+     * from before the removal.
      * \param [in] delcons A vector of constraint pointers that should be
      * deleted from the engine.
      */
@@ -10,16 +10,21 @@
  * \author Ashutosh Mahajan, Argonne National Laboratory
  */
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <string>
+#if USE_OPENMP
+#include <omp.h>
+#endif
 
 #include "MinotaurConfig.h"
 #include "Environment.h"
 #include "Logger.h"
 #include "Option.h"
+#include "Profiler.h"
 #include "Timer.h"
 #include "Version.h"
 
@@ -31,6 +36,7 @@ Environment::Environment()
 {
   logger_     = (LoggerPtr) new Logger();
   options_    = (OptionDBPtr) new OptionDB();
+  profiler_   = 0;
   timerFac_   = new TimerFactory();
   timer_      = timerFac_->getTimer();
   createDefaultOptions_();
@@ -39,6 +45,10 @@ Environment::Environment()
 
 Environment::~Environment()
 {
+  if (profiler_) {
+    writeProfile_();
+    delete profiler_;
+  }
   delete logger_;
   delete options_;
   delete timer_;
@@ -72,6 +82,10 @@ void Environment::createDefaultOptions_()
       "Display the best solution if one found: <0/1>", true, false);
   options_->insert(b_option);
 
+  b_option = (BoolOptionPtr) new Option<bool>("log_json", 
+      "Write each line of the log as a JSON object: <0/1>", true, false);
+  options_->insert(b_option);
+
   b_option = (BoolOptionPtr) new Option<bool>("use_internal_quad", 
       "Should quadratic functions be treated natively: <0/1>",
       true, false);
@@ -195,6 +209,10 @@ void Environment::createDefaultOptions_()
       "If true, run the parallel branch-and-bound algorithm in opportunistic mode: <0/1>", true, false);
   options_->insert(b_option);
 
+  b_option = (BoolOptionPtr) new Option<bool>("mcbnb_steal_mode",
+      "If true, each thread keeps its own nodes and steals nodes from other threads when it runs out in parallel branch-and-bound: <0/1>", true, false);
+  options_->insert(b_option);
+
   b_option = (BoolOptionPtr) new Option<bool>("mcbnb_iter_mode",
       "If true, synchronize node processing in each iteration across all threads in parallel branch-and-bound: <0/1>", true, false);
   options_->insert(b_option);
@@ -315,6 +333,11 @@ void Environment::createDefaultOptions_()
       true, 200);
   options_->insert(i_option);
 
+  i_option = (IntOptionPtr) new Option<int>("divheur_threads",
+      "Number of threads used to run dives concurrently in the diving "
+      "heuristic: >=1", true, 1);
+  options_->insert(i_option);
+
   i_option = (IntOptionPtr) new Option<int>("engine_log_level",
       "Verbosity of engine: 0-6", true, LogInfo);
   options_->insert(i_option);
@@ -335,11 +358,46 @@ void Environment::createDefaultOptions_()
       "Limit on number of iterations allowed during strong branching: >0",
       true, 25);
   options_->insert(i_option);
+
+  i_option = (IntOptionPtr) new Option<int>("strbr_threads",
+      "Number of threads used to solve strong-branching problems in "
+      "reliability branching: >=1", true, 1);
+  options_->insert(i_option);
+
+  i_option = (IntOptionPtr) new Option<int>("cover_threads",
+      "Number of threads used to separate knapsack cover cuts: >=1",
+      true, 1);
+  options_->insert(i_option);
+
+  i_option = (IntOptionPtr) new Option<int>("nlpms_threads",
+      "Number of threads used to solve from different starting points in "
+      "NLP multi-start heuristic: >=1", true, 1);
+  options_->insert(i_option);
+
+  i_option = (IntOptionPtr) new Option<int>("nlpms_starts",
+      "Maximum number of starting points tried in NLP multi-start "
+      "heuristic: >=1", true, 10);
+  options_->insert(i_option);
  
   i_option = (IntOptionPtr) new Option<int>("threads",
       "Number of threads to be used ", true, 1);
   options_->insert(i_option);
 
+  i_option = (IntOptionPtr) new Option<int>("mcbnb_cut_import",
+      "Maximum number of cuts of other threads added to the relaxation of a "
+      "thread before one node in parallel branch-and-bound: >=0", true, 1000);
+  options_->insert(i_option);
+
+  i_option = (IntOptionPtr) new Option<int>("mcbnb_cut_age",
+      "Cuts found more than this many cuts ago are not shared among threads "
+      "in parallel branch-and-bound: >=0", true, 100000);
+  options_->insert(i_option);
+
+  i_option = (IntOptionPtr) new Option<int>("sol_pool_size",
+      "Number of best distinct solutions kept in the solution pool: >=1",
+      true, 1);
+  options_->insert(i_option);
+
   i_option = (IntOptionPtr) new Option<int>("msbnb_scheme_id",
       "Initial point generation scheme for MsProcessor: 1-5", true, 5);
   options_->insert(i_option);
@@ -431,6 +489,11 @@ void Environment::createDefaultOptions_()
   options_->insert(d_option);
   // Serdar ended.
 
+  d_option = (DoubleOptionPtr) new Option<double>("node_mem_limit", 
+      "Memory (in MB) for warm-start information of active nodes, beyond which it is written to a temporary file. 0 means no limit",
+      true, 0.0);
+  options_->insert(d_option);
+
   d_option = (DoubleOptionPtr) new Option<double>("obj_cut_off", 
       "Nodes with objective value above obj_cut_off are assumed infeasible",
       true, INFINITY);
@@ -504,6 +567,21 @@ void Environment::createDefaultOptions_()
       true, "Filter-SQP");
   options_->insert(s_option);
 
+  s_option = (StringOptionPtr) new Option<std::string>("node_mem_policy", 
+      "What to do with warm starts of cold nodes when node_mem_limit is exceeded: spill (to a file), drop",
+      true, "spill");
+  options_->insert(s_option);
+
+  s_option = (StringOptionPtr) new Option<std::string>("profile_file", 
+      "File for writing the time spent by each thread in nodes, presolve, separation, engine solves, strong branching and heuristics, in the folded format of flame graph tools. Empty: do not profile",
+      true, "");
+  options_->insert(s_option);
+
+  s_option = (StringOptionPtr) new Option<std::string>("problem_cache", 
+      "Binary file for saving the problem read from problem_file. It is read instead of problem_file in later runs if use_native_cgraph is 1 and no AMPL .sol file is written. Empty: do not use",
+      true, "");
+  options_->insert(s_option);
+
   s_option = (StringOptionPtr) new Option<std::string>("problem_file", 
       "Name of file that contains the instance to be solved", 
       true, "");
@@ -534,6 +612,23 @@ void Environment::createDefaultOptions_()
 }
 
 
+void Environment::createProfiler_()
+{
+  int nthreads = 1;
+
+  if (profiler_ || options_->findString("profile_file")->getValue()=="") {
+    return;
+  }
+#if USE_OPENMP
+  nthreads = std::max(omp_get_max_threads(), omp_get_num_procs());
+#endif
+  nthreads = std::max(nthreads, options_->findInt("threads")->getValue());
+  nthreads = std::max(nthreads,
+                      options_->findInt("strbr_threads")->getValue());
+  profiler_ = new Profiler(nthreads);
+}
+
+
 void Environment::convertAndAddOneOption_(BoolOptionPtr &b_option, 
                                           IntOptionPtr &i_option,
                                           DoubleOptionPtr &d_option, 
@@ -664,6 +759,18 @@ Timer* Environment::getNewTimer()
 }
 
 
+Timer* Environment::getNewThreadTimer() 
+{
+  return timerFac_->getThreadTimer();
+}
+
+
+Timer* Environment::getNewWallTimer() 
+{
+  return timerFac_->getWallTimer();
+}
+
+
 OptionDBPtr Environment::getOptions()
 {
   return options_;
@@ -691,6 +798,12 @@ const Timer* Environment::getTimer()
 }
 
 
+Profiler* Environment::getProfiler()
+{
+  return profiler_;
+}
+
+
 std::string Environment::getVersion() 
 {
   std::stringstream name_stream;
@@ -836,6 +949,8 @@ void Environment::readOptions(int argc, char **argv)
   // update the log level if set by the user
   logger_->setMaxLevel((LogLevel)getOptions()->findInt("log_level")
                        ->getValue());
+  logger_->setJson(getOptions()->findBool("log_json")->getValue());
+  createProfiler_();
   // display all the new options set.
   logger_->msgStream(LogInfo) << ostr.str();
 
@@ -937,6 +1052,22 @@ void Environment::stopTimer(int &err)
 }
 
 
+void Environment::writeProfile_()
+{
+  std::string fname = options_->findString("profile_file")->getValue();
+  std::ofstream fout(fname.c_str());
+
+  if (fout.is_open()) {
+    profiler_->write(fout);
+    fout.close();
+  } else {
+    logger_->msgStream(LogError) << me_ << "could not open profile file "
+                                 << fname << std::endl;
+  }
+  profiler_->writeStats(logger_->msgStream(LogInfo));
+}
+
+
 // Local Variables: 
 // mode: c++ 
 // eval: (c-set-style "k&r") 
@@ -18,6 +18,7 @@
 namespace Minotaur {
 
   class Interrupt;
+  class Profiler;
   class Timer;
   class TimerFactory;
 
@@ -43,6 +44,19 @@ namespace Minotaur {
       /// Get a new timer. The calling function has to free this timer.
       Timer *getNewTimer();
 
+      /**
+       * \brief Get a new timer that measures the cpu time of the calling
+       * thread. The calling function has to free this timer.
+       */
+      Timer *getNewThreadTimer();
+
+      /**
+       * \brief Get a new timer that measures wall-clock time. Use it for
+       * times of parallel algorithms. The calling function has to free this
+       * timer.
+       */
+      Timer *getNewWallTimer();
+
       /// Get the options database.
       OptionDBPtr getOptions();
 
@@ -63,6 +77,14 @@ namespace Minotaur {
        */
       const Timer* getTimer();
 
+      /**
+       * \brief Get the profiler.
+       *
+       * \return The profiler, or NULL if option profile_file was not set
+       * when the options were read.
+       */
+      Profiler* getProfiler();
+
       /// Get the version string
       std::string getVersion();
 
@@ -100,6 +122,9 @@ namespace Minotaur {
       /// The options database
       OptionDBPtr options_;
 
+      /// Profiler for timing scopes in each thread. NULL if not profiling.
+      Profiler *profiler_;
+
       /// The global timer
       Timer *timer_;
 
@@ -119,6 +144,9 @@ namespace Minotaur {
       /// Create default set of options
       void createDefaultOptions_();
 
+      /// Create the profiler if option profile_file is set.
+      void createProfiler_();
+
       /*
        * Find an option with the provided name. The option is option of that
        * type is returned and all others are NULLed.
@@ -146,6 +174,9 @@ namespace Minotaur {
        */
       UInt removeDashes_(std::string &name);
 
+      /// Write the profile to the file given in option profile_file.
+      void writeProfile_();
+
       /// Remove the string "minotaur." from front of a string.
       void removeMinotaurPrepend_(std::string & fullname);
 
@@ -4,6 +4,7 @@
 //     (C)opyright 2009 - 2017 The MINOTAUR Team.
 // 
 
+#include <algorithm>
 #include <cmath>
 #include <iterator>
 #include <iostream>
@@ -342,6 +343,20 @@ void Function::evalHessian(const double mult, const double *x,
 }
 
 
+void Function::evalHessianWork(double mult, const double *x,
+                               const LTHessStor *stor, double *values,
+                               NlWork *w, int *error) const
+{
+  *error = 0;
+  if (qf_) {
+    qf_->evalHessian(mult, x, stor, values, error);
+  }
+  if (nlf_) {
+    nlf_->evalHessianWork(mult, x, stor, values, w, error);
+  }
+}
+
+
 void Function::add(ConstLinearFunctionPtr lPtr)
 {
   if (lf_) {
@@ -452,6 +467,86 @@ void Function::evalGradient(const double *x, double *grad_f, int *error) const
 }
 
 
+void Function::evalGradientWork(const double *x, double *grad_f, NlWork *w,
+                                int *error) const
+{
+  *error = 0;
+  if (lf_) {
+    lf_->evalGradient(grad_f);
+  }
+  if (qf_) {
+    qf_->evalGradient(x, grad_f);
+  }
+  if (nlf_) {
+    nlf_->evalGradientWork(x, grad_f, w, error);
+  }
+}
+
+
+void Function::evalBatch(const double *x, UInt n, UInt k, double *f,
+                         NlWork *w, int *error) const
+{
+  *error = 0;
+  if (nlf_) {
+    nlf_->evalBatch(x, n, k, f, w, error);
+  } else {
+    std::fill(f, f+k, 0.0);
+  }
+  for (UInt j=0; j<k; ++j) {
+    if (lf_) {
+      f[j] += lf_->eval(x+j*n);
+    }
+    if (qf_) {
+      f[j] += qf_->eval(x+j*n);
+    }
+  }
+}
+
+
+void Function::evalGradientBatch(const double *x, UInt n, UInt k,
+                                 double *grad_f, NlWork *w, int *error) const
+{
+  *error = 0;
+  for (UInt j=0; j<k; ++j) {
+    if (lf_) {
+      lf_->evalGradient(grad_f+j*n);
+    }
+    if (qf_) {
+      qf_->evalGradient(x+j*n, grad_f+j*n);
+    }
+  }
+  if (nlf_) {
+    nlf_->evalGradientBatch(x, n, k, grad_f, w, error);
+  }
+}
+
+
+double Function::evalWork(const double *x, NlWork *w, int *error) const
+{
+  double val = 0.0;
+  *error = 0;
+  if (lf_) {
+    val += lf_->eval(x);
+  }
+  if (qf_) {
+    val += qf_->eval(x);
+  }
+  if (nlf_) {
+    val += nlf_->evalWork(x, w, error);
+  }
+  return val;
+}
+
+
+NlWork* Function::newWork() const
+{
+  if (nlf_) {
+    return nlf_->newWork();
+  }
+  return 0;
+}
+
+
 void Function::prepJac() 
 {
   if (lf_) {
@@ -503,6 +598,52 @@ void Function::fillJac(const double *x, double *values, int *error)
 }
 
 
+void Function::fillJacBatch(const double *x, UInt n, UInt k, double *values,
+                            UInt nz, NlWork *w, int *error) const
+{
+  *error = 0;
+  for (UInt j=0; j<k; ++j) {
+    if (lf_) {
+      lf_->fillJac(values+j*nz, error);
+    }
+    if (qf_) {
+      qf_->fillJac(x+j*n, values+j*nz, error);
+    }
+  }
+  if (nlf_) {
+    nlf_->fillJacBatch(x, n, k, values, nz, w, error);
+  }
+}
+
+
+void Function::fillNlJac(const double *x, double *values, int *error) 
+{
+  *error = 0;
+  if (qf_) {
+    qf_->fillJac(x, values, error);
+  }
+  if (nlf_) {
+    nlf_->fillJac(x, values, error);
+  }
+}
+
+
+void Function::fillJacWork(const double *x, double *values, NlWork *w,
+                           int *error) const
+{
+  *error = 0;
+  if (lf_) {
+    lf_->fillJac(values, error);
+  }
+  if (qf_) {
+    qf_->fillJac(x, values, error);
+  }
+  if (nlf_) {
+    nlf_->fillJacWork(x, values, w, error);
+  }
+}
+
+
 FunctionType Function::getType()
 {
   return type_;
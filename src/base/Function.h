@@ -18,6 +18,7 @@
 namespace Minotaur {
 
   struct LTHessStor;
+  struct NlWork;
 
   /**
    * The class Function is meant to model functions that are used to specify
@@ -80,6 +81,28 @@ namespace Minotaur {
     /// Evaluate the function at a given point x.
     virtual double eval(const double *x, int *error) const;
 
+    /**
+     * Evaluate the function at a given point x using a workspace created by
+     * newWork(). Different threads can evaluate the same function at the
+     * same time if each uses its own workspace. w may be NULL if the
+     * function has no nonlinear part.
+     */
+    virtual double evalWork(const double *x, NlWork *w, int *error) const;
+
+    /**
+     * Evaluate the function at k points stored one after the other: point
+     * j starts at x+j*n. f[j] is set to the value at point j. w is the same
+     * as in evalWork().
+     */
+    virtual void evalBatch(const double *x, UInt n, UInt k, double *f,
+                           NlWork *w, int *error) const;
+
+    /**
+     * Create a workspace for evalWork() and related functions. The caller
+     * must delete it. Returns NULL if the function has no nonlinear part.
+     */
+    virtual NlWork* newWork() const;
+
     virtual void prepJac();
 
     /**
@@ -88,7 +111,34 @@ namespace Minotaur {
     virtual void evalGradient(const double *x, double *grad_f, int *error) 
       const;
 
+    /// Same as evalGradient() but use a workspace. See evalWork().
+    virtual void evalGradientWork(const double *x, double *grad_f,
+                                  NlWork *w, int *error) const;
+
+    /// Same as evalGradient() but at k points. See evalBatch().
+    virtual void evalGradientBatch(const double *x, UInt n, UInt k,
+                                   double *grad_f, NlWork *w, int *error)
+      const;
+
     virtual void fillJac(const double *x, double *values, int *error);
+
+    /// Same as fillJac() but use a workspace. See evalWork().
+    virtual void fillJacWork(const double *x, double *values, NlWork *w,
+                             int *error) const;
+
+    /**
+     * Same as fillJac() but at k points. See evalBatch(). Jacobian values
+     * of point j start at values+j*nz.
+     */
+    virtual void fillJacBatch(const double *x, UInt n, UInt k,
+                              double *values, UInt nz, NlWork *w,
+                              int *error) const;
+
+    /**
+     * Same as fillJac() but only add the values of the quadratic and
+     * nonlinear parts. Used when the values of the linear part are saved.
+     */
+    virtual void fillNlJac(const double *x, double *values, int *error);
     /**
      * Get number of terms in the hessian of the function. We only count
      * terms that are nonzero in the lower-triangular half (including the
@@ -145,6 +195,11 @@ namespace Minotaur {
     virtual void evalHessian(double mult, const double *x, 
                              const LTHessStor *stor, double *values , int *error);
 
+    /// Same as evalHessian() but use a workspace. See evalWork().
+    virtual void evalHessianWork(double mult, const double *x,
+                                 const LTHessStor *stor, double *values,
+                                 NlWork *w, int *error) const;
+
 
     /// Fill in the values of offset, starting from position pos. 
     virtual void fillHessOffset(size_t *offset, size_t &pos, 
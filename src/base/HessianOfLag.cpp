@@ -14,6 +14,9 @@
 
 #include <cmath>
 #include <iostream>
+#if USE_OPENMP
+#include <omp.h>
+#endif
 
 
 #include "MinotaurConfig.h"
@@ -93,29 +96,96 @@ void HessianOfLag::fillRowColIndices(UInt *irow, UInt *jcol)
 }
 
 
+void HessianOfLag::fillNlCons_(const double *x, const double *con_mult,
+                               double *values, int *error)
+{
+  UInt ncons = nlCons_.size();
+  UInt nz = stor_.nz;
+  int nerr = 0;
+
+#if USE_OPENMP
+  // two constraints may add to the same non-zero. Each thread other than
+  // the first adds to its own copy of the values, and the copies are added
+  // to values at the end. The parallel region is skipped if there is too
+  // little work or if we already are in one, e.g. in parallel
+  // branch-and-bound.
+  int nthreads = 1;
+  if (ncons >= 256 && !omp_in_parallel()) {
+    nthreads = omp_get_max_threads();
+  }
+  if (nthreads > 1) {
+    if (thrVals_.size() < (size_t) (nthreads-1)*nz) {
+      thrVals_.resize((size_t) (nthreads-1)*nz);
+    }
+#pragma omp parallel num_threads(nthreads) reduction(+:nerr)
+    {
+      int t = omp_get_thread_num();
+      int nt = omp_get_num_threads();
+      double *vals = (0==t) ? values : &thrVals_[(size_t) (t-1)*nz];
+
+      if (t > 0) {
+        std::fill(vals, vals+nz, 0.0);
+      }
+#pragma omp for schedule(dynamic, 64)
+      for (UInt i=0; i<ncons; ++i) {
+        double mult = con_mult[nlCons_[i]];
+        int err = 0;
+        if (fabs(mult) > etol_) {
+          nlFuns_[i]->evalHessian(mult, x, &stor_, vals, &err);
+          if (err != 0) {
+            ++nerr;
+          }
+        }
+      }
+#pragma omp for schedule(static)
+      for (UInt j=0; j<nz; ++j) {
+        for (int k=1; k<nt; ++k) {
+          values[j] += thrVals_[(size_t) (k-1)*nz+j];
+        }
+      }
+    }
+    *error = (nerr > 0) ? 1 : 0;
+    return;
+  }
+#endif
+
+  for (UInt i=0; i<ncons; ++i) {
+    double mult = con_mult[nlCons_[i]];
+    int err = 0;
+    if (fabs(mult) > etol_) {
+      nlFuns_[i]->evalHessian(mult, x, &stor_, values, &err);
+      if (err != 0) {
+        ++nerr;
+      }
+    }
+  }
+  *error = (nerr > 0) ? 1 : 0;
+}
+
+
 void HessianOfLag::fillRowColValues(const double *x, double obj_mult, 
                                     const double *con_mult, double *values,
                                     int *error)
 {
-  UInt i=0;
   FunctionPtr f;
+  int err = 0;
 
+  *error = 0;
   std::fill(values, values+stor_.nz, 0);
   if (p_->getObjective()) {
     f = p_->getObjective()->getFunction();
     if (f) {
       if (fabs(obj_mult) > etol_) {
-        f->evalHessian(obj_mult, x, &stor_, values, error);
+        f->evalHessian(obj_mult, x, &stor_, values, &err);
       }
     }
   }
 
-  for (ConstraintConstIterator c_iter=p_->consBegin(); c_iter!=p_->consEnd(); 
-       ++c_iter, ++i) {
-    f = (*c_iter)->getFunction();
-    if (fabs(con_mult[i]) > etol_) {
-      f->evalHessian(con_mult[i], x, &stor_, values, error);
-    }
+  if (!nlCons_.empty()) {
+    fillNlCons_(x, con_mult, values, error);
+  }
+  if (err != 0) {
+    *error = err;
   }
 }
 
@@ -126,6 +196,7 @@ void HessianOfLag::setupRowCol()
   std::deque<UInt> *indq;
   UInt *cols;
   UInt i;
+  FunctionPtr f;
 
   // remember, we need lower triangle.
   if (stor_.cols) {
@@ -161,9 +232,17 @@ void HessianOfLag::setupRowCol()
   if (obj_) {
     obj_->fillHessStor(&stor_);
   }
+  nlCons_.clear();
+  nlFuns_.clear();
+  i = 0;
   for (ConstraintConstIterator c_iter=p_->consBegin(); c_iter!=p_->consEnd(); 
-       ++c_iter) {
-    (*c_iter)->getFunction()->fillHessStor(&stor_);
+       ++c_iter, ++i) {
+    f = (*c_iter)->getFunction();
+    f->fillHessStor(&stor_);
+    if (f->getQuadraticFunction() || f->getNonlinearFunction()) {
+      nlCons_.push_back(i);
+      nlFuns_.push_back(f);
+    }
   }
 
 
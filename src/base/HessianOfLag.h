@@ -43,6 +43,13 @@ namespace Minotaur {
    * This class provides methods for building and managing hessian of the
    * lagrangean by calling the methods of the Functions in objective and
    * constraints.
+   *
+   * The constraints that have a quadratic or a nonlinear part are found
+   * once in setupRowCol(); linear constraints are not visited again. When
+   * there are many such constraints and OpenMP is available, they are
+   * evaluated in parallel. Since different constraints may add to the same
+   * non-zero, each thread adds to its own copy of the values, and the
+   * copies are summed at the end.
    */
   class HessianOfLag {
     public:
@@ -104,6 +111,12 @@ namespace Minotaur {
        */
       double etol_;
 
+      /// Indices of constraints that have a quadratic or nonlinear part.
+      UIntVector nlCons_;
+
+      /// Functions of the constraints in nlCons_.
+      std::vector<FunctionPtr> nlFuns_;
+
       FunctionPtr obj_;
 
       /**
@@ -122,6 +135,12 @@ namespace Minotaur {
       Problem *p_;
       LTHessStor stor_;
 
+      /// Values added by threads other than the first. Size (threads-1)*nz.
+      DoubleVector thrVals_;
+
+      /// Add hessians of nlCons_ multiplied by their multipliers to values.
+      void fillNlCons_(const double *x, const double *con_mult,
+                       double *values, int *error);
   };
 
   typedef HessianOfLag* HessianOfLagPtr;
@@ -5,11 +5,15 @@
 //
 
 #include <iostream>
+#if USE_OPENMP
+#include <omp.h>
+#endif
 
 #include "MinotaurConfig.h"
 #include "Constraint.h"
 #include "Function.h"
 #include "Jacobian.h"
+#include "LinearFunction.h"
 #include "Variable.h"
 
 using namespace Minotaur;
@@ -22,15 +26,60 @@ Jacobian::Jacobian()
 }
 
 
-Jacobian::Jacobian(const std::vector<ConstraintPtr> & cons, const UInt)
+Jacobian::Jacobian(const std::vector<ConstraintPtr> & cons, const UInt n)
 {
   ConstraintConstIterator c_iter;
+  FunctionPtr f;
+  UInt r_cnt = 0;
+  int error = 0;
 
   nz_ = 0;
   cons_ = &cons;
-  for (c_iter=cons_->begin(); c_iter!=cons_->end(); ++c_iter) {
-    nz_ += (*c_iter)->getFunction()->getNumVars();
-    (*c_iter)->getFunction()->prepJac();
+  rowStart_.reserve(cons_->size()+1);
+  rowStart_.push_back(0);
+  for (c_iter=cons_->begin(); c_iter!=cons_->end(); ++c_iter, ++r_cnt) {
+    f = (*c_iter)->getFunction();
+    f->prepJac();
+    for (VarSetConstIter it=f->varsBegin(); it!=f->varsEnd(); ++it) {
+      csrCol_.push_back((*it)->getIndex());
+    }
+    nz_ += f->getNumVars();
+    rowStart_.push_back(nz_);
+    if (f->getQuadraticFunction() || f->getNonlinearFunction()) {
+      nlRows_.push_back(r_cnt);
+    }
+  }
+
+  // values of linear parts do not change.
+  base_.resize(nz_, 0.0);
+  r_cnt = 0;
+  for (c_iter=cons_->begin(); c_iter!=cons_->end(); ++c_iter, ++r_cnt) {
+    f = (*c_iter)->getFunction();
+    if (f->getLinearFunction() && rowStart_[r_cnt] < rowStart_[r_cnt+1]) {
+      f->getLinearFunction()->fillJac(&base_[rowStart_[r_cnt]], &error);
+    }
+  }
+
+  // column-wise layout, by counting sort on columns. Rows stay sorted.
+  colStart_.resize(n+1, 0);
+  for (UInt i=0; i<nz_; ++i) {
+    assert(csrCol_[i] < n);
+    ++colStart_[csrCol_[i]+1];
+  }
+  for (UInt j=0; j<n; ++j) {
+    colStart_[j+1] += colStart_[j];
+  }
+  cscPos_.resize(nz_);
+  cscRow_.resize(nz_);
+  if (nz_ > 0) {
+    UIntVector next(colStart_.begin(), colStart_.end()-1);
+    for (UInt r=0; r+1<rowStart_.size(); ++r) {
+      for (UInt i=rowStart_[r]; i<rowStart_[r+1]; ++i) {
+        UInt k = next[csrCol_[i]]++;
+        cscPos_[k] = i;
+        cscRow_[k] = r;
+      }
+    }
   }
 }
 
@@ -41,6 +90,56 @@ Jacobian::~Jacobian()
 }
 
 
+void Jacobian::fillColRowIndices(UInt *iRow, UInt *jCol)
+{
+  for (UInt j=0; j+1<colStart_.size(); ++j) {
+    for (UInt k=colStart_[j]; k<colStart_[j+1]; ++k) {
+      iRow[k] = cscRow_[k];
+      jCol[k] = j;
+    }
+  }
+}
+
+
+void Jacobian::fillColRowValues(const double *x, double *values, int *error)
+{
+  rowVals_.resize(nz_);
+  if (0 == nz_) {
+    *error = 0;
+    return;
+  }
+  fillRowColValues(x, &rowVals_[0], error);
+  for (UInt k=0; k<nz_; ++k) {
+    values[k] = rowVals_[cscPos_[k]];
+  }
+}
+
+
+void Jacobian::fillNlRows_(const double *x, double *values, int *error)
+{
+  UInt nrows = nlRows_.size();
+  int nerr = 0;
+
+  // each function has its own workspace and writes only its own row, so
+  // different rows can be filled by different threads. The parallel region
+  // is skipped if there is too little work or if we already are in one,
+  // e.g. in parallel branch-and-bound.
+#if USE_OPENMP
+#pragma omp parallel for schedule(dynamic, 64) reduction(+:nerr) \
+  if (nrows >= 1024 && !omp_in_parallel())
+#endif
+  for (UInt i=0; i<nrows; ++i) {
+    UInt r = nlRows_[i];
+    int err = 0;
+    (*cons_)[r]->getFunction()->fillNlJac(x, values+rowStart_[r], &err);
+    if (err != 0) {
+      ++nerr;
+    }
+  }
+  *error = (nerr > 0) ? 1 : 0;
+}
+
+
 UInt Jacobian::getNumNz()
 {
   return nz_;
@@ -49,43 +148,22 @@ UInt Jacobian::getNumNz()
 
 void Jacobian::fillRowColIndices(UInt *iRow, UInt *jCol)
 {
-  ConstraintConstIterator c_iter;
-  FunctionPtr f;
-  UInt r_cnt=0;
-  UInt nz_cnt=0;
-
-  for (c_iter=cons_->begin(); c_iter!=cons_->end(); ++c_iter) {
-    f = (*c_iter)->getFunction();
-    for (VarSetConstIter it=f->varsBegin(); it!=f->varsEnd(); ++it, ++nz_cnt) {
-      iRow[nz_cnt] = r_cnt;
-      jCol[nz_cnt] = (*it)->getIndex();
-      //std::cout << "irow["<<nz_cnt<<"] = "<<iRow[nz_cnt]<<" jCol["<<nz_cnt<<"] = "
-      // << jCol[nz_cnt] << std::endl; 
+  for (UInt r=0; r+1<rowStart_.size(); ++r) {
+    for (UInt i=rowStart_[r]; i<rowStart_[r+1]; ++i) {
+      iRow[i] = r;
     }
-    ++r_cnt;
   }
-  assert( (r_cnt==0) || (r_cnt==cons_->size()) );
-  assert(nz_cnt==nz_);
+  std::copy(csrCol_.begin(), csrCol_.end(), jCol);
 }
 
 
 void Jacobian::fillRowColValues(const double *x, double *values, int *error)
 {
-  ConstraintConstIterator c_iter;
-  UInt nz_cnt = 0;
-  FunctionPtr f;
-
   *error = 0;
-  std::fill(values, values+nz_, 0.0);
-  for (c_iter=cons_->begin(); c_iter!=cons_->end(); ++c_iter) {
-    f = (*c_iter)->getFunction();
-    f->fillJac(x, values+nz_cnt, error);
-    nz_cnt += f->getNumVars();
-    if (*error != 0) {
-      return;
-    }
+  std::copy(base_.begin(), base_.end(), values);
+  if (!nlRows_.empty()) {
+    fillNlRows_(x, values, error);
   }
-  assert(nz_cnt==nz_);
 }
 
 
@@ -49,6 +49,12 @@ namespace Minotaur {
    * 0 0 1 1 
    * 1 2   2
    *       3
+   *
+   * Both layouts are computed once in the constructor. The entries that
+   * come from linear parts of the constraints do not depend on the point,
+   * so they are also saved once and copied at each evaluation. Only the
+   * rows that have quadratic or nonlinear parts are evaluated, in parallel
+   * if there are many of them and OpenMP is available.
    */
   class Jacobian {
 
@@ -88,26 +94,55 @@ namespace Minotaur {
       virtual void fillRowColValues(const double *x, double *values, 
           int *error);
 
-      /// Fill indices, column wise.
-      virtual void fillColRowIndices(UInt *, UInt *)
-      { assert(!"implement me!");}
+      /**
+       * Same as fillRowColIndices(), but the nonzeros are arranged in the
+       * order of increasing jCol and then increasing iRow.
+       */
+      virtual void fillColRowIndices(UInt *iRow, UInt *jCol);
          
-      /// Fill values, column wise.
-      virtual void fillColRowValues(const double *, double *, int *)
-      { assert(!"implement me!");}
+      /// Fill values in the order of fillColRowIndices().
+      virtual void fillColRowValues(const double *x, double *values,
+                                    int *error);
          
       void write(std::ostream &out) const;
 
     private:
+      /// Values of the linear parts of all rows, in row order.
+      DoubleVector base_;
+
+      /// Offset of the first nonzero of each column. Size n+1.
+      UIntVector colStart_;
+
       /**
        * The constraints that constitute the system whose jacobian needs to be
        * evaluated.
        */
       const std::vector<ConstraintPtr> * cons_;
 
+      /// Position in row order of each nonzero, in column order.
+      UIntVector cscPos_;
+
+      /// Row of each nonzero, in column order.
+      UIntVector cscRow_;
+
+      /// Column of each nonzero, in row order.
+      UIntVector csrCol_;
+
+      /// Rows that have a quadratic or a nonlinear part.
+      UIntVector nlRows_;
+
       /// Number of nonzeros
       UInt nz_;
 
+      /// Values in row order, used by fillColRowValues().
+      DoubleVector rowVals_;
+
+      /// Offset of the first nonzero of each row. Size is one more than rows.
+      UIntVector rowStart_;
+
+      /// Add values of quadratic and nonlinear parts of nlRows_.
+      void fillNlRows_(const double *x, double *values, int *error);
+
   };
   typedef Jacobian* JacobianPtr;
 }
@@ -5,6 +5,7 @@
 // 
 
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -18,7 +19,8 @@ using namespace Minotaur;
 
 
 LinearFunction::LinearFunction()
-  : hasChanged_(true),
+  : flat_(true),
+    hasChanged_(true),
     tol_(1e-9)
 {
   terms_.clear();
@@ -26,7 +28,8 @@ LinearFunction::LinearFunction()
 
 
 LinearFunction::LinearFunction(const double tol)
-  : hasChanged_(true),
+  : flat_(true),
+    hasChanged_(true),
     tol_(tol)
 {
   terms_.clear();
@@ -35,7 +38,8 @@ LinearFunction::LinearFunction(const double tol)
 
 LinearFunction::LinearFunction(double *a, VariableConstIterator vbeg, 
     VariableConstIterator vend, double tol)
-  : hasChanged_(true),
+  : flat_(true),
+    hasChanged_(true),
     tol_(tol)
 {
   VariablePtr v;
@@ -89,7 +93,9 @@ void LinearFunction::minus(LinearFunctionPtr lf){
 void LinearFunction::addTerm(ConstVariablePtr var, const double a) 
 {
   if (fabs(a) > tol_) {
-    terms_.insert(std::make_pair(var, a));
+    if (terms_.insert(std::make_pair(var, a)).second) {
+      flat_ = false;
+    }
     hasChanged_ = true;
   }
 }
@@ -137,6 +143,7 @@ void LinearFunction::incTerm(ConstVariablePtr var, const double a)
     if (fabs(nv) < tol_) {
       terms_.erase(var);
     } 
+    flat_ = false;
     hasChanged_ = true;
   }
 }
@@ -144,15 +151,26 @@ void LinearFunction::incTerm(ConstVariablePtr var, const double a)
 
 double LinearFunction::eval(const std::vector<double> &x) const
 {
-   return(InnerProduct(x, terms_));
+  if (x.empty()) {
+    return 0.0;
+  }
+  return eval(&x[0]);
 }
 
 
 double LinearFunction::eval(const double *x) const
 {
   double value = 0;
-  for (VariableGroupConstIterator it=terms_.begin(); it!=terms_.end(); ++it) {
-    value += x[it->first->getIndex()] * it->second;
+  if (flat_) {
+    const UInt n = tCoeffs_.size();
+    for (UInt i=0; i<n; ++i) {
+      value += x[tVars_[i]->getIndex()] * tCoeffs_[i];
+    }
+  } else {
+    for (VariableGroupConstIterator it=terms_.begin(); it!=terms_.end();
+         ++it) {
+      value += x[it->first->getIndex()] * it->second;
+    }
   }
   return value;
 }
@@ -160,8 +178,15 @@ double LinearFunction::eval(const double *x) const
 
 void LinearFunction::evalGradient(double *grad_f) const
 {
-  for (VariableGroupConstIterator it=terms_.begin(); it!=terms_.end(); ++it) {
-    grad_f[it->first->getIndex()] += it->second;
+  if (flat_) {
+    for (UInt i=0; i<tCoeffs_.size(); ++i) {
+      grad_f[tVars_[i]->getIndex()] += tCoeffs_[i];
+    }
+  } else {
+    for (VariableGroupConstIterator it=terms_.begin(); it!=terms_.end();
+         ++it) {
+      grad_f[it->first->getIndex()] += it->second;
+    }
   }
 }
 
@@ -180,15 +205,18 @@ void LinearFunction::computeBounds(double *l, double *u)
   double lb = 0.0;
   double ub = 0.0;
   double a;
+  ConstVariablePtr v;
 
-  for (VariableGroupConstIterator it=terms_.begin(); it!=terms_.end(); ++it) {
-    a = it->second;
+  finalize();
+  for (UInt i=0; i<tCoeffs_.size(); ++i) {
+    a = tCoeffs_[i];
+    v = tVars_[i];
     if (a>0) {
-      lb += a*it->first->getLb();
-      ub += a*it->first->getUb();
+      lb += a*v->getLb();
+      ub += a*v->getUb();
     } else {
-      lb += a*it->first->getUb();
-      ub += a*it->first->getLb();
+      lb += a*v->getUb();
+      ub += a*v->getLb();
     }
   }
   *l = lb;
@@ -196,6 +224,38 @@ void LinearFunction::computeBounds(double *l, double *u)
 }
 
 
+void LinearFunction::finalize()
+{
+  UInt i = 0;
+
+  if (flat_) {
+    return;
+  }
+  tCoeffs_.resize(terms_.size());
+  tVars_.resize(terms_.size());
+  for (VariableGroupConstIterator it=terms_.begin(); it!=terms_.end();
+       ++it, ++i) {
+    tVars_[i] = it->first;
+    tCoeffs_[i] = it->second;
+  }
+  flat_ = true;
+}
+
+
+const DoubleVector & LinearFunction::getTermCoeffs()
+{
+  finalize();
+  return tCoeffs_;
+}
+
+
+const std::vector<ConstVariablePtr> & LinearFunction::getTermVars()
+{
+  finalize();
+  return tVars_;
+}
+
+
 void LinearFunction::getVars(VariableSet *vars)
 {
   for (VariableGroupConstIterator it=terms_.begin(); it!=terms_.end(); ++it) {
@@ -224,11 +284,18 @@ void LinearFunction::multiply(double d)
 { 
   if (fabs(d) < 1e-7) {
     terms_.clear();
+    tCoeffs_.clear();
+    tVars_.clear();
+    flat_ = true;
     hasChanged_ = true;
   } else {
     for (VariableGroupIterator it = terms_.begin(); it != terms_.end(); ++it) {
       it->second *= d;
     }
+    for (DoubleVector::iterator it=tCoeffs_.begin(); it!=tCoeffs_.end();
+         ++it) {
+      *it *= d;
+    }
   }
   hasChanged_ = true;
 }
@@ -271,13 +338,18 @@ QuadraticFunctionPtr LinearFunction::square()
 
 void LinearFunction::removeVar(VariablePtr v, double )
 {
-  terms_.erase(v);
+  if (terms_.erase(v) > 0) {
+    flat_ = false;
+  }
   hasChanged_ = true;
 }
 
 void LinearFunction::clearAll()
 {
   terms_.clear();
+  tCoeffs_.clear();
+  tVars_.clear();
+  flat_ = true;
   off_.clear();
   hasChanged_ = true;
 }
@@ -305,10 +377,10 @@ void LinearFunction::prepJac(VarSetConstIter vbeg, VarSetConstIter vend)
     }
     hasChanged_ = false;
   }
+  finalize();
 }
 
 
-
 LinearFunctionPtr LinearFunction::copyMinus(ConstLinearFunctionPtr l2)
 {
   LinearFunctionPtr lf = LinearFunctionPtr();  //NULL
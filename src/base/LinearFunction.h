@@ -107,11 +107,32 @@ namespace Minotaur {
 
     void fillJac(double *values, int *error);
 
+    /**
+     * \brief Build the flat arrays of terms that are used in evaluation.
+     *
+     * Terms are added and changed in a map. Evaluation walks the map until
+     * this function copies it, sorted, into contiguous arrays. A change in
+     * the terms drops the arrays again. Does nothing if they are up to date.
+     */
+    void finalize();
+
     double getFixVarOffset(VariablePtr v, double val);
 
     /// Get the number of terms in this function.
     UInt getNumTerms() const { return(terms_.size()); }
 
+    /**
+     * Get the coefficients of the terms, in the order of getTermVars().
+     * Calls finalize() first.
+     */
+    const DoubleVector & getTermCoeffs();
+
+    /**
+     * Get the variables of the terms, in the same order as termsBegin().
+     * Calls finalize() first.
+     */
+    const std::vector<ConstVariablePtr> & getTermVars();
+
     void getVars(VariableSet *vars);
 
     /**
@@ -189,6 +210,9 @@ namespace Minotaur {
     QuadraticFunctionPtr copyMult(ConstLinearFunctionPtr l1);
 
   private:
+    /// True if tCoeffs_ and tVars_ have the same terms as terms_.
+    bool flat_;
+
     /**
      * True if terms in linear function are modified since previous call to
      * prepJac.
@@ -204,6 +228,17 @@ namespace Minotaur {
      */
     VariableGroup terms_;
 
+    /**
+     * Coefficients of terms_, in the same order as tVars_. The two arrays
+     * are a flat copy of terms_ built by finalize(). Valid only if flat_.
+     * Variable indices are read through tVars_ because deleting variables
+     * renumbers them.
+     */
+    DoubleVector tCoeffs_;
+
+    /// Variables of terms_, sorted in the same order as in terms_.
+    std::vector<ConstVariablePtr> tVars_;
+
     /// Tolerance below which a coefficient is considered 0.
     double tol_;
 
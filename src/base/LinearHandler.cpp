@@ -12,6 +12,7 @@
  * \author Ashutosh Mahajan, Argonne National Laboratory
  */
 
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
@@ -56,6 +57,8 @@ LinearHandler::LinearHandler()
     intTol_(1e-6),
     eTol_(1e-8),
     infty_(1e20),
+    actBig_(1e8),
+    actProb_(0),
     pStats_(0),
     pOpts_(0)
 {
@@ -69,6 +72,8 @@ LinearHandler::LinearHandler(EnvPtr env, ProblemPtr problem)
     intTol_(1e-6),
     eTol_(1e-8),
     infty_(1e20),
+    actBig_(1e8),
+    actProb_(0),
     pStats_(0),
     pOpts_(0)
 {
@@ -300,6 +305,7 @@ SolveStatus LinearHandler::presolve(PreModQ *pre_mods, bool *changed0)
     if (true == chkDupRows_ && true == pOpts_->purgeCons) {
       dupRows_(&changed);
       problem_->delMarkedCons();
+      if (true == pOpts_->dualFix) dupCols_(&changed);
       chkDupRows_ = false;
     }
     if (true == pOpts_->coeffImp) coeffImp_(&changed);
@@ -489,44 +495,58 @@ SolveStatus LinearHandler::varBndsFromCons_(ProblemPtr p, bool apply_to_prob,
   ConstraintPtr c_ptr;
   bool t_changed;
   SolveStatus status = Started;
+  UInt nprop = 0;
+  UInt max_prop;
 
 #if SPEW
   logger_->msgStream(LogDebug2) << me_ << "bounds from constraints." 
                                << std::endl; 
 #endif
 
-  for (ConstraintConstIterator c_iter=p->consBegin(); c_iter!=p->consEnd();
-       ++c_iter) {
-    c_ptr = *c_iter;
-    if (c_ptr->getBFlag() &&  c_ptr->getFunctionType() == Linear &&
-        c_ptr->getQuadraticFunction() == 0 && c_ptr->getNonlinearFunction() == 0
-        && DeletedCons!=c_ptr->getState()) {
-      t_changed = true;
-      c_ptr->setBFlag(false);
-      while (true == t_changed) {
-        status = linBndTighten_(p, apply_to_prob, c_ptr, &t_changed, mods,
-                                nintmods);
-        if (SolvedInfeasible == status) {
-          return SolvedInfeasible;
-        }
-        if (true == t_changed) {
-          *changed = true;
-          if (false==apply_to_prob) {
-            t_changed = false;
-          }
+  // in presolve, coefficients and bounds of constraints are changed in
+  // place. So build the activities again.
+  syncAct_(p, apply_to_prob);
+  max_prop = 4*act_.size() + 100;
+
+  while (!actQ_.empty() && nprop < max_prop) {
+    c_ptr = actQ_.front();
+    actQ_.pop_front();
+    act_[c_ptr->getIndex()].inQ = false;
+    c_ptr->setBFlag(false);
+    ++nprop;
+    if (DeletedCons==c_ptr->getState()) {
+      continue;
+    }
+    t_changed = true;
+    while (true == t_changed) {
+      status = linBndTighten_(p, apply_to_prob, c_ptr, &t_changed, mods,
+                              nintmods);
+      if (SolvedInfeasible == status) {
+        return SolvedInfeasible;
+      }
+      if (true == t_changed) {
+        *changed = true;
+        if (false==apply_to_prob) {
+          t_changed = false;
         }
       }
-    } else if (c_ptr->getFunctionType() == Constant
-               && DeletedCons!=c_ptr->getState()
-               && apply_to_prob 
-               && pOpts_->purgeCons) {
+    }
+  }
+
+  if (apply_to_prob && pOpts_->purgeCons) {
+    for (ConstraintConstIterator c_iter=p->consBegin(); c_iter!=p->consEnd();
+         ++c_iter) {
+      c_ptr = *c_iter;
+      if (c_ptr->getFunctionType() == Constant
+          && DeletedCons!=c_ptr->getState()) {
 #if SPEW
-      logger_->msgStream(LogDebug) << me_ << "constraint " << c_ptr->getName() 
-                                   << " is redundant\n";
+        logger_->msgStream(LogDebug) << me_ << "constraint "
+                                     << c_ptr->getName() << " is redundant\n";
 #endif
-      //assert(!"check activity!");
-      p->markDelete(c_ptr);
-      ++(pStats_->conDel);
+        //assert(!"check activity!");
+        p->markDelete(c_ptr);
+        ++(pStats_->conDel);
+      }
     }
   }
   return status;
@@ -871,76 +891,202 @@ void LinearHandler::dualFix_(bool *changed)
 }
 
 
+void LinearHandler::dupCols_(bool *changed)
+{
+  const UInt m = problem_->getNumCons();
+  LinearFunctionPtr olf = problem_->getObjective()->getLinearFunction();
+  std::vector<LinParHash> hv;
+  UIntVector grps;
+  DoubleVector r;
+  LinParHash ph;
+  VariablePtr vj, vk;
+  ConstraintPtr c;
+  double w, s, cj, ck;
+  bool is_par;
+
+  findLinVars_();
+  r.reserve(m);
+  for (UInt i=0; i<m; ++i) {
+    r.push_back((double) rand()/(RAND_MAX)*10.0);
+  }
+
+  hv.reserve(linVars_.size());
+  for (VarQueueConstIter vit=linVars_.begin(); vit!=linVars_.end(); ++vit) {
+    vj = *vit;
+    if (vj->getUb() - vj->getLb() < eTol_ || problem_->isMarkedDel(vj)) {
+      continue;
+    }
+    ph.len = 0;
+    ph.first = m;
+    ph.a = ph.h = 0.0;
+    ph.item = vj->getIndex();
+    for (ConstrSet::iterator cit=vj->consBegin(); cit!=vj->consEnd();
+         ++cit) {
+      c = *cit;
+      if (DeletedCons==c->getState() || problem_->isMarkedDel(c)) {
+        continue;
+      }
+      w = c->getLinearFunction()->getWeight(vj);
+      ++ph.len;
+      ph.h += r[c->getIndex()]*w;
+      if (c->getIndex() < ph.first) {
+        ph.first = c->getIndex();
+        ph.a = w;
+      }
+    }
+    if (ph.len>0 && fabs(ph.a)>eTol_) {
+      ph.h /= ph.a;
+      hv.push_back(ph);
+    }
+  }
+
+  groupParallel_(hv, grps);
+  for (UInt g=0; g<grps.size(); g+=2) {
+    for (UInt i=grps[g]; i<grps[g+1]; ++i) {
+      for (UInt j=grps[g]; j<grps[g+1]; ++j) {
+        vj = problem_->getVariable(hv[i].item);
+        vk = problem_->getVariable(hv[j].item);
+        if (i==j || vj->getUb() - vj->getLb() < eTol_ ||
+            vk->getUb() - vk->getLb() < eTol_ ||
+            vk->getType()!=Continuous || vj->getLb() <= -INFINITY) {
+          continue;
+        }
+        s = hv[i].a/hv[j].a;
+        if ((s>0 && vk->getUb() < INFINITY) ||
+            (s<0 && vk->getLb() > -INFINITY)) {
+          continue;
+        }
+        cj = (olf) ? olf->getWeight(vj) : 0.0;
+        ck = (olf) ? olf->getWeight(vk) : 0.0;
+        if (cj < s*ck) {
+          continue;
+        }
+        is_par = true;
+        for (ConstrSet::iterator cit=vj->consBegin(); cit!=vj->consEnd();
+             ++cit) {
+          c = *cit;
+          if (DeletedCons==c->getState() || problem_->isMarkedDel(c)) {
+            continue;
+          }
+          w = c->getLinearFunction()->getWeight(vj);
+          if (fabs(w - s*c->getLinearFunction()->getWeight(vk)) >
+              1e-12*(1.0+fabs(w))) {
+            is_par = false;
+            break;
+          }
+        }
+        if (true==is_par) {
+          VarBoundModPtr mod = new VarBoundMod(vj, Upper, vj->getLb());
+#if SPEW
+          logger_->msgStream(LogDebug) << me_ << "variable " << vj->getName() 
+                                       << " is dominated by " << vk->getName()
+                                       << std::endl;
+#endif
+          changeBFlag_(vj);
+          mod->applyToProblem(problem_);
+          delete mod;
+          ++(pStats_->vBnd);
+          *changed = true;
+        }
+      }
+    }
+  }
+}
+
+
 void LinearHandler::dupRows_(bool *changed)
 {
   const UInt n = problem_->getNumVars();
   const UInt m = problem_->getNumCons();
-  UInt i,j;
-  int err = 0;
-  DoubleVector r1, r2;
-  DoubleVector h1;
-  DoubleVector h2;
+  std::vector<LinParHash> hv;
+  UIntVector grps;
+  DoubleVector r;
+  LinParHash ph;
   ConstraintPtr c1, c2;
-  bool is_deleted;
+  LinearFunctionPtr lf;
+  UInt i1, i2;
 
 #if SPEW
   logger_->msgStream(LogDebug) << me_ << "searching for duplicate "
     << "constraints" << std::endl; 
 #endif
 
-  r1.reserve(n);
-  r2.reserve(n);
-  h1.reserve(m);
-  h2.reserve(m);
-
-  for (i=0; i<n; ++i) {
-    r1.push_back((double) rand()/(RAND_MAX)*10.0);
-    r2.push_back((double) rand()/(RAND_MAX)*10.0);
+  r.reserve(n);
+  for (UInt i=0; i<n; ++i) {
+    r.push_back((double) rand()/(RAND_MAX)*10.0);
   }
 
-  i=0;
+  // terms of a linear function are sorted by variables, so the first term
+  // is the same in parallel rows.
+  hv.reserve(m);
   for (ConstraintConstIterator it=problem_->consBegin();
-       it!=problem_->consEnd(); ++it, ++i) {
+       it!=problem_->consEnd(); ++it) {
     c1 = *it;
-    if (c1->getFunctionType()==Linear) {
-      h1[i] = c1->getActivity(&(r1[0]), &err);
-      h2[i] = c1->getActivity(&(r2[0]), &err);
-    } else {
-      h1[i] = h2[i] = 1e30;
+    if (c1->getFunctionType()!=Linear || problem_->isMarkedDel(c1)) {
+      continue;
+    }
+    lf = c1->getLinearFunction();
+    if (!lf || 0==lf->getNumTerms()) {
+      continue;
     }
+    ph.len = lf->getNumTerms();
+    ph.first = lf->termsBegin()->first->getIndex();
+    ph.a = lf->termsBegin()->second;
+    ph.h = 0.0;
+    ph.item = c1->getIndex();
+    for (VariableGroupConstIterator vit=lf->termsBegin();
+         vit!=lf->termsEnd(); ++vit) {
+      ph.h += r[vit->first->getIndex()]*vit->second;
+    }
+    ph.h /= ph.a;
+    hv.push_back(ph);
   }
 
-  for (i=0; i<m; ++i) {
-    if (h1[i]<1e29) {
-      for (j=i+1; j<m; ++j) {
-        if (fabs(h1[j]-h1[i])<1e-10 ||
-            fabs(h1[j]+h1[i])<1e-10) {
-          c1 = problem_->getConstraint(i);
-          c2 = problem_->getConstraint(j);
-          is_deleted = treatDupRows_(c1, c2, 1.0, changed);
-          //c1->write(std::cout);
-          //c2->write(std::cout);
-          //std::cout << h1[i] << " xxx " << h1[j] << "\n";
-          if (is_deleted) {
-            h1[j] = h2[j] = 1e30;
-          }
-        } else if (h1[j] < 1e29 && fabs(h1[i]/h1[j]-h2[i]/h2[j])<1e-10) {
-          c1 = problem_->getConstraint(i);
-          c2 = problem_->getConstraint(j);
-          is_deleted = treatDupRows_(c1, c2, h1[i]/h1[j], changed);
-          //c1->write(std::cout);
-          //c2->write(std::cout);
-          //std::cout << h1[i] << " *** " << h1[j] << "\n";
-          if (is_deleted) {
-            h1[j] = h2[j] = 1e30;
-          }
+  groupParallel_(hv, grps);
+  for (UInt g=0; g<grps.size(); g+=2) {
+    for (UInt i=grps[g]; i<grps[g+1]; ++i) {
+      for (UInt j=i+1; j<grps[g+1]; ++j) {
+        // keep the constraint that comes first.
+        if (hv[i].item < hv[j].item) {
+          i1 = i;
+          i2 = j;
+        } else {
+          i1 = j;
+          i2 = i;
+        }
+        c1 = problem_->getConstraint(hv[i1].item);
+        c2 = problem_->getConstraint(hv[i2].item);
+        if (problem_->isMarkedDel(c1) || problem_->isMarkedDel(c2)) {
+          continue;
         }
+        treatDupRows_(c1, c2, hv[i1].a/hv[i2].a, changed);
       }
     }
   }
 }
 
 
+void LinearHandler::groupParallel_(std::vector<LinParHash> &hv,
+                                   UIntVector &grps)
+{
+  UInt start = 0;
+
+  grps.clear();
+  std::sort(hv.begin(), hv.end());
+  for (UInt i=1; i<=hv.size(); ++i) {
+    if (i==hv.size() || hv[i].len!=hv[start].len ||
+        hv[i].first!=hv[start].first ||
+        hv[i].h - hv[start].h > 1e-9*(1.0+fabs(hv[start].h))) {
+      if (i-start > 1) {
+        grps.push_back(start);
+        grps.push_back(i);
+      }
+      start = i;
+    }
+  }
+}
+
+
 SolveStatus LinearHandler::linBndTighten_(ProblemPtr p, bool apply_to_prob, 
                                           ConstraintPtr c_ptr, bool *changed,
                                           ModQ *mods, UInt *nintmods)
@@ -948,8 +1094,7 @@ SolveStatus LinearHandler::linBndTighten_(ProblemPtr p, bool apply_to_prob,
   LinearFunctionPtr lf = c_ptr->getLinearFunction();
   double lb = c_ptr->getLb();
   double ub = c_ptr->getUb();
-  double ll, uu;
-  double sing_ll = -INFINITY, sing_uu = INFINITY;
+  double ll, uu, sing_ll, sing_uu;
 
   *changed = false;
 
@@ -958,10 +1103,7 @@ SolveStatus LinearHandler::linBndTighten_(ProblemPtr p, bool apply_to_prob,
   }
 
   assert(lf);
-  getLfBnds_(lf, &ll, &uu);
-  if (ll < -infty_ || uu > infty_) {
-    getSingLfBnds_(lf, &sing_ll, &sing_uu);
-  }
+  getActBnds_(c_ptr, &ll, &uu, &sing_ll, &sing_uu);
 
   if (apply_to_prob && ll >= lb - eTol_ && uu <= ub + eTol_) {
 #if SPEW
@@ -1017,10 +1159,7 @@ SolveStatus LinearHandler::linBndTighten_(ProblemPtr p, bool apply_to_prob,
   }
 
   if (true == *changed) {
-    getLfBnds_(lf, &ll, &uu);
-    if (ll < -infty_ || uu > infty_) {
-      getSingLfBnds_(lf, &sing_ll, &sing_uu);
-    }
+    getActBnds_(c_ptr, &ll, &uu, &sing_ll, &sing_uu);
   }
 
   // c_ptr->write(std::cout);
@@ -1043,15 +1182,16 @@ void LinearHandler::updateLfBoundsFromLb_(ProblemPtr p, bool apply_to_prob,
                                           bool *changed, 
                                           ModQ* mods, UInt *nintmods)
 {
+  const std::vector<ConstVariablePtr> &vars = lf->getTermVars();
+  const DoubleVector &coefs = lf->getTermCoeffs();
   ConstVariablePtr cvar;
   VariablePtr var;
   double coef, vlb, vub, nlb, nub;
   VarBoundModPtr mod;
 
-  for (VariableGroupConstIterator it=lf->termsBegin(); it != lf->termsEnd(); 
-      ++it) {
-    cvar = it->first;
-    coef = it->second;
+  for (UInt i=0; i<vars.size(); ++i) {
+    cvar = vars[i];
+    coef = coefs[i];
     vlb  = cvar->getLb();
     vub  = cvar->getUb();
     if (coef > eTol_ && (is_sing==false || vub >= infty_)) {
@@ -1065,9 +1205,8 @@ void LinearHandler::updateLfBoundsFromLb_(ProblemPtr p, bool apply_to_prob,
         if (nlb > var->getUb()-eTol_) {
           nlb = var->getUb();
         }
-        changeBFlag_(var);
         mod = (VarBoundModPtr) new VarBoundMod(var, Lower, nlb);
-        mod->applyToProblem(p);
+        applyBndMod_(p, mod);
 #if SPEW
         logger_->msgStream(LogDebug2) << me_ << "mod 1: ";
         mod->write(logger_->msgStream(LogDebug2));
@@ -1100,9 +1239,8 @@ void LinearHandler::updateLfBoundsFromLb_(ProblemPtr p, bool apply_to_prob,
           nub = var->getLb();
         }
 
-        changeBFlag_(var);
         mod = (VarBoundModPtr) new VarBoundMod(var, Upper, nub);
-        mod->applyToProblem(p);
+        applyBndMod_(p, mod);
 #if SPEW
         logger_->msgStream(LogDebug2) << me_ << "mod 2: ";
         mod->write(logger_->msgStream(LogDebug2));
@@ -1134,15 +1272,16 @@ void LinearHandler::updateLfBoundsFromUb_(ProblemPtr p, bool apply_to_prob,
                                           bool *changed, ModQ *mods,
                                           UInt *nintmods)
 {
+  const std::vector<ConstVariablePtr> &vars = lf->getTermVars();
+  const DoubleVector &coefs = lf->getTermCoeffs();
   ConstVariablePtr cvar;
   VariablePtr var;
   double coef, vlb, vub, nlb, nub;
   VarBoundModPtr mod;
 
-  for (VariableGroupConstIterator it=lf->termsBegin(); it!=lf->termsEnd(); 
-      ++it) {
-    cvar = it->first;
-    coef = it->second;
+  for (UInt i=0; i<vars.size(); ++i) {
+    cvar = vars[i];
+    coef = coefs[i];
     vlb  = cvar->getLb();
     vub  = cvar->getUb();
     if (coef > eTol_ && (is_sing == false || vlb <= -infty_)) {
@@ -1156,9 +1295,8 @@ void LinearHandler::updateLfBoundsFromUb_(ProblemPtr p, bool apply_to_prob,
         if (nub < var->getLb()+eTol_) {
           nub = var->getLb();
         }
-        changeBFlag_(var);
         mod = (VarBoundModPtr) new VarBoundMod(var, Upper, nub);
-        mod->applyToProblem(p);
+        applyBndMod_(p, mod);
 #if SPEW
         logger_->msgStream(LogDebug2) << me_ << "mod 3: ";
         mod->write(logger_->msgStream(LogDebug2));
@@ -1190,9 +1328,8 @@ void LinearHandler::updateLfBoundsFromUb_(ProblemPtr p, bool apply_to_prob,
         if (nlb > var->getUb()-eTol_) {
           nlb = var->getUb();
         }
-        changeBFlag_(var);
         mod = (VarBoundModPtr) new VarBoundMod(var, Lower, nlb);
-        mod->applyToProblem(p);
+        applyBndMod_(p, mod);
 #if SPEW
         logger_->msgStream(LogDebug2) << me_ << "mod 4: ";
         mod->write(logger_->msgStream(LogDebug2));
@@ -1226,17 +1363,204 @@ void LinearHandler::changeBFlag_(VariablePtr v)
 }
 
 
+void LinearHandler::addActTerm_(LinActivity &a, double coef, double vlb,
+                                double vub, int sign)
+{
+  double tlo = 0.0, tup = 0.0;
+
+  if (coef>0) {
+    if (vlb <= -infty_) {
+      a.infLo += sign;
+    } else {
+      tlo = coef*vlb;
+    }
+    if (vub >= infty_) {
+      a.infUp += sign;
+    } else {
+      tup = coef*vub;
+    }
+  } else if (coef<0) {
+    if (vub >= infty_) {
+      a.infLo += sign;
+    } else {
+      tlo = coef*vub;
+    }
+    if (vlb <= -infty_) {
+      a.infUp += sign;
+    } else {
+      tup = coef*vlb;
+    }
+  }
+  a.lo += sign*tlo;
+  a.up += sign*tup;
+  if (fabs(tlo) > actBig_ || fabs(tup) > actBig_) {
+    a.big = true;
+  }
+}
+
+
+void LinearHandler::applyBndMod_(ProblemPtr p, VarBoundModPtr mod)
+{
+  VariablePtr v = mod->getVar();
+  double olb = v->getLb();
+  double oub = v->getUb();
+
+  mod->applyToProblem(p);
+  if (p==actProb_) {
+    varBndChanged_(v, olb, oub);
+  } else {
+    changeBFlag_(v);
+  }
+}
+
+
+void LinearHandler::computeAct_(LinActivity &a)
+{
+  const std::vector<ConstVariablePtr> &vars = a.lf->getTermVars();
+  const DoubleVector &coefs = a.lf->getTermCoeffs();
+
+  a.lo = a.up = 0.0;
+  a.infLo = a.infUp = 0;
+  a.nUpd = 0;
+  for (UInt i=0; i<vars.size(); ++i) {
+    addActTerm_(a, coefs[i], vars[i]->getLb(), vars[i]->getUb(), 1);
+  }
+  a.big = false;
+}
+
+
+void LinearHandler::getActBnds_(ConstraintPtr c, double *ll, double *uu,
+                                double *sing_ll, double *sing_uu)
+{
+  LinActivity &a = act_[c->getIndex()];
+
+  assert(a.c==c && a.lf);
+  // sums updated many times, or updated with large terms, may have lost
+  // accuracy.
+  if (a.big || a.nUpd > a.nTerms + 64) {
+    computeAct_(a);
+  }
+  *ll = (a.infLo > 0) ? -INFINITY : a.lo;
+  *uu = (a.infUp > 0) ? INFINITY : a.up;
+  *sing_ll = (a.infLo > 1) ? -INFINITY : a.lo;
+  *sing_uu = (a.infUp > 1) ? INFINITY : a.up;
+}
+
+
+void LinearHandler::syncAct_(ProblemPtr p, bool rebuild)
+{
+  UInt m = p->getNumCons();
+  UInt n = p->getNumVars();
+  ConstraintPtr c;
+  LinearFunctionPtr lf;
+  VariablePtr v;
+  UInt i;
+
+  if (true==rebuild || p!=actProb_ || n!=actVlb_.size()) {
+    act_.clear();
+    actVlb_.resize(n);
+    actVub_.resize(n);
+    for (VariableConstIterator it=p->varsBegin(); it!=p->varsEnd(); ++it) {
+      v = *it;
+      actVlb_[v->getIndex()] = v->getLb();
+      actVub_[v->getIndex()] = v->getUb();
+    }
+    actProb_ = p;
+  } else {
+    // bounds changed by branching, backtracking, other handlers etc.
+    for (VariableConstIterator it=p->varsBegin(); it!=p->varsEnd(); ++it) {
+      v = *it;
+      i = v->getIndex();
+      if (v->getLb()!=actVlb_[i] || v->getUb()!=actVub_[i]) {
+        varBndChanged_(v, actVlb_[i], actVub_[i]);
+      }
+    }
+  }
+
+  // new constraints, e.g. cuts, are appended at the end. Deleting
+  // constraints changes indices of the others. The queue is built again
+  // from the flags.
+  actQ_.clear();
+  act_.resize(m);
+  i = 0;
+  for (ConstraintConstIterator it=p->consBegin(); it!=p->consEnd();
+       ++it, ++i) {
+    LinActivity &a = act_[i];
+    c = *it;
+    lf = 0;
+    if (c->getFunctionType() == Linear && c->getQuadraticFunction() == 0 &&
+        c->getNonlinearFunction() == 0 && DeletedCons!=c->getState()) {
+      lf = c->getLinearFunction();
+    }
+    a.inQ = false;
+    if (a.c!=c || a.id!=c->getId() || a.lf!=lf ||
+        (lf && a.nTerms!=lf->getNumTerms())) {
+      a.c = c;
+      a.id = c->getId();
+      a.lf = lf;
+      a.cLb = c->getLb();
+      a.cUb = c->getUb();
+      if (lf) {
+        a.nTerms = lf->getNumTerms();
+        computeAct_(a);
+        c->setBFlag(true);
+      }
+    } else if (a.cLb!=c->getLb() || a.cUb!=c->getUb()) {
+      a.cLb = c->getLb();
+      a.cUb = c->getUb();
+      c->setBFlag(true);
+    }
+    if (lf && c->getBFlag()) {
+      a.inQ = true;
+      actQ_.push_back(c);
+    }
+  }
+}
+
+
+void LinearHandler::varBndChanged_(VariablePtr v, double olb, double oub)
+{
+  ConstraintPtr c;
+  double coef;
+  UInt i = v->getIndex();
+
+  for (ConstrSet::iterator cit=v->consBegin(); cit!=v->consEnd(); ++cit) {
+    c = *cit;
+    c->setBFlag(true);
+    if (c->getIndex() >= act_.size()) {
+      continue;
+    }
+    LinActivity &a = act_[c->getIndex()];
+    if (a.c==c && a.id==c->getId() && a.lf) {
+      coef = a.lf->getWeight(v);
+      addActTerm_(a, coef, olb, oub, -1);
+      addActTerm_(a, coef, v->getLb(), v->getUb(), 1);
+      ++(a.nUpd);
+      if (false==a.inQ) {
+        a.inQ = true;
+        actQ_.push_back(c);
+      }
+    }
+  }
+  if (i < actVlb_.size()) {
+    actVlb_[i] = v->getLb();
+    actVub_[i] = v->getUb();
+  }
+}
+
+
 void LinearHandler::getLfBnds_(LinearFunctionPtr lf, double *lo, double *up)
 {
+  const std::vector<ConstVariablePtr> &vars = lf->getTermVars();
+  const DoubleVector &coefs = lf->getTermCoeffs();
   double lb = 0;
   double ub = 0;
   double coef, vlb, vub;
 
-  for (VariableGroupConstIterator it = lf->termsBegin(); it != lf->termsEnd(); 
-      ++it) {
-    coef = it->second;
-    vlb = it->first->getLb();
-    vub = it->first->getUb();
+  for (UInt i=0; i<vars.size(); ++i) {
+    coef = coefs[i];
+    vlb = vars[i]->getLb();
+    vub = vars[i]->getUb();
     if (coef>0) {
       lb += coef*vlb;
       ub += coef*vub;
@@ -1253,17 +1577,18 @@ void LinearHandler::getLfBnds_(LinearFunctionPtr lf, double *lo, double *up)
 void LinearHandler::getSingLfBnds_(LinearFunctionPtr lf, double *lo, 
                                    double *up)
 {
+  const std::vector<ConstVariablePtr> &vars = lf->getTermVars();
+  const DoubleVector &coefs = lf->getTermCoeffs();
   double lb = 0;
   double ub = 0;
   double coef, vlb, vub;
   bool lo_is_sing = false, up_is_sing = false;
   bool lo_is_finite = true, up_is_finite = true;
 
-  for (VariableGroupConstIterator it = lf->termsBegin(); it != lf->termsEnd(); 
-      ++it) {
-    coef = it->second;
-    vlb = it->first->getLb();
-    vub = it->first->getUb();
+  for (UInt i=0; i<vars.size(); ++i) {
+    coef = coefs[i];
+    vlb = vars[i]->getLb();
+    vub = vars[i]->getUb();
     if (coef>eTol_) {
       if (vub < infty_ && true == up_is_finite) {
         ub += coef*vub;
@@ -1604,15 +1929,11 @@ void LinearHandler::simplePresolve(ProblemPtr p, SolutionPoolPtr spool,
   UInt iters = 1;
   UInt nintmods;
   Timer *timer = 0;
-  ConstraintPtr c_ptr;
   timer = env_->getNewTimer();
   timer->start();
 
-  for (ConstraintConstIterator c_iter = p->consBegin(); c_iter != p->consEnd();
-       ++c_iter) {
-    c_ptr = *c_iter;
-    c_ptr->setBFlag(true);
-  }
+  // only the constraints whose variables have new bounds since the last
+  // call are propagated. See syncAct_().
 
   while (true == changed && iters <= max_iters &&
          (iters <= min_iters || nintmods > 0) &&
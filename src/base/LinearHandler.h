@@ -17,6 +17,8 @@
 #include "Handler.h"
 
 namespace Minotaur {
+class VarBoundMod;
+typedef VarBoundMod* VarBoundModPtr;
 
 /// Store statistics of presolving.
 struct LinPresolveStats 
@@ -53,6 +55,43 @@ struct LinPresolveOpts {
 }; 
 
 
+/// Bounds on the activity of a linear constraint, updated incrementally.
+struct LinActivity {
+  ConstraintPtr c;      ///> The constraint. NULL if the entry is unused.
+  UInt id;              ///> Id of c, to detect reuse of its memory.
+  LinearFunctionPtr lf; ///> Its linear function. NULL if not tracked.
+  UInt nTerms;          ///> Number of terms in lf when the entry was built.
+  double lo;            ///> Sum of finite lower contributions of terms.
+  double up;            ///> Sum of finite upper contributions of terms.
+  int infLo;            ///> Number of terms with infinite lower contribution.
+  int infUp;            ///> Number of terms with infinite upper contribution.
+  UInt nUpd;            ///> Number of updates since lo, up were computed.
+  bool big;             ///> True if a term larger than actBig_ changed since.
+  double cLb;           ///> Lower bound of c when last seen.
+  double cUb;           ///> Upper bound of c when last seen.
+  bool inQ;             ///> True if c is in the propagation queue.
+};
+
+
+/// Hash of a sparse row or column that does not change when it is scaled.
+struct LinParHash {
+  UInt len;   ///> Number of nonzeros.
+  UInt first; ///> Smallest index of a nonzero.
+  double a;   ///> The nonzero at index first.
+  double h;   ///> Random combination of the nonzeros, divided by a.
+  UInt item;  ///> Index of the row or column.
+
+  bool operator<(const LinParHash &o) const {
+    if (len!=o.len) {
+      return len<o.len;
+    } else if (first!=o.first) {
+      return first<o.first;
+    }
+    return h<o.h;
+  }
+};
+
+
 /**
  * An LinearHandler handles variables of a problem. It only checks bounds 
  * and integrality of the variables.
@@ -176,6 +215,31 @@ protected:
   /// Infinity. Bounds beyond this number are treated as infinity.
   const double infty_;
 
+  /**
+   * Activity bounds are computed again when a finite term larger than this
+   * is added to or removed from the sums, because cancellation would leave
+   * a large absolute error.
+   */
+  const double actBig_;
+
+  /**
+   * Activity bounds of the constraints of actProb_, indexed by the
+   * constraint index. Only constraints that are purely linear are tracked.
+   */
+  std::vector<LinActivity> act_;
+
+  /// The problem for which act_ was built.
+  ProblemPtr actProb_;
+
+  /// Constraints whose activity bounds changed and must be propagated.
+  ConstrQ actQ_;
+
+  /// Lower bounds of variables of actProb_ when act_ was last updated.
+  DoubleVector actVlb_;
+
+  /// Upper bounds of variables of actProb_ when act_ was last updated.
+  DoubleVector actVub_;
+
   /// Statistics of presolve.
   LinPresolveStats *pStats_;
 
@@ -192,6 +256,19 @@ protected:
   /// For log.
   static const std::string me_;
 
+  /**
+   * \brief Add (sign = 1) or remove (sign = -1) the contribution of a term
+   * to the activity bounds of a constraint.
+   */
+  void addActTerm_(LinActivity &a, double coef, double vlb, double vub,
+                   int sign);
+
+  /**
+   * \brief Apply a bound modification to the problem and update the
+   * activity bounds of the constraints of the variable.
+   */
+  void applyBndMod_(ProblemPtr p, VarBoundModPtr mod);
+
   void chkIntToBin_(VariablePtr v);
 
   /**
@@ -206,6 +283,9 @@ protected:
 
 
   void coeffImp_(bool *changed);
+  /// Compute the activity bounds of a tracked constraint from scratch.
+  void computeAct_(LinActivity &a);
+
   void computeImpBounds_(ConstraintPtr c, VariablePtr z, double zval,
                          double *lb, double *ub);
   void copyBndsFromRel_(RelaxationPtr rel, ModVector &p_mods);
@@ -213,6 +293,19 @@ protected:
   void delFixedVars_(bool *changed);
 
   void dualFix_(bool *changed);
+
+  /**
+   * \brief Fix variables whose columns are parallel to that of another
+   * variable that is cheaper and can absorb any change.
+   *
+   * If a_j = s a_k in every constraint, c_j >= s c_k, x_k is continuous and
+   * unbounded in the direction of s, then x_j can be fixed at its lower
+   * bound: any solution can be changed by moving x_j to its lower bound and
+   * x_k by s times as much, without increasing the objective.
+   */
+  void dupCols_(bool *changed);
+
+  /// Find and remove duplicate and parallel linear constraints.
   void dupRows_(bool *changed);
 
   /// check if lb <= ub for all variables and constraints.
@@ -226,9 +319,31 @@ protected:
   void findAllBinCons_();
   void fixToCont_();
 
+  /**
+   * \brief Get bounds on the activity of a constraint from act_.
+   *
+   * ll and uu are infinite if some term has an infinite contribution.
+   * sing_ll and sing_uu are the bounds without the only term with infinite
+   * contribution, and are infinite if there are two or more such terms.
+   */
+  void getActBnds_(ConstraintPtr c, double *ll, double *uu, double *sing_ll,
+                   double *sing_uu);
+
   void getLfBnds_(LinearFunctionPtr lf, double *lo, double *up);
   void getSingLfBnds_(LinearFunctionPtr lf, double *lo, double *up);
 
+  /**
+   * \brief Sort hashes of rows or columns and find groups that may be
+   * parallel.
+   *
+   * Only vectors in the same group need to be compared exactly, so the
+   * work is O(k log k) instead of O(k^2) for k vectors.
+   * \param[in,out] hv The hashes. Sorted on return.
+   * \param[out] grps Pairs of positions [begin, end) in hv of each group
+   * that has two or more vectors.
+   */
+  void groupParallel_(std::vector<LinParHash> &hv, UIntVector &grps);
+
   SolveStatus linBndTighten_(ProblemPtr p, bool apply_to_prob, 
                       ConstraintPtr c_ptr, bool *changed, ModQ *mods, UInt *nintmods);
 
@@ -248,6 +363,19 @@ protected:
 
   void substVars_(bool *changed, PreModQ *pre_mods);
 
+  /**
+   * \brief Bring act_ up to date with the constraints and variable bounds
+   * of p, and queue the constraints that need to be propagated.
+   *
+   * Variable bounds are compared with those seen in the last call and only
+   * the constraints of the variables whose bounds changed are updated and
+   * queued, along with constraints that are new, modified or flagged with
+   * Constraint::getBFlag(). If p is a different problem or the number of
+   * variables changed, or if rebuild is true, act_ is built again and all
+   * constraints are queued.
+   */
+  void syncAct_(ProblemPtr p, bool rebuild);
+
   /// Round the bounds
   void tightenInts_(ProblemPtr p, bool apply_to_prob, bool *changed, 
                     ModQ *mods);
@@ -265,6 +393,16 @@ protected:
                              bool is_sing, bool *changed, ModQ *mods,
                              UInt *nintmods);
 
+  /**
+   * \brief Update activity bounds and queue the constraints of a variable
+   * whose bounds changed from [olb, oub].
+   */
+  void varBndChanged_(VariablePtr v, double olb, double oub);
+
+  /**
+   * \brief Tighten variable bounds using the queued constraints until the
+   * queue is empty or a work limit is reached.
+   */
   SolveStatus varBndsFromCons_(ProblemPtr p, bool apply_to_prob, bool *changed, 
                                ModQ *mods, UInt *nintmods);
 
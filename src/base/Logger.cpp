@@ -4,15 +4,26 @@
 //     (C)opyright 2008 - 2017 The MINOTAUR Team.
 //
 
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 
 #include "MinotaurConfig.h"
 #include "Logger.h"
 
+#if USE_OPENMP
+#include <omp.h>
+#endif
+
 using namespace Minotaur;
 
+// threads with a larger number write directly to std::cout.
+static const int maxLogThreads = 256;
+
 Logger::Logger(LogLevel max_level) 
-  : maxLevel_(max_level),  nb_(), nout_(&nb_)
+  : maxLevel_(max_level),  nb_(), nout_(&nb_), json_(false),
+    tBufs_(maxLogThreads, (linebuf *) 0),
+    tStreams_(maxLogThreads, (std::ostream *) 0)
 {
 
 }
@@ -20,16 +31,11 @@ Logger::Logger(LogLevel max_level)
 
 Logger::~Logger() 
 {
-  // Destructor 
-}
-
-
-std::ostream& Logger::msgStream(LogLevel level) const 
-{
-  if (level <= maxLevel_) { 
-    return std::cout; 
+  flush();
+  for (UInt i=0; i<tBufs_.size(); ++i) {
+    delete tStreams_[i];
+    delete tBufs_[i];
   }
-  return nout_;
 }
 
 
@@ -42,6 +48,178 @@ std::ostream& Logger::errStream() const
   }
 }
 
+
+void Logger::flush() const
+{
+  for (UInt i=0; i<tBufs_.size(); ++i) {
+    if (tBufs_[i]) {
+      tBufs_[i]->flushAll();
+    }
+  }
+  fflush(stdout);
+}
+
+
+std::ostream& Logger::msgStream(LogLevel level) const 
+{
+  int t = 0;
+
+  if (level > maxLevel_) { 
+    return nout_;
+  }
+#if USE_OPENMP
+  if (omp_in_parallel()) {
+    if (omp_get_level() > 1) {
+      return std::cout;
+    }
+    t = omp_get_thread_num();
+  } else if (false==json_) {
+    return std::cout;
+  }
+#else
+  if (false==json_) {
+    return std::cout;
+  }
+#endif
+  if (t >= maxLogThreads) {
+    return std::cout;
+  }
+  if (!tBufs_[t]) {
+#if USE_OPENMP
+#pragma omp critical (loggerBufs)
+#endif
+    {
+      tBufs_[t] = new linebuf(this, t);
+      tStreams_[t] = new std::ostream(tBufs_[t]);
+    }
+  }
+  tBufs_[t]->setLevel(level);
+  return *(tStreams_[t]);
+}
+
+
+void Logger::setJson(bool json)
+{
+  flush();
+  json_ = json;
+}
+
+
+void Logger::writeLine_(const char *s, size_t n, LogLevel level,
+                        int thread) const
+{
+  std::string line;
+  char hex[8];
+
+  if (false==json_) {
+    fwrite(s, 1, n, stdout);
+    return;
+  }
+
+  if (n>0 && '\n'==s[n-1]) {
+    --n;
+  }
+  line.reserve(n+48);
+  sprintf(hex, "%d", (int) level);
+  line += "{\"level\":";
+  line += hex;
+  sprintf(hex, "%d", thread);
+  line += ",\"thread\":";
+  line += hex;
+  line += ",\"msg\":\"";
+  for (size_t i=0; i<n; ++i) {
+    if ('"'==s[i] || '\\'==s[i]) {
+      line += '\\';
+      line += s[i];
+    } else if ((unsigned char) s[i] < 0x20) {
+      sprintf(hex, "\\u%04x", (unsigned int) (unsigned char) s[i]);
+      line += hex;
+    } else {
+      line += s[i];
+    }
+  }
+  line += "\"}\n";
+  fwrite(line.data(), 1, line.size(), stdout);
+}
+
+
+Logger::linebuf::linebuf(const Logger *logger, int thread)
+  : level_(LogInfo),
+    logger_(logger),
+    thread_(thread)
+{
+}
+
+
+void Logger::linebuf::flushAll()
+{
+  flushLines_();
+  if (!buf_.empty()) {
+    logger_->writeLine_(buf_.data(), buf_.size(), level_, thread_);
+    buf_.clear();
+  }
+}
+
+
+void Logger::linebuf::flushLines_()
+{
+  size_t start = 0;
+  size_t pos;
+
+  if (false==logger_->json_) {
+    // all complete lines in one call.
+    pos = buf_.rfind('\n');
+    if (pos!=std::string::npos) {
+      logger_->writeLine_(buf_.data(), pos+1, level_, thread_);
+      buf_.erase(0, pos+1);
+    }
+    return;
+  }
+  while ((pos = buf_.find('\n', start))!=std::string::npos) {
+    logger_->writeLine_(buf_.data()+start, pos+1-start, level_, thread_);
+    start = pos+1;
+  }
+  buf_.erase(0, start);
+}
+
+
+Logger::linebuf::int_type Logger::linebuf::overflow(int_type c)
+{
+  if (c!=traits_type::eof()) {
+    buf_ += traits_type::to_char_type(c);
+    if ('\n'==c) {
+      flushLines_();
+    }
+  }
+  return c;
+}
+
+
+void Logger::linebuf::setLevel(LogLevel level)
+{
+  // the level of a line is that of the stream it was started on.
+  if (buf_.empty()) {
+    level_ = level;
+  }
+}
+
+
+int Logger::linebuf::sync()
+{
+  flushAll();
+  return 0;
+}
+
+
+std::streamsize Logger::linebuf::xsputn(const char *s, std::streamsize n)
+{
+  buf_.append(s, n);
+  if (memchr(s, '\n', n)) {
+    flushLines_();
+  }
+  return n;
+}
+
 // Local Variables: 
 // mode: c++ 
 // eval: (c-set-style "k&r") 
@@ -26,13 +26,41 @@
  * that writes the string using FORTRAN calls.
  * 
  * We may want to describe the output levels in this section.
+ *
+ * The MINOTAUR_LOG macro should be used for messages that are expensive
+ * to format or are written often. The message is not evaluated at all if
+ * its level is above the level set at run time, or above
+ * MINOTAUR_LOG_MAX_LEVEL, which can be set at compile time, e.g.
+ * -DMINOTAUR_LOG_MAX_LEVEL=LogInfo, to remove debugging messages from the
+ * binary.
+ *
+ * Messages written from within an OpenMP parallel region go to a buffer
+ * that belongs to the thread and are written out one complete line at a
+ * time. Threads never wait for each other while formatting, and lines from
+ * different threads are not mixed. So callers do not need to hold a lock
+ * when logging. In JSON mode, every line is written as one JSON object
+ * with the level, the thread and the message.
  */
 
 #include <iostream>
 #include <streambuf>
+#include <string>
+#include <vector>
 
 #include "Types.h"
 
+#ifndef MINOTAUR_LOG_MAX_LEVEL
+#define MINOTAUR_LOG_MAX_LEVEL Minotaur::LogDebug2
+#endif
+
+/**
+ * Use as MINOTAUR_LOG(logger_, LogDebug) << "x = " << x << std::endl; The
+ * right side of << is not evaluated if the message would be discarded.
+ */
+#define MINOTAUR_LOG(logger, level)                                       \
+  if ((level) > MINOTAUR_LOG_MAX_LEVEL || !(logger)->isOn(level)) {}      \
+  else (logger)->msgStream(level)
+
 namespace Minotaur {
   class Logger {
     public:
@@ -48,12 +76,21 @@ namespace Minotaur {
       /// Get the maxLevel
       inline LogLevel getMaxLevel() const { return maxLevel_; }
 
+      /// Return true if messages of this level are written.
+      inline bool isOn(LogLevel level) const { return level <= maxLevel_; }
+
+      /// Write all complete and incomplete lines that are buffered.
+      void flush() const;
+
       /// Get the stream where one can write messages.
       virtual std::ostream& msgStream(LogLevel level) const;
 
       /// Get the stream where one can write errors.
       std::ostream& errStream() const;
 
+      /// Write each line as a JSON object if true, as plain text otherwise.
+      void setJson(bool json);
+
     protected:
       // Maximum output level
       LogLevel maxLevel_;
@@ -76,6 +113,52 @@ namespace Minotaur {
 
       // Null output stream
       mutable std::ostream nout_;
+
+      /// linebuf collects the output of one thread and writes full lines.
+      class linebuf : public std::streambuf {
+        public:
+          linebuf(const Logger *logger, int thread);
+
+          /// Write whatever has been collected.
+          void flushAll();
+
+          /// Set the level of the next line, if a line is not in progress.
+          void setLevel(LogLevel level);
+
+        protected:
+          virtual int_type overflow(int_type c);
+          virtual int sync();
+          virtual std::streamsize xsputn(const char *s, std::streamsize n);
+
+        private:
+          /// Characters not written yet.
+          std::string buf_;
+
+          /// Level of the line being written.
+          LogLevel level_;
+
+          /// The logger.
+          const Logger *logger_;
+
+          /// Number of the thread that writes to this buffer.
+          const int thread_;
+
+          /// Write all complete lines in buf_.
+          void flushLines_();
+      };
+
+      /// True if lines are written as JSON objects.
+      bool json_;
+
+      /// Buffers of threads, created when a thread first writes.
+      mutable std::vector<linebuf *> tBufs_;
+
+      /// Streams of threads, writing to tBufs_.
+      mutable std::vector<std::ostream *> tStreams_;
+
+      /// Write one line (including the newline, if any) to stdout.
+      void writeLine_(const char *s, size_t n, LogLevel level,
+                      int thread) const;
   };
 
   typedef const Logger* ConstLoggerPtr;
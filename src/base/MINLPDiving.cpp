@@ -12,10 +12,15 @@
  * Implements the class MINLPDiving.
  */
 
+#include <algorithm>
 #include <cmath> // for INFINITY
 #include <iomanip>
 
 #include "MinotaurConfig.h"
+#if USE_OPENMP
+#include <omp.h>
+#endif
+
 #include "Constraint.h"
 #include "Engine.h"
 #include "Environment.h"
@@ -40,7 +45,9 @@ using namespace Minotaur;
 const std::string MINLPDiving::me_ = "MINLP Diving Heuristic: "; 
 
 MINLPDiving::MINLPDiving(EnvPtr env, ProblemPtr p, EnginePtr e)
-: e_(e), 
+: diveTries_(32, 0),
+  diveWins_(32, 0),
+  e_(e), 
   env_(env), 
   gradientObj_(NULL),
   intTol_(1e-5),
@@ -48,10 +55,18 @@ MINLPDiving::MINLPDiving(EnvPtr env, ProblemPtr p, EnginePtr e)
   maxNLP_(100),
   maxSol_(2), 
   nSelector_(4),
+  nThreads_(1),
   p_(p), 
   stats_(NULL), 
   timer_(env_->getNewTimer())
 {
+#if USE_OPENMP
+  int k = env->getOptions()->findInt("divheur_threads")->getValue();
+  if (k > 1) {
+    nThreads_ = k;
+  }
+#endif
+
   for (UInt i=0; i<p_->getNumVars(); ++i) {
     avgDual_.push_back(0.);
   }
@@ -137,6 +152,103 @@ void MINLPDiving::backtrack_(UInt n_moded)
 }
 
 
+bool MINLPDiving::divePar_(const std::vector<int> &order,
+                           const double *root_x, double *lb, double *ub,
+                           SolutionPoolPtr s_pool)
+{
+#if USE_OPENMP
+  UInt numvars = p_->getNumVars();
+  UInt nt = std::min(nThreads_, (UInt) order.size());
+  std::vector<MINLPDiving *> workers;
+  int nsols = stats_->totalSol;
+  EnginePtr e;
+
+  for (UInt t=0; t<nt; ++t) {
+    e = e_->emptyCopy();
+    if (!e) {
+      break;
+    }
+    workers.push_back(new MINLPDiving(env_, p_->clone(env_), e));
+    workers[t]->avgDual_ = avgDual_;
+    workers[t]->lh_ = new LinearHandler(env_, workers[t]->p_);
+    workers[t]->nThreads_ = 1;
+    workers[t]->stats_->numLocal = stats_->numLocal;
+    workers[t]->stats_->best_obj_value = stats_->best_obj_value;
+  }
+  if (workers.empty()) {
+    logger_->msgStream(LogInfo) << me_ << "engine " << e_->getName()
+                                << " can not be copied. Diving serially."
+                                << std::endl;
+    nThreads_ = 1;
+    return false;
+  }
+  nt = workers.size();
+
+#pragma omp parallel num_threads(nt)
+  {
+    MINLPDiving *w = workers[omp_get_thread_num()];
+    std::vector<double> x(numvars);
+
+    w->timer_->start();
+    w->e_->clear();
+    w->e_->load(w->p_);
+    w->e_->setIterationLimit(200);
+
+#pragma omp for schedule(dynamic, 1)
+    for (int k=0; k<(int) order.size(); ++k) {
+      int i = order[k];
+      UInt nsol = w->stats_->totalSol;
+      double t0 = w->timer_->query();
+      int found;
+
+#pragma omp atomic read
+      found = nsols;
+      if (found >= (int) maxSol_) {
+        continue;
+      }
+      std::copy(root_x, root_x + numvars, x.begin());
+      w->implementDive_(i, &(x[0]), s_pool);
+      w->restoreBounds_(lb, ub, numvars);
+      while (!w->mods_.empty()) {
+        w->mods_.pop();
+      }
+      w->stats_->time[i/8] += w->timer_->query() - t0;
+      ++(diveTries_[i]);
+      if (w->stats_->totalSol > nsol) {
+        ++(diveWins_[i]);
+#pragma omp atomic
+        ++nsols;
+      }
+    }
+    w->timer_->stop();
+  }
+
+  for (UInt t=0; t<nt; ++t) {
+    MINLPDiving *w = workers[t];
+    for (UInt j=0; j<nSelector_; ++j) {
+      stats_->numNLPs[j] += w->stats_->numNLPs[j];
+      stats_->numInfeas[j] += w->stats_->numInfeas[j];
+      stats_->errors[j] += w->stats_->errors[j];
+      stats_->numSol[j] += w->stats_->numSol[j];
+      stats_->time[j] += w->stats_->time[j];
+    }
+    stats_->totalNLPs += w->stats_->totalNLPs;
+    stats_->totalSol += w->stats_->totalSol;
+    stats_->best_obj_value = std::min(stats_->best_obj_value,
+                                      w->stats_->best_obj_value);
+    e = w->e_;
+    ProblemPtr p = w->p_;
+    delete w;
+    delete e;
+    delete p;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+
 UInt MINLPDiving::FracBounds_(UInt numfrac, const double* x, 
                               Direction d, Order o)
 {
@@ -329,7 +441,10 @@ void MINLPDiving::implementDive_(int i, const double* x, SolutionPoolPtr s_pool)
         || status == ProvenFailedCQFeas || status == FailedFeas) {
       sol = e_->getSolution();
       ++(stats_->numLocal);
-      if (stats_->best_obj_value - 1e-6 < sol->getObjValue()) {
+      // the solution pool may have a better solution found by another
+      // heuristic or thread.
+      if (std::min(stats_->best_obj_value, s_pool->getBestSolutionValue())
+          - 1e-6 < sol->getObjValue()) {
 #if SPEW
         logger_->msgStream(LogDebug) << me_ 
           << "current solution worse than ub. Returning." << std::endl; 
@@ -558,6 +673,23 @@ UInt MINLPDiving::ReducedCost_(UInt numfrac, const double* x,
 }
 
 
+void MINLPDiving::orderDives_(int n, std::vector<int> &order)
+{
+  std::vector<std::pair<double, int> > rate(n);
+
+  // success rate with one success and one failure added, so that a dive
+  // not tried yet is ranked in the middle.
+  for (int i=0; i<n; ++i) {
+    rate[i] = std::make_pair(-(diveWins_[i] + 1.0)/(diveTries_[i] + 2.0), i);
+  }
+  std::sort(rate.begin(), rate.end());
+  order.resize(n);
+  for (int i=0; i<n; ++i) {
+    order[i] = rate[i].second;
+  }
+}
+
+
 void MINLPDiving::restoreBounds_(double* LB_copy, double* UB_copy, UInt vars)
 {
   for (UInt i=0; i<vars; ++i, ++LB_copy, ++UB_copy) {
@@ -711,10 +843,24 @@ void MINLPDiving::solve(NodePtr, RelaxationPtr, SolutionPoolPtr s_pool)
       << stats_->best_obj_value << std::endl;
     s_pool->addSolution(sol);
   } else {
-    lh_ = new LinearHandler(env_, p_);
+    std::vector<int> order;
+    bool done = false;
+
     saveBounds_(LB_copy, UB_copy, numvars);
+    orderDives_(num_method, order);
+#if USE_OPENMP
+    if (nThreads_ > 1 && p_->hasNativeDer() && !omp_in_parallel()) {
+      done = divePar_(order, root_x, LB_copy, UB_copy, s_pool);
+    }
+#endif
+    if (!lh_) {
+      lh_ = new LinearHandler(env_, p_);
+    }
     // loop over the methods starts here
-    for (int i=0; i<num_method && stats_->totalSol < maxSol_; ++i) {
+    for (int k=0; !done && k<num_method && stats_->totalSol < maxSol_; ++k) {
+      int i = order[k];
+      UInt nsol = stats_->totalSol;
+      double t0 = timer_->query();
       logger_->msgStream(LogDebug) << me_<< "diving method "
         << i << std::endl;
       std::copy(root_x, root_x + numvars, root_copy); 
@@ -725,10 +871,10 @@ void MINLPDiving::solve(NodePtr, RelaxationPtr, SolutionPoolPtr s_pool)
       while (!mods_.empty()) {
           mods_.pop();
       }
-      if ((i+1)%8 == 0) {
-        stats_->time[i/8]  = timer_->query();
-        timer_->stop();
-        timer_->start();
+      stats_->time[i/8] += timer_->query() - t0;
+      ++(diveTries_[i]);
+      if (stats_->totalSol > nsol) {
+        ++(diveWins_[i]);
       }
     } // loop over methods ends here
   }
@@ -76,6 +76,16 @@
     * by solving the Relaxed NLP using an NLP engine. The engine is 
     * called once initially to generate a solution  which is rounded 
     * and used for diving. 
+    *
+    * The 32 dives (selection method, order and direction) are tried in the
+    * order of their success in earlier calls. When the option
+    * divheur_threads is more than one and the problem has native
+    * derivatives, the dives are run concurrently as a portfolio. Each
+    * thread dives on its own clone of the problem and its own copy of the
+    * engine, restoring the bounds from the root bounds shared by all
+    * threads after each dive. Solutions go to the solution pool as soon as
+    * they are found, and every dive stops when its relaxation is no better
+    * than the best solution in the pool.
     */
 
    class MINLPDiving : public Heuristic {
@@ -101,6 +111,12 @@
      /// which is to be used to reduced cost diving
      DoubleVector avgDual_;
 
+     /// Number of times each dive was tried.
+     UIntVector diveTries_;
+
+     /// Number of times each dive found a solution.
+     UIntVector diveWins_;
+
      /// Engine being used to solve the problem
      EnginePtr e_;
 
@@ -139,6 +155,9 @@
      /// Number of method for selection of variables
      UInt nSelector_;
 
+     /// Number of threads used to run dives concurrently.
+     UInt nThreads_;
+
      /// Problem to be solved
      ProblemPtr p_;
 
@@ -168,6 +187,20 @@
       */
      void backtrack_(UInt n_flipped);
 
+     /**
+      * \brief Run dives concurrently.
+      *
+      * \param[in] order Indices of dives in the order they are started.
+      * \param[in] root_x Primal solution of the root relaxation.
+      * \param[in] lb Lower bounds of variables at the root.
+      * \param[in] ub Upper bounds of variables at the root.
+      * \param[in] s_pool Pointer to the solution pool.
+      *
+      * \return False if the engine can not be copied. No dive is run then.
+      */
+     bool divePar_(const std::vector<int> &order, const double *root_x,
+                   double *lb, double *ub, SolutionPoolPtr s_pool);
+
      /** 
       * \brief Fractional selection method for fractional variable
       * 
@@ -225,6 +258,15 @@
      UInt LexBounds_(UInt numfrac, const double* x, 
                      Direction d, Order o);
 
+     /**
+      * \brief Order the dives by their rate of success in earlier calls.
+      *
+      * \param[in] n Number of dives.
+      * \param[out] order Indices of dives, most successful first. Ties are
+      * broken by the index.
+      */
+     void orderDives_(int n, std::vector<int> &order);
+
      /** 
       * \brief Reduced cost diving selection method for fractional variable
       * 
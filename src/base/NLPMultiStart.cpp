@@ -13,6 +13,10 @@
 #include <cmath> // for INFINITY
 
 #include "MinotaurConfig.h"
+#if USE_OPENMP
+#include <omp.h>
+#endif
+
 #include "Engine.h"
 #include "Variable.h"
 #include "Environment.h"
@@ -35,10 +39,13 @@ const std::string NLPMultiStart::me_ = "NLP Multi-Start Heuristic: ";
 NLPMultiStart::NLPMultiStart(EnvPtr env, ProblemPtr p, EnginePtr e)
 : e_(e),
   env_(env),
+  nStarts_(10),
+  nThreads_(1),
   p_(p)
 {
   VariablePtr variable;
   UInt n      = p_->getNumVars();
+  int k;
   distBound_  = 0.0;
   for (UInt i=0; i<n; ++i) {
     variable = p_->getVariable(i);
@@ -48,11 +55,24 @@ NLPMultiStart::NLPMultiStart(EnvPtr env, ProblemPtr p, EnginePtr e)
   logger_ = env->getLogger();
   random_                  = new double[n];  
 
+  k = env->getOptions()->findInt("nlpms_starts")->getValue();
+  if (k > 0) {
+    nStarts_ = k;
+  }
+#if USE_OPENMP
+  k = env->getOptions()->findInt("nlpms_threads")->getValue();
+  if (k > 1) {
+    nThreads_ = k;
+  }
+#endif
+
   // statistics
   stats_.numNLPs           = 0;
   stats_.numInfeas         = 0;
   stats_.numImprove        = 0;
   stats_.numBadstatus      = 0;
+  stats_.numSkipped        = 0;
+  stats_.numCancelled      = 0;
   stats_.time              = 0;
   stats_.iterations        = 0;
   stats_.bestObjValue      = INFINITY;
@@ -62,6 +82,28 @@ NLPMultiStart::NLPMultiStart(EnvPtr env, ProblemPtr p, EnginePtr e)
 
 NLPMultiStart::~NLPMultiStart(){
   delete [] random_;
+  for (UInt i=0; i<engines_.size(); ++i) {
+    delete engines_[i];
+  }
+}
+
+
+bool NLPMultiStart::addBasin_(const double *start, const double *x, UInt n)
+{
+  double d = getDistance(start, x, n);
+
+  for (std::vector<Basin>::iterator it=basins_.begin(); it!=basins_.end();
+       ++it) {
+    if (getDistance(&(it->x[0]), x, n) <=
+        1e-4*(1.0 + sqrt(InnerProduct(x, x, n)))) {
+      it->radius = std::max(it->radius, 0.5*d);
+      return false;
+    }
+  }
+  basins_.push_back(Basin());
+  basins_.back().x.assign(x, x+n);
+  basins_.back().radius = 0.5*d;
+  return true;
 }
 
 
@@ -111,11 +153,30 @@ void NLPMultiStart::constructInitial_(double* a, const double* b, double rho,
 }
 
 
+bool NLPMultiStart::inBasin_(const double *x, UInt n) const
+{
+  for (std::vector<Basin>::const_iterator it=basins_.begin();
+       it!=basins_.end(); ++it) {
+    if (getDistance(&(it->x[0]), x, n) < it->radius) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
 void NLPMultiStart::solve(NodePtr, RelaxationPtr, SolutionPoolPtr s_pool)
 {
+#if USE_OPENMP
+  if (nThreads_ > 1 && p_->hasNativeDer() && !omp_in_parallel()) {
+    solvePar_(s_pool);
+    return;
+  }
+#endif
+
   ConstSolutionPtr sol; 
   EngineStatus status;
-  UInt heur_bound                = 10; // no. of times the heuristic should run
+  UInt heur_bound                = nStarts_; // no. of times the heuristic should run
   UInt unchanged_obj_count_limit =  3;
   double obj_tol                 = 1e-6; 
   double rho_initial             = 1.1;// amplification factor
@@ -199,6 +260,176 @@ void NLPMultiStart::solve(NodePtr, RelaxationPtr, SolutionPoolPtr s_pool)
 }
 
 
+void NLPMultiStart::solvePar_(SolutionPoolPtr s_pool)
+{
+#if USE_OPENMP
+  UInt n                         = p_->getNumVars();
+  UInt nt                        = nThreads_;
+  UInt batch                     = 2*nThreads_; // starts solved together
+  UInt unchanged_limit           = 3; // batches without new local solutions
+  int probe_iters                = 20; // iterations before a start is checked
+  double obj_tol                 = 1e-6;
+  double rho_initial             = 1.1; // amplification factor
+  double rho                     = rho_initial;
+  double best                    = stats_.bestObjValue;
+  Timer *timer                   = env_->getNewTimer();
+  std::vector<ProblemPtr> probs(nt, ProblemPtr());
+  std::vector<double> center(n), pt(n), starts;
+  UInt tried = 0, unchanged = 0;
+  UInt nb;
+  bool improved, found;
+
+  while (engines_.size() < nt) {
+    EnginePtr e = e_->emptyCopy();
+    if (!e) {
+      logger_->msgStream(LogInfo) << me_ << "engine " << e_->getName()
+                                  << " can not be copied. Solving serially."
+                                  << std::endl;
+      nThreads_ = 1;
+      delete timer;
+      solve(NodePtr(), RelaxationPtr(), s_pool);
+      return;
+    }
+    engines_.push_back(e);
+  }
+
+  // start at a random point.
+  for (UInt i=0; i<n; ++i) {
+    VariablePtr v = p_->getVariable(i);
+    pt[i] = std::max(std::min(rand()/double (RAND_MAX), v->getUb()),
+                     v->getLb());
+  }
+  center = pt;
+
+  srand(1);
+  timer->start();
+  while (tried < nStarts_ && unchanged < unchanged_limit) {
+    // starting points of this batch are spread around the best solution
+    // found so far at distances increasing up to that used in serial mode.
+    starts.clear();
+    nb = 0;
+    while (nb < batch && tried < nStarts_) {
+      ++tried;
+      if (tried > 1) {
+        constructInitial_(&pt[0], &center[0], rho*(nb+1)/batch, n);
+      }
+      if (inBasin_(&pt[0], n)) {
+        ++(stats_.numSkipped);
+        continue;
+      }
+      starts.insert(starts.end(), pt.begin(), pt.end());
+      ++nb;
+    }
+
+    improved = false;
+    found = false;
+#pragma omp parallel num_threads(nt)
+    {
+      UInt t = omp_get_thread_num();
+      EnginePtr e = engines_[t];
+
+      if (!probs[t]) {
+        probs[t] = p_->clone(env_);
+        e->clear();
+        e->load(probs[t]);
+      }
+
+#pragma omp for schedule(dynamic, 1)
+      for (int i=0; i<(int) nb; ++i) {
+        const double *x0 = &(starts[i*n]);
+        ConstSolutionPtr sol;
+        EngineStatus status;
+        bool hopeless;
+
+#pragma omp critical (nlpMultiStart)
+        {
+          hopeless = inBasin_(x0, n);
+          if (hopeless) {
+            ++(stats_.numCancelled);
+          }
+        }
+        if (hopeless) {
+          continue;
+        }
+
+        // solve a few iterations first, and give up if the iterate has
+        // entered the basin of a local solution found by another thread.
+        probs[t]->setInitialPoint(x0);
+        e->setIterationLimit(probe_iters);
+        status = e->solve();
+        e->resetIterationLimit();
+        if (EngineIterationLimit == status) {
+          sol = e->getSolution();
+          if (sol) {
+#pragma omp critical (nlpMultiStart)
+            {
+              hopeless = inBasin_(sol->getPrimal(), n);
+              if (hopeless) {
+                ++(stats_.numCancelled);
+              }
+            }
+            if (hopeless) {
+              continue;
+            }
+            probs[t]->setInitialPoint(sol->getPrimal());
+          }
+          status = e->solve();
+        }
+
+        sol = e->getSolution();
+#pragma omp critical (nlpMultiStart)
+        {
+          ++(stats_.numNLPs);
+          if (sol && (ProvenOptimal == status ||
+                      ProvenLocalOptimal == status)) {
+            found = addBasin_(x0, sol->getPrimal(), n) || found;
+            if (sol->getObjValue() < best - obj_tol) {
+              best = sol->getObjValue();
+              std::copy(sol->getPrimal(), sol->getPrimal() + n,
+                        center.begin());
+              s_pool->addSolution(sol);
+              improved = true;
+              ++(stats_.numImprove);
+            }
+          } else if (ProvenInfeasible==status ||
+                     ProvenLocalInfeasible==status ||
+                     ProvenObjectiveCutOff==status ||
+                     ProvenFailedCQInfeas==status || FailedInfeas==status) {
+            ++(stats_.numInfeas);
+          } else if (ProvenUnbounded==status) {
+            ++(stats_.numBadstatus);
+          }
+        }
+      }
+    }
+
+    if (improved) {
+      rho = rho_initial;
+      unchanged = 0;
+    } else if (found) {
+      unchanged = 0;
+    } else {
+      rho *= 1.07;
+      ++unchanged;
+    }
+    stats_.bestObjValue = best;
+    stats_.time = timer->query();
+  }
+
+  for (UInt t=0; t<nt; ++t) {
+    if (probs[t]) {
+      engines_[t]->clear();
+      delete probs[t];
+    }
+  }
+  basins_.clear();
+  delete timer;
+#else
+  solve(NodePtr(), RelaxationPtr(), s_pool);
+#endif
+}
+
+
 void NLPMultiStart::writeStats(std::ostream &out) const
 {
   out << me_ << " number of nlps solved                 = " 
@@ -209,6 +440,10 @@ void NLPMultiStart::writeStats(std::ostream &out) const
     << stats_.numImprove << std::endl
     << me_ << " number of Bad status(unbounded etc)   = " 
     << stats_.numNLPs << std::endl
+    << me_ << " number of starts skipped in basins    = " 
+    << stats_.numSkipped << std::endl
+    << me_ << " number of starts cancelled            = " 
+    << stats_.numCancelled << std::endl
     << me_ << " total time taken                      = " 
     << stats_.time << std::endl
     << me_ << " number of iterations                  = " 
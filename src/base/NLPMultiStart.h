@@ -31,6 +31,8 @@ namespace Minotaur {
     UInt numInfeas;
     UInt numImprove;
     UInt numBadstatus;
+    UInt numSkipped;   /// Starts not solved because they lie in a basin.
+    UInt numCancelled; /// Starts abandoned after the first iterations.
     double time;
     UInt iterations;
     double bestObjValue;
@@ -43,6 +45,16 @@ namespace Minotaur {
    * A Heuristic used to find solutions for continuous NLPs by solving the
    * NLP using NLP engine. The engine is called multiple times from different
    * strategically constructed starting points.
+   *
+   * When the option nlpms_threads is more than one and the problem has
+   * native derivatives, batches of starting points are solved concurrently,
+   * each thread using its own copy of the engine (Engine::emptyCopy) and its
+   * own clone of the problem. Every local solution found defines a basin: a
+   * ball around it whose radius is half the largest distance from which a
+   * start converged to it. A start that lies in a known basin is not
+   * solved, and a start whose iterate enters a known basin after the first
+   * few iterations is abandoned, because it can not improve the incumbent.
+   * At most nlpms_starts starting points are tried.
    */
   class NLPMultiStart : public Heuristic {
     
@@ -63,6 +75,15 @@ namespace Minotaur {
       const static std::string me_; 
           
     private:
+
+      /// A local solution and the region of starts converging to it.
+      struct Basin {
+        std::vector<double> x; ///< The local solution.
+        double radius;         ///< Starts within this distance are skipped.
+      };
+
+      /// Local solutions found by concurrent starts.
+      std::vector<Basin> basins_;
  
       /** bound on the distance. If radius of the ball is less than this
        * number then radius = distBound_
@@ -71,12 +92,21 @@ namespace Minotaur {
 
       /// Engine being used to solve problem.
       EnginePtr e_;
+
+      /// Copies of the engine used by threads, one for each thread.
+      std::vector<EnginePtr> engines_;
    
       /// Environment
       EnvPtr env_;
 
       /// Logger.
       LoggerPtr logger_;
+
+      /// Maximum number of starting points tried in one call to solve.
+      UInt nStarts_;
+
+      /// Number of threads used to solve from different starting points.
+      UInt nThreads_;
      
       /// Problem that is being solved.
       ProblemPtr p_;
@@ -100,6 +130,21 @@ namespace Minotaur {
        * \param]in] vars Number of variables
        */
       void constructInitial_(double* a, const double* b, double rho, UInt vars);
+
+      /**
+       * \brief Record a local solution reached from a starting point.
+       *
+       * A new basin is created if the solution is not close to the solution
+       * of a known basin. Otherwise the radius of that basin is increased.
+       * \return True if a new basin was created.
+       */
+      bool addBasin_(const double *start, const double *x, UInt n);
+
+      /// Return true if the point lies in a known basin.
+      bool inBasin_(const double *x, UInt n) const;
+
+      /// Solve from batches of starting points concurrently.
+      void solvePar_(SolutionPoolPtr s_pool);
       
   };
 
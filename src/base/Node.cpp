@@ -223,6 +223,60 @@ void Node::applyMods(RelaxationPtr rel, ProblemPtr p)
 }
 
 
+const PCostRecord* Node::findPCost(UInt index) const
+{
+  UInt pos;
+  for (ConstNodePtr n=this; n; n=n->parent_) {
+    pos = n->pcostPos_(index);
+    if (pos < n->pcosts_.size() && n->pcosts_[pos].index == index) {
+      return &(n->pcosts_[pos]);
+    }
+  }
+  return 0;
+}
+
+
+UInt Node::pcostPos_(UInt index) const
+{
+  // binary search in records sorted by index.
+  UInt lo = 0;
+  UInt hi = pcosts_.size();
+  UInt mid;
+  while (lo < hi) {
+    mid = (lo+hi)/2;
+    if (pcosts_[mid].index < index) {
+      lo = mid+1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+
+PCostRecord* Node::recordPCost(UInt index)
+{
+  UInt pos = pcostPos_(index);
+  if (pos < pcosts_.size() && pcosts_[pos].index == index) {
+    return &(pcosts_[pos]);
+  }
+
+  PCostRecord rec;
+  const PCostRecord *old = (parent_) ? parent_->findPCost(index) : 0;
+  if (old) {
+    rec = *old;
+  } else {
+    rec.index = index;
+    rec.lastStrBranched = 0;
+    rec.pcDown = 0.0;
+    rec.pcUp = 0.0;
+    rec.timesDown = 0;
+    rec.timesUp = 0;
+  }
+  return &(*pcosts_.insert(pcosts_.begin()+pos, rec));
+}
+
+
 void Node::removeChild(NodePtrIterator childNodeIter)
 {
   children_.erase(childNodeIter);
@@ -393,56 +447,6 @@ void Node::undoMods(RelaxationPtr rel, ProblemPtr p)
 }
 
 
-void Node::updateBrCands(UInt index) {
-  brCands_.push_back(index);
-}
-
-
-void Node::updateLastStrBranched(UInt index, double value) {
-  if (index >= lastStrBranched_.size()) {
-    lastStrBranched_.push_back(value);
-  } else {
-    lastStrBranched_[index] = value;
-  }
-}
-
-
-void Node::updatePCDown(UInt index, double value) {
-  if (index >= pseudoDown_.size()) {
-    pseudoDown_.push_back(value);
-  } else {
-    pseudoDown_[index] = value;
-  }
-}
-
-
-void Node::updatePCUp(UInt index, double value) {
-  if (index >= pseudoUp_.size()) {
-    pseudoUp_.push_back(value);
-  } else {
-    pseudoUp_[index] = value;
-  }
-}
-
-
-void Node::updateTimesDown(UInt index, double value) {
-  if (index >= timesDown_.size()) {
-    timesDown_.push_back(value);
-  } else {
-    timesDown_[index] = value;
-  }
-}
-
-
-void Node::updateTimesUp(UInt index, double value) {
-  if (index >= timesUp_.size()) {
-    timesUp_.push_back(value);
-  } else {
-    timesUp_[index] = value;
-  }
-}
-
-
 void Node::write(std::ostream &out) const
 {
   out << "Node ID: " << id_ << " at depth: " << depth_;
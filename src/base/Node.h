@@ -24,6 +24,35 @@ namespace Minotaur {
   typedef const Node* ConstNodePtr;
   typedef Relaxation* RelaxationPtr;
   typedef WarmStart* WarmStartPtr;
+
+  /**
+   * \brief Branching statistics of one variable that were recorded at a
+   * node.
+   *
+   * A node only keeps records of the variables whose statistics changed
+   * while processing it. The statistics of other variables are those of the
+   * closest ancestor that has a record for them.
+   */
+  struct PCostRecord {
+    /// Pseudo-cost index of the variable.
+    UInt index;
+
+    /// When did we last strong-branch on the variable.
+    UInt lastStrBranched;
+
+    /// Pseudo-cost for rounding down.
+    double pcDown;
+
+    /// Pseudo-cost for rounding up.
+    double pcUp;
+
+    /// Number of times the down pseudo-cost was updated.
+    UInt timesDown;
+
+    /// Number of times the up pseudo-cost was updated.
+    UInt timesUp;
+  };
+  typedef std::vector<PCostRecord> PCostRecordVector;
   
    /**
     * A Node is a node in the search tree or the branch-and-bound tree.
@@ -131,6 +160,16 @@ namespace Minotaur {
      */
     BranchPtr getBranch() const { return branch_; }
 
+    /**
+     * \brief Find the branching statistics of a variable at this node.
+     *
+     * The records of this node and then of its ancestors are searched.
+     * \param[in] index The pseudo-cost index of the variable.
+     * \return The most recent record. NULL if no node in the parental chain
+     * has a record of the variable.
+     */
+    const PCostRecord* findPCost(UInt index) const;
+
     /// Return the cut-pool of this node.
     CutList getCutPool() { return cutPool_; }
 
@@ -140,9 +179,6 @@ namespace Minotaur {
     /// Return the ID of this node.
     UInt getId() const { return id_; }
 
-    /// Return the vector of last strong branching information of candidates.
-    UIntVector getLastStrongBranched() {return lastStrBranched_;}
-
     /// Return the lower bound of the relaxation obtained at this node.
     double getLb() const { return lb_; }
 
@@ -152,24 +188,8 @@ namespace Minotaur {
     /// Return a pointer to the parent node.
     NodePtr getParent() const { return parent_; }
 
-    /**
-     * Return the vector of pseudocosts of down-branchings upto this node in
-     * the parental chain (direct ancestors only).
-     */
-    //DoubleVector getPCDown() const { return pseudoDown_; }
-    DoubleVector getPCDown() { return pseudoDown_; }
-
-    /**
-     * Return the vector of indices of the variables branched till this node.
-     * in the parental chain (direct ancestors only).
-     */
-    UIntVector getBrCands() const { return brCands_; }
-
-    /**
-     * Return the vector of pseudocosts of up-branchings upto this node in
-     * the parental chain (direct ancestors only).
-     */
-    DoubleVector getPCUp() const { return pseudoUp_; }
+    /// Return the branching statistics recorded at this node only.
+    const PCostRecordVector& getPCosts() const { return pcosts_; }
 
     /// Get the status of this node.
     NodeStatus getStatus() const { return status_; }
@@ -181,18 +201,6 @@ namespace Minotaur {
     
     double getVioVal() { return vioVal_; }
 
-    /**
-     * Return the vector of number of down-branchings of a variable upto this
-     * in the parental chain (direct ancestors only).
-     */
-    UIntVector getTimesDown() const { return timesDown_; }
-
-    /**
-     * Return the vector of number of up-branchings of a variable upto this
-     * node in the parental chain (direct ancestors only).
-     */
-    UIntVector getTimesUp() const { return timesUp_; }
-
     /// Get the warm start information.
     WarmStartPtr getWarmStart() { return ws_; }
 
@@ -217,6 +225,19 @@ namespace Minotaur {
     /// Reverse iterators.
     ModificationRConstIterator modsREnd() const { return pMods_.rend(); }
 
+    /**
+     * \brief Return the record of branching statistics of a variable at
+     * this node so that it can be updated.
+     *
+     * If this node does not have a record of the variable, one is created
+     * from the statistics found by findPCost(), or with all statistics zero
+     * if none are found.
+     * \param[in] index The pseudo-cost index of the variable.
+     * \return The record of this node. It is valid until the next record is
+     * created at this node.
+     */
+    PCostRecord* recordPCost(UInt index);
+
     /**
      * Remove a child node from the list of children. If the node is
      * fathomed and if this list is empty, we can delete this node.
@@ -232,9 +253,6 @@ namespace Minotaur {
     /// Remove warm start information associated with this node.
     void removeWarmStart();
 
-    /// Set the branching candidate information for this node.
-    void setBrCands(UIntVector brCands) { brCands_ = brCands; }
-
     /// Set the depth of the node in the tree.
     void setDepth(UInt depth);
 
@@ -244,30 +262,15 @@ namespace Minotaur {
      */
     void setId(UInt id);
 
-    /// Set the vector of last strong branched information of candidates.
-    void setLastStrongBranched(UIntVector lstStrnBrnchd) {lastStrBranched_ = lstStrnBrnchd;}
-
     /// Set a lower bound for the relaxation at this node.
     void setLb(double value);
 
-    /// Set the down pseudocosts for this node.
-    void setPCDown(DoubleVector pcDown) { pseudoDown_ = pcDown; }
-
-    /// Set the up pseudocosts for this node.
-    void setPCUp(DoubleVector pcUp) { pseudoUp_ = pcUp; }
-
     /// Set the status of this node.
     void setStatus(NodeStatus status) { status_ = status; }
 
     /// Get the tie-breaking score.
     void setTbScore(double d) { tbScore_ = d; }
 
-    /// Set the times down for this node.
-    void setTimesDown(UIntVector timesDown) { timesDown_ = timesDown; }
-
-    /// Set the times up for this node.
-    void setTimesUp(UIntVector timesUp) { timesUp_ = timesUp; }
-
     /// Set warm start information
     void setWarmStart (WarmStartPtr ws);
 
@@ -296,36 +299,6 @@ namespace Minotaur {
      */
     void undoMods(RelaxationPtr rel, ProblemPtr p);
 
-    /**
-     * Update the branching candidate vector at this node.
-     */
-    void updateBrCands(UInt index);
-
-    /**
-     * Update the last strong branched statistic at this node.
-     */
-    void updateLastStrBranched(UInt index, double value);
-
-    /**
-     * Update the down-branching pseudocosts at this node.
-     */
-    void updatePCDown(UInt index, double value);
-
-    /**
-     * Update the up-branching pseudocosts at this node.
-     */
-    void updatePCUp(UInt index, double value);
-
-    /**
-     * Update the down-branching count of candidates at this node.
-     */
-    void updateTimesDown(UInt index, double value);
-
-    /**
-     * Update the up-branching count of candidates at this node.
-     */
-    void updateTimesUp(UInt index, double value);
-
     ///Write the node
     void write(std::ostream &o) const;
 
@@ -345,9 +318,6 @@ namespace Minotaur {
     /// Id of this node.
     UInt id_;
 
-    /// When did we last strong-branch on a candidate.
-    UIntVector lastStrBranched_;
-
     /**
      * Lower bound on the relaxation at this node (not to original
      * relaxation).
@@ -370,16 +340,10 @@ namespace Minotaur {
     NodePtr parent_;
 
     /**
-     * Vector of indices of variables branched on till this node in the
-     * parental chain (direct ancestors only).
+     * Branching statistics that were updated at this node, sorted by the
+     * index of the variable.
      */
-    UIntVector brCands_;
-
-    /// Vector of pseudocosts for rounding down ().
-    DoubleVector pseudoDown_;
-
-    /// Vector of pseudocosts for rounding up.
-    DoubleVector pseudoUp_;
+    PCostRecordVector pcosts_;
 
     /// The status of this node.
     NodeStatus status_;   
@@ -393,24 +357,18 @@ namespace Minotaur {
     /// List of cuts generated at this node.
     CutList cutPool_;
 
-    /**
-     * \brief Number of times we have branched down and noted the effect on
-     * objective improvement.
-     */
-    UIntVector timesDown_;
-
-    /**
-     * \brief Number of times we have branched up and noted the effect on objective
-     * improvement.
-     */
-    UIntVector timesUp_;
-
     /// The warm start information saved for this node
     WarmStartPtr ws_;
 
     /// Not allowed to copy a node.
     Node(const Node &node); 
 
+    /**
+     * Return the position in pcosts_ of the record of a variable, or of the
+     * first record with a larger index if there is none.
+     */
+    UInt pcostPos_(UInt index) const;
+
     /// Not allowed to copy a node.
     Node(NodePtr node); 
   };
@@ -89,6 +89,23 @@ double NodeHeap::getBestLB() const
 }
 
 
+void NodeHeap::getColdNodes(NodePtrVector &nodes) const
+{
+  NodePtrVector::iterator first = nodes.insert(nodes.end(), nodes_.begin(),
+                                               nodes_.end());
+  switch(type_) {
+  case (Value):
+    std::sort(first, nodes.end(), valueGreaterThan);
+    break;
+  case (Depth):
+    std::sort(first, nodes.end(), depthGreaterThan);
+    break;
+  default:
+    assert(0);
+  }
+}
+
+
 UInt NodeHeap::getDeepestLevel() const
 {
    UInt retval = 0;
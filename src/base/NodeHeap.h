@@ -58,6 +58,9 @@ namespace Minotaur {
          */
         virtual double getBestLB() const;
 
+        /// Get all nodes sorted from the worst to the best.
+        virtual void getColdNodes(NodePtrVector &nodes) const;
+
         /// Find the maximum depth of all active nodes.
         virtual UInt getDeepestLevel() const;
 
@@ -26,7 +26,8 @@ using namespace Minotaur;
 
 
 NodeIncRelaxer::NodeIncRelaxer (EnvPtr env, HandlerVector handlers) 
-  : engine_(EnginePtr()),  // NULL
+  : applied_(0),
+    engine_(EnginePtr()),  // NULL
     env_(env),
     handlers_(handlers),
     modProb_(true),
@@ -99,12 +100,13 @@ RelaxationPtr NodeIncRelaxer::createNodeRelaxation(NodePtr node, bool dived,
   prune = false;
 
   if (!dived) {
-    // traceback to root and put in all modifications that need to go into the
+    // traceback to root (or to the ancestor whose modifications are still
+    // there) and put in all modifications that need to go into the
     // relaxation and the engine.
     std::stack<NodePtr> predecessors;
     t_node = node->getParent();
 
-    while (t_node) {
+    while (t_node && t_node != applied_) {
       predecessors.push(t_node);
       t_node = t_node->getParent();
     }
@@ -125,6 +127,7 @@ RelaxationPtr NodeIncRelaxer::createNodeRelaxation(NodePtr node, bool dived,
       }
     }
   } 
+  applied_ = 0;
 
   // put in the modifications that were used to create this node from
   // its parent.
@@ -157,19 +160,53 @@ RelaxationPtr NodeIncRelaxer::createNodeRelaxation(NodePtr node, bool dived,
 
 void NodeIncRelaxer::reset(NodePtr node, bool diving)
 {
-  NodePtr t_node = node;
-
   if (!diving) {
-    if (modProb_) {
-      while (t_node) {
-        t_node->undoMods(rel_, p_);
-        t_node = t_node->getParent();
-      }
-    } else {
-      while (t_node) {
-        t_node->undoRMods(rel_);
-        t_node = t_node->getParent();
-      }
+    // after resetTo(), only the changes of applied_ and its ancestors are
+    // still there. The changes below it were never applied.
+    undoUpTo_(applied_ ? applied_ : node, 0);
+  }
+  applied_ = 0;
+}
+
+
+void NodeIncRelaxer::resetTo(NodePtr node, NodePtr next)
+{
+  NodePtr a = node;
+  NodePtr b = next;
+
+  if (!next) {
+    reset(node, false);
+    return;
+  }
+
+  // find the common ancestor.
+  while (a->getDepth() > b->getDepth()) {
+    a = a->getParent();
+  }
+  while (b->getDepth() > a->getDepth()) {
+    b = b->getParent();
+  }
+  while (a != b) {
+    a = a->getParent();
+    b = b->getParent();
+  }
+  undoUpTo_(node, a);
+  applied_ = a;
+}
+
+
+void NodeIncRelaxer::undoUpTo_(NodePtr node, NodePtr last)
+{
+  NodePtr t_node = node;
+  if (modProb_) {
+    while (t_node != last) {
+      t_node->undoMods(rel_, p_);
+      t_node = t_node->getParent();
+    }
+  } else {
+    while (t_node != last) {
+      t_node->undoRMods(rel_);
+      t_node = t_node->getParent();
     }
   }
 }
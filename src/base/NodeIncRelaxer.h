@@ -27,6 +27,11 @@ namespace Minotaur {
  *
  * If we dive after processing a node, we do not need to undo all changes
  * and apply them again. We just apply the modifications of the parent.
+ * Similarly, if the next node is known when we are done with a node (see
+ * resetTo()), only the changes below their common ancestor are undone and
+ * only the changes from there to the next node are applied. If we stop
+ * before processing the next node, reset() undoes the changes that are
+ * left.
  */
 class NodeIncRelaxer : public NodeRelaxer {
 public:
@@ -48,6 +53,9 @@ public:
   // Implement NodeRelaxer::reset()
   void reset(NodePtr node, bool diving);
 
+  // Implement NodeRelaxer::resetTo()
+  void resetTo(NodePtr node, NodePtr next);
+
   /**
    * /brief Set the engine that is used to solve the relaxations. We need to set
    * it in order to be able to load warm-starts at a node.
@@ -72,6 +80,12 @@ public:
   /// Set the problem pointer
   void setProblem(ProblemPtr p);
 private:
+  /**
+   * The deepest node whose modifications (and those of its ancestors) were
+   * kept by resetTo(). NULL if all modifications were undone.
+   */
+  NodePtr applied_;
+
   /// Pointer engine used to solve the relaxation.
   EnginePtr engine_;
 
@@ -95,6 +109,10 @@ private:
    * reset.
    */
   RelaxationPtr rel_;
+
+  /// Undo the modifications of node and its ancestors up to, but not
+  /// including, the node last.
+  void undoUpTo_(NodePtr node, NodePtr last);
 };
 
 typedef NodeIncRelaxer* NodeIncRelaxerPtr;
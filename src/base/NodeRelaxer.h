@@ -72,6 +72,15 @@ public:
    */
   virtual void reset(NodePtr node, bool diving) = 0;
 
+  /**
+   * Same as reset(node, false), except that the next node to be processed
+   * is known. Relaxers that modify the relaxation incrementally may then
+   * keep the changes of the ancestors common to node and next, so that the
+   * next call to createNodeRelaxation(next, false, ...) only needs to apply
+   * the changes along the path between the two nodes. next can be NULL.
+   */
+  virtual void resetTo(NodePtr node, NodePtr) { reset(node, false); }
+
   /**
    * Return a pointer to the last relaxation that was created by this
    * relaxer.
@@ -55,6 +55,12 @@ double NodeStack::getBestLB() const
 }
 
 
+void NodeStack::getColdNodes(NodePtrVector &nodes) const
+{
+  nodes.insert(nodes.end(), nodes_.rbegin(), nodes_.rend());
+}
+
+
 UInt NodeStack::getDeepestLevel() const
 {
   NodeStackConstIter iter = nodes_.begin();
@@ -50,6 +50,9 @@ namespace Minotaur {
        */
       virtual double getBestLB() const;
 
+      /// Get all nodes from the bottom of the stack to the top.
+      virtual void getColdNodes(NodePtrVector &nodes) const;
+
       /// The maximum depth is the depth of the topmost node in the stack.
       virtual UInt getDeepestLevel() const;
 
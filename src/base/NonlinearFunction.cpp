@@ -45,6 +45,68 @@ void NonlinearFunction::computeBounds(double *lb, double *ub, int *error)
 }
 
 
+double NonlinearFunction::evalWork(const double *, NlWork *, int *error) const
+{
+  assert(!"evaluation with workspace not implemented!");
+  *error = 1;
+  return 0.0;
+}
+
+
+void NonlinearFunction::evalBatch(const double *x, UInt n, UInt k,
+                                  double *f, NlWork *w, int *error) const
+{
+  for (UInt j=0; j<k && 0==*error; ++j) {
+    f[j] = evalWork(x+j*n, w, error);
+  }
+}
+
+
+void NonlinearFunction::evalGradientBatch(const double *x, UInt n, UInt k,
+                                          double *grad_f, NlWork *w,
+                                          int *error) const
+{
+  for (UInt j=0; j<k && 0==*error; ++j) {
+    evalGradientWork(x+j*n, grad_f+j*n, w, error);
+  }
+}
+
+
+void NonlinearFunction::evalGradientWork(const double *, double *, NlWork *,
+                                         int *error) const
+{
+  assert(!"evaluation with workspace not implemented!");
+  *error = 1;
+}
+
+
+void NonlinearFunction::evalHessianWork(double, const double *,
+                                        const LTHessStor *, double *,
+                                        NlWork *, int *error) const
+{
+  assert(!"evaluation with workspace not implemented!");
+  *error = 1;
+}
+
+
+void NonlinearFunction::fillJacBatch(const double *x, UInt n, UInt k,
+                                     double *values, UInt nz, NlWork *w,
+                                     int *error) const
+{
+  for (UInt j=0; j<k && 0==*error; ++j) {
+    fillJacWork(x+j*n, values+j*nz, w, error);
+  }
+}
+
+
+void NonlinearFunction::fillJacWork(const double *, double *, NlWork *,
+                                    int *error) const
+{
+  assert(!"evaluation with workspace not implemented!");
+  *error = 1;
+}
+
+
 std::string NonlinearFunction::getNlString(int *)
 {
   return "";
@@ -72,6 +134,12 @@ NonlinearFunctionPtr NonlinearFunction::getPersp(VariablePtr, double,
 }
 
 
+NlWork* NonlinearFunction::newWork() const
+{
+  return 0;
+}
+
+
 void NonlinearFunction::sqrRoot(int &err)
 {
   err = 1; 
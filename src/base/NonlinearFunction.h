@@ -25,6 +25,34 @@ namespace Minotaur {
   typedef std::vector<VarBoundModPtr> VarBoundModVector;
   typedef VarBoundModVector::iterator VarBoundModIter;
 
+  /**
+   * \brief Scratch space for evaluating a nonlinear function.
+   *
+   * A workspace is created by NonlinearFunction::newWork() and is owned by
+   * the caller. It can only be used with the function that created it, and
+   * only until that function is modified. Different threads can evaluate the
+   * same function at the same time if each of them uses its own workspace.
+   */
+  struct NlWork {
+    /// Values of all nodes.
+    DoubleVector val;
+
+    /// Reverse-mode gradients.
+    DoubleVector g;
+
+    /// Forward-mode gradients.
+    DoubleVector gi;
+
+    /// Second order adjoints.
+    DoubleVector h;
+
+    /// Values of all nodes at several points, used in batch evaluation.
+    DoubleVector bval;
+
+    /// Reverse-mode gradients at several points, used in batch evaluation.
+    DoubleVector bg;
+  };
+
   /**
    * \brief Base class for nonlinear functions. 
    */
@@ -86,6 +114,33 @@ namespace Minotaur {
      */
     virtual double eval(const double *x, int *error) = 0;
 
+    /**
+     * \brief Evaluate the function at a given point x using a workspace.
+     * Unlike eval(), this does not modify the function and may be called
+     * concurrently with different workspaces.
+     *
+     * \param [in] x The point, same as in eval().
+     * \param [in,out] w A workspace obtained from newWork().
+     * \param [out] error Same as in eval().
+     * \return The value of function of x.
+     */
+    virtual double evalWork(const double *x, NlWork *w, int *error) const;
+
+    /**
+     * \brief Evaluate the function at k points.
+     *
+     * The default implementation calls evalWork() for each point.
+     * \param [in] x The points stored column-wise: point j starts at x+j*n.
+     * \param [in] n The size of each point.
+     * \param [in] k The number of points.
+     * \param [out] f The value at each point. Size k.
+     * \param [in,out] w A workspace obtained from newWork().
+     * \param [out] error Set to a positive value if an error is encountered
+     * at any point.
+     */
+    virtual void evalBatch(const double *x, UInt n, UInt k, double *f,
+                           NlWork *w, int *error) const;
+
     /**
      * \brief Evaluate and add gradient at a given point.
      *
@@ -99,6 +154,18 @@ namespace Minotaur {
     virtual void evalGradient(const double *x, double *grad_f, int *error) 
       = 0;
 
+    /// Same as evalGradient(), but use a workspace. See evalWork().
+    virtual void evalGradientWork(const double *x, double *grad_f,
+                                  NlWork *w, int *error) const;
+
+    /**
+     * \brief Evaluate and add gradients at k points. Arguments are the same
+     * as in evalBatch(). The gradient at point j is added to grad_f+j*n.
+     */
+    virtual void evalGradientBatch(const double *x, UInt n, UInt k,
+                                   double *grad_f, NlWork *w, int *error)
+      const;
+
     /**
      * \brief Evaluate and add hessian at a given point.
      *
@@ -114,6 +181,11 @@ namespace Minotaur {
                              const LTHessStor *stor, double *values, 
                              int *error) = 0;
 
+    /// Same as evalHessian(), but use a workspace. See evalWork().
+    virtual void evalHessianWork(double mult, const double *x,
+                                 const LTHessStor *stor, double *values,
+                                 NlWork *w, int *error) const;
+
     /**
      * \brief Fill sparsity of hessian into hessian storage.
      *
@@ -136,6 +208,19 @@ namespace Minotaur {
      */
     virtual void fillJac(const double *x, double *values, int *error) = 0;
 
+    /// Same as fillJac(), but use a workspace. See evalWork().
+    virtual void fillJacWork(const double *x, double *values, NlWork *w,
+                             int *error) const;
+
+    /**
+     * \brief Add gradients at k points to the jacobian. Arguments are the
+     * same as in evalBatch(). The jacobian values of point j start at
+     * values+j*nz.
+     */
+    virtual void fillJacBatch(const double *x, UInt n, UInt k,
+                              double *values, UInt nz, NlWork *w,
+                              int *error) const;
+
     /**
      * \brief Finalize hessian preparation. 
      *
@@ -200,6 +285,15 @@ namespace Minotaur {
      */
     virtual void multiply(double c) = 0;
 
+    /**
+     * \brief Create a workspace for evaluating this function with
+     * evalWork(), evalGradientWork(), fillJacWork() and evalHessianWork().
+     *
+     * \return A new workspace that must be deleted by the caller. NULL if
+     * this function does not support evaluation with workspaces.
+     */
+    virtual NlWork* newWork() const;
+
     /// Return the number of variables in this function.
     virtual UInt numVars() { return vars_.size(); };
 
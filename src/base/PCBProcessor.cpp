@@ -23,6 +23,7 @@
 #include "Logger.h"
 #include "Node.h"
 #include "Option.h"
+#include "Profiler.h"
 #include "Modification.h"
 #include "Relaxation.h"
 #include "SolutionPool.h"
@@ -48,6 +49,7 @@ PCBProcessor::PCBProcessor (EnvPtr env, EnginePtr engine, HandlerVector handlers
   handlers_ = handlers;
   logger_ = env->getLogger();
   presFreq_ = env->getOptions()-> findInt("pres_freq")->getValue();
+  prof_ = env->getProfiler();
   stats_.bra = 0;
   stats_.inf = 0;
   stats_.opt = 0;
@@ -140,6 +142,7 @@ bool PCBProcessor::presolveNode_(NodePtr node, SolutionPoolPtr s_pool)
   if (presFreq_<1 || node->getId()%presFreq_!=0) {
     return false;
   } 
+  ProfScope ps(prof_, "presolve");
   // TODO: make this more sophisticated: loop several times until no more
   // changes are possible.
   for (it=0; it<max_iter && true==cont; ++it) {
@@ -279,6 +282,7 @@ void PCBProcessor::process(NodePtr node, RelaxationPtr rel,
 
     if (iter == 1 && !node->getParent()) {
       // in root, in first iteration, run a heuristic. XXX: better management.
+      ProfScope ps(prof_, "heuristic");
       for (HeurVector::iterator it=heurs_.begin(); it!=heurs_.end(); ++it) {
         (*it)->solve(node, rel, s_pool);
       }
@@ -303,8 +307,11 @@ void PCBProcessor::process(NodePtr node, RelaxationPtr rel,
       if (ws_) {
         ws_->incrUseCnt();
       }
-      branches_ = brancher_->findBranches(relaxation_, node, sol, s_pool, 
-                                          br_status, mods);
+      {
+        ProfScope ps(prof_, "branch");
+        branches_ = brancher_->findBranches(relaxation_, node, sol, s_pool, 
+                                            br_status, mods);
+      }
       if (br_status==PrunedByBrancher) {
 
         should_prune = true;
@@ -348,6 +355,7 @@ void PCBProcessor::process(NodePtr node, RelaxationPtr rel,
 void PCBProcessor::separate_(ConstSolutionPtr sol, NodePtr node, 
                             SolutionPoolPtr s_pool, SeparationStatus *status) 
 {
+  ProfScope ps(prof_, "separate");
   ModVector mods;
   HandlerIterator h;
   SeparationStatus st = SepaContinue;
@@ -517,6 +525,7 @@ bool PCBProcessor::shouldPrune_(NodePtr node, double solval,
 
 void PCBProcessor::solveRelaxation_() 
 {
+  ProfScope ps(prof_, "solve");
   engineStatus_ = EngineError;
   engine_->solve();
   engineStatus_ = engine_->getStatus();
@@ -20,6 +20,7 @@
 namespace Minotaur {
 
   class CutManager;
+  class Profiler;
   //class Problem;
 
   struct NodeStats {
@@ -116,6 +117,9 @@ namespace Minotaur {
       /// all nodes. If 0, then never. If 4, then every fourth node, etc.
       int presFreq_;
 
+      /// Profiler for timing the steps of processing. NULL if not profiling.
+      Profiler *prof_;
+
       /// How many new solutions were found by the processor.
       UInt numSolutions_;
 
@@ -10,10 +10,12 @@
  * \author Prashant Palkar, IIT Bombay
  */
 
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
 #include <sstream>
 #include <string>
+#include <unistd.h>
 #if USE_OPENMP
 #include <omp.h>
 #else
@@ -29,10 +31,12 @@
 #include "NodeRelaxer.h"
 #include "Option.h"
 #include "ParPCBProcessor.h"
+#include "ParPseudoCosts.h"
 #include "ParBranchAndBound.h"
 #include "ParNodeIncRelaxer.h"
 #include "ParTreeManager.h"
 #include "Problem.h"
+#include "Profiler.h"
 #include "Relaxation.h"
 #include "Solution.h"
 #include "SolutionPool.h"
@@ -73,7 +77,7 @@ ParBranchAndBound::ParBranchAndBound(EnvPtr env, ProblemPtr p)
     stats_(0),
     status_(NotStarted)
 {
-  timer_ = env->getNewTimer();
+  timer_ = env->getNewWallTimer();
   tm_ = (ParTreeManagerPtr) new ParTreeManager(env);
   options_ = (ParBabOptionsPtr) new ParBabOptions(env);
   logger_ = env->getLogger();
@@ -582,8 +586,10 @@ void ParBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
   stats_ = new ParBabStats();
 
   // initialize solution pool
-  // TODO: use user options to set the pool size. For now it is 1.
-  solPool_ = (SolutionPoolPtr) new SolutionPool(env_, problem_, 1);
+  solPool_ = (SolutionPoolPtr) new SolutionPool(env_, problem_,
+    env_->getOptions()->findInt("sol_pool_size")->getValue());
+  // prune with new solutions as soon as a thread finds them.
+  solPool_->addListener(tm_);
 
   rel[0] = parNodeRlxr[0]->getRelaxation();
 
@@ -629,21 +635,22 @@ void ParBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
   if (nodePrcssr[0]->getBrancher()->getName() == "ParReliabilityBrancher") {
     isParRel = true;
   }
+  ParPseudoCosts pcosts(isParRel ? numVars : 0);
+  if (isParRel) {
+    for (UInt j=0; j<numThreads; ++j) {
+      dynamic_cast <ParReliabilityBrancher*> (nodePrcssr[j]->getBrancher())
+        ->setSharedPCosts(&pcosts);
+    }
+  }
 
   UInt i=0; // thread id
 #pragma omp parallel private(i)
   {
     i = omp_get_thread_num();
-    ParReliabilityBrancherPtr parRelBr;
-    UIntVector tmpTimesUp, tmpTimesDown, timesUp, timesDown, lastStrBranched;
-    DoubleVector tmpPseudoUp, tmpPseudoDown, pseudoUp, pseudoDown;
-    if (isParRel) {
-      timesUp.resize(numVars,0);
-      timesDown.resize(numVars,0);
-      pseudoUp.resize(numVars,0);
-      pseudoDown.resize(numVars,0);
-      lastStrBranched.resize(numVars,0);
-    }
+    // pseudo costs are read from pcosts by the brancher.
+    UIntVector timesUp, timesDown;
+    DoubleVector pseudoUp, pseudoDown;
+    UInt nproc; // nodes processed by all threads so far.
  
     while (nodeCountTh[i] > 0 && shouldRun) {
       if (current_node[i]) {
@@ -672,8 +679,7 @@ void ParBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
         if (current_node[i]) {
           nodesProcTh[i]++;
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogDebug) << me_ << "get node "
+          MINOTAUR_LOG(logger_, LogDebug) << me_ << "get node "
             << current_node[i]->getId() << " thread "
             << omp_get_thread_num() << std::endl;
 #endif
@@ -682,60 +688,35 @@ void ParBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
       }
       if (current_node[i]) {
 #if SPEW
-#pragma omp critical (logger)
-        logger_->msgStream(LogInfo) << me_ << "process node "
+        MINOTAUR_LOG(logger_, LogInfo) << me_ << "process node "
           << current_node[i]->getId() << " thread " << omp_get_thread_num() << std::endl;
           //<< me_ << "depth = " << current_node[i]->getDepth() << std::endl
           //<< me_ << "did we dive = " << dived_prev[i] << std::endl;
 #endif
         should_dive[i] = false;
 
+        ProfScope ps(env_->getProfiler(), "node");
         rel[i] = parNodeRlxr[i]->createNodeRelaxation(current_node[i],
                                                       dived_prev[i],
                                                       should_prune[i]);
-        if (isParRel) {
-          for(UInt j = 0; j < numThreads; ++j) {
-            if (i!=j) {
-              parRelBr = dynamic_cast <ParReliabilityBrancher*> (nodePrcssr[j]->getBrancher());
-              tmpTimesUp = parRelBr->getTimesUp();
-              tmpTimesDown = parRelBr->getTimesDown();
-              tmpPseudoUp = parRelBr->getPCUp();
-              tmpPseudoDown = parRelBr->getPCDown();
-              for (UInt l=0; l < tmpTimesDown.size(); ++l) {
-                timesUp[l] += tmpTimesUp[l];
-                timesDown[l] += tmpTimesDown[l];
-                pseudoUp[l] += tmpTimesUp[l]*tmpPseudoUp[l];
-                pseudoDown[l] += tmpTimesDown[l]*tmpPseudoDown[l];
-              }
-            }
-          }
-        }
+#pragma omp atomic read
+        nproc = stats_->nodesProc;
         nodePrcssr[i]->process(current_node[i], rel[i], solPool_,
                                initialized[i], timesUp, timesDown,
-                               pseudoUp, pseudoDown, stats_->nodesProc);
-#pragma omp critical (stats)
-        {
-          ++stats_->nodesProc;
-        }
+                               pseudoUp, pseudoDown, nproc);
+#pragma omp atomic
+        ++stats_->nodesProc;
 #if SPEW
-#pragma omp critical (logger)
-        logger_->msgStream(LogDebug1) << me_ << "node " 
+        MINOTAUR_LOG(logger_, LogDebug1) << me_ << "node " 
           << current_node[i]->getId() << " lower bound = "
           << current_node[i]->getLb() << " thread " 
           << omp_get_thread_num() << std::endl;
 #endif
-        if (nodePrcssr[i]->foundNewSolution()) {
-#pragma omp critical (treeManager)
-          {
-            tm_->setUb(solPool_->getBestSolutionValue());
-          }
-        }
         should_prune[i] = shouldPrune_(current_node[i]);
 
         if (should_prune[i]) {
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogInfo) << me_ << "prune node "
+          MINOTAUR_LOG(logger_, LogInfo) << me_ << "prune node "
             << current_node[i]->getId() << " thread "
             << omp_get_thread_num() << std::endl;
 #endif
@@ -755,8 +736,7 @@ void ParBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
               tm_->removeActiveNode(new_node[i]);
               nodesProcTh[i]++;
 #if SPEW
-#pragma omp critical (logger)
-              logger_->msgStream(LogDebug) << me_ << "get node "
+              MINOTAUR_LOG(logger_, LogDebug) << me_ << "get node "
                 << new_node[i]->getId() << " (prune) thread "
                 << omp_get_thread_num() << std::endl;
 #endif
@@ -766,8 +746,7 @@ void ParBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
         } else {
           initialized[i] = true;
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogDebug) << me_ << "branch at node "
+          MINOTAUR_LOG(logger_, LogDebug) << me_ << "branch at node "
             << current_node[i]->getId() << " thread "
             << omp_get_thread_num() << std::endl;
 #endif
@@ -784,8 +763,7 @@ void ParBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
 #pragma omp critical (current_node)
             new_node[i] = tm_->branch(branches[i], current_node[i], ws[i]);
 #if SPEW
-#pragma omp critical (logger)
-            logger_->msgStream(LogDebug) << me_ << "get node "
+            MINOTAUR_LOG(logger_, LogDebug) << me_ << "get node "
               << new_node[i]->getId() << " (branch) thread " << omp_get_thread_num()
               << std::endl;
 #endif
@@ -804,8 +782,7 @@ void ParBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
               if (new_node[i]) {
                 tm_->removeActiveNode(new_node[i]);
 #if SPEW
-#pragma omp critical (logger)
-                logger_->msgStream(LogDebug) << me_ << "get/remove node "
+                MINOTAUR_LOG(logger_, LogDebug) << me_ << "get/remove node "
                   << new_node[i]->getId() << " thread "
                   << omp_get_thread_num() << std::endl;
 #endif
@@ -881,8 +858,7 @@ void ParBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
         shouldRun = false;
       } else {
 #if SPEW
-#pragma omp critical (logger)
-        logger_->msgStream(LogInfo) << "nodesCount " << nodeCountThread << " thread " << i << std::endl;
+        MINOTAUR_LOG(logger_, LogInfo) << "nodesCount " << nodeCountThread << " thread " << i << std::endl;
         logger_->msgStream(LogDebug) << std::setprecision(8)
           << me_ << "lb = " << tm_->updateLb() << std::endl
           << me_ << "ub = " << tm_->getUb() << std::endl;
@@ -903,6 +879,13 @@ void ParBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
     << me_ << "nodes processed = " << stats_->nodesProc << std::endl
     << me_ << "nodes created   = " << tm_->getSize() << std::endl;
   solPool_->writeStats(logger_->msgStream(LogExtraInfo));
+  // pcosts is not valid after this function returns.
+  if (isParRel) {
+    for (UInt j=0; j<numThreads; ++j) {
+      dynamic_cast <ParReliabilityBrancher*> (nodePrcssr[j]->getBrancher())
+        ->setSharedPCosts(0);
+    }
+  }
 
   stats_->timeUsed = timer_->query();
   timer_->stop();
@@ -995,8 +978,10 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
   stats_ = new ParBabStats();
 
   // initialize solution pool
-  // TODO: use user options to set the pool size. For now it is 1.
-  solPool_ = (SolutionPoolPtr) new SolutionPool(env_, problem_, 1);
+  solPool_ = (SolutionPoolPtr) new SolutionPool(env_, problem_,
+    env_->getOptions()->findInt("sol_pool_size")->getValue());
+  // prune with new solutions as soon as a thread finds them.
+  solPool_->addListener(tm_);
 
   rel[0] = parNodeRlxr[0]->getRelaxation();
 
@@ -1045,6 +1030,13 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
   if (nodePrcssr[0]->getBrancher()->getName() == "ParReliabilityBrancher") {
     isParRel = true;
   }
+  ParPseudoCosts pcosts(isParRel ? numVars : 0);
+  if (isParRel) {
+    for (UInt j=0; j<numThreads; ++j) {
+      dynamic_cast <ParReliabilityBrancher*> (nodePrcssr[j]->getBrancher())
+        ->setSharedPCosts(&pcosts);
+    }
+  }
 
   // memory leak check: remove later
   if (numThreads > 1) {
@@ -1061,16 +1053,10 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
     {
 #pragma omp for
       for(UInt i = 0; i < numThreads; ++i) {
-        ParReliabilityBrancherPtr parRelBr;
-        UIntVector tmpTimesUp, tmpTimesDown, timesUp, timesDown, lastStrBranched;
-        DoubleVector tmpPseudoUp, tmpPseudoDown, pseudoUp, pseudoDown;
-        if (isParRel) {
-          timesUp.resize(numVars,0);
-          timesDown.resize(numVars,0);
-          pseudoUp.resize(numVars,0);
-          pseudoDown.resize(numVars,0);
-          lastStrBranched.resize(numVars,0);
-        }
+        // pseudo costs are read from pcosts by the brancher.
+        UIntVector timesUp, timesDown;
+        DoubleVector pseudoUp, pseudoDown;
+        UInt nproc; // nodes processed by all threads so far.
         if (current_node[i]) {
 //#if SPEW
 //#pragma omp critical (logger)
@@ -1104,60 +1090,35 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
         }
         if (current_node[i]) {
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogInfo) << me_ << "process node "
+          MINOTAUR_LOG(logger_, LogInfo) << me_ << "process node "
             << current_node[i]->getId() << " thread " << omp_get_thread_num() << std::endl
             << me_ << "depth = " << current_node[i]->getDepth() << std::endl
             << me_ << "did we dive = " << dived_prev[i] << std::endl;
 #endif
           should_dive[i] = false;
 
+          ProfScope ps(env_->getProfiler(), "node");
           rel[i] = parNodeRlxr[i]->createNodeRelaxation(current_node[i],
                                                         dived_prev[i],
                                                         should_prune[i]);
-          if (isParRel) {
-            for(UInt j = 0; j < numThreads; ++j) {
-              if (i!=j) {
-                parRelBr = dynamic_cast <ParReliabilityBrancher*> (nodePrcssr[j]->getBrancher());
-                tmpTimesUp = parRelBr->getTimesUp();
-                tmpTimesDown = parRelBr->getTimesDown();
-                tmpPseudoUp = parRelBr->getPCUp();
-                tmpPseudoDown = parRelBr->getPCDown();
-                for (UInt l=0; l < tmpTimesDown.size(); ++l) {
-                  timesUp[l] += tmpTimesUp[l];
-                  timesDown[l] += tmpTimesDown[l];
-                  pseudoUp[l] += tmpTimesUp[l]*tmpPseudoUp[l];
-                  pseudoDown[l] += tmpTimesDown[l]*tmpPseudoDown[l];
-                }
-              }
-            }
-          }
+#pragma omp atomic read
+          nproc = stats_->nodesProc;
           nodePrcssr[i]->process(current_node[i], rel[i], solPool_,
                                  initialized[i], timesUp, timesDown,
-                                 pseudoUp, pseudoDown, stats_->nodesProc);
-#pragma omp critical (stats)
-          {
-            ++stats_->nodesProc;
-          }
+                                 pseudoUp, pseudoDown, nproc);
+#pragma omp atomic
+          ++stats_->nodesProc;
 
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogDebug1) << me_ << "node lower bound = " <<
+          MINOTAUR_LOG(logger_, LogDebug1) << me_ << "node lower bound = " <<
             current_node[i]->getLb() << current_node[i]->getId() << " thread "
             << omp_get_thread_num()<< std::endl;
 #endif
-          if (nodePrcssr[i]->foundNewSolution()) {
-#pragma omp critical (treeManager)
-            {
-              tm_->setUb(solPool_->getBestSolutionValue());
-            }
-          }
           should_prune[i] = shouldPrune_(current_node[i]);
 
           if (should_prune[i]) {
 #if SPEW
-#pragma omp critical (logger)
-            logger_->msgStream(LogInfo) << me_ << "prune node "
+            MINOTAUR_LOG(logger_, LogInfo) << me_ << "prune node "
               << current_node[i]->getId() << " thread "
               << omp_get_thread_num() << std::endl;
 #endif
@@ -1172,8 +1133,7 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
               new_node[i] = tm_->getCandidate();
               if (new_node[i]) {
 #if SPEW
-#pragma omp critical (logger)
-                logger_->msgStream(LogDebug) << me_ << "get node "
+                MINOTAUR_LOG(logger_, LogDebug) << me_ << "get node "
                   << new_node[i]->getId() << " (prune) thread "
                   << omp_get_thread_num() << std::endl;
 #endif
@@ -1187,8 +1147,7 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
           } else {
             initialized[i] = true;
 #if SPEW
-#pragma omp critical (logger)
-            logger_->msgStream(LogDebug) << me_ << "branch at node "
+            MINOTAUR_LOG(logger_, LogDebug) << me_ << "branch at node "
               << current_node[i]->getId() << " thread "
               << omp_get_thread_num() << std::endl;
 #endif
@@ -1204,8 +1163,7 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
             {
               new_node[i] = tm_->branch(branches[i], current_node[i], ws[i]);
 #if SPEW
-#pragma omp critical (logger)
-              logger_->msgStream(LogDebug) << me_ << "get node "
+              MINOTAUR_LOG(logger_, LogDebug) << me_ << "get node "
                 << new_node[i]->getId() << " (branch) thread " << omp_get_thread_num()
                 << std::endl;
 #endif
@@ -1224,8 +1182,7 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
                 if (new_node[i]) {
                   tm_->removeActiveNode(new_node[i]);
 #if SPEW
-#pragma omp critical (logger)
-                  logger_->msgStream(LogDebug) << me_ << "get/remove node "
+                  MINOTAUR_LOG(logger_, LogDebug) << me_ << "get/remove node "
                     << new_node[i]->getId() << " thread "
                     << omp_get_thread_num() << std::endl;
 #endif
@@ -1306,8 +1263,7 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
             status_ = SolvedInfeasible; // TODO: get the right status
           }
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogDebug) << me_ << "all nodes have "
+          MINOTAUR_LOG(logger_, LogDebug) << me_ << "all nodes have "
             << "been processed" << std::endl;
 #endif
         } else if (shouldStopPar_(wallTimeStart, treeLb)) {
@@ -1315,8 +1271,7 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
           shouldRun = false;
         } else {
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogDebug) << std::setprecision(8)
+          MINOTAUR_LOG(logger_, LogDebug) << std::setprecision(8)
             << me_ << "lb = " << tm_->updateLb() << std::endl 
             << me_ << "ub = " << tm_->getUb() << std::endl;
 #endif
@@ -1333,6 +1288,13 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
       << std::endl;
   //}
   solPool_->writeStats(logger_->msgStream(LogExtraInfo));
+  // pcosts is not valid after this function returns.
+  if (isParRel) {
+    for (UInt j=0; j<numThreads; ++j) {
+      dynamic_cast <ParReliabilityBrancher*> (nodePrcssr[j]->getBrancher())
+        ->setSharedPCosts(0);
+    }
+  }
 
   stats_->timeUsed = timer_->query();
   timer_->stop();
@@ -1368,6 +1330,257 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
 }
 
 
+void ParBranchAndBound::parsolveSteal(ParNodeIncRelaxerPtr parNodeRlxr[],
+                                      ParPCBProcessorPtr nodePrcssr[],
+                                      UInt numThreads)
+{
+  double wallTimeStart = getWallTime();
+  bool *dived_prev = new bool[numThreads];
+  bool *should_prune = new bool[numThreads];
+  bool *initialized = new bool[numThreads];
+  NodePtr *current_node = new NodePtr[numThreads]();
+  Branches *branches = new Branches[numThreads]();
+  WarmStartPtr *ws = new WarmStartPtr[numThreads]();
+  RelaxationPtr *rel = new RelaxationPtr[numThreads];
+  UInt *nodesProcTh = new UInt[numThreads];
+  UInt numVars = 0;
+  bool shouldRun = true;
+
+  omp_set_num_threads(numThreads);
+  for(UInt i = 0; i < numThreads; ++i) {
+    dived_prev[i] = false;
+    should_prune[i] = false;
+    initialized[i] = false;
+    nodesProcTh[i] = 0;
+  }
+
+  // initialize timer
+  timer_->start();
+
+  logger_->msgStream(LogInfo) << me_ << "starting branch-and-bound ";
+  if (numThreads > 1) {
+    logger_->msgStream(LogInfo) << "using " << numThreads << " out of "
+      << omp_get_num_procs() << " processors";
+  }
+  logger_->msgStream(LogInfo) << " with work stealing" << std::endl;
+  // get problem size and statistics to detect problem type.
+  problem_->calculateSize();
+#if SPEW
+  problem_->writeSize(logger_->msgStream(LogExtraInfo));
+#endif
+
+  // initialize statistics
+  if (stats_) {
+    delete stats_;
+  }
+  stats_ = new ParBabStats();
+
+  // initialize solution pool
+  solPool_ = (SolutionPoolPtr) new SolutionPool(env_, problem_,
+    env_->getOptions()->findInt("sol_pool_size")->getValue());
+  // prune with new solutions as soon as a thread finds them.
+  solPool_->addListener(tm_);
+
+  rel[0] = parNodeRlxr[0]->getRelaxation();
+
+  // call heuristics before the root, if needed 
+  for (HeurVector::iterator it=preHeurs_.begin(); it!=preHeurs_.end(); ++it) {
+    (*it)->solve(current_node[0], rel[0], solPool_);
+  }
+  tm_->setUb(solPool_->getBestSolutionValue());
+
+  // do the root
+  current_node[0] = (NodePtr) new Node ();
+  processRoot_(&should_prune[0], &dived_prev[0], parNodeRlxr[0],
+                  nodePrcssr[0], ws[0], current_node[0]);
+  // stop if done
+  if (!current_node[0]) {
+    tm_->updateLb();
+    if (tm_->getUb() <= -INFINITY) {
+      status_ = SolvedUnbounded;
+    } else  if (tm_->getUb() < INFINITY) {
+      status_ = SolvedOptimal; 
+    } else {
+      status_ = SolvedInfeasible; 
+    }
+#if SPEW
+    logger_->msgStream(LogDebug) << me_ << "stopping after root node "
+      << std::endl;
+#endif
+    shouldRun = false;
+  } else if (shouldStopPar_(wallTimeStart, tm_->getLb())) {
+    tm_->updateLb();
+    shouldRun = false;
+  }
+
+  // from now on, each thread has its own store of nodes and the tree
+  // manager is not locked as a whole.
+  tm_->setWorkStealing(numThreads, current_node[0]);
+
+  initialized[0] = true; //pseudoCosts for thread0 initialized while doing root
+  numVars = rel[0]->getNumVars();
+  bool isParRel = false;
+  if (nodePrcssr[0]->getBrancher()->getName() == "ParReliabilityBrancher") {
+    isParRel = true;
+  }
+  ParPseudoCosts pcosts(isParRel ? numVars : 0);
+  if (isParRel) {
+    for (UInt j=0; j<numThreads; ++j) {
+      dynamic_cast <ParReliabilityBrancher*> (nodePrcssr[j]->getBrancher())
+        ->setSharedPCosts(&pcosts);
+    }
+  }
+
+  UInt i=0; // thread id
+#pragma omp parallel private(i)
+  {
+    i = omp_get_thread_num();
+    // pseudo costs are read from pcosts by the brancher.
+    UIntVector timesUp, timesDown;
+    DoubleVector pseudoUp, pseudoDown;
+    UInt nproc; // nodes processed by all threads so far.
+    NodePtr new_node;
+    double treeLb;
+    bool run;
+    UInt idle = 0; // consecutive failures to find a node.
+
+#pragma omp atomic read
+    run = shouldRun;
+    while (run && tm_->anyOpenNodesPar()) {
+      if (current_node[i]) {
+        if (tm_->shouldPrunePar_(current_node[i])) {
+          parNodeRlxr[i]->reset(current_node[i], false);
+          tm_->pruneNodePar(current_node[i]);
+          current_node[i] = NodePtr();
+        }
+      } else {
+        current_node[i] = tm_->getCandidatePar(i);
+        dived_prev[i] = false;
+        idle = current_node[i] ? 0 : idle+1;
+      }
+      if (current_node[i]) {
+        nodesProcTh[i]++;
+#if SPEW
+        MINOTAUR_LOG(logger_, LogInfo) << me_ << "process node "
+          << current_node[i]->getId() << " thread " << i << std::endl;
+#endif
+        ProfScope ps(env_->getProfiler(), "node");
+        rel[i] = parNodeRlxr[i]->createNodeRelaxation(current_node[i],
+                                                      dived_prev[i],
+                                                      should_prune[i]);
+#pragma omp atomic read
+        nproc = stats_->nodesProc;
+        nodePrcssr[i]->process(current_node[i], rel[i], solPool_,
+                               initialized[i], timesUp, timesDown,
+                               pseudoUp, pseudoDown, nproc);
+#pragma omp atomic
+        ++stats_->nodesProc;
+        should_prune[i] = shouldPrune_(current_node[i]);
+
+        if (should_prune[i]) {
+          parNodeRlxr[i]->reset(current_node[i], false);
+          tm_->pruneNodePar(current_node[i]);
+          current_node[i] = NodePtr();
+          dived_prev[i] = false;
+        } else {
+          initialized[i] = true;
+          branches[i] = nodePrcssr[i]->getBranches();
+          ws[i] = nodePrcssr[i]->getWarmStart();
+          if (!branches[i]) {
+            logger_->msgStream(LogDebug) << " NO BRANCHES \n";
+          }
+          // new_node is NULL if we do not dive. Then the next node comes
+          // from the store of this thread or from some other thread.
+          new_node = tm_->branchPar(branches[i], current_node[i], ws[i], i);
+          if (new_node) {
+            dived_prev[i] = true;
+          } else {
+            parNodeRlxr[i]->reset(current_node[i], false);
+            dived_prev[i] = false;
+          }
+          current_node[i] = new_node;
+        }
+      } // if (current_node[i]) ends
+
+      // an idle thread updates its bound once. After that, the threads
+      // with nodes update the bound and check the limits.
+      if (idle < 2) {
+        treeLb = tm_->updateLbPar(i, current_node[i]);
+#pragma omp critical (logger)
+        {
+          if (current_node[i]) {
+            showParStatus_(1, treeLb, wallTimeStart, i);
+          }
+          if (shouldStopPar_(wallTimeStart, treeLb)) {
+#pragma omp atomic write
+            shouldRun = false;
+          }
+        }
+      }
+      if (idle > 0) {
+        // nothing to steal. Back off so that the threads holding nodes get
+        // the locks, but not longer than a millisecond.
+        usleep(50*std::min(idle, (UInt) 20));
+      }
+#pragma omp atomic read
+      run = shouldRun;
+    } //while ends
+  }   //parallel region ends
+
+  if (shouldRun) {
+    // all nodes have been processed.
+    tm_->getLbPar();
+    if (tm_->getUb() <= -INFINITY) {
+      status_ = SolvedUnbounded;
+    } else if (tm_->getUb() < INFINITY) {
+      status_ = SolvedOptimal;
+    } else {
+      status_ = SolvedInfeasible;
+    }
+  }
+  logger_->msgStream(LogExtraInfo) << me_ << "stopping branch-and-bound"
+    << std::endl
+    << me_ << "nodes processed = " << stats_->nodesProc << std::endl
+    << me_ << "nodes created   = " << tm_->getSize() << std::endl
+    << me_ << "nodes stolen    = " << tm_->getNumSteals() << std::endl;
+#if SPEW
+  for (UInt j=0; j < numThreads; ++j) {
+    logger_->msgStream(LogInfo) << "nodesProc " << nodesProcTh[j]
+      << " thread " << j << std::endl;
+  }
+#endif
+  solPool_->writeStats(logger_->msgStream(LogExtraInfo));
+  // pcosts is not valid after this function returns.
+  if (isParRel) {
+    for (UInt j=0; j<numThreads; ++j) {
+      dynamic_cast <ParReliabilityBrancher*> (nodePrcssr[j]->getBrancher())
+        ->setSharedPCosts(0);
+    }
+  }
+
+  stats_->timeUsed = timer_->query();
+  timer_->stop();
+
+  for (UInt j=0; j < numThreads; j++) {
+    if (current_node[j]) {
+      // undo the changes of the node in the relaxation of thread j, as
+      // when a node is pruned during the search.
+      parNodeRlxr[j]->reset(current_node[j], false);
+      tm_->pruneNodePar(current_node[j]);
+      current_node[j] = 0;
+    }
+  }
+  delete[] dived_prev;
+  delete[] should_prune;
+  delete[] initialized;
+  delete[] current_node;
+  delete[] nodesProcTh;
+  delete[] ws;
+  delete[] rel;
+  delete[] branches;
+}
+
+
 void ParBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
                                  ParPCBProcessorPtr nodePrcssr[],
                                  UInt numThreads)
@@ -1425,8 +1638,8 @@ void ParBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
   stats_ = new ParBabStats();
 
   // initialize solution pool
-  // TODO: use user options to set the pool size. For now it is 1.
-  solPool_ = (SolutionPoolPtr) new SolutionPool(env_, problem_, 1);
+  solPool_ = (SolutionPoolPtr) new SolutionPool(env_, problem_,
+    env_->getOptions()->findInt("sol_pool_size")->getValue());
 
   rel[0] = parNodeRlxr[0]->getRelaxation();
 
@@ -1495,8 +1708,7 @@ void ParBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
     for(UInt i = 0; i < numThreads; ++i) {
       if (current_node[i]) {
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogDebug1) << me_ << "process node "
+          MINOTAUR_LOG(logger_, LogDebug1) << me_ << "process node "
             << current_node[0]->getId() << std::endl
             << me_ << "depth = " << current_node[0]->getDepth() << std::endl
             << me_ << "did we dive = " << dived_prev[0] << std::endl;
@@ -1507,8 +1719,7 @@ void ParBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
           current_node[i] = tm_->getCandidate();
           if (current_node[i]) {
 #if SPEW
-#pragma omp critical (logger)
-            logger_->msgStream(LogDebug1) << "assign node " << current_node[i]->getId() << " score "
+            MINOTAUR_LOG(logger_, LogDebug1) << "assign node " << current_node[i]->getId() << " score "
               << (int)current_node[i]->getTbScore() << " lb "
               << current_node[i]->getLb() << " thread " << omp_get_thread_num() << "\n";
 #endif
@@ -1525,25 +1736,28 @@ void ParBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
       // NODE SOLVING
 #pragma omp for
       for (UInt i = 0; i < numThreads; ++i) {
-        UIntVector tmpTimesUp, tmpTimesDown, timesUp, timesDown, lastStrBranched;
-        DoubleVector tmpPseudoUp, tmpPseudoDown, pseudoUp, pseudoDown;
+        UIntVector timesUp, timesDown, lastStrBranched;
+        DoubleVector pseudoUp, pseudoDown;
+        UInt nproc; // nodes processed by all threads so far.
 
         if (current_node[i]) {
           should_dive[i] = false;
+          ProfScope ps(env_->getProfiler(), "node");
           rel[i] = parNodeRlxr[i]->createNodeRelaxation(current_node[i],
                                                         dived_prev[i],
                                                         should_prune[i]);
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogInfo) << me_ << "process node "
+          MINOTAUR_LOG(logger_, LogInfo) << me_ << "process node "
             << current_node[i]->getId() << " score "
             << (int)current_node[i]->getTbScore() << " thread "
             << omp_get_thread_num() << std::endl;
 #endif
+#pragma omp atomic read
+          nproc = stats_->nodesProc;
           nodePrcssr[i]->process(current_node[i], rel[i], solPool_,
                                    initialized[i], timesUp, timesDown,
-                                   pseudoUp, pseudoDown, stats_->nodesProc);
-#pragma omp critical (stats)
+                                   pseudoUp, pseudoDown, nproc);
+#pragma omp atomic
           ++stats_->nodesProc;
         } //if current_node[i]
       } //for ends
@@ -1577,8 +1791,7 @@ void ParBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
           //}
           if (should_prune[i]) {
 #if SPEW
-#pragma omp critical (logger)
-            logger_->msgStream(LogInfo) << me_ << "prune node "
+            MINOTAUR_LOG(logger_, LogInfo) << me_ << "prune node "
               << current_node[i]->getId() << " score "
               << (int)current_node[i]->getTbScore() << " thread "
               << omp_get_thread_num() << std::endl;
@@ -1593,8 +1806,7 @@ void ParBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
           } else {
             initialized[i] = true;
 #if SPEW
-#pragma omp critical (logger)
-            logger_->msgStream(LogInfo) << me_ << "branch at node "
+            MINOTAUR_LOG(logger_, LogInfo) << me_ << "branch at node "
               << current_node[i]->getId() << " score "
               << (int)current_node[i]->getTbScore() << " thread "
               << omp_get_thread_num() << std::endl;
@@ -1622,8 +1834,7 @@ void ParBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
             {
               new_node[i] = tm_->branch(branches[i], current_node[i], ws[i]);
 #if SPEW
-#pragma omp critical (logger)
-              logger_->msgStream(LogInfo) << me_ << "get node "
+              MINOTAUR_LOG(logger_, LogInfo) << me_ << "get node "
                 << new_node[i]->getId() << " score "
                 << (int)new_node[i]->getTbScore() << " (branch) thread "
                 << omp_get_thread_num() << std::endl;
@@ -1643,8 +1854,7 @@ void ParBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
                 if (new_node[i]) {
                   tm_->removeActiveNode(new_node[i]);
 #if SPEW
-#pragma omp critical (logger)
-              logger_->msgStream(LogInfo) << me_ << "get node "
+              MINOTAUR_LOG(logger_, LogInfo) << me_ << "get node "
                 << new_node[i]->getId() << " score "
                 << (int)new_node[i]->getTbScore() << " (prune) thread "
                 << omp_get_thread_num() << std::endl;
@@ -1688,8 +1898,7 @@ void ParBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
             status_ = SolvedInfeasible; // TODO: get the right status
           }
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogDebug) << me_ << "all nodes have "
+          MINOTAUR_LOG(logger_, LogDebug) << me_ << "all nodes have "
             << "been processed" << std::endl;
 #endif
         } else if (shouldStopPar_(wallTimeStart, treeLb)) {
@@ -1697,8 +1906,7 @@ void ParBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
           shouldRun = false;
         } else {
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogDebug) << std::setprecision(8)
+          MINOTAUR_LOG(logger_, LogDebug) << std::setprecision(8)
             << me_ << "lb = " << tm_->updateLb() << std::endl
             << me_ << "ub = " << tm_->getUb() << std::endl;
 #endif
@@ -1758,6 +1966,7 @@ void ParBranchAndBound::writeStats(std::ostream &out)
     (*it)->writeStats(out);
   }
   solPool_->writeStats(out);
+  tm_->writeStats(out);
 }
 
 void ParBranchAndBound::writeParStats(std::ostream &out, ParPCBProcessorPtr nodePrcssr[])
@@ -1773,6 +1982,7 @@ void ParBranchAndBound::writeParStats(std::ostream &out, ParPCBProcessorPtr node
     (*it)->writeStats(out);
   }
   solPool_->writeStats(out);
+  tm_->writeStats(out);
 }
 
 double ParBranchAndBound::totalTime()
@@ -188,6 +188,20 @@ namespace Minotaur {
                   ParPCBProcessorPtr parPCBProcessor[],
                   UInt nThreads);
 
+    /**
+     * \brief Start solving the Problem using parallel branch-and-bound with
+     * a store of nodes for each thread and work stealing.
+     *
+     * Threads do not wait for each other unless one of them runs out of
+     * nodes and all other stores are empty.
+     * \param [in] parNodeRelaxer is the array of node relaxers.
+     * \param [in] parPCBProcessor is the array of node processors.
+     * \param [in] nThreads is the number of threads being used.
+     */
+    void parsolveSteal(ParNodeIncRelaxerPtr parNodeRelaxer[],
+                  ParPCBProcessorPtr parPCBProcessor[],
+                  UInt nThreads);
+
     /**
      * \brief Branch-and-bound solver with reproducibility of results.
      *
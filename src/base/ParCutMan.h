@@ -20,6 +20,8 @@
 
 namespace Minotaur {
 
+class ParCutStore;
+
 /**
  * \brief Derived class for managing cuts. Add and remove cuts based on
  * priority and violation.
@@ -48,6 +50,15 @@ public:
   
   std::vector<ConstraintPtr > getPoolCons();
 
+  /**
+   * \brief Also add each cut sent to the pool to a store shared by all
+   * threads.
+   *
+   * \param [in] store The shared store. NULL to stop sharing.
+   * \param [in] t The thread that owns this cut manager.
+   */
+  void setCutStore(ParCutStore *store, UInt t);
+
   ConstraintPtr addCut(ProblemPtr, FunctionPtr, double, double, 
                        bool, bool) {return ConstraintPtr();};
 
@@ -119,6 +130,12 @@ private:
 
   CutList pool_;
 
+  /// Shared store of cuts of all threads. NULL if cuts are not shared.
+  ParCutStore *store_;
+
+  /// Thread that owns this cut manager, used as its id in store_.
+  UInt storeId_;
+
   void addToRel_(CutPtr cons, bool new_cut);
 
   void addToPool_(CutPtr cons);
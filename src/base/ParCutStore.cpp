@@ -0,0 +1,292 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2008 - 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file ParCutStore.cpp
+ * \brief Define class ParCutStore for sharing linear cuts among the threads
+ * of a parallel branch-and-bound.
+ * \author The MINOTAUR Team
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "MinotaurConfig.h"
+#include "Cut.h"
+#include "Environment.h"
+#include "Function.h"
+#include "LinearFunction.h"
+#include "Option.h"
+#include "ParCutStore.h"
+#include "Relaxation.h"
+#include "Variable.h"
+
+using namespace Minotaur;
+
+const std::string ParCutStore::me_ = "ParCutStore: ";
+
+ParCutStore::ParCutStore(EnvPtr env, UInt nthreads)
+  : cursor_(nthreads, 0),
+    dups_(0),
+    imported_(0),
+    match_(nthreads, 0),
+    rels_(nthreads, RelaxationPtr())
+{
+  OptionDBPtr options = env->getOptions();
+  int k;
+
+  k = options->findInt("mcbnb_cut_age")->getValue();
+  maxAge_ = (k > 0) ? k : 0;
+  k = options->findInt("mcbnb_cut_import")->getValue();
+  maxImport_ = (k > 0) ? k : 0;
+}
+
+
+ParCutStore::~ParCutStore()
+{
+  for (UInt i=0; i<cuts_.size(); ++i) {
+    delete cuts_[i];
+  }
+  cuts_.clear();
+  hashes_.clear();
+}
+
+
+bool ParCutStore::add(CutPtr cut, UInt t)
+{
+  FunctionPtr f = cut->getFunction();
+  LinearFunctionPtr lf;
+  StoredCut_ *c;
+  std::vector<std::pair<UInt, double> > terms;
+  double norm = 0.0;
+  bool is_new = true;
+  UInt h;
+
+  if (t>=match_.size() || 0==match_[t]) {
+    return false;
+  }
+  if (!f || f->getType()!=Linear || !(lf = f->getLinearFunction())) {
+    return false;
+  }
+  terms.reserve(lf->getNumTerms());
+  for (VariableGroupConstIterator it=lf->termsBegin(); it!=lf->termsEnd();
+       ++it) {
+    // names_ does not change once thread t is checked.
+    if (it->first->getIndex() >= names_.size()) {
+      return false;
+    }
+    terms.push_back(std::make_pair(it->first->getIndex(), it->second));
+    norm += it->second*it->second;
+  }
+  std::sort(terms.begin(), terms.end());
+
+  c = new StoredCut_();
+  c->idx.reserve(terms.size());
+  c->coef.reserve(terms.size());
+  for (UInt i=0; i<terms.size(); ++i) {
+    c->idx.push_back(terms[i].first);
+    c->coef.push_back(terms[i].second);
+  }
+  c->lb = cut->getLb();
+  c->ub = cut->getUb();
+  c->eff = 0.0;
+  if (cut->getInfo()->fixedScore > 0.0 && norm > 0.0) {
+    c->eff = cut->getInfo()->fixedScore/sqrt(norm);
+  }
+  c->owner = t;
+  h = hash_(c);
+
+#pragma omp critical (parCutStore)
+  {
+    UIntVector &same_h = hashes_[h];
+    for (UInt i=0; i<same_h.size(); ++i) {
+      if (same_(c, cuts_[same_h[i]])) {
+        is_new = false;
+        break;
+      }
+    }
+    if (is_new) {
+      same_h.push_back(cuts_.size());
+      cuts_.push_back(c);
+    } else {
+      ++dups_;
+    }
+  }
+
+  if (!is_new) {
+    delete c;
+  }
+  return is_new;
+}
+
+
+UInt ParCutStore::addNewCuts(RelaxationPtr rel, UInt t)
+{
+  std::vector<StoredCut_ *> fresh;
+  StoredCut_ *c;
+  LinearFunctionPtr lf;
+  UInt n = rel->getNumVars();
+  UInt first, last, cnt = 0;
+  bool ok;
+
+  if (t>=cursor_.size()) {
+    return 0;
+  }
+  if (rels_[t]!=rel) {
+#pragma omp critical (parCutStore)
+    match_[t] = checkVars_(rel) ? 1 : 0;
+    rels_[t] = rel;
+  }
+  if (0==match_[t]) {
+    return 0;
+  }
+
+#pragma omp critical (parCutStore)
+  {
+    last = cuts_.size();
+    first = cursor_[t];
+    if (last > maxAge_ && first < last-maxAge_) {
+      first = last-maxAge_;
+    }
+    // newest first. cuts_ may be reallocated by other threads, but the
+    // cuts themselves never change, so only the pointers are copied here.
+    for (UInt i=last; i>first; --i) {
+      if (cuts_[i-1]->owner!=t) {
+        fresh.push_back(cuts_[i-1]);
+      }
+    }
+  }
+  cursor_[t] = last;
+
+  if (fresh.size() > maxImport_) {
+    std::stable_sort(fresh.begin(), fresh.end(), moreEff_);
+    fresh.resize(maxImport_);
+  }
+
+  for (UInt i=0; i<fresh.size(); ++i) {
+    c = fresh[i];
+    ok = true;
+    for (UInt j=0; j<c->idx.size(); ++j) {
+      if (c->idx[j] >= n) {
+        ok = false;
+        break;
+      }
+    }
+    if (!ok) {
+      continue;
+    }
+    lf = (LinearFunctionPtr) new LinearFunction();
+    for (UInt j=0; j<c->idx.size(); ++j) {
+      lf->addTerm(rel->getVariable(c->idx[j]), c->coef[j]);
+    }
+    rel->newConstraint((FunctionPtr) new Function(lf), c->lb, c->ub);
+    ++cnt;
+  }
+
+#pragma omp atomic
+  imported_ += cnt;
+
+  return cnt;
+}
+
+
+bool ParCutStore::checkVars_(RelaxationPtr rel)
+{
+  VariablePtr v;
+  UInt n = rel->getNumVars();
+
+  if (names_.empty() && types_.empty()) {
+    names_.reserve(n);
+    types_.reserve(n);
+    for (VariableConstIterator it=rel->varsBegin(); it!=rel->varsEnd();
+         ++it) {
+      names_.push_back((*it)->getName());
+      types_.push_back((*it)->getType());
+    }
+    return true;
+  }
+  if (n!=names_.size()) {
+    return false;
+  }
+  for (UInt i=0; i<n; ++i) {
+    v = rel->getVariable(i);
+    if (v->getType()!=types_[i] || v->getName()!=names_[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+UInt ParCutStore::getNumCuts()
+{
+  UInt n;
+
+#pragma omp critical (parCutStore)
+  n = cuts_.size();
+  return n;
+}
+
+
+UInt ParCutStore::hash_(const StoredCut_ *c) const
+{
+  UInt h = 2166136261u;
+  UInt w[2];
+
+  for (UInt i=0; i<c->idx.size(); ++i) {
+    h = (h ^ c->idx[i])*16777619u;
+    memcpy(w, &(c->coef[i]), sizeof(double));
+    h = (h ^ w[0])*16777619u;
+    h = (h ^ w[1])*16777619u;
+  }
+  memcpy(w, &(c->ub), sizeof(double));
+  h = (h ^ w[0] ^ w[1])*16777619u;
+  memcpy(w, &(c->lb), sizeof(double));
+  h = (h ^ w[0] ^ w[1])*16777619u;
+  return h;
+}
+
+
+bool ParCutStore::moreEff_(const StoredCut_ *c1, const StoredCut_ *c2)
+{
+  return c1->eff > c2->eff;
+}
+
+
+bool ParCutStore::same_(const StoredCut_ *c1, const StoredCut_ *c2) const
+{
+  return (c1->lb==c2->lb && c1->ub==c2->ub && c1->idx==c2->idx &&
+          c1->coef==c2->coef);
+}
+
+
+void ParCutStore::writeStats(std::ostream &out)
+{
+  UInt nomatch = 0;
+
+  for (UInt t=0; t<rels_.size(); ++t) {
+    if (rels_[t] && 0==match_[t]) {
+      ++nomatch;
+    }
+  }
+  out << me_ << "cuts in store      = " << getNumCuts() << std::endl
+      << me_ << "duplicates skipped = " << dups_ << std::endl
+      << me_ << "cuts imported      = " << imported_ << std::endl
+      << me_ << "threads not sharing = " << nomatch << std::endl;
+}
+
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
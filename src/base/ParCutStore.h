@@ -0,0 +1,180 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2008 - 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file ParCutStore.h
+ * \brief Declare class ParCutStore for sharing linear cuts among the
+ * threads of a parallel branch-and-bound.
+ * \author The MINOTAUR Team
+ */
+
+
+#ifndef MINOTAURPARCUTSTORE_H
+#define MINOTAURPARCUTSTORE_H
+
+#include <iostream>
+#include <map>
+
+#include "Types.h"
+
+namespace Minotaur {
+
+  class Cut;
+  class Relaxation;
+  typedef Cut* CutPtr;
+  typedef Relaxation* RelaxationPtr;
+
+  /**
+   * \brief A store of linear cuts that all threads add to and read from.
+   *
+   * A thread adds each cut it finds with add(). The cut is copied as a list
+   * of variable indices and coefficients, so it does not depend on the
+   * relaxation or the constraint it was found in. A cut that is already in
+   * the store is not added again.
+   *
+   * An index must mean the same variable in the relaxation of each thread.
+   * The first relaxation given to addNewCuts() fixes the variables of the
+   * store: their number, names and types. The relaxation of every other
+   * thread is checked against them when the thread first calls
+   * addNewCuts(). A thread whose relaxation does not match, or that has not
+   * called addNewCuts(), neither adds nor gets cuts. Cuts on variables
+   * added to a relaxation later are not shared.
+   *
+   * Each thread keeps a cursor to the first cut it has not seen. addNewCuts()
+   * takes the cuts after the cursor, leaving out those the thread added
+   * itself, and adds them to the relaxation of the thread. Its cost depends
+   * only on the number of new cuts. If there are more than maxImport new
+   * cuts, those with the highest efficacy are added. Cuts that were added to
+   * the store more than maxAge cuts ago are skipped. maxImport and maxAge are
+   * the options mcbnb_cut_import and mcbnb_cut_age.
+   *
+   * Cuts are never changed or deleted once added, so they are read without
+   * a lock. The list of cuts and the index of hash values are changed only
+   * inside the critical section parCutStore.
+   */
+  class ParCutStore {
+  public:
+    /// Constructor. Threads 0 to nthreads-1 may use the store.
+    ParCutStore(EnvPtr env, UInt nthreads);
+
+    /// Destroy.
+    ~ParCutStore();
+
+    /**
+     * \brief Add a cut found by a thread.
+     *
+     * \param[in] cut The cut. Its function must be linear. If the
+     * fixedScore in its CutInfo is positive, it is taken as the violation
+     * of the cut at the point it separated.
+     * \param[in] t The thread that found the cut.
+     * \return True if the cut was added, false if it was already in the
+     * store, is not linear, or cannot be shared by thread t.
+     */
+    bool add(CutPtr cut, UInt t);
+
+    /**
+     * \brief Add the cuts thread t has not seen to its relaxation.
+     *
+     * Checks the variables of rel against those of the store when rel is
+     * different from the one given by thread t last time.
+     * \param[in] rel The relaxation of thread t.
+     * \param[in] t The thread.
+     * \return The number of constraints added to rel.
+     */
+    UInt addNewCuts(RelaxationPtr rel, UInt t);
+
+    /// Get the number of cuts in the store.
+    UInt getNumCuts();
+
+    /// Write statistics.
+    void writeStats(std::ostream &out);
+
+  private:
+    /// A cut in the store.
+    struct StoredCut_ {
+      /// Variable indices in increasing order.
+      UIntVector idx;
+
+      /// Coefficients of the variables in idx.
+      DoubleVector coef;
+
+      /// Lower bound.
+      double lb;
+
+      /// Upper bound.
+      double ub;
+
+      /// Violation divided by the norm of coef. 0 if not known.
+      double eff;
+
+      /// The thread that added the cut.
+      UInt owner;
+    };
+
+    /// Cuts in the order they were added.
+    std::vector<StoredCut_ *> cuts_;
+
+    /// Position in cuts_ of the first cut each thread has not seen.
+    UIntVector cursor_;
+
+    /// Number of cuts that were not added because they were in the store.
+    UInt dups_;
+
+    /// Positions in cuts_ of the cuts with each hash value.
+    std::map<UInt, UIntVector> hashes_;
+
+    /// Number of cuts added to the relaxations of other threads.
+    UInt imported_;
+
+    /// Cuts added this many cuts before the newest one are not imported.
+    UInt maxAge_;
+
+    /// Maximum number of cuts imported by a thread in one call.
+    UInt maxImport_;
+
+    /**
+     * 1 if the variables of rels_[t] match those of the store, 0 otherwise.
+     * Not a vector<bool>, so that each thread can write its own entry.
+     */
+    UIntVector match_;
+
+    /// For logging.
+    static const std::string me_;
+
+    /// Names of the variables of the store, in the order of their indices.
+    std::vector<std::string> names_;
+
+    /// Relaxation of each thread that was last checked. NULL if none.
+    std::vector<RelaxationPtr> rels_;
+
+    /// Types of the variables of the store.
+    std::vector<VariableType> types_;
+
+    /// Check the variables of rel against the store. Lock must be held.
+    bool checkVars_(RelaxationPtr rel);
+
+    /// Hash value of a cut.
+    UInt hash_(const StoredCut_ *c) const;
+
+    /// Return true if c1 has higher efficacy than c2.
+    static bool moreEff_(const StoredCut_ *c1, const StoredCut_ *c2);
+
+    /// Return true if two cuts have the same terms and bounds.
+    bool same_(const StoredCut_ *c1, const StoredCut_ *c2) const;
+  };
+}
+#endif
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
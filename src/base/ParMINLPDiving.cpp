@@ -400,9 +400,6 @@ void ParMINLPDiving::implementDive_(int i, const double* x, SolutionPoolPtr s_po
 //#endif
             } else {
               logger_->msgStream(LogInfo) << me_ << "NLP feasible!" << std::endl;
-#if USE_OPENMP
-#pragma omp critical (solPool)
-#endif
               s_pool->addSolution(nlpe->getSolution());
 #if USE_OPENMP
 #pragma omp critical (stats)
@@ -425,9 +422,6 @@ void ParMINLPDiving::implementDive_(int i, const double* x, SolutionPoolPtr s_po
 #pragma omp critical (stats)
 #endif
           stats_->best_obj_value = sol->getObjValue();
-#if USE_OPENMP
-#pragma omp critical (solPool)
-#endif
           s_pool->addSolution(sol);
           ++(stats->numSol[i/8]);
           ++(stats->totalSol);
@@ -27,6 +27,7 @@
 #include "Logger.h"
 #include "Node.h"
 #include "Option.h"
+#include "Profiler.h"
 #include "ParCutMan.h"
 #include "Modification.h"
 #include "Relaxation.h"
@@ -81,6 +82,7 @@ ParPCBProcessor::ParPCBProcessor (EnvPtr env, EnginePtr engine,
   handlers_ = handlers;
   logger_ = env->getLogger();
   presFreq_ = env->getOptions()-> findInt("pres_freq")->getValue();
+  prof_ = env->getProfiler();
   stats_.bra = 0;
   stats_.inf = 0;
   stats_.opt = 0;
@@ -160,10 +162,7 @@ bool ParPCBProcessor::isFeasible_(NodePtr node, ConstSolutionPtr sol,
   }
 
   if (is_feas == true && h==handlers_.end()) {
-#pragma omp critical (solPool)
-    {
-      s_pool->addSolution(sol);
-    }
+    s_pool->addSolution(sol);
     ++numSolutions_;
     node->setStatus(NodeOptimal);
     ++stats_.opt;
@@ -191,6 +190,7 @@ bool ParPCBProcessor::presolveNode_(NodePtr node, SolutionPoolPtr s_pool)
   if (presFreq_ < 1 || checkForPresolve) {
     return false;
   } 
+  ProfScope ps(prof_, "presolve");
   // TODO: make this more sophisticated: loop several times until no more
   // changes are possible.
   for (it=0; it<max_iter && true==cont; ++it) {
@@ -304,6 +304,7 @@ void ParPCBProcessor::process(NodePtr node, RelaxationPtr rel,
 
     if (iter == 1 && !node->getParent()) {
       // in root, in first iteration, run a heuristic. XXX: better management.
+      ProfScope ps(prof_, "heuristic");
       for (HeurVector::iterator it=heurs_.begin(); it!=heurs_.end(); ++it) {
         (*it)->solve(node, rel, s_pool);
       }
@@ -330,11 +331,13 @@ void ParPCBProcessor::process(NodePtr node, RelaxationPtr rel,
       if (brancher_->getName()=="ParReliabilityBrancher") {
         ParReliabilityBrancherPtr parRelBr;
         parRelBr = dynamic_cast <ParReliabilityBrancher*> (brancher_);
+        ProfScope ps(prof_, "branch");
 #pragma omp critical (solPool)
         branches_ = parRelBr->findBranches(relaxation_, node, sol, s_pool,
                                             br_status, mods, timesUp, timesDown,
                                             pseudoUp, pseudoDown, nodesProc);
       } else {
+        ProfScope ps(prof_, "branch");
 #pragma omp critical (solPool)
         branches_ = brancher_->findBranches(relaxation_, node, sol, s_pool,
                                             br_status, mods);
@@ -381,6 +384,7 @@ void ParPCBProcessor::process(NodePtr node, RelaxationPtr rel,
 void ParPCBProcessor::separate_(ConstSolutionPtr sol, NodePtr node, 
                             SolutionPoolPtr s_pool, SeparationStatus *status) 
 {
+  ProfScope ps(prof_, "separate");
   ModVector mods;
   HandlerIterator h;
   SeparationStatus st = SepaContinue;
@@ -505,8 +509,7 @@ bool ParPCBProcessor::shouldPrune_(NodePtr node, double solval,
      if (node->getParent() &&
          node->getParent()->getLb() > solval+oATol_ &&
          node->getParent()->getLb() > solval+fabs(solval)*oRTol_ ) {
-#pragma omp critical (logger)
-       logger_->msgStream(LogError) << me_ << "node lb lower than parent's lb. "
+       MINOTAUR_LOG(logger_, LogError) << me_ << "node lb lower than parent's lb. "
                                     << "Relaxation may not be convex or "
                                     << "engine has an issue."
                                     << " Node: " << node->getId() << " nodelb: " 
@@ -557,6 +560,7 @@ bool ParPCBProcessor::shouldPrune_(NodePtr node, double solval,
 
 void ParPCBProcessor::solveRelaxation_() 
 {
+  ProfScope ps(prof_, "solve");
   engineStatus_ = EngineError;
   engine_->solve();
   engineStatus_ = engine_->getStatus();
@@ -24,6 +24,7 @@ namespace Minotaur {
 
   //class Engine;
   //class Problem;
+  class Profiler;
   class Solution;
   typedef const Solution* ConstSolutionPtr;
 
@@ -141,6 +142,9 @@ namespace Minotaur {
     /// all nodes. If 0, then never. If 4, then every fourth node, etc.
     int presFreq_;
 
+    /// Profiler for timing the steps of processing. NULL if not profiling.
+    Profiler *prof_;
+
     /// How many new solutions were found by the processor.
     UInt numSolutions_;
 
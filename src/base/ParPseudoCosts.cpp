@@ -0,0 +1,113 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2008 - 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file ParPseudoCosts.cpp
+ * \brief Define class ParPseudoCosts, a table of pseudo costs shared by the
+ * threads of a parallel branch-and-bound.
+ * \author The MINOTAUR Team
+ */
+
+#include <algorithm>
+
+#include "MinotaurConfig.h"
+#include "ParPseudoCosts.h"
+
+using namespace Minotaur;
+
+ParPseudoCosts::ParPseudoCosts(UInt n)
+  : n_(n)
+{
+  cntDown_ = new UInt[n];
+  cntUp_ = new UInt[n];
+  sumDown_ = new double[n];
+  sumUp_ = new double[n];
+  std::fill(cntDown_, cntDown_+n, 0);
+  std::fill(cntUp_, cntUp_+n, 0);
+  std::fill(sumDown_, sumDown_+n, 0.0);
+  std::fill(sumUp_, sumUp_+n, 0.0);
+}
+
+
+ParPseudoCosts::~ParPseudoCosts()
+{
+  delete [] cntDown_;
+  delete [] cntUp_;
+  delete [] sumDown_;
+  delete [] sumUp_;
+}
+
+
+void ParPseudoCosts::add(UInt i, double cost, BranchDirection dir)
+{
+  add(i, cost, 1, dir);
+}
+
+
+void ParPseudoCosts::add(UInt i, double avg, UInt cnt, BranchDirection dir)
+{
+  double s = avg*cnt;
+
+  if (i>=n_ || 0==cnt) {
+    return;
+  }
+  if (DownBranch==dir) {
+#pragma omp atomic
+    sumDown_[i] += s;
+#pragma omp atomic
+    cntDown_[i] += cnt;
+  } else {
+#pragma omp atomic
+    sumUp_[i] += s;
+#pragma omp atomic
+    cntUp_[i] += cnt;
+  }
+}
+
+
+void ParPseudoCosts::get(UInt i, UInt *t_down, UInt *t_up, double *pc_down,
+                         double *pc_up) const
+{
+  UInt td, tu;
+  double sd, su;
+
+  if (i>=n_) {
+    *t_down = *t_up = 0;
+    *pc_down = *pc_up = 0.0;
+    return;
+  }
+#pragma omp atomic read
+  td = cntDown_[i];
+#pragma omp atomic read
+  sd = sumDown_[i];
+#pragma omp atomic read
+  tu = cntUp_[i];
+#pragma omp atomic read
+  su = sumUp_[i];
+
+  *t_down = td;
+  *t_up = tu;
+  *pc_down = (td>0) ? sd/td : 0.0;
+  *pc_up = (tu>0) ? su/tu : 0.0;
+}
+
+
+UInt ParPseudoCosts::getSize() const
+{
+  return n_;
+}
+
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
@@ -0,0 +1,109 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2008 - 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file ParPseudoCosts.h
+ * \brief Declare class ParPseudoCosts, a table of pseudo costs shared by
+ * the threads of a parallel branch-and-bound.
+ * \author The MINOTAUR Team
+ */
+
+
+#ifndef MINOTAURPARPSEUDOCOSTS_H
+#define MINOTAURPARPSEUDOCOSTS_H
+
+#include "Types.h"
+
+namespace Minotaur {
+
+  /**
+   * \brief Pseudo costs of all variables, updated and read by all threads.
+   *
+   * For each variable and direction, the table keeps the number of
+   * observations and the sum of observed costs per unit change. Each entry
+   * is updated and read with atomic operations, so threads do not lock and
+   * each update or lookup takes constant time. A reader may see a count and
+   * a sum that differ by the one observation being added, which only
+   * changes the average slightly.
+   */
+  class ParPseudoCosts {
+  public:
+    /// Constructor for a relaxation with n variables.
+    ParPseudoCosts(UInt n);
+
+    /// Destroy.
+    ~ParPseudoCosts();
+
+    /**
+     * \brief Add one observed cost.
+     *
+     * \param[in] i Index of the variable.
+     * \param[in] cost Change in objective per unit change of the variable.
+     * \param[in] dir DownBranch or UpBranch.
+     */
+    void add(UInt i, double cost, BranchDirection dir);
+
+    /**
+     * \brief Add several observations at once, e.g., those a brancher made
+     * before the table was created.
+     *
+     * \param[in] i Index of the variable.
+     * \param[in] avg Average cost of the observations.
+     * \param[in] cnt Number of observations.
+     * \param[in] dir DownBranch or UpBranch.
+     */
+    void add(UInt i, double avg, UInt cnt, BranchDirection dir);
+
+    /**
+     * \brief Get the pseudo costs of a variable.
+     *
+     * \param[in] i Index of the variable.
+     * \param[out] t_down Number of observations of down branches.
+     * \param[out] t_up Number of observations of up branches.
+     * \param[out] pc_down Average cost of down branches. 0 if none.
+     * \param[out] pc_up Average cost of up branches. 0 if none.
+     */
+    void get(UInt i, UInt *t_down, UInt *t_up, double *pc_down,
+             double *pc_up) const;
+
+    /// Get the number of variables.
+    UInt getSize() const;
+
+  private:
+    /// Number of observations of down branches.
+    UInt *cntDown_;
+
+    /// Number of observations of up branches.
+    UInt *cntUp_;
+
+    /// Number of variables.
+    UInt n_;
+
+    /// Sum of costs of down branches.
+    double *sumDown_;
+
+    /// Sum of costs of up branches.
+    double *sumUp_;
+
+    /// Copying is not allowed.
+    ParPseudoCosts(const ParPseudoCosts &);
+
+    /// Copying is not allowed.
+    ParPseudoCosts & operator = (const ParPseudoCosts &);
+  };
+}
+#endif
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
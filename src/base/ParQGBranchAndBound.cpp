@@ -34,11 +34,14 @@
 #include "NodeRelaxer.h"
 #include "Option.h"
 #include "ParCutMan.h"
+#include "ParCutStore.h"
 #include "ParPCBProcessor.h"
+#include "ParPseudoCosts.h"
 #include "ParQGBranchAndBound.h"
 #include "ParNodeIncRelaxer.h"
 #include "ParTreeManager.h"
 #include "Problem.h"
+#include "Profiler.h"
 #include "Relaxation.h"
 #include "Solution.h"
 #include "SolutionPool.h"
@@ -78,7 +81,7 @@ ParQGBranchAndBound::ParQGBranchAndBound(EnvPtr env, ProblemPtr p)
   stats_(0),
   status_(NotStarted)
 {
-  timer_ = env->getNewTimer();
+  timer_ = env->getNewWallTimer();
   tm_ = (ParTreeManagerPtr) new ParTreeManager(env);
   options_ = (ParQGBabOptionsPtr) new ParQGBabOptions(env);
   logger_ = env->getLogger();
@@ -269,8 +272,7 @@ bool ParQGBranchAndBound::shouldPrune_(NodePtr node)
   case (NodeOptimal):
     should_prune = true;
 #if SPEW
-#pragma omp critical (logger)
-            logger_->msgStream(LogInfo) << me_ << "prune node (NodeOptimal) "
+            MINOTAUR_LOG(logger_, LogInfo) << me_ << "prune node (NodeOptimal) "
               << node->getId() << " score "
               << (long int)node->getTbScore() << " lb " << node->getLb() << " thread "
               << omp_get_thread_num() << std::endl;
@@ -279,8 +281,7 @@ bool ParQGBranchAndBound::shouldPrune_(NodePtr node)
   case (NodeHitUb):
     should_prune = true;
 #if SPEW
-#pragma omp critical (logger)
-            logger_->msgStream(LogInfo) << me_ << "prune node (NodeHitUb) "
+            MINOTAUR_LOG(logger_, LogInfo) << me_ << "prune node (NodeHitUb) "
               << node->getId() << " score "
               << (long int)node->getTbScore() << " lb " << node->getLb() << " thread "
               << omp_get_thread_num() << std::endl;
@@ -289,8 +290,7 @@ bool ParQGBranchAndBound::shouldPrune_(NodePtr node)
     break;
   case (NodeInfeasible):
 #if SPEW
-#pragma omp critical (logger)
-            logger_->msgStream(LogInfo) << me_ << "prune node (NodeInfeasible) "
+            MINOTAUR_LOG(logger_, LogInfo) << me_ << "prune node (NodeInfeasible) "
               << node->getId() << " score "
               << (long int)node->getTbScore() << " lb " << node->getLb() << " thread "
               << omp_get_thread_num() << std::endl;
@@ -438,7 +438,7 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
   UInt *nodesProcTh = new UInt[numThreads];
   //UInt iterCount = 1;
   std::vector<ParCutMan*> cutman(numThreads);
-  UInt *cutsIndex = new UInt[numThreads*numThreads]();
+  ParCutStore cutStore(env_, numThreads);
   UInt numVars = 0;
   bool shouldRun = true;
 
@@ -446,6 +446,7 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
 //#pragma omp parallel for
   for(UInt i = 0; i < numThreads; ++i) {
     cutman[i] = new ParCutMan(env_, problem_);
+    cutman[i]->setCutStore(&cutStore, i);
     nodePrcssr[i]->setCutManager(cutman[i]);
     should_dive[i] = false;
     dived_prev[i] = false;
@@ -477,8 +478,10 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
   stats_ = new ParQGBabStats();
 
   // initialize solution pool
-  // TODO: use user options to set the pool size. For now it is 1.
-  solPool_ = (SolutionPoolPtr) new SolutionPool(env_, problem_, 1);
+  solPool_ = (SolutionPoolPtr) new SolutionPool(env_, problem_,
+    env_->getOptions()->findInt("sol_pool_size")->getValue());
+  // prune with new solutions as soon as a thread finds them.
+  solPool_->addListener(tm_);
 
   rel[0] = parNodeRlxr[0]->getRelaxation();
 
@@ -530,25 +533,22 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
   if (nodePrcssr[0]->getBrancher()->getName() == "ParReliabilityBrancher") {
     isParRel = true;
   }
+  ParPseudoCosts pcosts(isParRel ? numVars : 0);
+  if (isParRel) {
+    for (UInt j=0; j<numThreads; ++j) {
+      dynamic_cast <ParReliabilityBrancher*> (nodePrcssr[j]->getBrancher())
+        ->setSharedPCosts(&pcosts);
+    }
+  }
 
   UInt i=0; // thread id
 #pragma omp parallel private(i)
   {
     i = omp_get_thread_num();
     //UInt nodeCountThread = nodeCount;
-    FunctionPtr f;
-    VariablePtr v;
-    LinearFunctionPtr lf, lfnew;
-    ParReliabilityBrancherPtr parRelBr;
-    UIntVector tmpTimesUp, tmpTimesDown, timesUp, timesDown, lastStrBranched;
-    DoubleVector tmpPseudoUp, tmpPseudoDown, pseudoUp, pseudoDown;
-    if (isParRel) {
-      timesUp.resize(numVars,0);
-      timesDown.resize(numVars,0);
-      pseudoUp.resize(numVars,0);
-      pseudoDown.resize(numVars,0);
-      lastStrBranched.resize(numVars,0);
-    }
+    // pseudo costs are read from pcosts by the brancher.
+    UIntVector timesUp, timesDown;
+    DoubleVector pseudoUp, pseudoDown;
 
     //while (nodeCountThread > 0 && shouldRun)
     while (nodeCountTh[i] > 0 && shouldRun) {
@@ -578,8 +578,7 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
         if (current_node[i]) {
           nodesProcTh[i]++;
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogDebug) << me_ << "get node "
+          MINOTAUR_LOG(logger_, LogDebug) << me_ << "get node "
             << current_node[i]->getId() << " thread "
             << omp_get_thread_num() << std::endl;
 #endif
@@ -588,55 +587,20 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
       }
       if (current_node[i]) {
 #if SPEW
-#pragma omp critical (logger)
-        logger_->msgStream(LogInfo) << me_ << "process node "
+        MINOTAUR_LOG(logger_, LogInfo) << me_ << "process node "
           << current_node[i]->getId() << " thread " << omp_get_thread_num() << std::endl;
           //<< me_ << "depth = " << current_node[i]->getDepth() << std::endl
           //<< me_ << "did we dive = " << dived_prev[i] << std::endl;
 #endif
         should_dive[i] = false;
 
+        ProfScope ps(env_->getProfiler(), "node");
         rel[i] = parNodeRlxr[i]->createNodeRelaxation(current_node[i],
                                                       dived_prev[i],
                                                       should_prune[i]);
-        // CAUTION: if parRel branching is not used, cuts are also not shared.
-        // Sharing pseudocosts must be separated from sharing cuts.
-        if (isParRel) {
-          for(UInt j = 0; j < numThreads; ++j) {
-            if (i!=j) {
-              std::vector<ConstraintPtr > consVec = nodePrcssr[j]->getCutManager()->getPoolCons();
-              if (consVec.size() > 0) {
-                for (UInt k=cutsIndex[i*numThreads+j]; k < consVec.size(); ++k) {
-                  lf = consVec[k]->getLinearFunction();
-                  if (lf) {
-                    lfnew = (LinearFunctionPtr) new LinearFunction();
-                    for (VariableGroupConstIterator it=lf->termsBegin(); it!=lf->termsEnd();++it) {
-                      v = it->first;
-                      //transform the cut
-                      lfnew->addTerm(rel[i]->getRelaxationVar(rel[i]->getOriginalVar(v)),it->second); //rel[j] not needed
-                    }
-                    f = (FunctionPtr) new Function(lfnew);
-                    rel[i]->newConstraint(f, consVec[k]->getLb(),
-                                          consVec[k]->getUb(), consVec[k]->getName());
-                  }
-                }
-                cutsIndex[i*numThreads+j] = consVec.size();
-                consVec.clear();
-              }
-              parRelBr = dynamic_cast <ParReliabilityBrancher*> (nodePrcssr[j]->getBrancher());
-              tmpTimesUp = parRelBr->getTimesUp();
-              tmpTimesDown = parRelBr->getTimesDown();
-              tmpPseudoUp = parRelBr->getPCUp();
-              tmpPseudoDown = parRelBr->getPCDown();
-              for (UInt l=0; l < tmpTimesDown.size(); ++l) {
-                timesUp[l] += tmpTimesUp[l];
-                timesDown[l] += tmpTimesDown[l];
-                pseudoUp[l] += tmpTimesUp[l]*tmpPseudoUp[l];
-                pseudoDown[l] += tmpTimesDown[l]*tmpPseudoDown[l];
-              }
-            }
-          }
-        }
+        // add cuts found by other threads since the last node of this
+        // thread.
+        cutStore.addNewCuts(rel[i], i);
         nodePrcssr[i]->process(current_node[i], rel[i], solPool_,
                                initialized[i], timesUp, timesDown,
                                pseudoUp, pseudoDown, stats_->nodesProc);
@@ -646,24 +610,16 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
         }
 
 #if SPEW
-#pragma omp critical (logger)
-        logger_->msgStream(LogDebug1) << me_ << "node "
+        MINOTAUR_LOG(logger_, LogDebug1) << me_ << "node "
           << current_node[i]->getId() << " lower bound = "
           << current_node[i]->getLb() << " thread "
           << omp_get_thread_num() << std::endl;
 #endif
-        if (nodePrcssr[i]->foundNewSolution()) {
-#pragma omp critical (treeManager)
-          {
-            tm_->setUb(solPool_->getBestSolutionValue());
-          }
-        }
         should_prune[i] = shouldPrune_(current_node[i]);
 
         if (should_prune[i]) {
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogInfo) << me_ << "prune node "
+          MINOTAUR_LOG(logger_, LogInfo) << me_ << "prune node "
             << current_node[i]->getId() << " thread "
             << omp_get_thread_num() << std::endl;
 #endif
@@ -683,8 +639,7 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
               tm_->removeActiveNode(new_node[i]);
               nodesProcTh[i]++;
 #if SPEW
-#pragma omp critical (logger)
-              logger_->msgStream(LogDebug) << me_ << "get node "
+              MINOTAUR_LOG(logger_, LogDebug) << me_ << "get node "
                 << new_node[i]->getId() << " (prune) thread "
                 << omp_get_thread_num() << std::endl;
 #endif
@@ -694,8 +649,7 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
         } else {
           initialized[i] = true;
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogDebug) << me_ << "branch at node "
+          MINOTAUR_LOG(logger_, LogDebug) << me_ << "branch at node "
             << current_node[i]->getId() << " thread "
             << omp_get_thread_num() << std::endl;
 #endif
@@ -712,8 +666,7 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
 #pragma omp critical (current_node)
             new_node[i] = tm_->branch(branches[i], current_node[i], ws[i]);
 #if SPEW
-#pragma omp critical (logger)
-            logger_->msgStream(LogDebug) << me_ << "get node "
+            MINOTAUR_LOG(logger_, LogDebug) << me_ << "get node "
               << new_node[i]->getId() << " (branch) thread " << omp_get_thread_num()
               << std::endl;
 #endif
@@ -732,8 +685,7 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
               if (new_node[i]) {
                 tm_->removeActiveNode(new_node[i]);
 #if SPEW
-#pragma omp critical (logger)
-                logger_->msgStream(LogDebug) << me_ << "get/remove node "
+                MINOTAUR_LOG(logger_, LogDebug) << me_ << "get/remove node "
                   << new_node[i]->getId() << " thread "
                   << omp_get_thread_num() << std::endl;
 #endif
@@ -831,6 +783,15 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
     << me_ << "nodes processed = " << stats_->nodesProc << std::endl
     << me_ << "nodes created   = " << tm_->getSize() << std::endl;
   solPool_->writeStats(logger_->msgStream(LogExtraInfo));
+  cutStore.writeStats(logger_->msgStream(LogExtraInfo));
+  // cutStore and pcosts are not valid after this function returns.
+  for (UInt j=0; j<numThreads; ++j) {
+    cutman[j]->setCutStore(0, j);
+    if (isParRel) {
+      dynamic_cast <ParReliabilityBrancher*> (nodePrcssr[j]->getBrancher())
+        ->setSharedPCosts(0);
+    }
+  }
 
   stats_->timeUsed = timer_->query();
   timer_->stop();
@@ -863,7 +824,6 @@ void ParQGBranchAndBound::parsolveOppor(ParNodeIncRelaxerPtr parNodeRlxr[],
   delete[] ws;
   delete[] rel;
   delete[] branches;
-  delete[] cutsIndex;
 }
 
 
@@ -891,7 +851,7 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
   std::vector<ParCutMan*> cutman(numThreads);
   //bool iterMode = env_->getOptions()->findBool("mcbnb_iter_mode")->getValue();
   UInt iterCount = 1;
-  UInt *cutsIndex = new UInt[numThreads*numThreads]();
+  ParCutStore cutStore(env_, numThreads);
   UInt numVars = 0;
 
   omp_set_num_threads(numThreads);
@@ -899,6 +859,7 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
   for(UInt i = 0; i < numThreads; ++i) {
     // declare cut manager
     cutman[i] = new ParCutMan(env_, problem_);
+    cutman[i]->setCutStore(&cutStore, i);
     nodePrcssr[i]->setCutManager(cutman[i]);
     should_dive[i] = false;
     dived_prev[i] = false;
@@ -930,8 +891,10 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
   stats_ = new ParQGBabStats();
 
   // initialize solution pool
-  // TODO: use user options to set the pool size. For now it is 1.
-  solPool_ = (SolutionPoolPtr) new SolutionPool(env_, problem_, 1);
+  solPool_ = (SolutionPoolPtr) new SolutionPool(env_, problem_,
+    env_->getOptions()->findInt("sol_pool_size")->getValue());
+  // prune with new solutions as soon as a thread finds them.
+  solPool_->addListener(tm_);
 
   rel[0] = parNodeRlxr[0]->getRelaxation();
   // call heuristics before the root, if needed
@@ -981,6 +944,13 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
   if (nodePrcssr[0]->getBrancher()->getName() == "ParReliabilityBrancher") {
     isParRel = true;
   }
+  ParPseudoCosts pcosts(isParRel ? numVars : 0);
+  if (isParRel) {
+    for (UInt j=0; j<numThreads; ++j) {
+      dynamic_cast <ParReliabilityBrancher*> (nodePrcssr[j]->getBrancher())
+        ->setSharedPCosts(&pcosts);
+    }
+  }
 
   // memory leak check: remove later
   if (numThreads > 1) {
@@ -997,20 +967,9 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
     {
 #pragma omp for
       for(UInt i = 0; i < numThreads; ++i) {
-        FunctionPtr f;
-        VariablePtr v;
-        LinearFunctionPtr lf, lfnew;
-        //brancher related
-        ParReliabilityBrancherPtr parRelBr;
-        UIntVector tmpTimesUp, tmpTimesDown, timesUp, timesDown, lastStrBranched;
-        DoubleVector tmpPseudoUp, tmpPseudoDown, pseudoUp, pseudoDown;
-        if (isParRel) {
-          timesUp.resize(numVars,0);
-          timesDown.resize(numVars,0);
-          pseudoUp.resize(numVars,0);
-          pseudoDown.resize(numVars,0);
-          lastStrBranched.resize(numVars,0);
-        }
+        // pseudo costs are read from pcosts by the brancher.
+        UIntVector timesUp, timesDown;
+        DoubleVector pseudoUp, pseudoDown;
         if (current_node[i]) {
 #pragma omp critical (treeManager)
           {
@@ -1037,55 +996,20 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
         }
         if (current_node[i]) {
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogInfo) << me_ << "process node "
+          MINOTAUR_LOG(logger_, LogInfo) << me_ << "process node "
             << current_node[i]->getId() << " thread " << omp_get_thread_num() << std::endl
             << me_ << "depth = " << current_node[i]->getDepth() << std::endl
             << me_ << "did we dive = " << dived_prev[i] << std::endl;
 #endif
           should_dive[i] = false;
 
+          ProfScope ps(env_->getProfiler(), "node");
           rel[i] = parNodeRlxr[i]->createNodeRelaxation(current_node[i],
                                                         dived_prev[i],
                                                         should_prune[i]);
-          // CAUTION: if parRel branching is not used, cuts are also not shared.
-          // Sharing pseudocosts must be separated from sharing cuts.
-          if (isParRel) {
-            for(UInt j = 0; j < numThreads; ++j) {
-              if (i!=j) {
-                std::vector<ConstraintPtr > consVec = nodePrcssr[j]->getCutManager()->getPoolCons();
-                if (consVec.size() > 0) {
-                  for (UInt k=cutsIndex[i*numThreads+j]; k < consVec.size(); ++k) {
-                    lf = consVec[k]->getLinearFunction();
-                    if (lf) {
-                      lfnew = (LinearFunctionPtr) new LinearFunction();
-                      for (VariableGroupConstIterator it=lf->termsBegin(); it!=lf->termsEnd();++it) {
-                        v = it->first;
-                        //transform the cut
-                        lfnew->addTerm(rel[i]->getRelaxationVar(rel[i]->getOriginalVar(v)),it->second); //rel[j] not needed
-                      }
-                      f = (FunctionPtr) new Function(lfnew);
-                      rel[i]->newConstraint(f, consVec[k]->getLb(),
-                                            consVec[k]->getUb(), consVec[k]->getName());
-                    }
-                  }
-                  cutsIndex[i*numThreads+j] = consVec.size();
-                  consVec.clear();
-                }
-                parRelBr = dynamic_cast <ParReliabilityBrancher*> (nodePrcssr[j]->getBrancher());
-                tmpTimesUp = parRelBr->getTimesUp();
-                tmpTimesDown = parRelBr->getTimesDown();
-                tmpPseudoUp = parRelBr->getPCUp();
-                tmpPseudoDown = parRelBr->getPCDown();
-                for (UInt l=0; l < tmpTimesDown.size(); ++l) {
-                  timesUp[l] += tmpTimesUp[l];
-                  timesDown[l] += tmpTimesDown[l];
-                  pseudoUp[l] += tmpTimesUp[l]*tmpPseudoUp[l];
-                  pseudoDown[l] += tmpTimesDown[l]*tmpPseudoDown[l];
-                }
-              }
-            }
-          }
+          // add cuts found by other threads since the last node of this
+          // thread.
+          cutStore.addNewCuts(rel[i], i);
           nodePrcssr[i]->process(current_node[i], rel[i], solPool_,
                                  initialized[i], timesUp, timesDown,
                                  pseudoUp, pseudoDown, stats_->nodesProc);
@@ -1095,23 +1019,15 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
           }
 
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogDebug1) << me_ << "node lower bound = " <<
+          MINOTAUR_LOG(logger_, LogDebug1) << me_ << "node lower bound = " <<
             current_node[i]->getLb() << current_node[i]->getId() << " thread "
             << omp_get_thread_num()<< std::endl;
 #endif
-          if (nodePrcssr[i]->foundNewSolution()) {
-#pragma omp critical (treeManager)
-            {
-              tm_->setUb(solPool_->getBestSolutionValue());
-            }
-          }
           should_prune[i] = shouldPrune_(current_node[i]);
 
           if (should_prune[i]) {
 #if SPEW
-#pragma omp critical (logger)
-            logger_->msgStream(LogInfo) << me_ << "prune node "
+            MINOTAUR_LOG(logger_, LogInfo) << me_ << "prune node "
               << current_node[i]->getId() << " thread "
               << omp_get_thread_num() << std::endl;
 #endif
@@ -1126,8 +1042,7 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
               new_node[i] = tm_->getCandidate();
               if (new_node[i]) {
 #if SPEW
-#pragma omp critical (logger)
-                logger_->msgStream(LogDebug) << me_ << "get node (prune) "
+                MINOTAUR_LOG(logger_, LogDebug) << me_ << "get node (prune) "
                   << new_node[i]->getId() << " thread "
                   << omp_get_thread_num() << std::endl;
 #endif
@@ -1140,8 +1055,7 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
           } else {
             initialized[i] = true;
 #if SPEW
-#pragma omp critical (logger)
-            logger_->msgStream(LogDebug) << me_ << "branch at node "
+            MINOTAUR_LOG(logger_, LogDebug) << me_ << "branch at node "
               << current_node[i]->getId() << " thread "
               << omp_get_thread_num() << std::endl;
 #endif
@@ -1157,8 +1071,7 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
             {
               new_node[i] = tm_->branch(branches[i], current_node[i], ws[i]);
 #if SPEW
-#pragma omp critical (logger)
-              logger_->msgStream(LogDebug) << me_ << "get node (branch) "
+              MINOTAUR_LOG(logger_, LogDebug) << me_ << "get node (branch) "
                 << new_node[i]->getId() << " thread " << omp_get_thread_num()
                 << std::endl;
 #endif
@@ -1177,8 +1090,7 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
                 if (new_node[i]) {
                   tm_->removeActiveNode(new_node[i]);
 #if SPEW
-#pragma omp critical (logger)
-                  logger_->msgStream(LogDebug) << me_ << "get/remove node "
+                  MINOTAUR_LOG(logger_, LogDebug) << me_ << "get/remove node "
                     << new_node[i]->getId() << " thread "
                     << omp_get_thread_num() << std::endl;
 #endif
@@ -1260,8 +1172,7 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
             status_ = SolvedInfeasible; // TODO: get the right status
           }
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogDebug) << me_ << "all nodes have "
+          MINOTAUR_LOG(logger_, LogDebug) << me_ << "all nodes have "
             << "been processed" << std::endl;
 #endif
         } else if (shouldStopPar_(wallTimeStart, treeLb)) {
@@ -1269,8 +1180,7 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
           shouldRun = false;
         } else {
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogDebug) << std::setprecision(8)
+          MINOTAUR_LOG(logger_, LogDebug) << std::setprecision(8)
             << me_ << "lb = " << tm_->updateLb() << std::endl 
             << me_ << "ub = " << tm_->getUb() << std::endl;
 #endif
@@ -1287,6 +1197,15 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
       << std::endl;
   //}
   solPool_->writeStats(logger_->msgStream(LogExtraInfo));
+  cutStore.writeStats(logger_->msgStream(LogExtraInfo));
+  // cutStore and pcosts are not valid after this function returns.
+  for (UInt j=0; j<numThreads; ++j) {
+    cutman[j]->setCutStore(0, j);
+    if (isParRel) {
+      dynamic_cast <ParReliabilityBrancher*> (nodePrcssr[j]->getBrancher())
+        ->setSharedPCosts(0);
+    }
+  }
 
   stats_->timeUsed = timer_->query();
   timer_->stop();
@@ -1305,7 +1224,6 @@ void ParQGBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
   delete[] ws;
   delete[] rel;
   delete[] branches;
-  delete[] cutsIndex;
 }
 
 
@@ -1373,8 +1291,8 @@ void ParQGBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
   stats_ = new ParQGBabStats();
 
   // initialize solution pool
-  // TODO: use user options to set the pool size. For now it is 1.
-  solPool_ = (SolutionPoolPtr) new SolutionPool(env_, problem_, 1);
+  solPool_ = (SolutionPoolPtr) new SolutionPool(env_, problem_,
+    env_->getOptions()->findInt("sol_pool_size")->getValue());
 
   rel[0] = parNodeRlxr[0]->getRelaxation();
   //std::cout << "root relaxation\n";
@@ -1461,8 +1379,7 @@ void ParQGBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
             current_node[i] = tm_->getCandidate();
             if (current_node[i]) {
 #if SPEW
-#pragma omp critical (logger)
-            logger_->msgStream(LogInfo) << "assign node "
+            MINOTAUR_LOG(logger_, LogInfo) << "assign node "
               << current_node[i]->getId() << " score "
               << (long int)current_node[i]->getTbScore() << " lb "
               << std::setprecision(9) << current_node[i]->getLb() << " thread "
@@ -1483,18 +1400,18 @@ void ParQGBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
 #pragma omp for
       for (UInt i = 0; i < numThreads; ++i) {
         // this is a bad way, correct the process() function later
-        UIntVector tmpTimesUp, tmpTimesDown, timesUp, timesDown;
+        UIntVector timesUp, timesDown;
         DoubleVector pseudoUp, pseudoDown;
 
         if (current_node[i]) {
           should_dive[i] = false;
 
+          ProfScope ps(env_->getProfiler(), "node");
           rel[i] = parNodeRlxr[i]->createNodeRelaxation(current_node[i],
                                                         dived_prev[i],
                                                         should_prune[i]);
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogInfo) << me_ << "process node "
+          MINOTAUR_LOG(logger_, LogInfo) << me_ << "process node "
             << current_node[i]->getId() << " score "
             << (long int)current_node[i]->getTbScore() << " lb "
             << std::setprecision(9) << current_node[i]->getLb()
@@ -1539,8 +1456,7 @@ void ParQGBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
         if (current_node[i]) {
           if (should_prune[i]) {
 #if SPEW
-#pragma omp critical (logger)
-            logger_->msgStream(LogInfo) << me_ << "prune node "
+            MINOTAUR_LOG(logger_, LogInfo) << me_ << "prune node "
               << current_node[i]->getId() << " score "
               << (long int)current_node[i]->getTbScore() << std::setprecision(9)
               << " lb " << current_node[i]->getLb() << " thread "
@@ -1570,8 +1486,7 @@ void ParQGBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
           } else {
             initialized[i] = true;
 #if SPEW
-#pragma omp critical (logger)
-            logger_->msgStream(LogInfo) << me_ << "branch at node "
+            MINOTAUR_LOG(logger_, LogInfo) << me_ << "branch at node "
               << current_node[i]->getId() << " score "
               << (long int)current_node[i]->getTbScore() << std::setprecision(9)
               << " lb " << current_node[i]->getLb() << " thread "
@@ -1587,8 +1502,7 @@ void ParQGBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
             {
               new_node[i] = tm_->branch(branches[i], current_node[i], ws[i]);
 #if SPEW
-#pragma omp critical (logger)
-              logger_->msgStream(LogInfo) << me_ << "get node "
+              MINOTAUR_LOG(logger_, LogInfo) << me_ << "get node "
                 << new_node[i]->getId() << " score "
                 << (long int)new_node[i]->getTbScore() << std::setprecision(9)
                 << " lb " << new_node[i]->getLb() << " (branch) thread "
@@ -1612,8 +1526,7 @@ void ParQGBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
                 if (new_node[i]) {
                   tm_->removeActiveNode(new_node[i]);
 #if SPEW
-#pragma omp critical (logger)
-              logger_->msgStream(LogInfo) << me_ << "get node "
+              MINOTAUR_LOG(logger_, LogInfo) << me_ << "get node "
                 << new_node[i]->getId() << " score "
                 << (long int)new_node[i]->getTbScore() << " lb " <<
                 current_node[i]->getLb() << " (prune) thread "
@@ -1659,8 +1572,7 @@ void ParQGBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
             status_ = SolvedInfeasible; // TODO: get the right status
           }
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogDebug) << me_ << "all nodes have "
+          MINOTAUR_LOG(logger_, LogDebug) << me_ << "all nodes have "
             << "been processed" << std::endl;
 #endif
         } else if (shouldStopPar_(wallTimeStart, treeLb)) {
@@ -1668,8 +1580,7 @@ void ParQGBranchAndBound::parsolveSync(ParNodeIncRelaxerPtr parNodeRlxr[],
           shouldRun = false;
         } else {
 #if SPEW
-#pragma omp critical (logger)
-          logger_->msgStream(LogDebug) << std::setprecision(8)
+          MINOTAUR_LOG(logger_, LogDebug) << std::setprecision(8)
             << me_ << "lb = " << tm_->updateLb() << std::endl
             << me_ << "ub = " << tm_->getUb() << std::endl;
 #endif
@@ -1717,6 +1628,7 @@ void ParQGBranchAndBound::writeStats(std::ostream &out)
     (*it)->writeStats(out);
   }
   solPool_->writeStats(out);
+  tm_->writeStats(out);
 }
 
 void ParQGBranchAndBound::writeParStats(std::ostream &out, ParPCBProcessorPtr nodePrcssr[])
@@ -1732,6 +1644,7 @@ void ParQGBranchAndBound::writeParStats(std::ostream &out, ParPCBProcessorPtr no
     (*it)->writeStats(out);
   }
   solPool_->writeStats(out);
+  tm_->writeStats(out);
 }
 
 double ParQGBranchAndBound::totalTime()
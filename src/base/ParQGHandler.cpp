@@ -172,10 +172,7 @@ void ParQGHandler::cutIntSol_(ConstSolutionPtr sol, CutManager *cutMan,
     {
       ++(stats_->nlpF);
       double nlpval = nlpe_->getSolutionValue();
-#pragma omp critical (solPool)
-      {
-       updateUb_(s_pool, nlpval, sol_found);
-      }
+      updateUb_(s_pool, nlpval, sol_found);
       if ((relobj_ >= nlpval-objATol_) ||
           (nlpval != 0 && (relobj_ >= nlpval-fabs(nlpval)*objRTol_))) {
           *status = SepaPrune;
@@ -480,6 +477,7 @@ void ParQGHandler::cutsAtLpSol_(const double *lpx, CutManager *cutman,
             CutPtr cut = (CutPtr) new Cut(minlp_->getNumVars(),f, -INFINITY,
                                           cUb-c, false,false);
             cut->setCons(newcon);
+            cut->getInfo()->fixedScore = lpvio;
             if (node_) {
               node_->addCutToPool(cut, rel_);
             }
@@ -522,6 +520,7 @@ void ParQGHandler::cutsAtLpSol_(const double *lpx, CutManager *cutman,
               CutPtr cut = (CutPtr) new Cut(minlp_->getNumVars(),f, -INFINITY,
                                             -1.0*c, false,false);
               cut->setCons(newcon);
+              cut->getInfo()->fixedScore = lpvio;
               if (node_) {
                 node_->addCutToPool(cut, rel_);
                 cut->setName_(sstm.str());
@@ -570,6 +569,7 @@ void ParQGHandler::addCut_(const double *nlpx, const double *lpx,
         CutPtr cut = (CutPtr) new Cut(minlp_->getNumVars(),f, -INFINITY,
                                       cUb-c, false,false);
         cut->setCons(newcon);
+        cut->getInfo()->fixedScore = lpvio;
         if (node_) {
           node_->addCutToPool(cut, rel_);
         }
@@ -622,6 +622,7 @@ void ParQGHandler::cutToObj_(const double *nlpx, const double *lpx,
               CutPtr cut = (CutPtr) new Cut(rel_->getNumVars(),f, -INFINITY,
                                             -1.0*c, false,false);
               cut->setCons(newcon);
+              cut->getInfo()->fixedScore = vio;
               if (node_) {
                 node_->addCutToPool(cut, rel_);
               }
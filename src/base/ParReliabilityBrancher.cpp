@@ -25,6 +25,8 @@
 #include "Modification.h"
 #include "Node.h"
 #include "Option.h"
+#include "ParPseudoCosts.h"
+#include "Profiler.h"
 #include "ProblemSize.h"
 #include "Relaxation.h"
 #include "ParReliabilityBrancher.h"
@@ -50,12 +52,14 @@ ParReliabilityBrancher::ParReliabilityBrancher(EnvPtr env, HandlerVector & handl
   maxStrongCands_(20),
   minNodeDist_(50),
   rel_(RelaxationPtr()),            // NULL
+  sharedPC_(0),
   status_(NotModifiedByBrancher),
   thresh_(4),
   trustCutoff_(true),
   x_(0)
 {
-  timer_ = env->getNewTimer();
+  prof_ = env->getProfiler();
+  timer_ = env->getNewThreadTimer();
   logger_ = env->getLogger();
   stats_ = new ParRelBrStats();
   stats_->calls = 0;
@@ -76,8 +80,8 @@ ParReliabilityBrancher::~ParReliabilityBrancher()
 
 BrCandPtr ParReliabilityBrancher::findBestCandidate_(const double objval, 
                                                   double cutoff, NodePtr node,
-                                                  DoubleVector pseudoUp,
-                                                  DoubleVector pseudoDown,
+                                                  const DoubleVector &pseudoUp,
+                                                  const DoubleVector &pseudoDown,
                                                   UInt nodesProc)
 {
   double best_score = -INFINITY;
@@ -183,6 +187,14 @@ Branches ParReliabilityBrancher::findBranches(RelaxationPtr rel, NodePtr node,
   x_.resize(rel->getNumVars());
   std::copy(x, x+rel->getNumVars(), x_.begin());
 
+  if (sharedPC_) {
+    // the caller need not fill these in, they are read from sharedPC_.
+    timesUp.resize(rel->getNumVars(), 0);
+    timesDown.resize(rel->getNumVars(), 0);
+    pseudoUp.resize(rel->getNumVars(), 0.);
+    pseudoDown.resize(rel->getNumVars(), 0.);
+  }
+
   findCandidates_(&timesUp, &timesDown, &pseudoUp, &pseudoDown, nodesProc);
   if (status_ == PrunedByBrancher) {
     br_status = status_;
@@ -294,14 +306,20 @@ void ParReliabilityBrancher::findCandidates_(UIntVector *timesUp,
   // visit each candidate in and check if it has reliable pseudo costs.
   for (BrVarCandIter it=cands.begin(); it!=cands.end(); ++it) {
     index = (*it)->getPCostIndex();
-    // global update of times and pseudoCost info
-    (*timesUp)[index] += timesUp_[index];
-    (*timesDown)[index] += timesDown_[index];
-    if ((*timesUp)[index]) {
-      (*pseudoUp)[index] = ((*pseudoUp)[index] + pseudoUp_[index]*timesUp_[index])/(*timesUp)[index];
-    }
-    if ((*timesDown)[index]) {
-      (*pseudoDown)[index] = ((*pseudoDown)[index] + pseudoDown_[index]*timesDown_[index])/(*timesDown)[index];
+    if (sharedPC_) {
+      // the shared table already has the observations of this thread.
+      sharedPC_->get(index, &((*timesDown)[index]), &((*timesUp)[index]),
+                     &((*pseudoDown)[index]), &((*pseudoUp)[index]));
+    } else {
+      // global update of times and pseudoCost info
+      (*timesUp)[index] += timesUp_[index];
+      (*timesDown)[index] += timesDown_[index];
+      if ((*timesUp)[index]) {
+        (*pseudoUp)[index] = ((*pseudoUp)[index] + pseudoUp_[index]*timesUp_[index])/(*timesUp)[index];
+      }
+      if ((*timesDown)[index]) {
+        (*pseudoDown)[index] = ((*pseudoDown)[index] + pseudoDown_[index]*timesDown_[index])/(*timesDown)[index];
+      }
     }
     // to also accommodate node resolves, use below commented line
     //if ((minNodeDist_ > fabs(stats_->calls-lastStrBranched_[index])) ||
@@ -378,7 +396,8 @@ std::string ParReliabilityBrancher::getName() const
 
 void ParReliabilityBrancher::getPCScore_(BrCandPtr cand, double *ch_down, 
                                       double *ch_up, double *score,
-                                      DoubleVector pseudoUp, DoubleVector pseudoDown) 
+                                      const DoubleVector &pseudoUp,
+                                      const DoubleVector &pseudoDown)
 {
   int index = cand->getPCostIndex();
   if (index>-1) {
@@ -428,6 +447,18 @@ void ParReliabilityBrancher::initialize(RelaxationPtr rel)
 }
 
 
+void ParReliabilityBrancher::setSharedPCosts(ParPseudoCosts *pc)
+{
+  sharedPC_ = pc;
+  if (sharedPC_ && init_) {
+    for (UInt i=0; i<timesUp_.size(); ++i) {
+      sharedPC_->add(i, pseudoDown_[i], timesDown_[i], DownBranch);
+      sharedPC_->add(i, pseudoUp_[i], timesUp_[i], UpBranch);
+    }
+  }
+}
+
+
 void ParReliabilityBrancher::setTrustCutoff(bool val)
 {
   trustCutoff_ = val;
@@ -510,6 +541,7 @@ void ParReliabilityBrancher::strongBranch_(BrCandPtr cand, double & obj_up,
                                         EngineStatus & status_up, 
                                         EngineStatus & status_down)
 {
+  ProfScope ps(prof_, "strong branching");
   HandlerPtr h = cand->getHandler();
   ModificationPtr mod;
 
@@ -558,8 +590,14 @@ void ParReliabilityBrancher::updateAfterSolve(NodePtr node, ConstSolutionPtr sol
       }
       if (newval < oldval) {
         updatePCost_(index, cost, pseudoDown_, timesDown_);
+        if (sharedPC_) {
+          sharedPC_->add(index, cost, DownBranch);
+        }
       } else {
         updatePCost_(index, cost, pseudoUp_, timesUp_);
+        if (sharedPC_) {
+          sharedPC_->add(index, cost, UpBranch);
+        }
       }
     } 
   }
@@ -607,9 +645,15 @@ void ParReliabilityBrancher::useStrongBranchInfo_(BrCandPtr cand,
   } else { 
     cost = fabs(change_down)/(fabs(cand->getDDist())+eTol_);
     updatePCost_(index, cost, pseudoDown_, timesDown_);
+    if (sharedPC_) {
+      sharedPC_->add(index, cost, DownBranch);
+    }
 
     cost = fabs(change_up)/(fabs(cand->getUDist())+eTol_);
     updatePCost_(index, cost, pseudoUp_, timesUp_);
+    if (sharedPC_) {
+      sharedPC_->add(index, cost, UpBranch);
+    }
   }
 }
 
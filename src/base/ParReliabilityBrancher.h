@@ -20,6 +20,8 @@
 namespace Minotaur {
 
 class Engine;
+class ParPseudoCosts;
+class Profiler;
 class Timer;
 typedef Engine* EnginePtr;
 
@@ -108,6 +110,18 @@ public:
    */
   void initialize(RelaxationPtr rel);
 
+  /**
+   * \brief Use pseudo costs shared with the branchers of other threads.
+   *
+   * Pseudo costs observed by this brancher are added to the table, and
+   * candidates are scored using the pseudo costs in the table instead of
+   * those passed to findBranches(). Observations made before this call are
+   * also added to the table.
+   *
+   * \param[in] pc The shared table. NULL to stop sharing.
+   */
+  void setSharedPCosts(ParPseudoCosts *pc);
+
   /// Set value of trustCutoff parameter.
   void setTrustCutoff(bool val);
 
@@ -195,8 +209,9 @@ private:
    * \param[in] node The node at which we are branching.
    */
   BrCandPtr findBestCandidate_(const double objval, double cutoff,
-                               NodePtr node, DoubleVector pseudoUp,
-                               DoubleVector pseudoDown, UInt nodesProc);
+                               NodePtr node, const DoubleVector &pseudoUp,
+                               const DoubleVector &pseudoDown,
+                               UInt nodesProc);
 
   /**
    * \brief Find and sort candidates for branching.
@@ -226,7 +241,8 @@ private:
    * \param[out] score The total score returned by this function.
    */
   void getPCScore_(BrCandPtr cand, double *ch_down, double *ch_up, 
-                   double *score, DoubleVector pseudoUp, DoubleVector pseudoDown);
+                   double *score, const DoubleVector &pseudoUp,
+                   const DoubleVector &pseudoDown);
 
   /**
    * \brief Calculate score from the up score and down score.
@@ -373,13 +389,20 @@ private:
   /// A vector of candidates that have reliable pseudocosts.
   std::vector<BrCandPtr> relCands_;
 
+  /// Pseudo costs shared with other threads. NULL if not shared.
+  ParPseudoCosts *sharedPC_;
+
   /// Statistics.
   ParRelBrStats * stats_;
 
+  /// Profiler for timing strong branching. NULL if not profiling.
+  Profiler *prof_;
+
   /// Status of problem after using this brancher.
   BrancherStatus status_;
 
-  /// Timer to track time spent in this class.
+  /// Timer to track time spent in this class. Counts only the cpu time of
+  /// the thread that owns this brancher.
   Timer *timer_;
 
   /**
@@ -23,6 +23,7 @@
 #include "Option.h"
 #include "Timer.h"
 #include "ParTreeManager.h"
+#include "WarmStartSpill.h"
 
 using namespace Minotaur;
 
@@ -32,9 +33,19 @@ ParTreeManager::ParTreeManager(EnvPtr env)
   cutOff_(INFINITY),
   doVbc_(false),
   etol_(1e-6),
+  nActive_(0),
+  nThreads_(0),
+  nOpen_(0),
+  nSteals_(0),
   size_(0),
-  timer_(0)
+  timer_(0),
+  thLb_(0),
+  thLock_(0),
+  thNodes_(0),
+  thSize_(0),
+  wsSpill_(0)
 {
+  double mem_limit;
   std::string s = env->getOptions()->findString("tree_search")->getValue();
   if ("dfs"==s) {
     searchType_ = DepthFirst;
@@ -46,20 +57,15 @@ ParTreeManager::ParTreeManager(EnvPtr env)
      assert (!"search strategy must be defined!");
   }
 
-  switch (searchType_) {
-   case (DepthFirst):
-     activeNodes_ = (NodeStackPtr) new NodeStack();
-     break;
-   case (BestFirst):
-   case (BestThenDive):
-     activeNodes_ = (NodeHeapPtr) new NodeHeap(NodeHeap::Value);
-     break;
-   default:
-     assert (!"search strategy must be defined!");
-  }
-
+  activeNodes_ = newStore_();
   aNode_ = NodePtr();
   cutOff_ = env->getOptions()->findDouble("obj_cut_off")->getValue();
+  mem_limit = env->getOptions()->findDouble("node_mem_limit")->getValue();
+  if (mem_limit > 0) {
+    s = env->getOptions()->findString("node_mem_policy")->getValue();
+    wsSpill_ = new WarmStartSpill(env, 1048576.0*mem_limit, // MB to bytes
+                                  "drop"==s);
+  }
   tbRule_ = env->getOptions()->findString("tb_rule")->getValue();
   s = env->getOptions()->findString("vbc_file")->getValue();
   if (s!="") {
@@ -73,7 +79,7 @@ ParTreeManager::ParTreeManager(EnvPtr env)
       vbcFile_ << "#BOUNDS: NONE" << std::endl;
       vbcFile_ << "#INFORMATION: STANDARD" << std::endl;
       vbcFile_ << "#NODE_NUMBER: NONE" << std::endl;
-      timer_ = env->getNewTimer();
+      timer_ = env->getNewWallTimer();
       timer_->start();
     }
   }
@@ -84,10 +90,24 @@ ParTreeManager::~ParTreeManager()
 {
   clearAll();
   delete activeNodes_;
+  if (nThreads_ > 0) {
+    for (UInt i=0; i<nThreads_; ++i) {
+      delete thNodes_[i];
+      omp_destroy_lock(&thLock_[i]);
+    }
+    omp_destroy_lock(&treeLock_);
+    delete [] thNodes_;
+    delete [] thLock_;
+    delete [] thLb_;
+    delete [] thSize_;
+  }
   if (doVbc_) {
     vbcFile_.close();
     delete timer_;
   }
+  if (wsSpill_) {
+    delete wsSpill_;
+  }
 }
 
 
@@ -97,6 +117,15 @@ bool ParTreeManager::anyActiveNodesLeft()
 }
 
 
+bool ParTreeManager::anyOpenNodesPar()
+{
+  UInt n;
+#pragma omp atomic read
+  n = nOpen_;
+  return (n > 0);
+}
+
+
 NodePtr ParTreeManager::branch(Branches branches, NodePtr node, WarmStartPtr ws)
 {
   BranchPtr branch_p;
@@ -139,6 +168,71 @@ NodePtr ParTreeManager::branch(Branches branches, NodePtr node, WarmStartPtr ws)
 }
 
 
+NodePtr ParTreeManager::branchPar(Branches branches, NodePtr node,
+                                  WarmStartPtr ws, UInt tid)
+{
+  BranchPtr branch_p;
+  NodePtr new_cand = NodePtr(); // NULL
+  NodePtr child;
+  NodePtrVector children;
+  bool is_first = shouldDive();
+  UInt n;
+
+  // Other threads may remove the siblings or ancestors of this node.
+  omp_set_lock(&treeLock_);
+  for (BranchConstIterator br_iter=branches->begin(); br_iter!=branches->end();
+      ++br_iter) {
+    branch_p = *br_iter;
+    child = (NodePtr) new Node(node, branch_p);
+    child->setLb(node->getLb());
+    child->setTbScore(node->getTbScore());
+    child->setDepth(node->getDepth()+1);
+    child->setWarmStart(ws);
+    node->addChild(child);
+    if (is_first) {
+      setCandidateInfo_(child, true);
+      is_first = false;
+      new_cand = child;
+    } else {
+      setCandidateInfo_(child, false);
+      children.push_back(child);
+    }
+  }
+  if (doVbc_) {
+    vbcFile_ << toClockTime(timer_->query()) << " P " << node->getId()+1 << " "
+             << VbcSolved << std::endl;
+    if (new_cand) {
+      vbcFile_ << toClockTime(timer_->query()) << " P "
+               << new_cand->getId()+1 << " " << VbcSolving << std::endl;
+    }
+  }
+  omp_unset_lock(&treeLock_);
+
+  n = children.size();
+  if (n > 0) {
+    omp_set_lock(&thLock_[tid]);
+    for (NodePtrIterator it=children.begin(); it!=children.end(); ++it) {
+      thNodes_[tid]->push(*it);
+    }
+#pragma omp atomic write
+    thSize_[tid] = thNodes_[tid]->getSize();
+    omp_unset_lock(&thLock_[tid]);
+#pragma omp atomic
+    nActive_ += n;
+  }
+
+  // the children are open now and node is not.
+  if (new_cand) {
+    ++n;
+  }
+#pragma omp atomic
+  nOpen_ += n;
+#pragma omp atomic
+  --nOpen_;
+  return new_cand;
+}
+
+
 void ParTreeManager::clearAll()
 {
   NodePtr n;
@@ -153,11 +247,27 @@ void ParTreeManager::clearAll()
     removeNodeAndUp_(n);
     activeNodes_->pop();
   }
+  for (UInt i=0; i<nThreads_; ++i) {
+    while (false==thNodes_[i]->isEmpty()) {
+      n = thNodes_[i]->top();
+      removeNodeAndUp_(n);
+      thNodes_[i]->pop();
+    }
+    thSize_[i] = 0;
+  }
+  nActive_ = 0;
+  nOpen_ = 0;
 }
 
 
 UInt ParTreeManager::getActiveNodes() const
 {
+  if (nThreads_ > 0) {
+    UInt n;
+#pragma omp atomic read
+    n = nActive_;
+    return n;
+  }
   return activeNodes_->getSize();
 }
 
@@ -167,6 +277,10 @@ NodePtr ParTreeManager::getCandidate()
   NodePtr node = NodePtr(); // NULL
   //aNode_.reset();
   aNode_ = 0;
+  if (wsSpill_) {
+    // another thread may still be loading the warm start of its node.
+    wsSpill_->check(activeNodes_, false);
+  }
   while (activeNodes_->getSize() > 0) {
     node = activeNodes_->top();
     if (shouldPrune_(node)) {
@@ -182,11 +296,36 @@ NodePtr ParTreeManager::getCandidate()
       break;
     }
   } 
+  if (wsSpill_) {
+    wsSpill_->load(node);
+  }
   return node; // can be NULL
   // do not pop the head until the candidate has been processed.
 }
 
 
+NodePtr ParTreeManager::getCandidatePar(UInt tid)
+{
+  NodePtr node = popPar_(tid, tid, true);
+  UInt n;
+
+  // steal. Start with the next thread so that the victims are spread out.
+  for (UInt i=1; i<nThreads_ && !node; ++i) {
+    UInt owner = (tid+i) % nThreads_;
+#pragma omp atomic read
+    n = thSize_[owner];
+    if (n > 0) {
+      node = popPar_(tid, owner, false);
+      if (node) {
+#pragma omp atomic
+        ++nSteals_;
+      }
+    }
+  }
+  return node; // can be NULL
+}
+
+
 double ParTreeManager::getCutOff()
 {
   return cutOff_;
@@ -241,6 +380,29 @@ double ParTreeManager::getLb()
 }
 
 
+double ParTreeManager::getLbPar()
+{
+  double lb = INFINITY;
+  double thlb;
+  for (UInt i=0; i<nThreads_; ++i) {
+#pragma omp atomic read
+    thlb = thLb_[i];
+    if (thlb < lb) {
+      lb = thlb;
+    }
+  }
+#pragma omp atomic write
+  bestLowerBound_ = lb;
+  return lb;
+}
+
+
+UInt ParTreeManager::getNumSteals() const
+{
+  return nSteals_;
+}
+
+
 UInt ParTreeManager::getSize() const
 {
   return size_;
@@ -255,33 +417,7 @@ double ParTreeManager::getUb()
 
 void ParTreeManager::insertCandidate_(NodePtr node, bool pop_now)
 {
-  assert(size_>0);
-
-  // set node id and depth
-  node->setId(size_);
-  node->setDepth(node->getParent()->getDepth()+1);
-  if (tbRule_ == "twoChild") {
-    bool dir = node->getBranch()->getBrCand()->getDir();
-      if (pop_now) {
-        if (!dir) { // down branch
-          node->setTbScore(2*(node->getParent()->getTbScore()));
-        } else { // up branch
-          node->setTbScore(2*(node->getParent()->getTbScore())+1);
-        }
-      } else {
-        if (!dir) { //up branch for the second child
-          node->setTbScore(2*(node->getParent()->getTbScore())+1);
-        } else { //down branch for the second child
-          node->setTbScore(2*(node->getParent()->getTbScore()));
-        }
-      }
-  } else if (tbRule_ == "FIFO") {
-      node->setTbScore(node->getId());
-  } else {
-    node->setTbScore(node->getParent()->getTbScore());
-  }
-
-  ++size_;
+  setCandidateInfo_(node, pop_now);
 
   // add node to the heap/stack of active nodes. If pop_now is true, the node
   // is processed right after creating it; we don't
@@ -289,11 +425,6 @@ void ParTreeManager::insertCandidate_(NodePtr node, bool pop_now)
   if (!pop_now) {
     activeNodes_->push(node);
   } 
-  if (doVbc_) {
-    vbcFile_ << toClockTime(timer_->query()) << " N "
-      << node->getParent()->getId()+1 << " " << node->getId()+1
-      << " " << VbcActive << std::endl;
-  }
 }
 
 
@@ -314,6 +445,87 @@ void ParTreeManager::insertRoot(NodePtr node)
 }
 
 
+void ParTreeManager::newIncumbent(double value)
+{
+  setUbPar(value);
+}
+
+
+ActiveNodeStorePtr ParTreeManager::newStore_()
+{
+  ActiveNodeStorePtr store = 0;
+  switch (searchType_) {
+   case (DepthFirst):
+     store = (NodeStackPtr) new NodeStack();
+     break;
+   case (BestFirst):
+   case (BestThenDive):
+     store = (NodeHeapPtr) new NodeHeap(NodeHeap::Value);
+     break;
+   default:
+     assert (!"search strategy must be defined!");
+  }
+  return store;
+}
+
+
+NodePtr ParTreeManager::popPar_(UInt tid, UInt owner, bool wait)
+{
+  NodePtr node = NodePtr(); // NULL
+  NodePtrVector pruned;
+  UInt n;
+
+  if (wait) {
+    omp_set_lock(&thLock_[owner]);
+  } else if (!omp_test_lock(&thLock_[owner])) {
+    return node;
+  }
+  while (!thNodes_[owner]->isEmpty()) {
+    node = thNodes_[owner]->top();
+    thNodes_[owner]->pop();
+    if (shouldPrunePar_(node)) {
+      pruned.push_back(node);
+      node = 0;
+    } else {
+      break;
+    }
+  }
+  n = thNodes_[owner]->getSize();
+#pragma omp atomic write
+  thSize_[owner] = n;
+  if (node && owner != tid) {
+    // the owner may forget this node in its bound as soon as we unlock, so
+    // this thread must account for it first.
+    double lb;
+#pragma omp atomic read
+    lb = thLb_[tid];
+    if (node->getLb() < lb) {
+      lb = node->getLb();
+#pragma omp atomic write
+      thLb_[tid] = lb;
+    }
+  }
+  omp_unset_lock(&thLock_[owner]);
+
+  n = pruned.size();
+  if (node) {
+    ++n;
+  }
+#pragma omp atomic
+  nActive_ -= n;
+  for (NodePtrIterator it=pruned.begin(); it!=pruned.end(); ++it) {
+    pruneNodePar(*it);
+  }
+  if (node && doVbc_) {
+    omp_set_lock(&treeLock_);
+    vbcFile_ << toClockTime(timer_->query()) << " P " << node->getId()+1
+             << " " << VbcSolving << std::endl;
+    omp_unset_lock(&treeLock_);
+  }
+  return node; // can be NULL
+}
+
+
 void ParTreeManager::pruneNode(NodePtr node)
 {
   // XXX: if required do something before deleting the node.
@@ -321,6 +533,16 @@ void ParTreeManager::pruneNode(NodePtr node)
 }
 
 
+void ParTreeManager::pruneNodePar(NodePtr node)
+{
+  omp_set_lock(&treeLock_);
+  removeNodeAndUp_(node);
+  omp_unset_lock(&treeLock_);
+#pragma omp atomic
+  --nOpen_;
+}
+
+
 void ParTreeManager::removeActiveNode(NodePtr node)
 {
   if (doVbc_) {
@@ -395,6 +617,44 @@ void ParTreeManager::removeNodeAndUp_(NodePtr node)
 }
 
 
+void ParTreeManager::setCandidateInfo_(NodePtr node, bool pop_now)
+{
+  assert(size_>0);
+
+  // set node id and depth
+  node->setId(size_);
+  node->setDepth(node->getParent()->getDepth()+1);
+  if (tbRule_ == "twoChild") {
+    bool dir = node->getBranch()->getBrCand()->getDir();
+      if (pop_now) {
+        if (!dir) { // down branch
+          node->setTbScore(2*(node->getParent()->getTbScore()));
+        } else { // up branch
+          node->setTbScore(2*(node->getParent()->getTbScore())+1);
+        }
+      } else {
+        if (!dir) { //up branch for the second child
+          node->setTbScore(2*(node->getParent()->getTbScore())+1);
+        } else { //down branch for the second child
+          node->setTbScore(2*(node->getParent()->getTbScore()));
+        }
+      }
+  } else if (tbRule_ == "FIFO") {
+      node->setTbScore(node->getId());
+  } else {
+    node->setTbScore(node->getParent()->getTbScore());
+  }
+
+  ++size_;
+
+  if (doVbc_) {
+    vbcFile_ << toClockTime(timer_->query()) << " N "
+      << node->getParent()->getId()+1 << " " << node->getId()+1
+      << " " << VbcActive << std::endl;
+  }
+}
+
+
 void ParTreeManager::setCutOff(double value)
 {
   cutOff_ = value;
@@ -410,6 +670,63 @@ void ParTreeManager::setUb(double value)
 }
 
 
+void ParTreeManager::setUbPar(double value)
+{
+#pragma omp critical (treeManagerUb)
+  {
+    if (value < bestUpperBound_) {
+#pragma omp atomic write
+      bestUpperBound_ = value;
+    }
+    if (value < cutOff_) {
+#pragma omp atomic write
+      cutOff_ = value;
+    }
+  }
+}
+
+
+void ParTreeManager::setWorkStealing(UInt num_threads, NodePtr node)
+{
+  UInt i = 0;
+  assert(0==nThreads_ && num_threads>0);
+
+  nThreads_ = num_threads;
+  thNodes_ = new ActiveNodeStorePtr[nThreads_];
+  thLock_ = new omp_lock_t[nThreads_];
+  thLb_ = new double[nThreads_];
+  thSize_ = new UInt[nThreads_];
+  for (i=0; i<nThreads_; ++i) {
+    thNodes_[i] = newStore_();
+    omp_init_lock(&thLock_[i]);
+  }
+  omp_init_lock(&treeLock_);
+
+  // best nodes go to different threads.
+  nActive_ = 0;
+  i = 0;
+  while (false==activeNodes_->isEmpty()) {
+    thNodes_[i]->push(activeNodes_->top());
+    activeNodes_->pop();
+    ++nActive_;
+    i = (i+1) % nThreads_;
+  }
+  nOpen_ = nActive_;
+  if (node) {
+    ++nOpen_;
+  }
+
+  for (i=0; i<nThreads_; ++i) {
+    thSize_[i] = thNodes_[i]->getSize();
+    thLb_[i] = thNodes_[i]->getBestLB();
+  }
+  if (node && node->getLb() < thLb_[0]) {
+    thLb_[0] = node->getLb();
+  }
+  aNode_ = 0;
+}
+
+
 bool ParTreeManager::shouldDive()
 {
   if (searchType_ == DepthFirst || searchType_ == BestThenDive) {
@@ -431,6 +748,23 @@ bool ParTreeManager::shouldPrune_(NodePtr node)
 }
 
 
+bool ParTreeManager::shouldPrunePar_(NodePtr node)
+{
+  double lb = node->getLb();
+  double ub, cutoff;
+#pragma omp atomic read
+  ub = bestUpperBound_;
+#pragma omp atomic read
+  cutoff = cutOff_;
+  if (lb > cutoff - etol_ || 
+      fabs(ub-lb)/(fabs(ub)+etol_)*100 < etol_) {
+    node->setStatus(NodeHitUb);
+    return true;
+  }
+  return false;
+}
+
+
 double ParTreeManager::updateLb()
 {
   // this could be an expensive operation. Try to avoid it.
@@ -440,6 +774,31 @@ double ParTreeManager::updateLb()
 }
 
 
+double ParTreeManager::updateLbPar(UInt tid, NodePtr node)
+{
+  double lb;
+
+  // only this thread writes thLb_[tid]. The lock keeps thieves from taking a
+  // node between reading the store and writing the bound.
+  omp_set_lock(&thLock_[tid]);
+  lb = thNodes_[tid]->getBestLB();
+  if (node && node->getLb() < lb) {
+    lb = node->getLb();
+  }
+#pragma omp atomic write
+  thLb_[tid] = lb;
+  omp_unset_lock(&thLock_[tid]);
+  return getLbPar();
+}
+
+
+void ParTreeManager::writeStats(std::ostream &out) const
+{
+  if (wsSpill_) {
+    wsSpill_->writeStats(out);
+  }
+}
+
 // Local Variables: 
 // mode: c++ 
 // eval: (c-set-style "k&r") 
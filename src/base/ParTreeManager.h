@@ -15,15 +15,23 @@
 
 #include <iostream>
 #include <fstream>
+#if USE_OPENMP
+#include <omp.h>
+#else
+#error "Cannot compile parallel algorithms: turn USE_OpenMP flag ON."
+#endif
 
+#include "SolutionPool.h"
 #include "Types.h"
 
 namespace Minotaur {
   
   class ActiveNodeStore;
   class WarmStart;
+  class WarmStartSpill;
   typedef ActiveNodeStore* ActiveNodeStorePtr;
   typedef WarmStart* WarmStartPtr;
+  typedef WarmStartSpill* WarmStartSpillPtr;
 
   // 1=like_red, 2=blue, 4=red, 5=yellow, 6=black, 7=pink, 8=cyan, 9=green
   // 11=orange, 12=green, 13=pink, 14=light blue
@@ -40,7 +48,7 @@ namespace Minotaur {
 
 
   /// Base class for managing the branch-and-bound tree. 
-  class ParTreeManager {
+  class ParTreeManager : public SolutionPoolListener {
 
   public:
     friend class ParBranchAndBound;
@@ -55,6 +63,12 @@ namespace Minotaur {
     /// Return true if any active nodes remain in the tree. False otherwise.
     bool anyActiveNodesLeft();
 
+    /**
+     * \brief Return true if some node is either stored or being processed by
+     * a thread. Used in work-stealing mode.
+     */
+    bool anyOpenNodesPar();
+
     /**
      * \brief Branch and create new nodes.
      *
@@ -67,6 +81,23 @@ namespace Minotaur {
      */
     NodePtr branch(Branches branches, NodePtr node, WarmStartPtr ws);
 
+    /**
+     * \brief Branch and create new nodes in work-stealing mode.
+     *
+     * The children that are not processed right away are added to the store
+     * of the calling thread. The node is no longer counted as open after
+     * this call.
+     * \param[in] branches The branching constraints or bounds or disjunctions
+     * that are used to create the new nodes after branching.
+     * \param[in] node The node that we wish to branch upon.
+     * \param[in] ws The warm starting information that should be linked to
+     * in the new nodes.
+     * \param[in] tid The calling thread.
+     * \returns The first child node if we should dive, NULL otherwise.
+     */
+    NodePtr branchPar(Branches branches, NodePtr node, WarmStartPtr ws,
+                      UInt tid);
+
     /**
      * \brief Return the number of active nodes, i.e. nodes that have been
      * created, but not processed yet.
@@ -107,6 +138,12 @@ namespace Minotaur {
     /// Return the best known upper bound.
     double getUb();
 
+    /**
+     * \brief Update the upper bound and cutoff when a thread adds a better
+     * solution to the pool. Calls setUbPar().
+     */
+    void newIncumbent(double value);
+
     /**
      * \brief Return the size of the tree, including both active and processed
      * nodes.
@@ -123,6 +160,29 @@ namespace Minotaur {
      */
     NodePtr getCandidate();
 
+    /**
+     * \brief Remove and return the best candidate of the store of a thread
+     * in work-stealing mode.
+     *
+     * If the store of the thread is empty, a node is stolen from the store
+     * of another thread. Nodes that can be pruned are removed from the tree
+     * on the way.
+     * \param[in] tid The calling thread.
+     * \return The candidate. NULL if no candidate was found.
+     */
+    NodePtr getCandidatePar(UInt tid);
+
+    /**
+     * \brief Return the lower bound of the tree in work-stealing mode.
+     *
+     * It is the minimum of the bounds last reported by each thread in
+     * updateLbPar() and hence it never exceeds the true bound of the tree.
+     */
+    double getLbPar();
+
+    /// Return the number of nodes stolen from other threads.
+    UInt getNumSteals() const;
+
     /**
      * \brief Insert the root node into the tree.
      *
@@ -137,6 +197,14 @@ namespace Minotaur {
      */
     void pruneNode(NodePtr node);
 
+    /**
+     * \brief Prune a node that is held by a thread in work-stealing mode.
+     *
+     * \param[in] node The node that must be pruned. It must not be in any
+     * store.
+     */
+    void pruneNodePar(NodePtr node);
+
     /**
      * \brief Remove a given active node from storage.
      *
@@ -163,6 +231,30 @@ namespace Minotaur {
      */
     void setUb(double value);
 
+    /**
+     * \brief Set the best known objective function value in work-stealing
+     * mode. Unlike setUb(), the value is ignored if it is not better than the
+     * current one, so threads may call it in any order.
+     *
+     * \param[in] value The new upper bound.
+     */
+    void setUbPar(double value);
+
+    /**
+     * \brief Switch to work-stealing mode.
+     *
+     * Each thread gets its own store of active nodes protected by its own
+     * lock. Threads add the children they create to their own store and
+     * take nodes from the stores of other threads only when their own is
+     * empty. The nodes that are currently active are distributed among the
+     * threads in a round-robin manner. Must be called before the parallel
+     * region, e.g. after the root node has been processed.
+     * \param[in] num_threads The number of threads.
+     * \param[in] node A node held by thread 0 that is not in the store. Can
+     * be NULL.
+     */
+    void setWorkStealing(UInt num_threads, NodePtr node);
+
     /// Return true if the tree-manager recommends diving. False otherwise.
     bool shouldDive();
 
@@ -177,6 +269,19 @@ namespace Minotaur {
      */
     double updateLb();
 
+    /**
+     * \brief Recalculate the lower bound of the nodes of a thread in
+     * work-stealing mode and return the lower bound of the tree.
+     *
+     * \param[in] tid The calling thread.
+     * \param[in] node The node held by the thread. Can be NULL.
+     * \return The updated lower bound of the tree, see getLbPar().
+     */
+    double updateLbPar(UInt tid, NodePtr node);
+
+    /// Write statistics of spilled or dropped warm starts, if any.
+    void writeStats(std::ostream &out) const;
+
   private:
     /// Set of nodes that are still active (those who need to be processed).
     ActiveNodeStorePtr activeNodes_;
@@ -203,6 +308,21 @@ namespace Minotaur {
     /// Tolerance for pruning nodes on the basis of bounds.
     const double etol_;
 
+    /// Number of nodes in all stores of threads in work-stealing mode.
+    UInt nActive_;
+
+    /// Number of threads in work-stealing mode. Zero otherwise.
+    UInt nThreads_;
+
+    /**
+     * \brief Number of nodes that are either in the stores or are being
+     * processed by threads in work-stealing mode.
+     */
+    UInt nOpen_;
+
+    /// Number of nodes stolen from other threads.
+    UInt nSteals_;
+
     /// The search order: depth first, best first or something else.
     TreeSearchOrder searchType_;
 
@@ -218,12 +338,64 @@ namespace Minotaur {
     /// Tie breaking rule (second priority) for node selection.
     std::string tbRule_;
 
+    /// Lower bound of the nodes of each thread, in work-stealing mode.
+    double *thLb_;
+
+    /// Locks of the stores of each thread, in work-stealing mode.
+    omp_lock_t *thLock_;
+
+    /// Stores of active nodes of each thread, in work-stealing mode.
+    ActiveNodeStorePtr *thNodes_;
+
+    /// Number of nodes in the store of each thread, in work-stealing mode.
+    UInt *thSize_;
+
+    /// Lock for changes in the structure of the tree in work-stealing mode.
+    omp_lock_t treeLock_;
+
     /// File name to store tree information for vbc.
     std::ofstream vbcFile_;
 
+    /**
+     * \brief Spills warm starts of active nodes to a file when they use
+     * more memory than the limit. NULL if there is no limit.
+     */
+    WarmStartSpillPtr wsSpill_;
+
+    /// Create a new store of active nodes for the search order.
+    ActiveNodeStorePtr newStore_();
+
+    /**
+     * \brief Remove the best node from the store of a thread, pruning nodes
+     * on the way.
+     *
+     * \param[in] tid The calling thread.
+     * \param[in] owner The thread whose store is searched.
+     * \param[in] wait If false, give up when the store is locked by some
+     * other thread.
+     * \return The node. NULL if none was found.
+     */
+    NodePtr popPar_(UInt tid, UInt owner, bool wait);
+
+    /**
+     * \brief Set id, tie-breaking score of a new node (that is not root) and
+     * update the size of the tree.
+     *
+     * \param[in] node The new node.
+     * \param[in] pop_now True if the node is processed right after creating
+     * it.
+     */
+    void setCandidateInfo_(NodePtr node, bool pop_now);
+
     /// Check if the node can be pruned because of its bound.
     bool shouldPrune_(NodePtr node);
 
+    /**
+     * \brief Check if the node can be pruned because of its bound, when the
+     * bound may be changed by other threads.
+     */
+    bool shouldPrunePar_(NodePtr node);
+
     /**
      * \brief Insert a candidate (that is not root) into the tree.
      *
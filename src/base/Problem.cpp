@@ -42,8 +42,10 @@ Problem::Problem(EnvPtr env)
   consModed_(false),
   engine_(0),
   hessian_(0),
+  holdCons_(false),
   jacobian_(0),
   nativeDer_(false),
+  newConsBeg_(0),
   nextCId_(0),
   nextSId_(0),
   nextVId_(0),
@@ -996,6 +998,8 @@ void Problem::delMarkedCons()
     std::vector<ConstraintPtr> copycons;
     std::vector<ConstraintPtr> delcons;
 
+    // the engine must know of all constraints before some are removed.
+    flushNewCons_();
     for (ConstraintIterator it=cons_.begin(); it!=cons_.end(); ++it) {
       c = *it;
       if (c->getState() == DeletedCons) {
@@ -1029,6 +1033,7 @@ void Problem::delMarkedCons()
     cons_ = copycons;
     consModed_ = true;
     numDCons_ = 0;
+    newConsBeg_ = cons_.size();
   }
 }
 
@@ -1071,6 +1076,13 @@ void Problem::delMarkedVars(bool keep)
 }
 
 
+void Problem::endConsBatch()
+{
+  flushNewCons_();
+  holdCons_ = false;
+}
+
+
 ProblemType Problem::findType()
 {
   calculateSize();
@@ -1094,6 +1106,15 @@ ProblemType Problem::findType()
 }
 
 
+void Problem::flushNewCons_()
+{
+  if (holdCons_ && engine_ && newConsBeg_ < cons_.size()) {
+    engine_->addConstraints(cons_.begin()+newConsBeg_, cons_.end());
+  }
+  newConsBeg_ = cons_.size();
+}
+
+
 void Problem::findVarFunTypes_()
 {
   FunctionType ftype;
@@ -1401,7 +1422,7 @@ ConstraintPtr Problem::newConstraint(FunctionPtr f, double lb, double ub,
     }
   }
   cons_.push_back(c);
-  if (engine_ != 0) {
+  if (engine_ != 0 && false==holdCons_) {
     engine_->addConstraint(c);
   }
   consModed_ = true;
@@ -1420,12 +1441,8 @@ ConstraintPtr Problem::newConstraint(FunctionPtr funPtr, double lb, double ub)
   name_stream << "cons" << cons_.size();
   name = name_stream.str();
 
-  // make a constraint,
+  // make a constraint, the engine is notified there.
   c = (ConstraintPtr) newConstraint(funPtr, lb, ub, name);
-  if (engine_ != 0) {
-    engine_->addConstraint(c);
-  }
-
   return c;
 }
 
@@ -1592,11 +1609,35 @@ void Problem::objToCons()
 void Problem::prepareForSolve()
 {
   bool reload = false;
+  LinearFunctionPtr lf;
+  QuadraticFunctionPtr qf;
 
   if (consModed_ || varsModed_) {
     reload = true;
   }
   calculateSize();
+
+  // evaluate linear and quadratic terms from flat arrays.
+  for (ConstraintConstIterator it=cons_.begin(); it!=cons_.end(); ++it) {
+    lf = (*it)->getLinearFunction();
+    qf = (*it)->getQuadraticFunction();
+    if (lf) {
+      lf->finalize();
+    }
+    if (qf) {
+      qf->finalize();
+    }
+  }
+  if (obj_) {
+    lf = obj_->getLinearFunction();
+    qf = obj_->getQuadraticFunction();
+    if (lf) {
+      lf->finalize();
+    }
+    if (qf) {
+      qf->finalize();
+    }
+  }
   if (nativeDer_ && (true == reload || !hessian_)) {
     setNativeDer();
   } 
@@ -1659,6 +1700,7 @@ void Problem::setEngine(Engine* engine)
     engine_->clear();
   }
   engine_ = engine;
+  newConsBeg_ = cons_.size(); // the engine loads all constraints.
 }
 
 
@@ -1773,6 +1815,15 @@ void Problem::setVarType(VariablePtr var, VariableType type)
 }
 
 
+void Problem::startConsBatch()
+{
+  if (false==holdCons_) {
+    holdCons_ = true;
+    newConsBeg_ = cons_.size();
+  }
+}
+
+
 void Problem::subst(VariablePtr out, VariablePtr in, double rat)
 {
   bool stayin;
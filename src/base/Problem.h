@@ -180,6 +180,12 @@ namespace Minotaur {
      */
     virtual void delMarkedVars(bool keep=false);
 
+    /**
+     * \brief Send the constraints added since startConsBatch() to the
+     * engine in one call and stop holding them.
+     */
+    virtual void endConsBatch();
+
     /**
      * \brief Return what type of problem it is. May result in re-calculation of
      * the problem size.
@@ -541,6 +547,16 @@ namespace Minotaur {
      */
     virtual void setVarType(VariablePtr var, VariableType type);
 
+    /**
+     * \brief Hold new constraints instead of sending each to the engine.
+     *
+     * Constraints added after this call are passed to
+     * Engine::addConstraints() together when endConsBatch() is called, so
+     * that a round of cuts is loaded with one call to the solver. Deleting
+     * constraints in between first sends the held ones.
+     */
+    virtual void startConsBatch();
+
     virtual SOSConstIterator sos1Begin() const { return sos1_.begin(); };
     virtual SOSConstIterator sos1End() const { return sos1_.end(); };
     virtual SOSConstIterator sos2Begin() const { return sos2_.begin(); };
@@ -593,6 +609,9 @@ namespace Minotaur {
     /// Pointer to the hessian of the lagrangean. Could be NULL.
     HessianOfLagPtr hessian_;
 
+    /// True if new constraints are held until endConsBatch().
+    bool holdCons_;
+
     /// Pointer to the jacobian of constraints. Can be NULL.
     JacobianPtr jacobian_;
 
@@ -605,6 +624,9 @@ namespace Minotaur {
     /// If true, set up our own Hessian and Jacobian.
     bool nativeDer_;
 
+    /// Index of the first new constraint not yet sent to the engine.
+    UInt newConsBeg_;
+
     /// ID of the next constraint.
     UInt nextCId_;
 
@@ -647,6 +669,9 @@ namespace Minotaur {
     /// Count the types of constraints and fill the values in size_.
     virtual void countConsTypes_();
 
+    /// Send the held constraints to the engine.
+    void flushNewCons_();
+
     /// Count the types of objectives and fill the values in size_.
     virtual void countObjTypes_();
 
@@ -0,0 +1,619 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2008 - 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file ProblemCache.cpp
+ * \brief Define class ProblemCache for saving a parsed problem in a binary
+ * file and loading it quickly in later runs.
+ * \author The MINOTAUR Team
+ */
+
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "MinotaurConfig.h"
+#include "CGraph.h"
+#include "CNode.h"
+#include "Constraint.h"
+#include "Environment.h"
+#include "Function.h"
+#include "LinearFunction.h"
+#include "Logger.h"
+#include "Objective.h"
+#include "Problem.h"
+#include "ProblemCache.h"
+#include "QuadraticFunction.h"
+#include "SOS.h"
+#include "Variable.h"
+
+using namespace Minotaur;
+
+const std::string ProblemCache::me_ = "ProblemCache: ";
+const UInt ProblemCache::version_ = 1;
+
+// first bytes of every cache file.
+static const char cacheMagic[8] = {'M','N','T','R','P','R','O','B'};
+
+// bits of the record of a function.
+static const UInt funLinear = 1;
+static const UInt funQuad = 2;
+static const UInt funNonlin = 4;
+
+
+ProblemCache::ProblemCache(EnvPtr env)
+  : end_(0),
+    env_(env),
+    fp_(0),
+    ok_(true),
+    pos_(0)
+{
+}
+
+
+ProblemCache::~ProblemCache()
+{
+  if (fp_) {
+    fclose(fp_);
+  }
+}
+
+
+CGraph* ProblemCache::getCGraph_(ProblemPtr p)
+{
+  CGraph *cg = new CGraph();
+  std::vector<CNode*> nodes;
+  std::vector<CNode*> kids;
+  UInt nnodes = getU_();
+  UInt nkids, k;
+  OpCode op;
+
+  if (!ok_ || nnodes == 0 || nnodes > (UInt) (end_-pos_)) {
+    ok_ = false;
+    delete cg;
+    return 0;
+  }
+  nodes.reserve(nnodes);
+  for (UInt i=0; i<nnodes && ok_; ++i) {
+    op = (OpCode) getU_();
+    nkids = getU_();
+    if (nkids > (UInt) (end_-pos_)/sizeof(UInt)) {
+      ok_ = false;
+      break;
+    }
+    kids.resize(nkids+1);
+    for (UInt j=0; j<nkids; ++j) {
+      k = getU_();
+      if (k >= nodes.size()) {
+        ok_ = false;
+        k = 0;
+      }
+      kids[j] = (ok_) ? nodes[k] : 0;
+    }
+    kids[nkids] = 0;
+    if (!ok_) {
+      break;
+    }
+    if (OpVar==op) {
+      VariablePtr v = getVar_(p);
+      if (!v) {
+        break;
+      }
+      nodes.push_back(cg->newNode(v));
+    } else if (OpNum==op) {
+      nodes.push_back(cg->newNode(getD_()));
+    } else if (OpInt==op) {
+      nodes.push_back(cg->newNode((int) getD_()));
+    } else if (nkids > 2 || OpSumList==op) {
+      nodes.push_back(cg->newNode(op, &kids[0], nkids));
+    } else {
+      nodes.push_back(cg->newNode(op, kids[0], (nkids>1) ? kids[1] : 0));
+    }
+  }
+  if (!ok_) {
+    delete cg;
+    return 0;
+  }
+  cg->setOut(nodes.back());
+  cg->finalize();
+  return cg;
+}
+
+
+double ProblemCache::getD_()
+{
+  double d = 0.0;
+  if (pos_ + sizeof(double) > end_) {
+    ok_ = false;
+  } else {
+    memcpy(&d, pos_, sizeof(double));
+    pos_ += sizeof(double);
+  }
+  return d;
+}
+
+
+FunctionPtr ProblemCache::getFun_(ProblemPtr p)
+{
+  UInt parts = getU_();
+  UInt nz;
+  LinearFunctionPtr lf = 0;
+  QuadraticFunctionPtr qf = 0;
+  CGraph *cg = 0;
+  VariablePtr v1, v2;
+  double a;
+
+  if (parts & funLinear) {
+    nz = getU_();
+    lf = (LinearFunctionPtr) new LinearFunction();
+    for (UInt i=0; i<nz && ok_; ++i) {
+      v1 = getVar_(p);
+      a = getD_();
+      if (v1) {
+        lf->addTerm(v1, a);
+      }
+    }
+  }
+  if (ok_ && (parts & funQuad)) {
+    nz = getU_();
+    qf = (QuadraticFunctionPtr) new QuadraticFunction();
+    for (UInt i=0; i<nz && ok_; ++i) {
+      v1 = getVar_(p);
+      v2 = getVar_(p);
+      a = getD_();
+      if (v1 && v2) {
+        qf->addTerm(v1, v2, a);
+      }
+    }
+  }
+  if (ok_ && (parts & funNonlin)) {
+    cg = getCGraph_(p);
+  }
+  if (!ok_) {
+    delete lf;
+    delete qf;
+    delete cg;
+    return 0;
+  }
+  if (0 == parts) {
+    return 0;
+  }
+  return (FunctionPtr) new Function(lf, qf, cg);
+}
+
+
+bool ProblemCache::getKey_(std::string src, long long *size,
+                           long long *mtime)
+{
+  struct stat st;
+  if (0 != stat(src.c_str(), &st)) {
+    // AMPL stubs are often given without the suffix.
+    src += ".nl";
+    if (0 != stat(src.c_str(), &st)) {
+      return false;
+    }
+  }
+  *size = (long long) st.st_size;
+  *mtime = (long long) st.st_mtime;
+  return true;
+}
+
+
+ProblemPtr ProblemCache::getProblem_(UInt *ndefs)
+{
+  ProblemPtr p = (ProblemPtr) new Problem(env_);
+  UInt nvars, ncons, nsos, k;
+  double lb, ub, init;
+  VariableType vtype;
+  VarSrcType stype;
+  std::string name;
+  FunctionPtr f;
+  VariablePtr v;
+  VarVector sos_vars;
+  std::vector<double> weights;
+  int priority;
+  SOSType sos_type;
+  ObjectiveType otype;
+
+  *ndefs = getU_();
+  nvars = getU_();
+  ncons = getU_();
+  if (nvars > (UInt) (end_-pos_) || ncons > (UInt) (end_-pos_)) {
+    ok_ = false;
+  }
+  for (UInt i=0; i<nvars && ok_; ++i) {
+    lb = getD_();
+    ub = getD_();
+    init = getD_();
+    vtype = (VariableType) getU_();
+    stype = (VarSrcType) getU_();
+    name = getS_();
+    v = p->newVariable(lb, ub, vtype, name, stype);
+    p->setInitVal(v, init);
+  }
+  for (UInt i=0; i<ncons && ok_; ++i) {
+    lb = getD_();
+    ub = getD_();
+    name = getS_();
+    f = getFun_(p);
+    if (ok_) {
+      p->newConstraint(f, lb, ub, name);
+    }
+  }
+  if (ok_ && 1 == getU_()) {
+    otype = (ObjectiveType) getU_();
+    init = getD_();
+    name = getS_();
+    f = getFun_(p);
+    if (ok_) {
+      p->newObjective(f, init, otype, name);
+    }
+  }
+  nsos = getU_();
+  for (UInt i=0; i<nsos && ok_; ++i) {
+    sos_type = (SOSType) getU_();
+    priority = (int) getU_();
+    name = getS_();
+    k = getU_();
+    if (k > (UInt) (end_-pos_)) {
+      ok_ = false;
+      break;
+    }
+    weights.resize(k+1);
+    sos_vars.clear();
+    for (UInt j=0; j<k && ok_; ++j) {
+      weights[j] = getD_();
+      v = getVar_(p);
+      sos_vars.push_back(v);
+    }
+    if (ok_) {
+      p->newSOS(k, sos_type, &weights[0], sos_vars, priority, name);
+    }
+  }
+  if (!ok_) {
+    delete p;
+    p = 0;
+  }
+  return p;
+}
+
+
+std::string ProblemCache::getS_()
+{
+  UInt len = getU_();
+  std::string s;
+  if (ok_ && len <= (UInt) (end_-pos_)) {
+    s.assign(pos_, len);
+    pos_ += len;
+  } else {
+    ok_ = false;
+  }
+  return s;
+}
+
+
+UInt ProblemCache::getU_()
+{
+  UInt u = 0;
+  if (pos_ + sizeof(UInt) > end_) {
+    ok_ = false;
+  } else {
+    memcpy(&u, pos_, sizeof(UInt));
+    pos_ += sizeof(UInt);
+  }
+  return u;
+}
+
+
+VariablePtr ProblemCache::getVar_(ProblemPtr p)
+{
+  UInt i = getU_();
+  if (ok_ && i < p->getNumVars()) {
+    return p->getVariable(i);
+  }
+  ok_ = false;
+  return 0;
+}
+
+
+bool ProblemCache::putCGraph_(const CGraph *cg)
+{
+  std::map<const CNode*, UInt> ids;
+  std::vector<const CNode*> order;
+  std::vector<const CNode*> stack;
+  std::vector<const CNode*> kids;
+  const CNode *node;
+  bool ready;
+
+  // number the nodes so that children come before their parents. The
+  // stack avoids deep recursion in long chains of operations.
+  if (!cg->getOut()) {
+    return false;
+  }
+  stack.push_back(cg->getOut());
+  while (!stack.empty()) {
+    node = stack.back();
+    if (ids.find(node) != ids.end()) {
+      stack.pop_back();
+      continue;
+    }
+    ready = true;
+    if (node->getListL()) {
+      for (CNode **c=node->getListL(); c!=node->getListR(); ++c) {
+        if (ids.find(*c) == ids.end()) {
+          stack.push_back(*c);
+          ready = false;
+        }
+      }
+    } else {
+      if (node->getL() && ids.find(node->getL()) == ids.end()) {
+        stack.push_back(node->getL());
+        ready = false;
+      }
+      if (node->getR() && ids.find(node->getR()) == ids.end()) {
+        stack.push_back(node->getR());
+        ready = false;
+      }
+    }
+    if (ready) {
+      ids[node] = order.size();
+      order.push_back(node);
+      stack.pop_back();
+    }
+  }
+
+  putU_(order.size());
+  for (UInt i=0; i<order.size(); ++i) {
+    node = order[i];
+    kids.clear();
+    if (node->getListL()) {
+      kids.assign(node->getListL(), node->getListR());
+    } else {
+      if (node->getL()) {
+        kids.push_back(node->getL());
+      }
+      if (node->getR()) {
+        kids.push_back(node->getR());
+      }
+    }
+    putU_((UInt) node->getOp());
+    putU_(kids.size());
+    for (UInt j=0; j<kids.size(); ++j) {
+      putU_(ids[kids[j]]);
+    }
+    switch (node->getOp()) {
+    case OpVar:
+      if (!node->getV()) {
+        return false;
+      }
+      putU_(node->getV()->getIndex());
+      break;
+    case OpNum:
+      putD_(node->getDouble());
+      break;
+    case OpInt:
+      putD_(node->getVal());
+      break;
+    default:
+      break;
+    }
+  }
+  return true;
+}
+
+
+void ProblemCache::putD_(double d)
+{
+  fwrite(&d, sizeof(double), 1, fp_);
+}
+
+
+bool ProblemCache::putFun_(const Function *f)
+{
+  LinearFunctionPtr lf = (f) ? f->getLinearFunction() : 0;
+  QuadraticFunctionPtr qf = (f) ? f->getQuadraticFunction() : 0;
+  NonlinearFunctionPtr nlf = (f) ? f->getNonlinearFunction() : 0;
+  const CGraph *cg = dynamic_cast<const CGraph*>(nlf);
+  UInt parts = 0;
+
+  if (nlf && !cg) {
+    env_->getLogger()->msgStream(LogInfo) << me_ << "only nonlinear "
+      << "functions in computational graphs can be saved." << std::endl;
+    return false;
+  }
+  parts |= (lf) ? funLinear : 0;
+  parts |= (qf) ? funQuad : 0;
+  parts |= (cg) ? funNonlin : 0;
+  putU_(parts);
+  if (lf) {
+    putU_(lf->getNumTerms());
+    for (VariableGroupConstIterator it=lf->termsBegin(); it!=lf->termsEnd();
+         ++it) {
+      putU_(it->first->getIndex());
+      putD_(it->second);
+    }
+  }
+  if (qf) {
+    putU_(qf->getNumTerms());
+    for (VariablePairGroupConstIterator it=qf->begin(); it!=qf->end();
+         ++it) {
+      putU_(it->first.first->getIndex());
+      putU_(it->first.second->getIndex());
+      putD_(it->second);
+    }
+  }
+  return (!cg || putCGraph_(cg));
+}
+
+
+void ProblemCache::putS_(const std::string &s)
+{
+  putU_(s.size());
+  fwrite(s.data(), 1, s.size(), fp_);
+}
+
+
+void ProblemCache::putU_(UInt u)
+{
+  fwrite(&u, sizeof(UInt), 1, fp_);
+}
+
+
+ProblemPtr ProblemCache::read(std::string fname, std::string src,
+                              UInt *ndefs)
+{
+  ProblemPtr p = 0;
+  long long size, mtime;
+  long long key[2];
+  struct stat st;
+  void *map;
+  int fd;
+  UInt hdr[3];
+
+  if (!getKey_(src, &size, &mtime)) {
+    return 0;
+  }
+  fd = open(fname.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return 0;
+  }
+  if (0 != fstat(fd, &st) || st.st_size < (off_t) (sizeof(cacheMagic) +
+                                                  sizeof(hdr)+sizeof(key))) {
+    close(fd);
+    return 0;
+  }
+  map = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (MAP_FAILED == map) {
+    return 0;
+  }
+  pos_ = (const char *) map;
+  end_ = pos_ + st.st_size;
+  ok_ = true;
+
+  if (0 == memcmp(pos_, cacheMagic, sizeof(cacheMagic))) {
+    pos_ += sizeof(cacheMagic);
+    memcpy(hdr, pos_, sizeof(hdr));
+    pos_ += sizeof(hdr);
+    memcpy(key, pos_, sizeof(key));
+    pos_ += sizeof(key);
+    if (version_ == hdr[0] && sizeof(UInt) == hdr[1] &&
+        sizeof(double) == hdr[2] && size == key[0] && mtime == key[1]) {
+      p = getProblem_(ndefs);
+      if (!p) {
+        env_->getLogger()->msgStream(LogInfo) << me_ << "file " << fname
+          << " is damaged. Ignoring it." << std::endl;
+      }
+    } else {
+      env_->getLogger()->msgStream(LogInfo) << me_ << "file " << fname
+        << " is not for this version or source file. Ignoring it."
+        << std::endl;
+    }
+  }
+  munmap(map, st.st_size);
+  pos_ = end_ = 0;
+  return p;
+}
+
+
+int ProblemCache::write(ConstProblemPtr p, std::string fname,
+                        std::string src, UInt ndefs)
+{
+  std::string tmp = fname + ".tmp";
+  long long key[2];
+  UInt hdr[3];
+  ObjectivePtr o = p->getObjective();
+  VariablePtr v;
+  ConstraintPtr c;
+  SOSPtr sos;
+  UInt nsos = 0;
+  bool ok = true;
+
+  if (!getKey_(src, key, key+1)) {
+    return 1;
+  }
+  fp_ = fopen(tmp.c_str(), "wb");
+  if (!fp_) {
+    env_->getLogger()->msgStream(LogInfo) << me_ << "cannot write file "
+      << tmp << std::endl;
+    return 1;
+  }
+
+  hdr[0] = version_;
+  hdr[1] = sizeof(UInt);
+  hdr[2] = sizeof(double);
+  fwrite(cacheMagic, 1, sizeof(cacheMagic), fp_);
+  fwrite(hdr, sizeof(UInt), 3, fp_);
+  fwrite(key, sizeof(long long), 2, fp_);
+
+  putU_(ndefs);
+  putU_(p->getNumVars());
+  putU_(p->getNumCons());
+  for (VariableConstIterator it=p->varsBegin(); it!=p->varsEnd(); ++it) {
+    v = *it;
+    putD_(v->getLb());
+    putD_(v->getUb());
+    putD_(v->getInitVal());
+    putU_((UInt) v->getType());
+    putU_((UInt) v->getSrcType());
+    putS_(v->getName());
+  }
+  for (ConstraintConstIterator it=p->consBegin(); it!=p->consEnd() && ok;
+       ++it) {
+    c = *it;
+    putD_(c->getLb());
+    putD_(c->getUb());
+    putS_(c->getName());
+    ok = putFun_(c->getFunction());
+  }
+  if (ok && o) {
+    putU_(1);
+    putU_((UInt) o->getObjectiveType());
+    putD_(o->getConstant());
+    putS_(o->getName());
+    ok = putFun_(o->getFunction());
+  } else {
+    putU_(0);
+  }
+
+  nsos = (UInt) (p->sos1End()-p->sos1Begin() + p->sos2End()-p->sos2Begin());
+  putU_(nsos);
+  for (UInt i=0; i<nsos; ++i) {
+    sos = (i < (UInt) (p->sos1End()-p->sos1Begin())) ? p->sos1Begin()[i] :
+      p->sos2Begin()[i-(p->sos1End()-p->sos1Begin())];
+    putU_((UInt) sos->getType());
+    putU_((UInt) sos->getPriority());
+    putS_(sos->getName());
+    putU_(sos->getNz());
+    for (int j=0; j<sos->getNz(); ++j) {
+      putD_(sos->getWeights()[j]);
+      putU_((*(sos->varsBegin()+j))->getIndex());
+    }
+  }
+
+  ok = (0 == ferror(fp_)) && ok;
+  ok = (0 == fclose(fp_)) && ok;
+  fp_ = 0;
+  if (ok && 0 == rename(tmp.c_str(), fname.c_str())) {
+    return 0;
+  }
+  remove(tmp.c_str());
+  return 1;
+}
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
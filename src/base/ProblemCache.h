@@ -0,0 +1,157 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2008 - 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file ProblemCache.h
+ * \brief Declare class ProblemCache for saving a parsed problem in a binary
+ * file and loading it quickly in later runs.
+ * \author The MINOTAUR Team
+ */
+
+
+#ifndef MINOTAURPROBLEMCACHE_H
+#define MINOTAURPROBLEMCACHE_H
+
+#include <cstdio>
+
+#include "Types.h"
+
+namespace Minotaur {
+
+  class CGraph;
+  class Function;
+  typedef Function* FunctionPtr;
+
+  /**
+   * \brief Write a Problem to a compact binary file and read it back.
+   *
+   * Reading a large instance through a modeling interface and building its
+   * computational graphs can take much longer than loading the same
+   * problem from a file that stores it in Minotaur's own form. The file has
+   * the variables with their bounds, types and initial values, the
+   * constraints and objective with their linear, quadratic and nonlinear
+   * parts, and the SOS constraints. Nonlinear functions must be CGraphs.
+   * Their nodes are saved in evaluation order and the tape is compiled
+   * again by CGraph::finalize() when the file is read.
+   *
+   * The file starts with a format version and the size and modification
+   * time of the source file it was created from. It is read only if all of
+   * these match, so a stale or foreign file is ignored. The file is mapped
+   * to memory for reading. It is written to a temporary name and renamed so
+   * that several runs may share it.
+   *
+   * Presolve is not saved. It is run again on the loaded problem.
+   */
+  class ProblemCache {
+  public:
+    /// Constructor.
+    ProblemCache(EnvPtr env);
+
+    /// Destroy.
+    ~ProblemCache();
+
+    /**
+     * \brief Load a problem from a cache file.
+     *
+     * \param[in] fname The cache file.
+     * \param[in] src The file the cache was created from. Its size and
+     * modification time must match those saved in the cache.
+     * \param[out] ndefs The number saved with write(), e.g., the number of
+     * defined variables of the modeling interface.
+     * \return The problem. NULL if the file does not exist, is stale or
+     * could not be read.
+     */
+    ProblemPtr read(std::string fname, std::string src, UInt *ndefs);
+
+    /**
+     * \brief Save a problem in a cache file.
+     *
+     * \param[in] p The problem.
+     * \param[in] fname The cache file.
+     * \param[in] src The file the problem was read from.
+     * \param[in] ndefs A number to save with the problem.
+     * \return 0 on success, nonzero if the problem has functions that can
+     * not be saved or the file could not be written.
+     */
+    int write(ConstProblemPtr p, std::string fname, std::string src,
+              UInt ndefs);
+
+  private:
+    /// Position after the last byte of the mapped file.
+    const char *end_;
+
+    /// Environment.
+    EnvPtr env_;
+
+    /// File being written. NULL otherwise.
+    FILE *fp_;
+
+    /// For logging.
+    static const std::string me_;
+
+    /// False if a read went past the end of the file.
+    bool ok_;
+
+    /// Position of the next byte to be read.
+    const char *pos_;
+
+    /// Version of the file format. Increase when the format or OpCode
+    /// changes.
+    static const UInt version_;
+
+    /// Get the size and modification time of a file. Return false if it
+    /// does not exist.
+    bool getKey_(std::string src, long long *size, long long *mtime);
+
+    /// Read a nonlinear function saved by putCGraph_().
+    CGraph* getCGraph_(ProblemPtr p);
+
+    /// Read a double.
+    double getD_();
+
+    /// Read a function saved by putFun_(). NULL if it was empty.
+    FunctionPtr getFun_(ProblemPtr p);
+
+    /// Read the problem from the mapped file.
+    ProblemPtr getProblem_(UInt *ndefs);
+
+    /// Read a string.
+    std::string getS_();
+
+    /// Read an unsigned integer.
+    UInt getU_();
+
+    /// Read a variable index and return the variable. NULL if out of range.
+    VariablePtr getVar_(ProblemPtr p);
+
+    /// Write the nodes of a computational graph.
+    bool putCGraph_(const CGraph *cg);
+
+    /// Write a double.
+    void putD_(double d);
+
+    /// Write the linear, quadratic and nonlinear parts of a function.
+    bool putFun_(const Function *f);
+
+    /// Write a string.
+    void putS_(const std::string &s);
+
+    /// Write an unsigned integer.
+    void putU_(UInt u);
+  };
+}
+#endif
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
@@ -0,0 +1,195 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2008 - 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file Profiler.cpp
+ * \brief Define class Profiler for measuring the time spent in different
+ * parts of the solver by each thread.
+ * \author The MINOTAUR Team
+ */
+
+#include <iomanip>
+#include <sstream>
+#if USE_OPENMP
+#include <omp.h>
+#endif
+
+#include "MinotaurConfig.h"
+#include "Profiler.h"
+#include "Timer.h"
+
+using namespace Minotaur;
+
+const std::string Profiler::me_ = "Profiler: ";
+
+Profiler::Profiler(UInt nthreads)
+{
+  ProfNode_ *n;
+
+  if (nthreads<1) {
+    nthreads = 1;
+  }
+  for (UInt i=0; i<nthreads; ++i) {
+    n = new ProfNode_();
+    n->name = "";
+    n->calls = 0;
+    n->cpu = n->cpuStart = 0.0;
+    n->wall = n->wallStart = 0.0;
+    n->parent = 0;
+    roots_.push_back(n);
+  }
+  cur_ = roots_;
+}
+
+
+Profiler::~Profiler()
+{
+  for (UInt i=0; i<roots_.size(); ++i) {
+    free_(roots_[i]);
+  }
+  roots_.clear();
+  cur_.clear();
+}
+
+
+void Profiler::free_(ProfNode_ *n)
+{
+  for (UInt i=0; i<n->kids.size(); ++i) {
+    free_(n->kids[i]);
+  }
+  delete n;
+}
+
+
+void Profiler::start(const char *name)
+{
+  UInt t = threadId_();
+  ProfNode_ *n, *kid = 0;
+
+  if (t>=cur_.size()) {
+    return;
+  }
+  n = cur_[t];
+  // scopes are few and names are literals, so compare pointers first.
+  for (UInt i=0; i<n->kids.size(); ++i) {
+    if (n->kids[i]->name==name ||
+        std::string(n->kids[i]->name)==name) {
+      kid = n->kids[i];
+      break;
+    }
+  }
+  if (!kid) {
+    kid = new ProfNode_();
+    kid->name = name;
+    kid->calls = 0;
+    kid->cpu = 0.0;
+    kid->wall = 0.0;
+    kid->parent = n;
+    n->kids.push_back(kid);
+  }
+  kid->wallStart = WallTimer::now();
+  kid->cpuStart = ThreadTimer::now();
+  cur_[t] = kid;
+}
+
+
+void Profiler::stop()
+{
+  UInt t = threadId_();
+  ProfNode_ *n;
+
+  if (t>=cur_.size() || 0==cur_[t]->parent) {
+    return;
+  }
+  n = cur_[t];
+  n->cpu += ThreadTimer::now() - n->cpuStart;
+  n->wall += WallTimer::now() - n->wallStart;
+  ++(n->calls);
+  cur_[t] = n->parent;
+}
+
+
+UInt Profiler::threadId_()
+{
+#if USE_OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+
+void Profiler::write(std::ostream &out) const
+{
+  std::ostringstream path;
+
+  for (UInt i=0; i<roots_.size(); ++i) {
+    path.str("");
+    path << "thread " << i;
+    for (UInt j=0; j<roots_[i]->kids.size(); ++j) {
+      write_(out, roots_[i]->kids[j], path.str());
+    }
+  }
+}
+
+
+void Profiler::write_(std::ostream &out, const ProfNode_ *n,
+                      const std::string &path) const
+{
+  std::string p = path + ";" + n->name;
+  double self = n->wall;
+
+  for (UInt i=0; i<n->kids.size(); ++i) {
+    self -= n->kids[i]->wall;
+    write_(out, n->kids[i], p);
+  }
+  if (self>0.0) {
+    out << p << " " << (long long) (self*1e6 + 0.5) << std::endl;
+  }
+}
+
+
+void Profiler::writeStats(std::ostream &out) const
+{
+  out << me_ << std::setw(28) << std::left << "scope" << std::right
+      << std::setw(10) << "calls" << std::setw(12) << "wall"
+      << std::setw(12) << "cpu" << std::endl;
+  for (UInt i=0; i<roots_.size(); ++i) {
+    if (roots_[i]->kids.empty()) {
+      continue;
+    }
+    out << me_ << "thread " << i << std::endl;
+    for (UInt j=0; j<roots_[i]->kids.size(); ++j) {
+      writeStats_(out, roots_[i]->kids[j], 1);
+    }
+  }
+}
+
+
+void Profiler::writeStats_(std::ostream &out, const ProfNode_ *n,
+                           UInt depth) const
+{
+  std::string name = std::string(2*depth, ' ') + n->name;
+
+  out << me_ << std::setw(28) << std::left << name << std::right
+      << std::setw(10) << n->calls << std::fixed << std::setprecision(3)
+      << std::setw(12) << n->wall << std::setw(12) << n->cpu << std::endl;
+  for (UInt i=0; i<n->kids.size(); ++i) {
+    writeStats_(out, n->kids[i], depth+1);
+  }
+}
+
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
@@ -0,0 +1,162 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2008 - 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file Profiler.h
+ * \brief Declare classes Profiler and ProfScope for measuring the time spent
+ * in different parts of the solver by each thread.
+ * \author The MINOTAUR Team
+ */
+
+
+#ifndef MINOTAURPROFILER_H
+#define MINOTAURPROFILER_H
+
+#include <iostream>
+
+#include "Types.h"
+
+namespace Minotaur {
+
+  /**
+   * \brief Collect the wall-clock and cpu time spent in named scopes.
+   *
+   * Scopes are opened with start() and closed with stop() by the same
+   * thread, usually through a ProfScope. A scope opened inside another one
+   * becomes its child, so the times form one tree per thread, e.g.,
+   * node -> separate -> solve. Each thread writes only to its own tree and
+   * no locks are taken. Threads whose id is not less than the number given
+   * to the constructor are not profiled.
+   *
+   * Wall time is measured with the monotonic clock and cpu time with the
+   * clock of the calling thread, so the times of parallel algorithms are
+   * not added up over threads.
+   */
+  class Profiler {
+  public:
+    /// Constructor. Profile threads 0 to nthreads-1.
+    Profiler(UInt nthreads);
+
+    /// Destroy.
+    ~Profiler();
+
+    /// Open a scope called name in the calling thread. The name must be a
+    /// string that lives as long as the profiler, e.g., a literal.
+    void start(const char *name);
+
+    /// Close the scope last opened by the calling thread.
+    void stop();
+
+    /**
+     * \brief Write the wall-clock time of all scopes in the folded format
+     * used by flame graph tools.
+     *
+     * Each line has the path of a scope, starting with the thread, and its
+     * own time, i.e., not including its children, in microseconds. E.g.,
+     * "thread 1;node;solve 52310".
+     */
+    void write(std::ostream &out) const;
+
+    /// Write the number of calls and the wall and cpu time of each scope.
+    void writeStats(std::ostream &out) const;
+
+  private:
+    /// A scope, with the total time of all its calls.
+    struct ProfNode_ {
+      /// Name of the scope.
+      const char *name;
+
+      /// Number of times the scope was closed.
+      UInt calls;
+
+      /// Total cpu time in seconds.
+      double cpu;
+
+      /// Cpu time when the scope was last opened.
+      double cpuStart;
+
+      /// Total wall-clock time in seconds.
+      double wall;
+
+      /// Wall-clock time when the scope was last opened.
+      double wallStart;
+
+      /// The enclosing scope. NULL for the root of a thread.
+      ProfNode_ *parent;
+
+      /// Scopes that were opened inside this one.
+      std::vector<ProfNode_ *> kids;
+    };
+
+    /// The scope open in each thread.
+    std::vector<ProfNode_ *> cur_;
+
+    /// For logging.
+    static const std::string me_;
+
+    /// The root of the tree of each thread.
+    std::vector<ProfNode_ *> roots_;
+
+    /// Free a tree.
+    void free_(ProfNode_ *n);
+
+    /// Id of the calling thread.
+    static UInt threadId_();
+
+    /// Write the folded lines of a tree.
+    void write_(std::ostream &out, const ProfNode_ *n,
+                const std::string &path) const;
+
+    /// Write the stats of a tree, indenting children.
+    void writeStats_(std::ostream &out, const ProfNode_ *n,
+                     UInt depth) const;
+  };
+
+  /**
+   * \brief Open a scope of a Profiler for the lifetime of this object.
+   *
+   * Does nothing if the profiler is NULL, so that it costs only a check
+   * when profiling is off.
+   */
+  class ProfScope {
+  public:
+    /// Open scope name in profiler p, which may be NULL.
+    ProfScope(Profiler *p, const char *name) : p_(p) {
+      if (p_) {
+        p_->start(name);
+      }
+    };
+
+    /// Close the scope.
+    ~ProfScope() {
+      if (p_) {
+        p_->stop();
+      }
+    };
+
+  private:
+    /// The profiler. NULL if profiling is off.
+    Profiler *p_;
+
+    /// Copying is not allowed.
+    ProfScope(const ProfScope &);
+
+    /// Copying is not allowed.
+    ProfScope & operator = (const ProfScope &);
+  };
+}
+#endif
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
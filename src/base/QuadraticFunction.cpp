@@ -10,6 +10,7 @@
  * \author Ashutosh Mahajan, Argonne National Laboratory
  */
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <iomanip>
@@ -33,6 +34,7 @@ using namespace Minotaur;
 
 QuadraticFunction::QuadraticFunction() 
   : etol_(1e-8),
+    flat_(true),
     hCoeffs_(0),
     hFirst_(0),
     hOff_(0),
@@ -47,6 +49,7 @@ QuadraticFunction::QuadraticFunction()
 QuadraticFunction::QuadraticFunction(UInt nz, double *vals, UInt *irow,
                                      UInt *jcol, VariableConstIterator vbeg)
 : etol_(1e-8),
+  flat_(true),
   hCoeffs_(0),
   hFirst_(0),
   hOff_(0),
@@ -71,6 +74,7 @@ QuadraticFunction::QuadraticFunction(UInt nz, double *vals, UInt *irow,
 QuadraticFunction::QuadraticFunction(double* vals, VariableConstIterator vbeg,
                                     VariableConstIterator vend)
 : etol_(1e-8),
+  flat_(true),
   hCoeffs_(0),
   hFirst_(0),
   hOff_(0),
@@ -114,6 +118,9 @@ QuadraticFunctionPtr QuadraticFunction::clone() const
 {
    QuadraticFunctionPtr qf = (QuadraticFunctionPtr) new QuadraticFunction();
    qf->terms_.insert(terms_.begin(), terms_.end());
+   qf->flat_ = flat_;
+   qf->tCoeffs_ = tCoeffs_;
+   qf->tPairs_ = tPairs_;
    qf->varFreq_.insert(varFreq_.begin(), varFreq_.end());
    return qf;
 }
@@ -133,21 +140,28 @@ QuadraticFunctionPtr QuadraticFunction::cloneWithVars(VariableConstIterator vbeg
 
 double QuadraticFunction::eval(const std::vector<double> &x) const
 {
-   double sum = 0.0;
-   for(VariablePairGroupConstIterator it = begin(); it != end(); ++it) {
-      sum += it->second * x[it->first.first->getIndex()] * 
-        x[it->first.second->getIndex()];
+   if (x.empty()) {
+     return 0.0;
    }
-   return sum;
+   return eval(&x[0]);
 }
 
 
 double QuadraticFunction::eval(const double *x) const
 {
    double sum = 0.0;
-   for(VariablePairGroupConstIterator it = begin(); it != end(); ++it) {
-      sum += it->second * x[it->first.first->getIndex()] * 
-        x[it->first.second->getIndex()];
+   if (flat_) {
+     const UInt n = tCoeffs_.size();
+     for (UInt i=0; i<n; ++i) {
+       sum += tCoeffs_[i] * x[tPairs_[i].first->getIndex()] * 
+         x[tPairs_[i].second->getIndex()];
+     }
+   } else {
+     for (VariablePairGroupConstIterator it=terms_.begin();
+          it!=terms_.end(); ++it) {
+       sum += it->second * x[it->first.first->getIndex()] * 
+         x[it->first.second->getIndex()];
+     }
    }
    return sum;
 }
@@ -297,13 +311,16 @@ void QuadraticFunction::bndsquadterms_2(double *l, double *u, VariablePtr v, Var
 
 void QuadraticFunction::evalGradient(const double *x, double *grad_f)
 {
+  UInt i1, i2;
+
   assert (grad_f);
   if (x) {
-    for(VariablePairGroupConstIterator it = terms_.begin(); it != terms_.end(); ++it) {
-      grad_f[it->first.first->getIndex()] +=  it->second * 
-        x[it->first.second->getIndex()];
-      grad_f[it->first.second->getIndex()] +=  it->second * 
-        x[it->first.first->getIndex()];
+    finalize();
+    for (UInt i=0; i<tCoeffs_.size(); ++i) {
+      i1 = tPairs_[i].first->getIndex();
+      i2 = tPairs_[i].second->getIndex();
+      grad_f[i1] += tCoeffs_[i] * x[i2];
+      grad_f[i2] += tCoeffs_[i] * x[i1];
     }
   }
 }
@@ -311,11 +328,14 @@ void QuadraticFunction::evalGradient(const double *x, double *grad_f)
 void QuadraticFunction::evalGradient(const std::vector<double> & x, 
     std::vector<double> & grad_f)
 {
-  for(VariablePairGroupConstIterator it = terms_.begin(); it != terms_.end(); ++it) {
-    grad_f[it->first.first->getIndex()] +=  it->second * 
-      x[it->first.second->getIndex()];
-    grad_f[it->first.second->getIndex()] +=  it->second * 
-      x[it->first.first->getIndex()];
+  UInt i1, i2;
+
+  finalize();
+  for (UInt i=0; i<tCoeffs_.size(); ++i) {
+    i1 = tPairs_[i].first->getIndex();
+    i2 = tPairs_[i].second->getIndex();
+    grad_f[i1] += tCoeffs_[i] * x[i2];
+    grad_f[i2] += tCoeffs_[i] * x[i1];
   }
 }
 
@@ -486,13 +506,18 @@ void QuadraticFunction::finalHessStor(const LTHessStor *stor)
 
 void QuadraticFunction::fillJac(const double *x, double *values, int *) 
 {
-  UInt i=0;
-  for (VariablePairGroupConstIterator it = terms_.begin(); it != terms_.end(); 
-      ++it) {
-    values[jacOff_[i]] += it->second * x[jacInd_[i]];
-    ++i;
-    values[jacOff_[i]] += it->second * x[jacInd_[i]];
-    ++i;
+  const UInt *off, *ind;
+
+  // jacOff_ and jacInd_ follow the order of terms_, as do the flat arrays.
+  finalize();
+  if (tCoeffs_.empty()) {
+    return;
+  }
+  off = &jacOff_[0];
+  ind = &jacInd_[0];
+  for (UInt i=0; i<tCoeffs_.size(); ++i, off+=2, ind+=2) {
+    values[off[0]] += tCoeffs_[i] * x[ind[0]];
+    values[off[1]] += tCoeffs_[i] * x[ind[1]];
   }
 }
 
@@ -514,6 +539,7 @@ void QuadraticFunction::addTerm(VariablePair vp, const double weight)
     terms_.insert(std::make_pair(vp, weight));
     varFreq_[vp.first] += 1;
     varFreq_[vp.second] += 1;
+    flat_ = false;
   }
 }
 
@@ -554,6 +580,7 @@ void QuadraticFunction::incTerm(ConstVariablePair vp, const double a)
         it->second = nv;
       }
     }
+    flat_ = false;
   }
 }
 
@@ -631,6 +658,7 @@ void QuadraticFunction::removeVar(VariablePtr v, double val,
       ++it;
     }
   }
+  flat_ = false;
 }
 
 NonlinearFunctionPtr QuadraticFunction::getPersp(VariablePtr z, double eps,
@@ -760,6 +788,7 @@ void QuadraticFunction::prepJac(VarSetConstIter vbeg, VarSetConstIter vend)
     jacInd_[i] = it->first.first->getIndex();
     ++i;
   }
+  finalize();
 }
 
 
@@ -918,6 +947,7 @@ void QuadraticFunction::subst(VariablePtr out, VariablePtr in, double rat)
     }
   }
   varFreq_.erase(vit);
+  flat_ = false;
 
   while (!newterms.empty()) {
     vpg = newterms.front();
@@ -971,8 +1001,27 @@ void QuadraticFunction::multiply(const double c) {
       it->second *= c;
     }
   }
+  flat_ = false;
+}
+
+void QuadraticFunction::finalize()
+{
+  UInt i = 0;
+
+  if (flat_) {
+    return;
+  }
+  tCoeffs_.resize(terms_.size());
+  tPairs_.resize(terms_.size());
+  for (VariablePairGroupConstIterator it=terms_.begin(); it!=terms_.end();
+       ++it, ++i) {
+    tPairs_[i] = it->first;
+    tCoeffs_[i] = it->second;
+  }
+  flat_ = true;
 }
 
+
 //void QuadraticFunction::setConvex(bool convex) {
 //  convex_ = convex;
 //}
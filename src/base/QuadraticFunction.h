@@ -270,6 +270,15 @@ namespace Minotaur {
       void fillJac(const double *x, double *values, int *error);
       void finalHessStor(const LTHessStor *hess);
 
+      /**
+       * \brief Build the flat arrays of terms that are used in evaluation.
+       *
+       * Evaluation walks the map of terms until this function copies it
+       * into contiguous arrays. A change in the terms drops the arrays
+       * again. Does nothing if they are up to date.
+       */
+      void finalize();
+
       /// Get the number of terms in this expression
       UInt getNumTerms() const;
 
@@ -300,6 +309,9 @@ namespace Minotaur {
       /// Tolerance below which a coefficient is deemed zero
       const double etol_;
 
+      /// True if tCoeffs_ and tPairs_ have the same terms as terms_.
+      bool flat_;
+
       double *hCoeffs_;
       UInt *hFirst_;
       UInt *hOff_;
@@ -315,6 +327,16 @@ namespace Minotaur {
        */
       VariablePairGroup terms_;
 
+      /**
+       * Coefficients of terms_, in the same order as tPairs_. The two
+       * arrays are a flat copy of terms_ built by finalize(). Valid only if
+       * flat_.
+       */
+      DoubleVector tCoeffs_;
+
+      /// Variable pairs of terms_, sorted in the same order as terms_.
+      std::vector<ConstVariablePair> tPairs_;
+
       /**
        * Set of variables that are in this quadratic and in how many times
        * do they occur. e.g. x0 occurs 4 times in:
@@ -26,13 +26,16 @@
 #include "Modification.h"
 #include "Node.h"
 #include "Option.h"
+#include "Profiler.h"
 #include "ProblemSize.h"
 #include "Relaxation.h"
 #include "ReliabilityBrancher.h"
 #include "Solution.h"
 #include "SolutionPool.h"
 #include "Timer.h"
+#include "VarBoundMod.h"
 #include "Variable.h"
+#include "WarmStart.h"
 
 //#define SPEW 1
 
@@ -42,6 +45,7 @@ const std::string ReliabilityBrancher::me_ = "reliability brancher: ";
 
 ReliabilityBrancher::ReliabilityBrancher(EnvPtr env, HandlerVector & handlers) 
 : engine_(EnginePtr()),             // NULL
+  env_(env),
   eTol_(1e-6),
   handlers_(handlers),              // Create a copy, the vector is not too big
   init_(false),
@@ -49,31 +53,66 @@ ReliabilityBrancher::ReliabilityBrancher(EnvPtr env, HandlerVector & handlers)
   maxIterations_(25),
   maxStrongCands_(20),
   minNodeDist_(50),
+  nThreads_(1),
   rel_(RelaxationPtr()),            // NULL
   status_(NotModifiedByBrancher),
   thresh_(4),
   trustCutoff_(true),
   x_(0)
 {
-  timer_ = env->getNewTimer();
+  int k = env->getOptions()->findInt("strbr_threads")->getValue();
+
+  if (k > 1) {
+    nThreads_ = k;
+  }
+  prof_ = env->getProfiler();
+  timer_ = env->getNewWallTimer();
   logger_ = env->getLogger();
   stats_ = new RelBrStats();
+  stats_->abandoned = 0;
   stats_->calls = 0;
   stats_->engProbs = 0;
   stats_->strBrCalls = 0;
   stats_->bndChange = 0;
   stats_->iters = 0;
+  stats_->parCalls = 0;
   stats_->strTime = 0.0;
 }
 
 
 ReliabilityBrancher::~ReliabilityBrancher()
 {
+  // an engine unsets its problem when deleted.
+  for (UInt i=0; i<strEngines_.size(); ++i) {
+    delete strEngines_[i];
+    if (strProbs_[i]) {
+      delete strProbs_[i];
+    }
+  }
   delete stats_;
   delete timer_;
 }
 
 
+bool ReliabilityBrancher::canPrune_(const double &chcutoff,
+                                    const double &change,
+                                    const EngineStatus & status) const
+{
+  switch (status) {
+   case (ProvenLocalInfeasible):
+   case (ProvenInfeasible):
+   case (ProvenObjectiveCutOff):
+     return true;
+   case (ProvenLocalOptimal):
+   case (ProvenOptimal):
+     return (trustCutoff_ && change>chcutoff-eTol_);
+   default:
+     break;
+  }
+  return false;
+}
+
+
 BrCandPtr ReliabilityBrancher::findBestCandidate_(const double objval, 
                                                   double cutoff, NodePtr node)
 {
@@ -105,8 +144,13 @@ BrCandPtr ReliabilityBrancher::findBestCandidate_(const double objval,
     engine_->setIterationLimit(maxIterations_); // TODO: make limit dynamic.
     cnt = 0;
     maxcnt = (node->getDepth()>maxDepth_) ? 0 : maxStrongCands_;
-    for (it=unrelCands_.begin(); it!=unrelCands_.end() && 
-        cnt < maxcnt; ++it, ++cnt) {
+    it = unrelCands_.begin();
+    if (nThreads_ > 1 && maxcnt > 1 && unrelCands_.size() > 1 &&
+        findBestCandPar_(objval, maxchange, maxcnt, best_score, best_cand,
+                         it)) {
+      cnt = maxcnt;
+    }
+    for (; it!=unrelCands_.end() && cnt < maxcnt; ++it, ++cnt) {
       cand = *it;
       strongBranch_(cand, change_up, change_down, status_up, status_down);
       change_up    = std::max(change_up - objval, 0.0);
@@ -161,6 +205,215 @@ BrCandPtr ReliabilityBrancher::findBestCandidate_(const double objval,
 }
 
 
+bool ReliabilityBrancher::findBestCandPar_(const double objval,
+                                           const double maxchange,
+                                           UInt maxcnt, double &best_score,
+                                           BrCandPtr &best_cand,
+                                           BrCandVIter &last)
+{
+#if USE_OPENMP
+  UInt n = std::min(maxcnt, (UInt) unrelCands_.size());
+  UInt nt = std::min(nThreads_, n);
+  std::vector<VarBoundModPtr> dmods(n, 0), umods(n, 0);
+  std::vector<EngineStatus> status_up(n), status_down(n);
+  DoubleVector change_up(n, 0.0), change_down(n, 0.0);
+  // 0: not solved, 1: only down child solved, 2: both solved.
+  std::vector<int> solved(n, 0);
+  WarmStartPtr ws;
+  double best = best_score;
+  double score;
+  int stop = 0;
+  bool ok = true;
+  UInt nsolves = 0;
+  UInt k;
+
+  if (omp_in_parallel() || !rel_->hasNativeDer()) {
+    return false;
+  }
+
+  // the modifications are for variables of rel_. They are used on clones
+  // only if they change bounds of variables.
+  for (k=0; k<n && ok; ++k) {
+    BrCandPtr cand = unrelCands_[k];
+    ModificationPtr mod;
+    mod = cand->getHandler()->getBrMod(cand, x_, rel_, DownBranch);
+    dmods[k] = dynamic_cast<VarBoundModPtr>(mod);
+    if (!dmods[k]) {
+      delete mod;
+      ok = false;
+      break;
+    }
+    mod = cand->getHandler()->getBrMod(cand, x_, rel_, UpBranch);
+    umods[k] = dynamic_cast<VarBoundModPtr>(mod);
+    if (!umods[k]) {
+      delete mod;
+      ok = false;
+    }
+  }
+  ok = ok && setupStrThreads_(nt);
+  if (!ok) {
+    for (k=0; k<n; ++k) {
+      delete dmods[k];
+      delete umods[k];
+    }
+    return false;
+  }
+
+  ws = engine_->getWarmStartCopy();
+  timer_->start();
+
+#pragma omp parallel num_threads(nt) reduction(+:nsolves)
+  {
+    ProfScope ps(prof_, "strong branching");
+    UInt t = omp_get_thread_num();
+    ProblemPtr p = rel_->clone(env_);
+    EnginePtr e = strEngines_[t];
+
+    e->clear();
+    e->load(p);
+    if (strProbs_[t]) {
+      delete strProbs_[t];
+    }
+    strProbs_[t] = p;
+    if (ws) {
+      e->loadFromWarmStart(ws);
+    }
+    e->enableStrBrSetup();
+    e->setIterationLimit(maxIterations_);
+
+#pragma omp for schedule(dynamic, 1)
+    for (UInt i=0; i<n; ++i) {
+      VarBoundModPtr mod;
+      double ub;
+      bool skip;
+      int stopped;
+
+#pragma omp atomic read
+      stopped = stop;
+      if (stopped) {
+        continue;
+      }
+
+      mod = new VarBoundMod(p->getVariable(dmods[i]->getVar()->getIndex()),
+                            dmods[i]->getLU(), dmods[i]->getNewVal());
+      mod->applyToProblem(p);
+      status_down[i] = e->solve();
+      change_down[i] = std::max(e->getSolutionValue() - objval, 0.0);
+      mod->undoToProblem(p);
+      delete mod;
+      ++nsolves;
+      solved[i] = 1;
+
+      if (canPrune_(maxchange, change_down[i], status_down[i])) {
+#pragma omp atomic write
+        stop = 1;
+        continue;
+      }
+
+      // a child that is not pruned has change at most maxchange. If even
+      // that can not give a better score, skip the up child.
+      if (trustCutoff_ && maxchange < INFINITY &&
+          (ProvenOptimal == status_down[i] ||
+           ProvenLocalOptimal == status_down[i])) {
+        ub = getScore_(maxchange, change_down[i]);
+#pragma omp critical (relBrBest)
+        skip = (ub <= best);
+        if (skip) {
+          continue;
+        }
+      }
+
+      mod = new VarBoundMod(p->getVariable(umods[i]->getVar()->getIndex()),
+                            umods[i]->getLU(), umods[i]->getNewVal());
+      mod->applyToProblem(p);
+      status_up[i] = e->solve();
+      change_up[i] = std::max(e->getSolutionValue() - objval, 0.0);
+      mod->undoToProblem(p);
+      delete mod;
+      ++nsolves;
+      solved[i] = 2;
+
+      if (canPrune_(maxchange, change_up[i], status_up[i])) {
+#pragma omp atomic write
+        stop = 1;
+      } else {
+        ub = getScore_(change_up[i], change_down[i]);
+#pragma omp critical (relBrBest)
+        {
+          if (ub > best) {
+            best = ub;
+          }
+        }
+      }
+    }
+    e->resetIterationLimit();
+    e->disableStrBrSetup();
+  }
+
+  stats_->strTime += timer_->query();
+  timer_->stop();
+  stats_->strBrCalls += nsolves;
+  ++(stats_->parCalls);
+  if (ws) {
+    delete ws;
+  }
+
+  // use the results in the same order as serial strong branching.
+  for (k=0; k<n; ++k) {
+    BrCandPtr cand = unrelCands_[k];
+    int index = cand->getPCostIndex();
+    if (1 == solved[k] && NotModifiedByBrancher == status_) {
+      bool is_rel = true;
+      if (!shouldPrune_(maxchange, change_down[k], status_down[k], &is_rel)
+          && is_rel) {
+        ++(stats_->abandoned);
+        updatePCost_(index, change_down[k]/(fabs(cand->getDDist())+eTol_),
+                     pseudoDown_, timesDown_);
+        lastStrBranched_[index] = stats_->calls;
+        continue;
+      }
+      // the down child can be pruned but the up child was not solved.
+      status_up[k] = EngineIterationLimit;
+      change_up[k] = 0.0;
+    } else if (0 == solved[k] || NotModifiedByBrancher != status_) {
+      continue;
+    }
+    useStrongBranchInfo_(cand, maxchange, change_up[k], change_down[k],
+                         status_up[k], status_down[k]);
+    score = getScore_(change_up[k], change_down[k]);
+    lastStrBranched_[index] = stats_->calls;
+#if SPEW
+    writeScore_(cand, score, change_up[k], change_down[k]);
+#endif
+    if (status_ != NotModifiedByBrancher) {
+      last = unrelCands_.begin()+k;
+      break;
+    }
+    if (score > best_score) {
+      best_score = score;
+      best_cand = cand;
+      if (change_up[k] > change_down[k]) {
+        best_cand->setDir(DownBranch);
+      } else {
+        best_cand->setDir(UpBranch);
+      }
+    }
+  }
+  if (NotModifiedByBrancher == status_) {
+    last = unrelCands_.begin()+n;
+  }
+
+  for (k=0; k<n; ++k) {
+    delete dmods[k];
+    delete umods[k];
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+
 Branches ReliabilityBrancher::findBranches(RelaxationPtr rel, NodePtr node, 
                                            ConstSolutionPtr sol,
                                            SolutionPoolPtr s_pool,
@@ -448,6 +701,26 @@ void ReliabilityBrancher::setThresh(UInt k)
 }
 
 
+bool ReliabilityBrancher::setupStrThreads_(UInt nt)
+{
+  EnginePtr e;
+
+  while (strEngines_.size() < nt) {
+    e = engine_->emptyCopy();
+    if (!e) {
+      logger_->msgStream(LogInfo) << me_ << "engine " << engine_->getName()
+                                  << " can not be copied. Strong branching"
+                                  << " serially." << std::endl;
+      nThreads_ = 1;
+      return false;
+    }
+    strEngines_.push_back(e);
+    strProbs_.push_back(0);
+  }
+  return true;
+}
+
+
 bool ReliabilityBrancher::shouldPrune_(const double &chcutoff, 
                                        const double &change,
                                        const EngineStatus & status,
@@ -494,6 +767,7 @@ void ReliabilityBrancher::strongBranch_(BrCandPtr cand, double & obj_up,
                                         EngineStatus & status_up, 
                                         EngineStatus & status_down)
 {
+  ProfScope ps(prof_, "strong branching");
   HandlerPtr h = cand->getHandler();
   ModificationPtr mod;
 
@@ -672,6 +946,10 @@ void ReliabilityBrancher::writeStats(std::ostream &out) const
       << std::endl
       << me_ << "times relaxation solved     = " << stats_->strBrCalls
       << std::endl
+      << me_ << "times solved concurrently   = " << stats_->parCalls
+      << std::endl
+      << me_ << "candidates abandoned        = " << stats_->abandoned
+      << std::endl
       << me_ << "times bounds changed        = " << stats_->bndChange
       << std::endl
       << me_ << "time in solving relaxations = " << stats_->strTime
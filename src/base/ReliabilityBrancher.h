@@ -19,20 +19,35 @@
 namespace Minotaur {
 
 class Engine;
+class Profiler;
 class Timer;
 typedef Engine* EnginePtr;
 
 struct RelBrStats {
+  UInt abandoned;  /// Number of candidates abandoned after one child.
   UInt bndChange;  /// Number of times variable bounds were changed.
   UInt calls;      /// Number of times called to find a branching candidate.
   UInt engProbs;   /// Number of times an unexpected engine status was met.
   UInt iters;      /// Number of iterations in strong-branching.
+  UInt parCalls;   /// Number of times strong-branching done concurrently.
   UInt strBrCalls; /// Number of times strong branching on a variable.
   double strTime;  /// Total time spent in strong-branching.
 };
 
 
-/// A class to select a variable for branching using reliability branching.
+/**
+ * \brief A class to select a variable for branching using reliability
+ * branching.
+ *
+ * When the option strbr_threads is more than one, the candidates selected
+ * for strong branching are solved concurrently. Each thread solves the
+ * children on its own copy of the engine (Engine::emptyCopy) loaded with its
+ * own clone of the relaxation at the node, warm started from the engine
+ * used at the node. The best score found so far is shared by all threads: a
+ * candidate whose score can not exceed it after solving the down child is
+ * abandoned without solving the up child, and all threads stop as soon as
+ * one of them finds a child that can be pruned.
+ */
 class ReliabilityBrancher : public Brancher {
 
 public:
@@ -120,6 +135,15 @@ public:
 
 private:
 
+  /**
+   * \brief Check if a child can be pruned, without updating statistics.
+   *
+   * Same as shouldPrune_(), but does not write messages or update
+   * statistics. Safe to call from several threads.
+   */
+  bool canPrune_(const double &chcutoff, const double &change,
+                 const EngineStatus & status) const;
+
   /**
    * \brief Find the variable that was selected for branching.
    * 
@@ -133,6 +157,27 @@ private:
   BrCandPtr findBestCandidate_(const double objval, double cutoff, 
                                NodePtr node);
 
+  /**
+   * \brief Do strong branching on the first few unreliable candidates
+   * concurrently.
+   *
+   * Only used when all branching modifications of these candidates are
+   * changes in bounds of variables, because they can then be applied to
+   * clones of the relaxation.
+   * \param[in] objval Optimal objective value of the current relaxation.
+   * \param[in] maxchange Change in objective value that leads to cutoff.
+   * \param[in] maxcnt Maximum number of candidates to strong branch on.
+   * \param[in,out] best_score Score of best_cand.
+   * \param[in,out] best_cand The best candidate found so far.
+   * \param[out] last Iterator pointing to the first unreliable candidate
+   * on which strong branching was not done.
+   * \return False if strong branching could not be done concurrently, in
+   * which case nothing is changed.
+   */
+  bool findBestCandPar_(const double objval, const double maxchange,
+                        UInt maxcnt, double &best_score, BrCandPtr &best_cand,
+                        BrCandVIter &last);
+
   /**
    * \brief Find and sort candidates for branching.
    *
@@ -186,6 +231,14 @@ private:
   bool shouldPrune_(const double &chcutoff, const double &change, 
                     const EngineStatus & status, bool *is_rel);
 
+  /**
+   * \brief Prepare one copy of the engine for each thread.
+   *
+   * \param[in] nt The number of threads.
+   * \return False if the engine can not be copied.
+   */
+  bool setupStrThreads_(UInt nt);
+
   /** 
    * \brief Do strong branching on candidate.
    * \param[in] cand Candidate for strong branching.
@@ -252,6 +305,9 @@ private:
   /// The engine used for strong branching.
   EnginePtr engine_;
 
+  /// Environment, needed to clone the relaxation.
+  EnvPtr env_;
+
   /// Tolerance for avoiding division by zero.
   const double eTol_;
 
@@ -300,6 +356,9 @@ private:
   /// Vector of pseudocosts for rounding up.
   DoubleVector pseudoUp_;
 
+  /// Number of threads used for strong branching.
+  UInt nThreads_;
+
   /// The problem that is being solved at this node.
   RelaxationPtr rel_;
 
@@ -309,10 +368,20 @@ private:
   /// Statistics.
   RelBrStats * stats_;
 
+  /// Profiler for timing strong branching. NULL if not profiling.
+  Profiler *prof_;
+
   /// Status of problem after using this brancher.
   BrancherStatus status_;
 
-  /// Timer to track time spent in this class.
+  /// Engine of each thread in concurrent strong branching.
+  std::vector<EnginePtr> strEngines_;
+
+  /// Clone of the relaxation solved by each engine in strEngines_.
+  std::vector<ProblemPtr> strProbs_;
+
+  /// Timer to track time spent in this class. Measures wall-clock time
+  /// because strong branching may use several threads.
   Timer *timer_;
 
   /**
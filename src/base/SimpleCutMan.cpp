@@ -128,6 +128,8 @@ void SimpleCutMan::separate(ProblemPtr p, ConstSolutionPtr sol, bool *, UInt *)
 
   mvNewToPool_();
  
+  // violated cuts are sent to the engine together.
+  p->startConsBatch();
   for (CLIter it=pool_.begin(); it!=pool_.end();) {
     cut = *it;
 #if SPEW
@@ -160,6 +162,7 @@ void SimpleCutMan::separate(ProblemPtr p, ConstSolutionPtr sol, bool *, UInt *)
       ++it;
     }
   }
+  p->endConsBatch();
 }
 
 
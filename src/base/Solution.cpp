@@ -12,6 +12,7 @@
  * Implement the base class Solution. 
  */
 
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
@@ -119,6 +120,58 @@ Solution::Solution(ConstSolutionPtr sol)
 }
 
 
+size_t Solution::getBytes() const
+{
+  size_t bytes = sizeof(Solution);
+  if (x_) {
+    bytes += n_*sizeof(double);
+  }
+  if (dualCons_) {
+    bytes += m_*sizeof(double);
+  }
+  if (dualX_) {
+    bytes += n_*sizeof(double);
+  }
+  return bytes;
+}
+
+
+bool Solution::hasSameValues(ConstSolutionPtr sol) const
+{
+  return (sol && n_ == sol->n_ && m_ == sol->m_ &&
+          objValue_ == sol->objValue_ && sameArr_(x_, sol->x_, n_) &&
+          sameArr_(dualCons_, sol->dualCons_, m_) &&
+          sameArr_(dualX_, sol->dualX_, n_));
+}
+
+
+bool Solution::readArr_(FILE *fp, double *&a, UInt n)
+{
+  char has_vals = 0;
+  if (fread(&has_vals, sizeof(char), 1, fp) != 1) {
+    return false;
+  }
+  if (has_vals) {
+    a = new double[n];
+    if (fread(a, sizeof(double), n, fp) != n) {
+      delete [] a;
+      a = 0;
+      return false;
+    }
+  }
+  return true;
+}
+
+
+bool Solution::sameArr_(const double *a, const double *b, UInt n)
+{
+  if (!a || !b) {
+    return (a == b);
+  }
+  return std::equal(a, a+n, b);
+}
+
+
 void Solution::setPrimal(const double *x)
 {
   if (!x_) {
@@ -145,6 +198,27 @@ void Solution::setDualOfVars(const double *dualX)
 }
 
 
+bool Solution::spill(FILE *fp)
+{
+  if (!writeArr_(fp, x_, n_) || !writeArr_(fp, dualCons_, m_) ||
+      !writeArr_(fp, dualX_, n_)) {
+    return false;
+  }
+  delete [] x_;
+  delete [] dualCons_;
+  delete [] dualX_;
+  x_ = dualCons_ = dualX_ = 0;
+  return true;
+}
+
+
+bool Solution::unspill(FILE *fp)
+{
+  return (readArr_(fp, x_, n_) && readArr_(fp, dualCons_, m_) &&
+          readArr_(fp, dualX_, n_));
+}
+
+
 void Solution::write(std::ostream &out) const
 {
   writePrimal(out);
@@ -178,6 +252,16 @@ void Solution::writePrimal(std::ostream &out, const VarVector *v) const
 }
 
 
+bool Solution::writeArr_(FILE *fp, const double *a, UInt n)
+{
+  char has_vals = (a != 0);
+  if (fwrite(&has_vals, sizeof(char), 1, fp) != 1) {
+    return false;
+  }
+  return (!a || fwrite(a, sizeof(double), n, fp) == n);
+}
+
+
 void Solution::writeDual(std::ostream &out) const
 {
   out << "dual values for variables:" << std::endl;
@@ -16,6 +16,8 @@
 #ifndef MINOTAURSOLUTION_H
 #define MINOTAURSOLUTION_H
 
+#include <cstdio>
+
 #include "Types.h"
 
 namespace Minotaur {
@@ -73,6 +75,24 @@ namespace Minotaur {
     /// Return a pointer to the solution.
     virtual const double * getDualOfVars() const {return dualX_;};
 
+    /// Return the approximate number of bytes used by this solution.
+    virtual size_t getBytes() const;
+
+    /// Return true if sol has exactly the same primal and dual values.
+    virtual bool hasSameValues(ConstSolutionPtr sol) const;
+
+    /**
+     * \brief Write the primal and dual values to a binary file and free
+     * them.
+     *
+     * \param [in] fp The file. Values are written at its current position.
+     * \return False if writing failed. Nothing is freed in that case.
+     */
+    virtual bool spill(FILE *fp);
+
+    /// Read the values written by spill(). Return false on error.
+    virtual bool unspill(FILE *fp);
+
     /// Write to a stream.
     virtual void write(std::ostream &out) const;
 
@@ -111,6 +131,15 @@ namespace Minotaur {
 
     /// Complementarity.
     double comple_;
+
+    /// Return true if both arrays are NULL or have the same n values.
+    static bool sameArr_(const double *a, const double *b, UInt n);
+
+    /// Read an array written by writeArr_(). It is allocated if not NULL.
+    static bool readArr_(FILE *fp, double *&a, UInt n);
+
+    /// Write a flag that says if the array is NULL, followed by its values.
+    static bool writeArr_(FILE *fp, const double *a, UInt n);
   };
 }
 #endif
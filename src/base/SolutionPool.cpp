@@ -11,6 +11,7 @@
  */
 
 #include <cmath>
+#include <cstring>
 #include <iostream>
 
 #include "MinotaurConfig.h"
@@ -24,13 +25,18 @@ const std::string SolutionPool::me_ = "SolutionPool: ";
 
 SolutionPool::SolutionPool (EnvPtr env, ProblemPtr problem, UInt limit)
 : bestSolution_(SolutionPtr()), // NULL
+  bestVal_(INFINITY),
   numSolsFound_(0),
   problem_(problem),
-  sizeLimit_(limit),
+  sizeLimit_((limit > 0) ? limit : 1),
   timeBest_(-1),
-  timeFirst_(-1)
+  timeFirst_(-1),
+  worstVal_(INFINITY)
 {
   timer_ = env->getTimer(); // should not be deleted.
+#if USE_OPENMP
+  omp_init_lock(&lock_);
+#endif
 }
 
 
@@ -40,27 +46,94 @@ SolutionPool::~SolutionPool()
        ++it) {
     delete *it;
   }
+  for (std::vector<SolutionPtr>::iterator it=retired_.begin();
+       it!=retired_.end(); ++it) {
+    delete *it;
+  }
+#if USE_OPENMP
+  omp_destroy_lock(&lock_);
+#endif
+}
+
+
+void SolutionPool::addListener(SolutionPoolListener *l)
+{
+  listeners_.push_back(l);
 }
 
 
 void SolutionPool::addSolution(ConstSolutionPtr solution)
 {
-  SolutionPtr newsol = new Solution(solution);
+  const UInt n = problem_->getNumVars();
+  double val = solution->getObjValue();
+  double worst;
+  size_t h;
+  bool is_best = false;
+  bool is_dup = false;
+  UInt pos;
+
+  // most solutions found late in the search are not good enough. Reject
+  // them without taking the lock.
+#if USE_OPENMP
+#pragma omp atomic read
+#endif
+  worst = worstVal_;
+  if (val >= worst) {
+#if USE_OPENMP
+#pragma omp atomic
+#endif
+    ++numSolsFound_;
+    return;
+  }
+
+  h = hash_(solution, n);
+#if USE_OPENMP
+  omp_set_lock(&lock_);
+#endif
+#if USE_OPENMP
+#pragma omp atomic
+#endif
   ++numSolsFound_;
-  if (sols_.size() > 0) {
-    if (sols_[0]->getObjValue() > solution->getObjValue()) {
-      delete sols_[0];
-      sols_[0] = newsol;
-      bestSolution_ = newsol;
-      timeBest_ = timer_->query();
-    } else {
-      delete newsol;
+  pos = sols_.size();
+  if (val < worstVal_) {
+    for (UInt i=0; i<sols_.size(); ++i) {
+      if (hashes_[i]==h && 0==memcmp(sols_[i]->getPrimal(),
+                                     solution->getPrimal(),
+                                     n*sizeof(double))) {
+        is_dup = true;
+        break;
+      }
+      if (sols_[i]->getObjValue() > val && pos==sols_.size()) {
+        pos = i;
+      }
+    }
+    if (false==is_dup) {
+      sols_.insert(sols_.begin()+pos, new Solution(solution));
+      hashes_.insert(hashes_.begin()+pos, h);
+      if (0==pos) {
+        is_best = true;
+        bestSolution_ = sols_[0];
+#if USE_OPENMP
+#pragma omp atomic write
+#endif
+        bestVal_ = val;
+        timeBest_ = timer_->query();
+        if (timeFirst_ < 0) {
+          timeFirst_ = timeBest_;
+        }
+      }
+      trim_();
+    }
+  }
+#if USE_OPENMP
+  omp_unset_lock(&lock_);
+#endif
+
+  if (true==is_best) {
+    for (std::vector<SolutionPoolListener *>::iterator it=listeners_.begin();
+         it!=listeners_.end(); ++it) {
+      (*it)->newIncumbent(val);
     }
-  } else {
-    sols_.push_back(newsol);
-    bestSolution_ = newsol;
-    timeFirst_ = timer_->query();
-    timeBest_ = timeFirst_;
   }
 }
 
@@ -75,23 +148,40 @@ void SolutionPool::addSolution(const double *x, double obj_value)
 
 SolutionPtr SolutionPool::getBestSolution()
 {
-  return bestSolution_;
+  SolutionPtr sol;
+#if USE_OPENMP
+  omp_set_lock(&lock_);
+#endif
+  sol = bestSolution_;
+#if USE_OPENMP
+  omp_unset_lock(&lock_);
+#endif
+  return sol;
 }
 
 
 double SolutionPool::getBestSolutionValue() const
 {
-  if (bestSolution_) {
-    return bestSolution_->getObjValue();
-  } else {
-    return INFINITY;
-  }
+  double val;
+#if USE_OPENMP
+#pragma omp atomic read
+#endif
+  val = bestVal_;
+  return val;
 }
 
 
 UInt SolutionPool::getNumSols() const
 {
-  return sols_.size();
+  UInt n;
+#if USE_OPENMP
+  omp_set_lock(&lock_);
+#endif
+  n = sols_.size();
+#if USE_OPENMP
+  omp_unset_lock(&lock_);
+#endif
+  return n;
 }
 
 
@@ -101,6 +191,59 @@ UInt SolutionPool::getNumSolsFound() const
 }
 
 
+UInt SolutionPool::getSizeLimit() const
+{
+  return sizeLimit_;
+}
+
+
+size_t SolutionPool::hash_(ConstSolutionPtr sol, UInt n) const
+{
+  // FNV-1a on the bytes of the primal values.
+  const unsigned char *b = (const unsigned char *) sol->getPrimal();
+  size_t h = 2166136261u;
+
+  for (size_t i=0; i<n*sizeof(double); ++i) {
+    h = (h ^ b[i])*16777619u;
+  }
+  return h;
+}
+
+
+void SolutionPool::setSizeLimit(UInt limit)
+{
+#if USE_OPENMP
+  omp_set_lock(&lock_);
+#endif
+  sizeLimit_ = (limit > 0) ? limit : 1;
+  trim_();
+#if USE_OPENMP
+  omp_unset_lock(&lock_);
+#endif
+}
+
+
+void SolutionPool::trim_()
+{
+  double worst = INFINITY;
+
+  while (sols_.size() > sizeLimit_) {
+    // may have been returned by getBestSolution(). Keep it until the pool
+    // is destroyed.
+    retired_.push_back(sols_.back());
+    sols_.pop_back();
+    hashes_.pop_back();
+  }
+  if (sols_.size() == sizeLimit_) {
+    worst = sols_.back()->getObjValue();
+  }
+#if USE_OPENMP
+#pragma omp atomic write
+#endif
+  worstVal_ = worst;
+}
+
+
 void SolutionPool::writeStats(std::ostream &out) const
 {
   out << me_ << "Number of solutions found = " << numSolsFound_ << std::endl
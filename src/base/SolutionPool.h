@@ -19,11 +19,51 @@
 #include "Solution.h"
 #include "Types.h"
 
+#if USE_OPENMP
+#include <omp.h>
+#endif
+
 namespace Minotaur {
 
   class Environment;
   class Timer;
 
+  /**
+   * \brief Interface for objects that need to know at once when a better
+   * solution is found, e.g. tree managers and heuristics.
+   */
+  class SolutionPoolListener {
+  public:
+    /// Destroy.
+    virtual ~SolutionPoolListener() {};
+
+    /**
+     * \brief Called by SolutionPool::addSolution() after a solution better
+     * than all previous ones is added. It may be called from any thread and
+     * by several threads at the same time.
+     *
+     * \param[in] value The objective value of the new best solution.
+     */
+    virtual void newIncumbent(double value) = 0;
+  };
+
+
+  /**
+   * \brief SolutionPool keeps the best few distinct solutions found, sorted
+   * by objective value.
+   *
+   * A solution is not added if another one in the pool has exactly the same
+   * primal values, or if the pool is full and the solution is not better
+   * than the worst one in it. Solutions can be added from several threads at
+   * the same time. The best objective value can be read at any time without
+   * waiting for threads that are adding solutions, so that nodes can be
+   * pruned with the latest cutoff. Listeners are called after a new best
+   * solution is added.
+   *
+   * Solutions that are dropped from the pool are kept until the pool is
+   * destroyed, so that a pointer returned by getBestSolution() remains valid
+   * after other threads add better solutions.
+   */
   class SolutionPool {
   public:
     /// Default constructor.
@@ -38,6 +78,12 @@ namespace Minotaur {
     /// Add Solution to the pool
     void addSolution(ConstSolutionPtr);
 
+    /**
+     * \brief Add an object to be told about new best solutions. Should not
+     * be called while solutions are being added by other threads.
+     */
+    void addListener(SolutionPoolListener *l);
+
     /// Save the root relaxation solution
     //void setRootSolution(ConstSolutionPtr);
 
@@ -53,7 +99,11 @@ namespace Minotaur {
     /// Put a limit on the number of solutions in the pool
     void setSizeLimit(UInt limit);
 
-    /// Get iterator for the first solution ...
+    /**
+     * Get iterator for the first solution ... Solutions are sorted by
+     * objective value. The iterators should not be used while other threads
+     * add solutions.
+     */
     SolutionIterator solsBegin() { return sols_.begin(); }
 
     /// ... and the end.
@@ -74,7 +124,7 @@ namespace Minotaur {
      */
     //SolutionPtr getRootSolution();
 
-    /// Get the best objective function value
+    /// Get the best objective function value. Does not wait for locks.
     double getBestSolutionValue() const;
 
     /// Get the best objective function value
@@ -84,21 +134,35 @@ namespace Minotaur {
     void writeStats(std::ostream &out) const; 
 
   private:
-    /// The solutions are stored in a vector. 
+    /// The solutions are stored in a vector, sorted by objective value.
     std::vector<SolutionPtr> sols_;
 
+    /// Hash of the primal values of each solution in sols_.
+    std::vector<size_t> hashes_;
+
     /**
      * The best solution in terms of objective function value. In case of tie,
-     * the most recently found one.
+     * the one found first.
      */
     SolutionPtr bestSolution_;
 
+    /// Objective value of bestSolution_. Read and written atomically.
+    double bestVal_;
+
     /**
      * The best solution in terms of objective function value. In case of tie,
      * the most recently found one.
      */
     //SolutionPtr rootSolution_;
 
+    /// Objects to be told about new best solutions.
+    std::vector<SolutionPoolListener *> listeners_;
+
+#if USE_OPENMP
+    /// Lock for changing the pool.
+    mutable omp_lock_t lock_;
+#endif
+
     /// For logging.
     const static std::string me_;
 
@@ -108,6 +172,9 @@ namespace Minotaur {
     /// Problem for which we are saving solutions
     ProblemPtr problem_;
 
+    /// Solutions removed from the pool. Deleted with the pool.
+    std::vector<SolutionPtr> retired_;
+
     /// The limit on number of solutions in the pool.
     UInt sizeLimit_;
 
@@ -120,6 +187,17 @@ namespace Minotaur {
     /// Global timer.
     const Timer* timer_;
 
+    /**
+     * A solution must have a smaller objective value to enter the pool.
+     * INFINITY if the pool is not full. Read and written atomically.
+     */
+    double worstVal_;
+
+    /// Hash the primal values of a solution.
+    size_t hash_(ConstSolutionPtr sol, UInt n) const;
+
+    /// Drop solutions beyond the size limit. Lock must be held.
+    void trim_();
   };
 
   typedef SolutionPool* SolutionPoolPtr;
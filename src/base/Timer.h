@@ -15,6 +15,8 @@
 #define MINOTAURTIMER_H
 
 #include <time.h>
+#include <sys/time.h>
+#include <unistd.h>
 
 #ifndef CLOCKS_PER_SEC
 #  define CLOCKS_PER_SEC 1000000
@@ -147,6 +149,108 @@ namespace Minotaur {
   };
 #endif
 
+  /**
+   * A timer that measures elapsed wall-clock time. Uses the monotonic clock
+   * when clock_gettime() is available, so that it is not affected by
+   * changes to the system time. Unlike ClockTimer and UsageTimer, it does
+   * not add up the time of all threads and should be used to report the
+   * time of parallel algorithms.
+   */
+  class WallTimer : public Timer {
+  private:
+    double s_;
+    bool is_started_;
+
+  public:
+    WallTimer() : s_(0.0), is_started_(false)  { };
+    ~WallTimer() { };
+
+    /**
+     * Current wall-clock time in seconds from some fixed point in the past.
+     * Can be called without a timer, e.g. by Profiler.
+     */
+    static double now() {
+#if defined(_POSIX_TIMERS) && _POSIX_TIMERS > 0 && defined(CLOCK_MONOTONIC)
+      struct timespec t;
+      if (0==clock_gettime(CLOCK_MONOTONIC, &t)) {
+        return (double) t.tv_sec + 1e-9 * (double) t.tv_nsec;
+      }
+#endif
+      struct timeval tv;
+      gettimeofday(&tv, NULL);
+      return (double) tv.tv_sec + 1e-6 * (double) tv.tv_usec;
+    };
+
+    /// Start the timer.
+    void start() {
+      s_ = now();
+      is_started_ = true;
+      return;
+    };
+
+    /// Stop the timer. Can not query after this.
+    void stop() {
+      is_started_ = false;
+      return;
+    };
+
+    /// Get the wall-clock time elapsed since this timer was started.
+    double query() const {
+      if (!is_started_) {
+        throw("Some exception");
+      }
+      return now() - s_;
+    };
+  };
+
+  /**
+   * A timer that measures the cpu time used by the calling thread only. It
+   * must be started and queried by the same thread. Falls back to the cpu
+   * time of the process when the per-thread clock is not available.
+   */
+  class ThreadTimer : public Timer {
+  private:
+    double s_;
+    bool is_started_;
+
+  public:
+    ThreadTimer() : s_(0.0), is_started_(false)  { };
+    ~ThreadTimer() { };
+
+    /// CPU time in seconds used by the calling thread so far.
+    static double now() {
+#if defined(_POSIX_TIMERS) && _POSIX_TIMERS > 0 && \
+    defined(CLOCK_THREAD_CPUTIME_ID)
+      struct timespec t;
+      if (0==clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t)) {
+        return (double) t.tv_sec + 1e-9 * (double) t.tv_nsec;
+      }
+#endif
+      return clock() / (double) CLOCKS_PER_SEC;
+    };
+
+    /// Start the timer.
+    void start() {
+      s_ = now();
+      is_started_ = true;
+      return;
+    };
+
+    /// Stop the timer. Can not query after this.
+    void stop() {
+      is_started_ = false;
+      return;
+    };
+
+    /// Get the cpu time used by this thread since the timer was started.
+    double query() const {
+      if (!is_started_) {
+        throw("Some exception");
+      }
+      return now() - s_;
+    };
+  };
+
   /// The TimerFactory should be used to get the approrpriate Timer.
   class TimerFactory {
   public:
@@ -165,6 +269,16 @@ namespace Minotaur {
 #endif
     };
 
+    /// Return a timer that measures wall-clock time.
+    virtual Timer *getWallTimer() {
+      return new WallTimer;
+    };
+
+    /// Return a timer that measures the cpu time of the calling thread.
+    virtual Timer *getThreadTimer() {
+      return new ThreadTimer;
+    };
+
   private: 
     TimerFactory (const TimerFactory &);
     TimerFactory & operator = (const TimerFactory &);
@@ -22,8 +22,12 @@
 #include "Option.h"
 #include "Timer.h"
 #include "TreeManager.h"
+#include "WarmStart.h"
+#include "WarmStartSpill.h"
 
 using namespace Minotaur;
+
+const std::string TreeManager::me_ = "TreeManager: ";
     
     
 TreeManager::TreeManager(EnvPtr env) 
@@ -33,8 +37,13 @@ TreeManager::TreeManager(EnvPtr env)
   doVbc_(false),
   etol_(1e-6),
   size_(0),
-  timer_(0)
+  timer_(0),
+  wsBytes_(0.0),
+  wsReused_(0),
+  wsSaved_(0),
+  wsSpill_(0)
 {
+  double mem_limit;
   std::string s = env->getOptions()->findString("tree_search")->getValue();
   if ("dfs"==s) {
     searchType_ = DepthFirst;
@@ -60,6 +69,12 @@ TreeManager::TreeManager(EnvPtr env)
 
   aNode_ = NodePtr();
   cutOff_ = env->getOptions()->findDouble("obj_cut_off")->getValue();
+  mem_limit = env->getOptions()->findDouble("node_mem_limit")->getValue();
+  if (mem_limit > 0) {
+    s = env->getOptions()->findString("node_mem_policy")->getValue();
+    wsSpill_ = new WarmStartSpill(env, 1048576.0*mem_limit, // MB to bytes
+                                  "drop"==s);
+  }
   s = env->getOptions()->findString("vbc_file")->getValue();
   if (s!="") {
     vbcFile_.open(s.c_str());
@@ -87,6 +102,9 @@ TreeManager::~TreeManager()
     vbcFile_.close();
     delete timer_;
   }
+  if (wsSpill_) {
+    delete wsSpill_;
+  }
 }
 
 
@@ -106,6 +124,9 @@ NodePtr TreeManager::branch(Branches branches, NodePtr node, WarmStartPtr ws)
   if (searchType_ == DepthFirst || searchType_ == BestThenDive) {
     is_first = true;
   }
+  if (ws) {
+    ws = shareWarmStart_(node, ws);
+  }
   for (BranchConstIterator br_iter=branches->begin(); br_iter!=branches->end();
       ++br_iter) {
     branch_p = *br_iter;
@@ -139,6 +160,13 @@ NodePtr TreeManager::branch(Branches branches, NodePtr node, WarmStartPtr ws)
 }
 
 
+bool TreeManager::canPrune(double lb) const
+{
+  return (lb > cutOff_ - etol_ || 
+          fabs(bestUpperBound_-lb)/(fabs(bestUpperBound_)+etol_)*100 < etol_);
+}
+
+
 void TreeManager::clearAll()
 {
   NodePtr n;
@@ -166,6 +194,9 @@ NodePtr TreeManager::getCandidate()
   NodePtr node = NodePtr(); // NULL
   //aNode_.reset();
   aNode_ = 0;
+  if (wsSpill_) {
+    wsSpill_->check(activeNodes_, true);
+  }
   while (activeNodes_->getSize() > 0) {
     node = activeNodes_->top();
     if (shouldPrune_(node)) {
@@ -181,6 +212,9 @@ NodePtr TreeManager::getCandidate()
       break;
     }
   } 
+  if (wsSpill_) {
+    wsSpill_->load(node);
+  }
   return node; // can be NULL
   // do not pop the head until the candidate has been processed.
 }
@@ -368,6 +402,30 @@ void TreeManager::setUb(double value)
 }
 
 
+WarmStartPtr TreeManager::shareWarmStart_(NodePtr node, WarmStartPtr ws)
+{
+  NodePtr parent = node->getParent();
+  WarmStartPtr pws;
+
+  ++wsSaved_;
+  if (parent) {
+    for (NodePtrIterator it=parent->childrenBegin(); it!=parent->childrenEnd();
+         ++it) {
+      pws = (*it)->getWarmStart();
+      if (pws && pws != ws && pws->getSpillPos() < 0 && pws->equals(ws)) {
+        ++wsReused_;
+        if (0 == ws->getUseCnt()) {
+          delete ws;
+        }
+        return pws;
+      }
+    }
+  }
+  wsBytes_ += ws->getBytes();
+  return ws;
+}
+
+
 bool TreeManager::shouldDive()
 {
   if (searchType_ == DepthFirst || searchType_ == BestThenDive) {
@@ -379,9 +437,7 @@ bool TreeManager::shouldDive()
 
 bool TreeManager::shouldPrune_(NodePtr node)
 {
-  double lb = node->getLb();
-  if (lb > cutOff_ - etol_ || 
-      fabs(bestUpperBound_-lb)/(fabs(bestUpperBound_)+etol_)*100 < etol_) {
+  if (canPrune(node->getLb())) {
     node->setStatus(NodeHitUb);
     return true;
   }
@@ -398,6 +454,17 @@ double TreeManager::updateLb()
 }
 
 
+void TreeManager::writeStats(std::ostream &out) const
+{
+  out << me_ << "warm starts saved     = " << wsSaved_ << std::endl
+      << me_ << "warm starts reused    = " << wsReused_ << std::endl
+      << me_ << "warm-start bytes (MB) = " << wsBytes_/1048576.0
+      << std::endl;
+  if (wsSpill_) {
+    wsSpill_->writeStats(out);
+  }
+}
+
 // Local Variables: 
 // mode: c++ 
 // eval: (c-set-style "k&r") 
@@ -22,8 +22,10 @@ namespace Minotaur {
   
   class ActiveNodeStore;
   class WarmStart;
+  class WarmStartSpill;
   typedef ActiveNodeStore* ActiveNodeStorePtr;
   typedef WarmStart* WarmStartPtr;
+  typedef WarmStartSpill* WarmStartSpillPtr;
 
   // 1=like_red, 2=blue, 4=red, 5=yellow, 6=black, 7=pink, 8=cyan, 9=green
   // 11=orange, 12=green, 13=pink, 14=light blue
@@ -64,6 +66,14 @@ namespace Minotaur {
      */
     NodePtr branch(Branches branches, NodePtr node, WarmStartPtr ws);
 
+    /**
+     * \brief Return true if a node with the given lower bound will be
+     * pruned by getCandidate() under the current cutoff and upper bound.
+     *
+     * \param[in] lb The lower bound of the node.
+     */
+    bool canPrune(double lb) const;
+
     /**
      * \brief Return the number of active nodes, i.e. nodes that have been
      * created, but not processed yet.
@@ -164,6 +174,9 @@ namespace Minotaur {
      */
     double updateLb();
 
+    /// Write statistics of warm starts saved on nodes to the stream.
+    void writeStats(std::ostream &out) const;
+
   private:
     /// Set of nodes that are still active (those who need to be processed).
     ActiveNodeStorePtr activeNodes_; 
@@ -190,6 +203,9 @@ namespace Minotaur {
     /// Tolerance for pruning nodes on the basis of bounds.
     const double etol_;
 
+    /// For logging.
+    static const std::string me_;
+
     /// The search order: depth first, best first or something else.
     TreeSearchOrder searchType_;
 
@@ -205,6 +221,21 @@ namespace Minotaur {
     /// File name to store tree information for vbc.
     std::ofstream vbcFile_;
 
+    /// Total bytes of warm starts saved on new nodes, excluding reused ones.
+    double wsBytes_;
+
+    /// Number of warm starts replaced by an identical one of the parent.
+    UInt wsReused_;
+
+    /// Number of warm starts given to branch().
+    UInt wsSaved_;
+
+    /**
+     * \brief Spills warm starts of active nodes to a file when they use
+     * more memory than the limit. NULL if there is no limit.
+     */
+    WarmStartSpillPtr wsSpill_;
+
     /// Check if the node can be pruned because of its bound.
     bool shouldPrune_(NodePtr node);
 
@@ -232,6 +263,20 @@ namespace Minotaur {
      * node are not removed.
      */
     void removeNode_(NodePtr node);
+
+    /**
+     * \brief Find a warm start of the parent that is identical to a new one.
+     *
+     * Open siblings of a node still carry the warm start of its parent. If
+     * that has the same information as ws, it is used for the children of
+     * the node instead. ws is deleted here if nobody holds a reference to
+     * it. Processors like PCBProcessor hold one and delete ws when they
+     * process the next node; BndProcessor and others do not.
+     * \param[in] node The node that is being branched on.
+     * \param[in] ws The warm start saved after processing the node.
+     * \return The warm start that should be given to the children.
+     */
+    WarmStartPtr shareWarmStart_(NodePtr node, WarmStartPtr ws);
   };
 
   typedef TreeManager* TreeManagerPtr;
@@ -75,10 +75,7 @@ UnambRelBrancher::~UnambRelBrancher()
 
 
 BrCandPtr UnambRelBrancher::findBestCandidate_(const double objval, 
-                                                  double cutoff, NodePtr node,
-                                                  IntVector candsPos, 
-                                                  IntVector candsPosRel,
-                                                  IntVector candsPosUnrel)
+                                                  double cutoff, NodePtr node)
 {
   double best_score = -INFINITY;
   double score, change_up, change_down, maxchange;
@@ -89,7 +86,7 @@ BrCandPtr UnambRelBrancher::findBestCandidate_(const double objval,
   // first evaluate candidates that have reliable pseudo costs
   cnt=0;
   for (BrCandVIter it=relCands_.begin(); it!=relCands_.end(); ++it) {
-    getPCScore_(*it, &change_down, &change_up, &score, node, candsPosRel, cnt);
+    getPCScore_(*it, &change_down, &change_up, &score, node);
     //std::cout << (*it)->getName() << " " << change_up << " " 
       //<< change_down << " " << score << "\n";
     if (score > best_score) {
@@ -106,8 +103,6 @@ BrCandPtr UnambRelBrancher::findBestCandidate_(const double objval,
 
   maxchange = cutoff-objval;
   // now do strong branching on unreliable candidates
-  UIntVector lastStrBranched = node->getLastStrongBranched();
-
   if (unrelCands_.size()>0) {
     BrCandVIter it;
     engine_->enableStrBrSetup();
@@ -122,7 +117,7 @@ BrCandPtr UnambRelBrancher::findBestCandidate_(const double objval,
       change_up    = std::max(change_up - objval, 0.0);
       change_down  = std::max(change_down - objval, 0.0);
       useStrongBranchInfo_(cand, maxchange, change_up, change_down, 
-          status_up, status_down, node, candsPos[cnt]);
+          status_up, status_down, node);
       score = getScore_(change_up, change_down);
       //lastStrBranched_[cand->getPCostIndex()] = stats_->calls;
 #if SPEW
@@ -146,7 +141,7 @@ BrCandPtr UnambRelBrancher::findBestCandidate_(const double objval,
     if (NotModifiedByBrancher == status_) {
       // get score of remaining unreliable candidates as well.
       for (;it!=unrelCands_.end(); ++it) {
-        getPCScore_(*it, &change_down, &change_up, &score, node, candsPosUnrel, cnt);
+        getPCScore_(*it, &change_down, &change_up, &score, node);
         if (score > best_score) {
           best_score = score;
           best_cand = *it;
@@ -178,9 +173,6 @@ Branches UnambRelBrancher::findBranches(RelaxationPtr rel, NodePtr node,
   Branches branches = 0;
   BrCandPtr br_can = 0;
   const double *x = sol->getPrimal();
-  
-  //position of the branching candidate in brCands (-1 otherwise)
-  IntVector candsPos; 
 
   ++(stats_->calls);
   if (!init_) {
@@ -196,8 +188,7 @@ Branches UnambRelBrancher::findBranches(RelaxationPtr rel, NodePtr node,
   x_.resize(rel->getNumVars());
   std::copy(x, x+rel->getNumVars(), x_.begin());
 
-  IntVector candsPosRel, candsPosUnrel;
-  findCandidates_(node, candsPos, candsPosRel, candsPosUnrel);
+  findCandidates_(node);
   if (status_ == PrunedByBrancher) {
     br_status = status_;
     return 0;
@@ -205,8 +196,7 @@ Branches UnambRelBrancher::findBranches(RelaxationPtr rel, NodePtr node,
 
   if (status_ == NotModifiedByBrancher) {
     br_can = findBestCandidate_(sol->getObjValue(), 
-                                s_pool->getBestSolutionValue(), node,
-                                candsPos, candsPosRel, candsPosUnrel);
+                                s_pool->getBestSolutionValue(), node);
   }
 
   // status_ might have changed now. Check again.
@@ -253,13 +243,12 @@ Branches UnambRelBrancher::findBranches(RelaxationPtr rel, NodePtr node,
 }
 
 
-void UnambRelBrancher::findCandidates_(NodePtr node, IntVector & candsPos, 
-                                       IntVector & candsPosRel,
-                                       IntVector & candsPosUnrel)
+void UnambRelBrancher::findCandidates_(NodePtr node)
 {
   VariableIterator v_iter, v_iter2, best_iter;
   VariableConstIterator cv_iter;
-  int index = -1, vindex = -1;
+  const PCostRecord *rec;
+  int index = -1;
   bool is_inf = false;   // if true, then node can be pruned.
 
   BrVarCandSet cands;       // candidates from which to choose one.
@@ -309,55 +298,25 @@ void UnambRelBrancher::findCandidates_(NodePtr node, IntVector & candsPos,
   }
 
   // visit each candidate in and check if it has reliable pseudo costs.
-  candsPos.resize(cands.size(),-1);
-
-  //check if the a candidate's information is present with the parent node
-  //NodePtr parent = node->getParent();
-  //if (parent) {
-    //node->setBrCands(parent->getBrCands());
-    //node->setPCDown(parent->getPCDown());
-    //node->setPCUp(parent->getPCUp());
-    //node->setTimesDown(parent->getTimesDown());
-    //node->setTimesUp(parent->getTimesUp());
-    //node->setLastStrongBranched(parent->getLastStrongBranched());
-  //}
-  UIntVector brCands = node->getBrCands();
-  DoubleVector pCDown = node->getPCDown();
-  DoubleVector pCUp = node->getPCUp();
-  UIntVector timesDown = node->getTimesDown();
-  UIntVector timesUp = node->getTimesUp();
-  UIntVector lastStrBranched = node->getLastStrongBranched();
-  
-  std::vector<UInt>::iterator vit;
-  UInt candi=0;
   for (BrVarCandIter it=cands.begin(); it!=cands.end(); ++it) {
     index = (*it)->getPCostIndex();
-    vit = std::find(brCands.begin(), brCands.end(), index);
-    if (vit != brCands.end()) {
-      vindex = std::distance(brCands.begin(), vit);
-      candsPos[candi] = vindex;
-      if ((minNodeDist_ > fabs(node->getDepth()-lastStrBranched[vindex])) ||
-          (timesUp[vindex] >= thresh_ && timesDown[vindex] >= thresh_)) {
+    rec = node->findPCost(index);
+    if (rec) {
+      if ((minNodeDist_ > fabs(node->getDepth()-rec->lastStrBranched)) ||
+          (rec->timesUp >= thresh_ && rec->timesDown >= thresh_)) {
         relCands_.push_back(*it);
-        candsPosRel.push_back(vindex);
       } else {
-        //score = 0;
-        score = timesUp[vindex] + timesDown[vindex]
-          -s_wt*(pCUp[vindex]+pCDown[vindex])
+        score = rec->timesUp + rec->timesDown
+          -s_wt*(rec->pcUp+rec->pcDown)
           -i_wt*std::max((*it)->getDDist(), (*it)->getUDist());
         (*it)->setScore(score);
         unrelCands_.push_back(*it);
-        //candsPosUnrel.push_back(vindex);
       }
     } else {
-      //score = timesUp[index] + timesDown[index]
-        //-s_wt*(pseudoUp[index]+pseudoDown_[index])
       score = -i_wt*std::max((*it)->getDDist(), (*it)->getUDist()); //candidate not branched on before
       (*it)->setScore(score);
       unrelCands_.push_back(*it);
-      //candsPosUnrel.push_back(-1);
     }
-    candi++;
   }
 
   // push all general candidates (that are not variables) as reliable
@@ -369,20 +328,6 @@ void UnambRelBrancher::findCandidates_(NodePtr node, IntVector & candsPos,
   // sort unreliable candidates in the increasing order of their reliability.
   std::sort(unrelCands_.begin(), unrelCands_.end(), CompareScore);
 
-  //form the sorted candsPosUnrel array
-  candi=0;
-  for (BrCandVIter it=unrelCands_.begin(); it!=unrelCands_.end(); ++it) {
-    index = (*it)->getPCostIndex();
-    vit = std::find(brCands.begin(), brCands.end(), index);
-    if (vit != brCands.end()) {
-      vindex = std::distance(brCands.begin(), vit);
-      candsPosUnrel.push_back(vindex);
-    } else {
-      candsPosUnrel.push_back(-1);
-    }
-    candi++;
-  }
-
 #if SPEW
   logger_->msgStream(LogDebug) << me_
                                << "number of reliable candidates = " 
@@ -397,7 +342,7 @@ void UnambRelBrancher::findCandidates_(NodePtr node, IntVector & candsPos,
 
   //Populate containers of reliability brancher with data from node (not needed?)
   
-  //writeScores_(std::cout, node, candsPosRel, candsPosUnrel);
+  //writeScores_(std::cout, node);
   return;
 }
 
@@ -439,16 +384,13 @@ std::string UnambRelBrancher::getName() const
 
 void UnambRelBrancher::getPCScore_(BrCandPtr cand, double *ch_down, 
                                       double *ch_up, double *score, 
-                                      NodePtr node, IntVector candsPos,
-                                      UInt cnt) 
+                                      NodePtr node) 
 {
-  UIntVector brCands = node->getBrCands();
-  DoubleVector pCDown = node->getPCDown();
-  DoubleVector pCUp = node->getPCUp();
-  //int index = cand->getPCostIndex();
-  if (candsPos[cnt]>-1) {
-    *ch_down   = cand->getDDist()*pCDown[candsPos[cnt]];
-    *ch_up     = cand->getUDist()*pCUp[candsPos[cnt]];
+  int index = cand->getPCostIndex();
+  const PCostRecord *rec = (index>-1) ? node->findPCost(index) : 0;
+  if (rec) {
+    *ch_down   = cand->getDDist()*rec->pcDown;
+    *ch_up     = cand->getUDist()*rec->pcUp;
     *score     = getScore_(*ch_up, *ch_down);
   } else {
     *ch_down   = 0.0;
@@ -620,22 +562,8 @@ void UnambRelBrancher::updateAfterSolve(NodePtr node, ConstSolutionPtr sol)
     BrCandPtr cand = node->getBranch()->getBrCand();
     int index = cand->getPCostIndex();
     if (index>-1) {
-      UInt vindex;
-      node->setBrCands(parent->getBrCands());
-      node->setPCDown(parent->getPCDown());
-      node->setPCUp(parent->getPCUp());
-      node->setTimesDown(parent->getTimesDown());
-      node->setTimesUp(parent->getTimesUp());
-      node->setLastStrongBranched(parent->getLastStrongBranched());
-      
-      UIntVector brCands = node->getBrCands();
-      DoubleVector pCDown = node->getPCDown();
-      DoubleVector pCUp = node->getPCUp();
-      UIntVector timesDown = node->getTimesDown();
-      UIntVector timesUp = node->getTimesUp();
-      std::vector<UInt>::iterator vit;
-      bool newCand = false;
-
+      // statistics of the parent are found by the node through its parent,
+      // so nothing needs to be copied.
       double oldval = node->getBranch()->getActivity();
       double newval = x[index];
       double cost = (node->getLb()-parent->getLb()) / 
@@ -643,61 +571,26 @@ void UnambRelBrancher::updateAfterSolve(NodePtr node, ConstSolutionPtr sol)
       if (cost < 0. || std::isinf(cost) || std::isnan(cost)) {
         cost = 0.;
       }
-      
-      vit = std::find(brCands.begin(), brCands.end(), index);
-      if (vit != brCands.end()) {
-        vindex = std::distance(brCands.begin(), vit);
-      } else { //this will never happen, right?
-        vindex = -1;
-        newCand = true;
-      }
-      if (newval < oldval) {
-        updatePCost_(index, vindex, cost, pCDown, timesDown, newCand, true, false, node);
-      } else {
-        updatePCost_(index, vindex, cost, pCUp, timesUp, newCand, false, false, node);
-      }
+      updatePCost_(index, cost, (newval < oldval), false, node);
     } 
   }
 }
 
 
-void UnambRelBrancher::updatePCost_(const int & index, int i, const double & new_cost,
-                                    DoubleVector cost, UIntVector count,
-                                    bool newCand, bool updateDown, bool strngBrnched, 
+void UnambRelBrancher::updatePCost_(UInt index, double new_cost,
+                                    bool updateDown, bool strngBrnched, 
                                     NodePtr node)
 {
-  if (!newCand) {
-    if (updateDown) {
-      node->updatePCDown(i, (cost[i]*count[i] + new_cost)/(count[i]+1));
-      node->updateTimesDown(i,count[i]+1);
-    } else {
-      node->updatePCUp(i, (cost[i]*count[i] + new_cost)/(count[i]+1));
-      node->updateTimesUp(i,count[i]+1);
-    }
-    if (strngBrnched) {
-      node->updateLastStrBranched(i, stats_->calls);
-    }
+  PCostRecord *rec = node->recordPCost(index);
+  if (updateDown) {
+    rec->pcDown = (rec->pcDown*rec->timesDown + new_cost)/(rec->timesDown+1);
+    ++(rec->timesDown);
   } else {
-    UIntVector brCands = node->getBrCands();
-    UInt n = brCands.size()+1;
-   
-    node->updateBrCands(index);
-    if (updateDown) {
-      node->updatePCDown(n, new_cost);
-      node->updateTimesDown(n, 1);
-      node->updatePCUp(n, 0);
-      node->updateTimesUp(n, 0);
-    } else {
-      node->updatePCUp(n, new_cost);
-      node->updateTimesUp(n, 1);
-      node->updatePCDown(n, 0);
-      node->updateTimesDown(n, 0);
-    }
-    if (strngBrnched) {
-      node->updateLastStrBranched(n, stats_->calls);
-    } else {
-      node->updateLastStrBranched(n, 0);
-    }
+    rec->pcUp = (rec->pcUp*rec->timesUp + new_cost)/(rec->timesUp+1);
+    ++(rec->timesUp);
+  }
+  if (strngBrnched) {
+    rec->lastStrBranched = stats_->calls;
   }
 }
 
@@ -708,7 +601,7 @@ void UnambRelBrancher::useStrongBranchInfo_(BrCandPtr cand,
                                                double &change_down,
                                                const EngineStatus & status_up,
                                                const EngineStatus & status_down,
-                                               NodePtr node, int candPosition)
+                                               NodePtr node)
 {
   const UInt index        = cand->getPCostIndex();
   bool should_prune_up    = false;
@@ -734,18 +627,10 @@ void UnambRelBrancher::useStrongBranchInfo_(BrCandPtr cand,
     mods_.push_back(cand->getHandler()->getBrMod(cand, x_, rel_, UpBranch));
     ++(stats_->bndChange);
   } else { 
-    if (candPosition > -1) {
-      cost = fabs(change_down)/(fabs(cand->getDDist())+eTol_);
-      //updatePCost_(index, cost, pseudoDown_, timesDown_, false, true, true, node);
-      updatePCost_(index, candPosition, cost, node->getPCDown(), node->getTimesDown(), false, true, true, node);
-      cost = fabs(change_up)/(fabs(cand->getUDist())+eTol_);
-      updatePCost_(index, candPosition, cost, node->getPCUp(), node->getTimesUp(), false, false, true, node);
-    } else {
-      cost = fabs(change_down)/(fabs(cand->getDDist())+eTol_);
-      updatePCost_(index, candPosition, cost, node->getPCDown(), node->getTimesDown(), true, true, true, node);
-      cost = fabs(change_up)/(fabs(cand->getUDist())+eTol_);
-      updatePCost_(index, node->getBrCands().size() - 1, cost, node->getPCUp(), node->getTimesUp(), false, false, true, node);
-    }
+    cost = fabs(change_down)/(fabs(cand->getDDist())+eTol_);
+    updatePCost_(index, cost, true, true, node);
+    cost = fabs(change_up)/(fabs(cand->getUDist())+eTol_);
+    updatePCost_(index, cost, false, true, node);
 
   }
 }
@@ -762,25 +647,20 @@ void UnambRelBrancher::writeScore_(BrCandPtr cand, double score,
 }
 
 
-void UnambRelBrancher::writeScores_(std::ostream &out, NodePtr node,
-                                    IntVector candsPosRel, 
-                                    IntVector candsPosUnrel)
+void UnambRelBrancher::writeScores_(std::ostream &out, NodePtr node)
 {
-  int cnt=0;
-  DoubleVector pCDown = node->getPCDown();
-  DoubleVector pCUp = node->getPCUp();
-  UIntVector timesDown = node->getTimesDown();
-  UIntVector timesUp = node->getTimesUp();
+  const PCostRecord *rec;
 
   out << me_ << "unreliable candidates:" << std::endl;
   for (BrCandVIter it=unrelCands_.begin(); it!=unrelCands_.end(); ++it) {
     if ((*it)->getPCostIndex()>-1) {
       out << std::setprecision(6) << (*it)->getName() << "\t";
-      if (candsPosUnrel[cnt] > -1) {
-        out << timesDown[candsPosUnrel[cnt]] << "\t"
-        << timesUp[candsPosUnrel[cnt]] << "\t" 
-        << node->getPCDown()[candsPosUnrel[cnt]] << "\t"
-        << node->getPCUp()[candsPosUnrel[cnt]] << "\t"
+      rec = node->findPCost((*it)->getPCostIndex());
+      if (rec) {
+        out << rec->timesDown << "\t"
+        << rec->timesUp << "\t" 
+        << rec->pcDown << "\t"
+        << rec->pcUp << "\t"
         << x_[(*it)->getPCostIndex()] << "\t"
         << rel_->getVariable((*it)->getPCostIndex())->getLb() << "\t"
         << rel_->getVariable((*it)->getPCostIndex())->getUb() << "\t";
@@ -803,19 +683,18 @@ void UnambRelBrancher::writeScores_(std::ostream &out, NodePtr node,
                                   << 0.0 << "\t"
                                   << 1.0 << "\t" << std::endl;
     }
-    cnt++;
   }
 
   out << me_ << "reliable candidates:" << std::endl;
-  cnt = 0;
   for (BrCandVIter it=relCands_.begin(); it!=relCands_.end(); ++it) {
     if ((*it)->getPCostIndex()>-1) {
       out << std::setprecision(6) << (*it)->getName() << "\t";
-      if (candsPosRel[cnt] > -1) {
-        out << timesDown[candsPosRel[cnt]] << "\t"
-        << timesUp[candsPosRel[cnt]] << "\t" 
-        << node->getPCDown()[candsPosRel[cnt]] << "\t"
-        << node->getPCUp()[candsPosRel[cnt]] << "\t"
+      rec = node->findPCost((*it)->getPCostIndex());
+      if (rec) {
+        out << rec->timesDown << "\t"
+        << rec->timesUp << "\t" 
+        << rec->pcDown << "\t"
+        << rec->pcUp << "\t"
         << x_[(*it)->getPCostIndex()] << "\t"
         << rel_->getVariable((*it)->getPCostIndex())->getLb() << "\t"
         << rel_->getVariable((*it)->getPCostIndex())->getUb() << "\t";
@@ -838,7 +717,6 @@ void UnambRelBrancher::writeScores_(std::ostream &out, NodePtr node,
                                   << 0.0 << "\t"
                                   << 1.0 << "\t" << std::endl;
     }
-    cnt++;
   }
 
 
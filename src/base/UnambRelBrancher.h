@@ -129,14 +129,9 @@ private:
    * \param[in] cutoff The cutoff value for objective function (an upper
    * bound).
    * \param[in] node The node at which we are branching.
-   * \param[in] candsPos Vector of branching variables' indices.
-   * \param[in] candsPos Vector of reliable branching variables' indices.
-   * \param[in] candsPos Vector of unreliable branching variables' indices.
    */
   BrCandPtr findBestCandidate_(const double objval, double cutoff, 
-                               NodePtr node, IntVector candsPos,
-                               IntVector candsPosRel,
-                               IntVector candsPosUnRel);
+                               NodePtr node);
 
   /**
    * \brief Find and sort candidates for branching.
@@ -147,9 +142,7 @@ private:
    * last_strong in the cands_ vector do not need any further strong 
    * branching.  
    */
-  void findCandidates_(NodePtr node, IntVector & candPositions,
-                               IntVector & candsPosRel, 
-                               IntVector & candsPosUnRel);
+  void findCandidates_(NodePtr node);
 
   /**
    * Clean up reliable and unreliable candidates, except for the no_del
@@ -167,8 +160,7 @@ private:
    * \param[out] node The node from which the information is taken.
    */
   void getPCScore_(BrCandPtr cand, double *ch_down, double *ch_up, 
-                   double *score, NodePtr node, IntVector candsPos,
-                   UInt cnt);
+                   double *score, NodePtr node);
 
   /**
    * \brief Calculate score from the up score and down score.
@@ -209,22 +201,17 @@ private:
   /**
    * \brief Update Pseudocost based on the new costs.
    *
-   * \param[in] index Index of the candidate.
-   * \param[in] i Position of the candidate in brCands array.
+   * The pseudo cost is recorded at the node. Statistics of the ancestors
+   * are used as the starting point if the node has no record of the
+   * candidate yet.
+   * \param[in] index Pseudo-cost index of the candidate.
    * \param[in] new_cost The new cost estimate.
-   * \param[in] cost The vector of costs of all candidates. cost[i] is to
-   * be updated
-   * \param[in] count The vector that keeps a cound of how many times cost
-   * has been updated for each candidate.
-   * \param[in] newCand True if the branching candidate is new.
    * \param[in] updateDown True if we have branched down.
    * \param[in] strngBrnched True if we have strong branched.
-   * \param[in] Pointer of the current node.
+   * \param[in] node Pointer of the current node.
    */
-  void updatePCost_(const int &index, int i, const double &new_cost, 
-                    DoubleVector cost, UIntVector count,
-                    bool newCand, bool updateDown, bool strngBrnched, 
-                    NodePtr node);
+  void updatePCost_(UInt index, double new_cost, bool updateDown,
+                    bool strngBrnched, NodePtr node);
 
   /**
    * \brief Analyze the strong-branching results.
@@ -241,13 +228,12 @@ private:
    * \param[in] status_up The engine status in up branch. 
    * \param[in] status_down The engine status in up branch.
    * \param[in] node The current node at which the info is update.
-   * \param[in] candPosition Position of the candidate in the pseudocost array.
    */
   void useStrongBranchInfo_(BrCandPtr cand, const double & chcutoff,
                             double & change_up, double & change_down, 
                             const EngineStatus & status_up,
                             const EngineStatus & status_down,
-                            NodePtr node, int candPosition);
+                            NodePtr node);
 
   /** 
    * \brief Display score details of the candidate.
@@ -274,11 +260,8 @@ private:
    *
    * \param[in] out Outstream where scores are displayed.
    * \param[in] node The current node.
-   * \param[in] candsPosRel Position of reliable candidates in the parent node vector.
-   * \param[in] candsPosUnrel Position of unreliable candidates in the parent node vector.
    */
-  void writeScores_(std::ostream &out, NodePtr node, IntVector candsPosRel,
-                    IntVector candsPosUnrel);
+  void writeScores_(std::ostream &out, NodePtr node);
 
   /// The engine used for strong branching.
   EnginePtr engine_;
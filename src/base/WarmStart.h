@@ -15,6 +15,8 @@
 #ifndef MINOTAURWARMSTART_H
 #define MINOTAURWARMSTART_H
 
+#include <cstdio>
+
 #include "Types.h"
 
 namespace Minotaur {
@@ -45,7 +47,7 @@ namespace Minotaur {
   class WarmStart {
     public:
       /// Default constructor
-      WarmStart() {cnt_ = 0;} ;
+      WarmStart() {cnt_ = 0; spillPos_ = -1;} ;
 
       /// Destroy
       virtual ~WarmStart() {} ;
@@ -53,6 +55,24 @@ namespace Minotaur {
       virtual void decrUseCnt()
       {--cnt_;} ;
 
+      /**
+       * Return true if ws holds exactly the same information as this one, so
+       * that nodes can share a single copy. False if unknown.
+       */
+      virtual bool equals(ConstWarmStartPtr) const
+      {return false;} ;
+
+      /**
+       * Return the approximate number of bytes of memory used by the
+       * information. It is zero for types that can not be spilled.
+       */
+      virtual size_t getBytes() const
+      {return 0;} ;
+
+      /// Return the position in the spill file, or -1 if not spilled.
+      long getSpillPos() const
+      {return spillPos_;} ;
+
       virtual int getUseCnt()
       {return cnt_;} ;
       
@@ -62,6 +82,22 @@ namespace Minotaur {
 
       virtual void incrUseCnt()
       {++cnt_;} ;
+
+      /// Set the position in the spill file. -1 means not spilled.
+      void setSpillPos(long pos)
+      {spillPos_ = pos;} ;
+
+      /**
+       * Write the information to the current position of a binary file and
+       * free the memory it uses. At most getBytes() bytes are written. Return
+       * false if it could not be written, in which case nothing is freed.
+       */
+      virtual bool spill(FILE *)
+      {return false;} ;
+
+      /// Read back the information written by spill(). Return false on error.
+      virtual bool unspill(FILE *)
+      {return false;} ;
       
       /// Write to an output stream
       virtual void write(std::ostream &out) const = 0;
@@ -74,6 +110,13 @@ namespace Minotaur {
        * is in use. When it is zero, it is safe to delete it.
        */
       int cnt_;
+
+      /**
+       * Position of the information in the file to which it was spilled by
+       * the tree-manager to save memory. It is -1 when the information is in
+       * memory.
+       */
+      long spillPos_;
   };
 }
 #endif
@@ -0,0 +1,250 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2008 - 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file WarmStartSpill.cpp
+ * \brief Define class WarmStartSpill for keeping the memory used by
+ * warm-start information of active nodes within a limit.
+ * \author The MINOTAUR Team
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+#include "MinotaurConfig.h"
+#include "ActiveNodeStore.h"
+#include "Environment.h"
+#include "Logger.h"
+#include "Node.h"
+#include "WarmStart.h"
+#include "WarmStartSpill.h"
+
+using namespace Minotaur;
+
+const std::string WarmStartSpill::me_ = "WarmStartSpill: ";
+
+WarmStartSpill::WarmStartSpill(EnvPtr env, double limit, bool drop)
+  : drop_(drop),
+    end_(0),
+    fp_(0),
+    limit_(limit),
+    logger_(env->getLogger()),
+    maxBytes_(0.0),
+    maxEnd_(0),
+    nextCheck_(0),
+    nDrops_(0),
+    nLoads_(0),
+    nSpills_(0),
+    spilledBytes_(0.0)
+{
+}
+
+
+WarmStartSpill::~WarmStartSpill()
+{
+  if (fp_) {
+    fclose(fp_);
+  }
+}
+
+
+void WarmStartSpill::check(ActiveNodeStorePtr store, bool shared)
+{
+  NodePtrVector nodes;
+  WarmStartPtr ws;
+  double bytes = 0.0;
+  double per_node, target;
+  UInt n_mem = 0;
+  UInt size = store->getSize();
+  UInt gap;
+
+  if (size < nextCheck_) {
+    return;
+  }
+
+  // a warm start shared by k nodes is counted 1/k times at each of them.
+  store->getColdNodes(nodes);
+  if (!live_.empty()) {
+    freeDead_(nodes);
+  }
+  for (NodePtrIterator it=nodes.begin(); it!=nodes.end(); ++it) {
+    ws = (*it)->getWarmStart();
+    if (ws && ws->getSpillPos() < 0 && ws->getUseCnt() > 0) {
+      bytes += (double) ws->getBytes()/ws->getUseCnt();
+      ++n_mem;
+    }
+  }
+  if (bytes > maxBytes_) {
+    maxBytes_ = bytes;
+  }
+  per_node = (n_mem > 0) ? bytes/n_mem : 0.0;
+  target = (bytes > limit_) ? 0.75*limit_ : bytes;
+
+  for (NodePtrIterator it=nodes.begin(); it!=nodes.end() && bytes > target;
+       ++it) {
+    ws = (*it)->getWarmStart();
+    if (ws && ws->getSpillPos() < 0 && (shared || ws->getUseCnt() == 1)) {
+      double ws_bytes = (double) ws->getBytes();
+      if (ws_bytes <= 0) {
+        continue;
+      } else if (drop_) {
+        // memory is freed when the last node drops it.
+        ws_bytes /= ws->getUseCnt();
+        (*it)->removeWarmStart();
+        ++nDrops_;
+        bytes -= ws_bytes;
+        spilledBytes_ += ws_bytes;
+      } else if (spill_(ws)) {
+        bytes -= ws_bytes;
+        spilledBytes_ += ws_bytes;
+      }
+    }
+  }
+
+  // scan again when the store has grown by 1/8 or when the new nodes could
+  // have used up the remaining memory, whichever is earlier.
+  gap = size/8 + 64;
+  if (per_node > 0.0 && bytes < limit_ && (limit_-bytes)/per_node < gap) {
+    gap = (UInt) ((limit_-bytes)/per_node);
+  }
+  nextCheck_ = size + std::max(gap, (UInt) 16);
+}
+
+
+void WarmStartSpill::freeDead_(const NodePtrVector &nodes)
+{
+  std::map<long, long> live;
+  std::map<long, long>::iterator sit;
+  WarmStartPtr ws;
+
+  // a spilled warm start is read back as soon as its node is taken from the
+  // store. So every slot still in use belongs to a node in the store. The
+  // others belonged to nodes that were pruned.
+  for (NodePtrVector::const_iterator it=nodes.begin(); it!=nodes.end();
+       ++it) {
+    ws = (*it)->getWarmStart();
+    if (ws && ws->getSpillPos() >= 0) {
+      sit = live_.find(ws->getSpillPos());
+      if (sit != live_.end()) {
+        live.insert(*sit);
+      }
+    }
+  }
+  for (sit=live_.begin(); sit!=live_.end(); ++sit) {
+    if (live.find(sit->first) == live.end()) {
+      free_.insert(std::make_pair(sit->second, sit->first));
+    }
+  }
+  live_.swap(live);
+  if (live_.empty()) {
+    free_.clear();
+    end_ = 0;
+  }
+}
+
+
+void WarmStartSpill::freeSlot_(long pos)
+{
+  std::map<long, long>::iterator it = live_.find(pos);
+  if (it != live_.end()) {
+    free_.insert(std::make_pair(it->second, pos));
+    live_.erase(it);
+  }
+  if (live_.empty()) {
+    // everything can be overwritten.
+    free_.clear();
+    end_ = 0;
+  }
+}
+
+
+bool WarmStartSpill::load(NodePtr node)
+{
+  WarmStartPtr ws = (node) ? node->getWarmStart() : 0;
+  bool ok = true;
+
+  if (ws && ws->getSpillPos() >= 0) {
+    ok = (0 == fseek(fp_, ws->getSpillPos(), SEEK_SET)) && ws->unspill(fp_);
+    freeSlot_(ws->getSpillPos());
+    ws->setSpillPos(-1);
+    ++nLoads_;
+    if (!ok) {
+      logger_->msgStream(LogError) << me_ << "could not read warm start of "
+                                   << "node " << node->getId()
+                                   << " from file." << std::endl;
+    }
+  }
+  return ok;
+}
+
+
+bool WarmStartSpill::spill_(WarmStartPtr ws)
+{
+  long len = (long) ws->getBytes();
+  long pos, written;
+  std::multimap<long, long>::iterator fit;
+
+  if (!fp_) {
+    fp_ = tmpfile();
+    if (!fp_) {
+      logger_->msgStream(LogError) << me_ << "cannot open temporary file "
+                                   << "for warm starts." << std::endl;
+      return false;
+    }
+  }
+
+  // smallest free slot that is large enough.
+  fit = free_.lower_bound(len);
+  if (fit != free_.end()) {
+    len = fit->first;
+    pos = fit->second;
+  } else {
+    pos = end_;
+  }
+  if (0 != fseek(fp_, pos, SEEK_SET) || !ws->spill(fp_)) {
+    return false;
+  }
+  written = ftell(fp_) - pos;
+  if (fit != free_.end()) {
+    // spill() writes at most getBytes() bytes.
+    assert(written <= len);
+    free_.erase(fit);
+  } else {
+    len = std::max(len, written);
+    end_ = pos + len;
+    maxEnd_ = std::max(maxEnd_, end_);
+  }
+  live_[pos] = len;
+  ws->setSpillPos(pos);
+  ++nSpills_;
+  return true;
+}
+
+
+void WarmStartSpill::writeStats(std::ostream &out) const
+{
+  out << me_ << "warm starts spilled   = " << nSpills_ << std::endl
+      << me_ << "warm starts reloaded  = " << nLoads_ << std::endl
+      << me_ << "warm starts dropped   = " << nDrops_ << std::endl
+      << me_ << "max memory used (MB)  = " << maxBytes_/1048576.0
+      << std::endl
+      << me_ << "memory freed (MB)     = " << spilledBytes_/1048576.0
+      << std::endl
+      << me_ << "spill file used (MB)  = " << maxEnd_/1048576.0
+      << std::endl;
+}
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
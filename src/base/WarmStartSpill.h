@@ -0,0 +1,178 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2008 - 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file WarmStartSpill.h
+ * \brief Declare class WarmStartSpill for keeping the memory used by
+ * warm-start information of active nodes within a limit.
+ * \author The MINOTAUR Team
+ */
+
+
+#ifndef MINOTAURWARMSTARTSPILL_H
+#define MINOTAURWARMSTARTSPILL_H
+
+#include <cstdio>
+#include <map>
+
+#include "Types.h"
+
+namespace Minotaur {
+
+  class ActiveNodeStore;
+  typedef ActiveNodeStore* ActiveNodeStorePtr;
+  class WarmStart;
+  typedef WarmStart* WarmStartPtr;
+
+  /**
+   * \brief Move warm-start information of active nodes to a file when it
+   * uses too much memory.
+   *
+   * Most of the memory used by a large branch-and-bound tree is in the
+   * warm-start information saved on active nodes. When the estimated memory
+   * used by warm starts of nodes in a store exceeds the limit, the
+   * warm starts of the nodes that would be selected last are written to a
+   * temporary binary file and freed, until the usage falls to 3/4th of the
+   * limit. The information of a node is read back just before the node is
+   * processed. The file is removed automatically when the object is
+   * destroyed or the program exits. Alternatively, the warm starts of the
+   * coldest nodes can be dropped, in which case those nodes are solved
+   * without warm start.
+   *
+   * Only warm starts whose size is known from WarmStart::getBytes() are
+   * counted and dropped, and only those that implement WarmStart::spill()
+   * are moved. The nodes themselves and their modifications always stay in
+   * memory.
+   *
+   * Each spilled warm start occupies a slot of getBytes() bytes in the
+   * file. The slot is freed when the warm start is read back, or, for warm
+   * starts of nodes that were pruned before being processed, at the next
+   * scan of the store. Free slots are reused, so the file does not grow
+   * beyond the largest amount of information spilled at any one time.
+   */
+  class WarmStartSpill {
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param[in] env The environment, used for logging.
+     * \param[in] limit The memory limit in bytes for warm-start information
+     * of active nodes.
+     * \param[in] drop If true, warm starts are deleted instead of being
+     * written to a file.
+     */
+    WarmStartSpill(EnvPtr env, double limit, bool drop);
+
+    /// Destroy. The file is closed and removed.
+    ~WarmStartSpill();
+
+    /**
+     * \brief Spill warm starts of the coldest nodes if the limit is
+     * exceeded.
+     *
+     * The store is scanned only after it has grown sufficiently since the
+     * last scan so that the cost of scanning is small.
+     * \param[in] store The active nodes.
+     * \param[in] shared If false, a warm start is spilled only if no other
+     * node uses it. Should be false when other threads may be reading warm
+     * starts of nodes taken from the store.
+     */
+    void check(ActiveNodeStorePtr store, bool shared);
+
+    /// Return the largest memory used by warm starts found in a scan.
+    double getMaxBytes() const { return maxBytes_; };
+
+    /// Return the number of warm starts read back from the file.
+    UInt getNumLoads() const { return nLoads_; };
+
+    /// Return the number of warm starts written to the file.
+    UInt getNumSpills() const { return nSpills_; };
+
+    /**
+     * \brief Read back the warm start of a node if it was spilled.
+     *
+     * \param[in] node The node that will be processed next. May be NULL.
+     * \return False if the information could not be read. The warm start
+     * then has no information and the engine starts cold.
+     */
+    bool load(NodePtr node);
+
+    /// Write statistics to the output stream.
+    void writeStats(std::ostream &out) const;
+
+  private:
+    /// True if warm starts are deleted instead of being spilled.
+    const bool drop_;
+
+    /// Position of the end of the last slot in the file.
+    long end_;
+
+    /// The file. NULL until something is spilled.
+    FILE *fp_;
+
+    /// Unused slots in the file, as (length, position) pairs.
+    std::multimap<long, long> free_;
+
+    /// Memory limit in bytes.
+    const double limit_;
+
+    /// Slots in the file that hold a spilled warm start, as (position,
+    /// length) pairs.
+    std::map<long, long> live_;
+
+    /// For logging errors.
+    LoggerPtr logger_;
+
+    /// Largest memory used by warm starts found in a scan.
+    double maxBytes_;
+
+    /// Largest size of the file.
+    long maxEnd_;
+
+    /// For logging.
+    static const std::string me_;
+
+    /// Number of nodes in the store at which it is scanned next.
+    UInt nextCheck_;
+
+    /// Number of warm starts removed from nodes in drop mode.
+    UInt nDrops_;
+
+    /// Number of warm starts read back.
+    UInt nLoads_;
+
+    /// Number of warm starts written out.
+    UInt nSpills_;
+
+    /// Total bytes of memory freed by spilling or dropping.
+    double spilledBytes_;
+
+    /// Free the slots of spilled warm starts that no node in the store uses.
+    void freeDead_(const NodePtrVector &nodes);
+
+    /// Free the slot at position pos of the file.
+    void freeSlot_(long pos);
+
+    /**
+     * Write a warm start to a free slot of the file that is large enough,
+     * or to a new slot at the end. Return true on success.
+     */
+    bool spill_(WarmStartPtr ws);
+  };
+  typedef WarmStartSpill* WarmStartSpillPtr;
+}
+#endif
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
@@ -0,0 +1,89 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2008 - 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file AllocCount.cpp
+ * \brief Replace the global operator new and delete to count allocations.
+ * \author The MINOTAUR Team
+ */
+
+#include <cstdlib>
+#include <new>
+
+#include "MinotaurConfig.h"
+#include "AllocCount.h"
+
+// Number of calls to operator new and new[] since the start.
+static unsigned long nAllocs = 0;
+
+void* operator new(std::size_t size)
+{
+  void *p;
+#if USE_OPENMP
+#pragma omp atomic
+#endif
+  ++nAllocs;
+  p = std::malloc(size ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+
+void* operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+
+void operator delete(void *p) throw()
+{
+  std::free(p);
+}
+
+
+void operator delete[](void *p) throw()
+{
+  std::free(p);
+}
+
+
+#if __cplusplus >= 201402L
+void operator delete(void *p, std::size_t) throw()
+{
+  std::free(p);
+}
+
+
+void operator delete[](void *p, std::size_t) throw()
+{
+  std::free(p);
+}
+#endif
+
+
+unsigned long getAllocs()
+{
+  unsigned long n;
+#if USE_OPENMP
+#pragma omp atomic read
+#endif
+  n = nAllocs;
+  return n;
+}
+
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
@@ -0,0 +1,35 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2008 - 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file AllocCount.h
+ * \brief Declare the counter of heap allocations used by the benchmarks.
+ * \author The MINOTAUR Team
+ */
+
+#ifndef MINOTAURALLOCCOUNT_H
+#define MINOTAURALLOCCOUNT_H
+
+/**
+ * Return the number of calls to the global operator new and new[] since the
+ * program started. The operators are replaced in AllocCount.cpp, which is
+ * kept separate so that the compiler does not see the replaced operators
+ * when inlining new and delete expressions.
+ */
+unsigned long getAllocs();
+
+#endif
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
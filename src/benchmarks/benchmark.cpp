@@ -0,0 +1,605 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2008 - 2017 The MINOTAUR Team.
+//
+
+/**
+ * \file benchmark.cpp
+ * \brief Time a fixed set of operations on hot paths and write the results
+ * in JSON.
+ * \author The MINOTAUR Team
+ *
+ * Every benchmark runs a fixed number of operations, repeated a few times.
+ * The median time per operation and the number of calls to operator new per
+ * operation are reported. The first problem is always a generated MINLP of a
+ * fixed size. If the AMPL interface is available, instances named on the
+ * command line (without the .nl extension) are benchmarked after it.
+ *
+ * Usage: benchmark [-r repeats] [instance ...]
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <sys/time.h>
+
+#include "MinotaurConfig.h"
+#include "AllocCount.h"
+#include "Branch.h"
+#include "CGraph.h"
+#include "Constraint.h"
+#include "Environment.h"
+#include "Function.h"
+#include "HessianOfLag.h"
+#include "Jacobian.h"
+#include "LinearFunction.h"
+#include "LinearHandler.h"
+#include "Node.h"
+#include "Objective.h"
+#include "Option.h"
+#include "PreMod.h"
+#include "Problem.h"
+#include "Relaxation.h"
+#include "TreeManager.h"
+#include "VarBoundMod.h"
+#include "Variable.h"
+
+#ifdef USE_MINOTAUR_AMPL_INTERFACE
+#include "AMPLInterface.h"
+#endif
+
+using namespace Minotaur;
+
+
+static double wallTime()
+{
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + 1e-6*tv.tv_usec;
+}
+
+
+/**
+ * A timed operation. run() is called iters_ times in one timed section.
+ * setUp() and tearDown() are called outside the timed sections, once
+ * around each section, or around each call of run() if perOp_ is true.
+ */
+class Bench {
+public:
+  Bench(std::string name, UInt iters, bool per_op)
+    : iters_(iters), name_(name), perOp_(per_op) {};
+  virtual ~Bench() {};
+  virtual void run() = 0;
+  virtual void setUp() {};
+  virtual void tearDown() {};
+
+  UInt iters_;
+  std::string name_;
+  bool perOp_;
+};
+
+
+/// Write the JSON record of one benchmark after timing it.
+static void timeBench(Bench *b, const std::string &prob, UInt reps,
+                      bool &first)
+{
+  std::vector<double> times;
+  unsigned long allocs = 0;
+  double t, t0;
+  unsigned long a0;
+
+  // one untimed section to warm up caches and lazily built structures.
+  b->setUp();
+  b->run();
+  b->tearDown();
+
+  for (UInt r=0; r<reps; ++r) {
+    t = 0.0;
+    allocs = 0;
+    if (b->perOp_) {
+      for (UInt i=0; i<b->iters_; ++i) {
+        b->setUp();
+        a0 = getAllocs();
+        t0 = wallTime();
+        b->run();
+        t += wallTime() - t0;
+        allocs += getAllocs() - a0;
+        b->tearDown();
+      }
+    } else {
+      b->setUp();
+      a0 = getAllocs();
+      t0 = wallTime();
+      for (UInt i=0; i<b->iters_; ++i) {
+        b->run();
+      }
+      t = wallTime() - t0;
+      allocs = getAllocs() - a0;
+      b->tearDown();
+    }
+    times.push_back(t);
+  }
+  std::sort(times.begin(), times.end());
+
+  std::printf("%s\n    {\"name\": \"%s\", \"problem\": \"%s\", "
+              "\"iters\": %u, \"ns_per_op\": %.1f, \"allocs_per_op\": %.2f}",
+              first ? "" : ",", b->name_.c_str(), prob.c_str(), b->iters_,
+              1e9*times[reps/2]/b->iters_, (double) allocs/b->iters_);
+  std::fflush(stdout);
+  first = false;
+}
+
+
+/// A deterministic generator so that the problem is the same everywhere.
+static UInt nextRand(UInt &seed)
+{
+  seed = seed*1103515245u + 12345u;
+  return (seed/65536) % 32768;
+}
+
+
+/// Generate a sparse MINLP with n variables.
+static ProblemPtr genProblem(EnvPtr env, UInt n)
+{
+  ProblemPtr p = new Problem(env);
+  std::vector<VariablePtr> x;
+  std::vector<CNode *> terms;
+  LinearFunctionPtr lf;
+  CGraphPtr cg;
+  CNode *n0, *n1;
+  UInt seed = 1;
+  UInt a, b, c;
+
+  for (UInt i=0; i<n; ++i) {
+    if (i < n/4) {
+      x.push_back(p->newVariable(0.0, 10.0, Integer));
+    } else {
+      x.push_back(p->newVariable(-5.0, 5.0, Continuous));
+    }
+  }
+
+  // objective: sum of (x_i - x_{i+1})^2 + exp(0.1 x_i).
+  cg = new CGraph();
+  for (UInt i=0; i+1<n; ++i) {
+    n0 = cg->newNode(OpMinus, cg->newNode(x[i]), cg->newNode(x[i+1]));
+    terms.push_back(cg->newNode(OpSqr, n0, 0));
+    n1 = cg->newNode(OpMult, cg->newNode(0.1), cg->newNode(x[i]));
+    terms.push_back(cg->newNode(OpExp, n1, 0));
+  }
+  cg->setOut(cg->newNode(OpSumList, &terms[0], terms.size()));
+  cg->finalize();
+  p->newObjective(new Function(cg), 0.0, Minimize);
+
+  // n/2 constraints: x_a*x_b + x_c^2 + cos(x_a) + linear terms <= rhs.
+  for (UInt i=0; i<n/2; ++i) {
+    a = nextRand(seed)%n;
+    b = nextRand(seed)%n;
+    c = nextRand(seed)%n;
+    cg = new CGraph();
+    terms.clear();
+    terms.push_back(cg->newNode(OpMult, cg->newNode(x[a]),
+                                cg->newNode(x[b])));
+    terms.push_back(cg->newNode(OpSqr, cg->newNode(x[c]), 0));
+    terms.push_back(cg->newNode(OpCos, cg->newNode(x[a]), 0));
+    cg->setOut(cg->newNode(OpSumList, &terms[0], terms.size()));
+    cg->finalize();
+    lf = new LinearFunction();
+    for (UInt j=0; j<4; ++j) {
+      lf->incTerm(x[nextRand(seed)%n], 1.0 + nextRand(seed)%5);
+    }
+    p->newConstraint(new Function(lf, cg), -INFINITY,
+                     50.0 + nextRand(seed)%50);
+  }
+
+  // n/2 knapsack rows on the integers, every tenth one duplicated.
+  for (UInt i=0; i<n/2; ++i) {
+    if (i%10 == 9) {
+      lf = p->getConstraint(p->getNumCons()-1)->getLinearFunction()->clone();
+    } else {
+      lf = new LinearFunction();
+      for (UInt j=0; j<6; ++j) {
+        lf->incTerm(x[nextRand(seed)%(n/4)], 1.0 + nextRand(seed)%9);
+      }
+    }
+    p->newConstraint(new Function(lf), -INFINITY, 20.0 + nextRand(seed)%40);
+  }
+  return p;
+}
+
+
+/// Return the CGraph with the largest number of nodes in the problem.
+static CGraphPtr getLargestCGraph(ProblemPtr p)
+{
+  CGraphPtr best = 0;
+  CGraphPtr cg;
+  FunctionPtr f;
+
+  for (ConstraintConstIterator it=p->consBegin(); it!=p->consEnd(); ++it) {
+    f = (*it)->getFunction();
+    cg = dynamic_cast <CGraph*> (f->getNonlinearFunction());
+    if (cg && (!best || cg->getNumNodes() > best->getNumNodes())) {
+      best = cg;
+    }
+  }
+  if (p->getObjective() && p->getObjective()->getFunction()) {
+    f = p->getObjective()->getFunction();
+    cg = dynamic_cast <CGraph*> (f->getNonlinearFunction());
+    if (cg && (!best || cg->getNumNodes() > best->getNumNodes())) {
+      best = cg;
+    }
+  }
+  return best;
+}
+
+
+/// Fill x with a point inside the bounds.
+static void getPoint(ProblemPtr p, std::vector<double> &x)
+{
+  VariablePtr v;
+  double lb, ub;
+
+  x.resize(p->getNumVars());
+  for (UInt i=0; i<p->getNumVars(); ++i) {
+    v = p->getVariable(i);
+    lb = std::max(v->getLb(), -10.0);
+    ub = std::min(v->getUb(), 10.0);
+    x[i] = (lb > ub) ? v->getLb() : lb + (ub-lb)*(i%7+1)/8.0;
+  }
+}
+
+
+class CGraphEvalBench : public Bench {
+public:
+  CGraphEvalBench(CGraphPtr cg, const double *x)
+    : Bench("cgraph_eval", 20000, false), cg_(cg), x_(x) {};
+  void run() { int err = 0; sum_ += cg_->eval(x_, &err); };
+  double sum_;
+private:
+  CGraphPtr cg_;
+  const double *x_;
+};
+
+
+class CGraphGradBench : public Bench {
+public:
+  CGraphGradBench(CGraphPtr cg, const double *x, UInt n)
+    : Bench("cgraph_gradient", 20000, false), cg_(cg), g_(n, 0.0), x_(x)
+  {};
+  void run() { int err = 0; cg_->evalGradient(x_, &g_[0], &err); };
+private:
+  CGraphPtr cg_;
+  std::vector<double> g_;
+  const double *x_;
+};
+
+
+/// Hessian of one CGraph, stored the same way as HessianOfLag does.
+class CGraphHessBench : public Bench {
+public:
+  CGraphHessBench(CGraphPtr cg, ProblemPtr p, const double *x);
+  ~CGraphHessBench();
+  void run();
+private:
+  CGraphPtr cg_;
+  LTHessStor stor_;
+  std::vector<double> vals_;
+  const double *x_;
+};
+
+
+CGraphHessBench::CGraphHessBench(CGraphPtr cg, ProblemPtr p, const double *x)
+  : Bench("cgraph_hessian", 500, false),
+    cg_(cg),
+    x_(x)
+{
+  VariableSet vars;
+  UInt i = 0;
+  UInt nz = 0;
+
+  cg_->getVars(&vars);
+  stor_.nlVars = 0;
+  for (VariableConstIterator it=p->varsBegin(); it!=p->varsEnd(); ++it) {
+    if (vars.find(*it) != vars.end()) {
+      ++stor_.nlVars;
+    }
+  }
+  stor_.rows = new VariablePtr[stor_.nlVars];
+  stor_.colQs = new std::deque<UInt>[stor_.nlVars];
+  stor_.starts = new UInt[stor_.nlVars+1];
+  for (VariableConstIterator it=p->varsBegin(); it!=p->varsEnd(); ++it) {
+    if (vars.find(*it) != vars.end()) {
+      stor_.rows[i++] = *it;
+    }
+  }
+  cg_->fillHessStor(&stor_);
+  for (i=0; i<stor_.nlVars; ++i) {
+    stor_.starts[i] = nz;
+    nz += stor_.colQs[i].size();
+  }
+  stor_.starts[i] = nz;
+  stor_.nz = nz;
+  stor_.cols = new UInt[nz];
+  nz = 0;
+  for (i=0; i<stor_.nlVars; ++i) {
+    for (std::deque<UInt>::iterator it=stor_.colQs[i].begin();
+         it!=stor_.colQs[i].end(); ++it, ++nz) {
+      stor_.cols[nz] = *it;
+    }
+  }
+  cg_->finalHessStor(&stor_);
+  delete [] stor_.colQs;
+  stor_.colQs = 0;
+  vals_.resize(nz+1, 0.0);
+}
+
+
+CGraphHessBench::~CGraphHessBench()
+{
+  delete [] stor_.rows;
+  delete [] stor_.starts;
+  delete [] stor_.cols;
+}
+
+
+void CGraphHessBench::run()
+{
+  int err = 0;
+  std::fill(vals_.begin(), vals_.end(), 0.0);
+  cg_->evalHessian(1.0, x_, &stor_, &vals_[0], &err);
+}
+
+
+class JacobianBench : public Bench {
+public:
+  JacobianBench(JacobianPtr jac, const double *x)
+    : Bench("jacobian_fill_values", 5000, false), jac_(jac),
+      vals_(jac->getNumNz()+1, 0.0), x_(x) {};
+  void run() { int err = 0; jac_->fillRowColValues(x_, &vals_[0], &err); };
+private:
+  JacobianPtr jac_;
+  std::vector<double> vals_;
+  const double *x_;
+};
+
+
+class HessianBench : public Bench {
+public:
+  HessianBench(HessianOfLagPtr hess, const double *x, UInt m)
+    : Bench("hessian_fill_values", 500, false), hess_(hess), mult_(m, 0.5),
+      vals_(hess->getNumNz()+1, 0.0), x_(x) {};
+  void run()
+  {
+    int err = 0;
+    hess_->fillRowColValues(x_, 1.0, mult_.size() ? &mult_[0] : 0,
+                            &vals_[0], &err);
+  };
+private:
+  HessianOfLagPtr hess_;
+  std::vector<double> mult_;
+  std::vector<double> vals_;
+  const double *x_;
+};
+
+
+/// Presolve a fresh copy of the problem in each operation.
+class PresolveBench : public Bench {
+public:
+  PresolveBench(EnvPtr env, ProblemPtr p)
+    : Bench("linear_handler_presolve", 20, true), env_(env), lh_(0), p_(p),
+      q_(0) {};
+  void setUp()
+  {
+    q_ = p_->clone(env_);
+    q_->calculateSize();
+    lh_ = new LinearHandler(env_, q_);
+    lh_->setPreOptPurgeVars(true);
+    lh_->setPreOptPurgeCons(true);
+    lh_->setPreOptCoeffImp(true);
+  };
+  void run() { bool changed = false; lh_->presolve(&mods_, &changed); };
+  void tearDown()
+  {
+    for (PreModQIter it=mods_.begin(); it!=mods_.end(); ++it) {
+      delete *it;
+    }
+    mods_.clear();
+    delete lh_;
+    delete q_;
+  };
+private:
+  EnvPtr env_;
+  LinearHandler *lh_;
+  PreModQ mods_;
+  ProblemPtr p_;
+  ProblemPtr q_;
+};
+
+
+/// Apply and undo the modifications of a node with 20 bound changes each
+/// in the problem and in its relaxation.
+class NodeModBench : public Bench {
+public:
+  NodeModBench(EnvPtr env, ProblemPtr p);
+  ~NodeModBench();
+  void run() { node_->applyMods(rel_, p_); node_->undoMods(rel_, p_); };
+private:
+  NodePtr node_;
+  ProblemPtr p_;
+  RelaxationPtr rel_;
+};
+
+
+NodeModBench::NodeModBench(EnvPtr env, ProblemPtr p)
+  : Bench("node_apply_undo_mods", 100000, false),
+    node_(0),
+    p_(p),
+    rel_(0)
+{
+  VariablePtr v;
+  UInt seed = 7;
+
+  rel_ = new Relaxation(p, env);
+  node_ = new Node();
+  for (UInt i=0; i<20; ++i) {
+    v = p_->getVariable(nextRand(seed)%p_->getNumVars());
+    node_->addPMod(new VarBoundMod(v, Upper, v->getUb()));
+    v = rel_->getVariable(nextRand(seed)%rel_->getNumVars());
+    node_->addRMod(new VarBoundMod(v, Lower, v->getLb()));
+  }
+}
+
+
+NodeModBench::~NodeModBench()
+{
+  delete node_;
+  delete rel_;
+}
+
+
+/// Take the best node and either branch on it or prune it. The tree is
+/// deep enough that it does not run out of nodes.
+class TreeBench : public Bench {
+public:
+  TreeBench(EnvPtr env, ProblemPtr p)
+    : Bench("tree_manager_push_pop", 20000, false), env_(env), p_(p),
+      seed_(11), tm_(0) {};
+  void setUp();
+  void run();
+  void tearDown() { delete tm_; tm_ = 0; };
+private:
+  EnvPtr env_;
+  ProblemPtr p_;
+  UInt seed_;
+  TreeManager *tm_;
+};
+
+
+void TreeBench::setUp()
+{
+  NodePtr root = new Node();
+
+  seed_ = 11;
+  tm_ = new TreeManager(env_);
+  root->setLb(0.0);
+  tm_->insertRoot(root);
+}
+
+
+void TreeBench::run()
+{
+  NodePtr node = tm_->getCandidate();
+  Branches branches;
+  BranchPtr br;
+  VariablePtr v;
+
+  if (!node) {
+    return;
+  }
+  tm_->removeActiveNode(node);
+  if (node->getDepth() < 16) {
+    node->setLb(node->getLb() + (nextRand(seed_)%100)/100.0);
+    branches = new BranchPtrVector();
+    v = p_->getVariable(nextRand(seed_)%p_->getNumVars());
+    br = new Branch();
+    br->addRMod(new VarBoundMod(v, Upper, v->getLb()));
+    branches->push_back(br);
+    br = new Branch();
+    br->addRMod(new VarBoundMod(v, Lower, v->getUb()));
+    branches->push_back(br);
+    tm_->branch(branches, node, 0);
+    delete branches;
+  } else {
+    tm_->pruneNode(node);
+  }
+}
+
+
+static void benchProblem(EnvPtr env, ProblemPtr p, const std::string &name,
+                         UInt reps, bool &first)
+{
+  std::vector<Bench *> benches;
+  std::vector<double> x;
+  CGraphPtr cg;
+
+  p->setNativeDer();
+  getPoint(p, x);
+  cg = getLargestCGraph(p);
+  if (cg) {
+    benches.push_back(new CGraphEvalBench(cg, &x[0]));
+    benches.push_back(new CGraphGradBench(cg, &x[0], p->getNumVars()));
+    benches.push_back(new CGraphHessBench(cg, p, &x[0]));
+  }
+  if (p->getJacobian()) {
+    benches.push_back(new JacobianBench(p->getJacobian(), &x[0]));
+  }
+  if (p->getHessian()) {
+    benches.push_back(new HessianBench(p->getHessian(), &x[0],
+                                       p->getNumCons()));
+  }
+  benches.push_back(new PresolveBench(env, p));
+  benches.push_back(new NodeModBench(env, p));
+  benches.push_back(new TreeBench(env, p));
+
+  for (UInt i=0; i<benches.size(); ++i) {
+    timeBench(benches[i], name, reps, first);
+    delete benches[i];
+  }
+}
+
+
+int main(int argc, char **argv)
+{
+  EnvPtr env = new Environment();
+  ProblemPtr p;
+  UInt reps = 5;
+  bool first = true;
+  int i = 1;
+
+  env->setLogLevel(LogNone);
+  env->getOptions()->findString("tree_search")->setValue("bfs");
+  env->getOptions()->findBool("use_native_cgraph")->setValue(true);
+  if (argc > 2 && 0 == std::strcmp(argv[1], "-r")) {
+    reps = std::max(1, std::atoi(argv[2]));
+    i = 3;
+  }
+
+  std::printf("{\n  \"benchmarks\": [");
+  p = genProblem(env, 400);
+  benchProblem(env, p, "generated", reps, first);
+  delete p;
+
+  for (; i<argc; ++i) {
+#ifdef USE_MINOTAUR_AMPL_INTERFACE
+    MINOTAUR_AMPL::AMPLInterface *iface;
+    iface = new MINOTAUR_AMPL::AMPLInterface(env, "benchmark");
+    p = iface->readInstance(argv[i]);
+    benchProblem(env, p, argv[i], reps, first);
+    delete p;
+    delete iface;
+#else
+    std::fprintf(stderr, "benchmark: AMPL interface is not available, "
+                 "skipping %s\n", argv[i]);
+#endif
+  }
+  std::printf("\n  ]\n}\n");
+
+  delete env;
+  return 0;
+}
+
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
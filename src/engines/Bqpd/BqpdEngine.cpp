@@ -17,6 +17,7 @@
 // #define SPEW 1
 
 #include <cmath>
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
 #include <string.h> // for memset
@@ -57,6 +58,7 @@ BqpdEngine::BqpdEngine(EnvPtr env)
     maxIterLimit_(1000),
     prevStrBr_(false),
     resolveError_(true),
+    rowsModed_(false),
     sol_(0),
     strBr_(false),
     timer_(0)
@@ -108,9 +110,91 @@ BqpdEngine::~BqpdEngine()
 }
 
 
-void BqpdEngine::addConstraint(ConstraintPtr)
+void BqpdEngine::addConstraint(ConstraintPtr c)
 {
-  consModed_ = true;
+  if (!fStart_ || true==consModed_ || chkPt_ ||
+      c->getIndex() > fStart_->m) {
+    consModed_ = true;
+    if (true==strBr_ && chkPt_) {
+      delete chkPt_;
+      chkPt_ = 0;
+    }
+  } else if (c->getIndex() == fStart_->m) {
+    // Problem may tell us more than once about the same constraint.
+    addRow_(c);
+    rowsModed_ = true;
+  }
+}
+
+
+void BqpdEngine::addConstraints(ConstraintConstIterator cbeg,
+                                ConstraintConstIterator cend)
+{
+  UInt rows = 0, nz = 0, used;
+  LinearFunctionPtr lf;
+
+  if (cbeg!=cend && fStart_ && false==consModed_ && !chkPt_ &&
+      (*cbeg)->getIndex() == fStart_->m) {
+    for (ConstraintConstIterator it=cbeg; it!=cend; ++it, ++rows) {
+      lf = (*it)->getLinearFunction();
+      nz += (lf) ? lf->getNumTerms() : 0;
+    }
+    used = fStart_->la[fStart_->maxa + 1 + fStart_->m + 1] - 1;
+    if (fStart_->m + rows > fStart_->mMax || used + nz > fStart_->maxa) {
+      grow_(std::max(fStart_->mMax + fStart_->mMax/2 + 16,
+                     fStart_->m + rows),
+            std::max(fStart_->maxa + fStart_->maxa/2, used + nz));
+    }
+  }
+  for (ConstraintConstIterator it=cbeg; it!=cend; ++it) {
+    addConstraint(*it);
+  }
+}
+
+
+void BqpdEngine::addRow_(ConstraintPtr c)
+{
+  LinearFunctionPtr lf = c->getLinearFunction();
+  UInt nz = (lf) ? lf->getNumTerms() : 0;
+  BqpdData *d = fStart_;
+  fint *ptr = d->la + d->maxa + 1;
+  UInt n = d->n;
+  UInt pos, i;
+  double l, u;
+
+  // ptr[0] is the start of the objective gradient, ptr[i+1] the start of
+  // row i and ptr[m+1] the first free position in a and la.
+  if (d->m == d->mMax || ptr[d->m+1] - 1 + nz > d->maxa) {
+    grow_(d->mMax + d->mMax/2 + 16,
+          std::max(d->maxa + d->maxa/2, (UInt) ptr[d->m+1] - 1 + nz));
+    d = fStart_;
+    ptr = d->la + d->maxa + 1;
+  }
+
+  pos = ptr[d->m+1];
+  if (lf) {
+    for (VariableGroupConstIterator it=lf->termsBegin(); it!=lf->termsEnd();
+         ++it, ++pos) {
+      d->a[pos-1] = it->second;
+      d->la[pos] = it->first->getIndex()+1;
+    }
+  }
+  ptr[d->m+2] = pos;
+
+  i = n + d->m;
+  l = std::max(-infty_, c->getLb());
+  u = std::min( infty_, c->getUb());
+  if (l>u && l<u+bTol_) {
+    u = l+bTol_;
+  }
+  d->bl[i] = l;
+  d->bu[i] = u;
+  d->r[i]  = 0.0;
+  d->w[i]  = 0.0;
+  d->e[i]  = 1.0;
+  // the new constraint is inactive: it goes to the end of ls.
+  d->ls[i] = i+1;
+  ++(d->m);
 }
 
 
@@ -142,22 +226,38 @@ void BqpdEngine::clear() {
   }
 }
 
+void BqpdEngine::grow_(UInt m_max, UInt maxa)
+{
+  BqpdData *d = fStart_->clone(m_max, maxa);
+  fint mxwk  = d->mxwk;
+  fint mxiwk = d->mxiwk;
+  fint kk0   = d->lws[0] + 1;        // same as in load_().
+  fint ll0   = d->lws[0] + 2 + d->n;
+
+  delete fStart_;
+  fStart_ = d;
+  setwsc(&mxwk, &mxiwk, &kk0, &ll0);
+  delete [] dualCons_;
+  dualCons_ = new double[m_max];
+}
+
+
 // kmax is the Maximum value of k. kmax = max(n - (Number of
 // constraints that are active)). set kmax= 0 iff LP. 
 void BqpdEngine::load_()
 {
   int n       = problem_->getNumVars();
   int m       = problem_->getNumCons();
-  int mlp     = 1000;      // Max level of degeneracy. 
   problem_->prepareForSolve(); // important before calling getNumJacNnzs.
-  int mxwk0   = 50000+10*(problem_->getNumJacNnzs()+n+m);
-  int mxiwk0  = 500000;    // Initial workspace
-  int lh1     = problem_->getNumHessNnzs() + 8 + 2*n + m;
+  UInt lin    = problem_->getSize()->linTerms;
+  // leave space for constraints that are added later.
+  UInt m_max  = m + m/4 + 16;
+  UInt maxa   = n + lin + lin/4 + 2*n;
+  int lh1     = problem_->getNumHessNnzs() + 8 + 2*n + m_max;
   int kmax    = 0;
   int mxwk    = 0;
   int mxiwk   = 0;
   int kk0, ll0;           // For setwsc routine.
-  UInt maxa   = n + problem_->getSize()->linTerms;
   logger_->msgStream(LogDebug1) << me_ << "Loaded problem." << std::endl;
 
   // set storage map for bqpd
@@ -178,18 +278,21 @@ void BqpdEngine::load_()
   } else {
     kmax    = 5000;
   }
-  mxwk    = 21*n + 8*m + mlp + lh1 + kmax*(kmax+9)/2 + mxwk0;
-  mxiwk   = 13*n + 4*m + mlp + lh1 + kmax + 113 + mxiwk0;
+  fStart_ = new BqpdData(n, m, m_max, kmax, maxa, lh1, maxa - n);
+  mxwk    = fStart_->mxwk;
+  mxiwk   = fStart_->mxiwk;
   setwsc(&mxwk, &mxiwk, &kk0, &ll0);
 
+  if (sol_) {
+    delete sol_;
+  }
   sol_ = (SolutionPtr) new Solution(INFINITY, 0, problem_);
   if (dualX_) {
     delete [] dualX_;
     delete [] dualCons_;
   }
   dualX_ = new double[n];
-  dualCons_ = new double[m];
-  fStart_ = new BqpdData(n, m, kmax, maxa, lh1, problem_->getNumJacNnzs());
+  dualCons_ = new double[m_max];
 
 #if SPEW
   logger_->msgStream(LogDebug2) << me_ << "maxa = " << maxa << std::endl;
@@ -197,8 +300,12 @@ void BqpdEngine::load_()
 }
 
 
-void BqpdEngine::removeCons(std::vector<ConstraintPtr> &)
+void BqpdEngine::removeCons(std::vector<ConstraintPtr> &delcons)
 {
+  if (fStart_ && false==consModed_ && !chkPt_ && removeRows_(delcons)) {
+    rowsModed_ = true;
+    return;
+  }
   consModed_ = true;
   if (true==strBr_ && chkPt_) {
     delete chkPt_;
@@ -207,10 +314,77 @@ void BqpdEngine::removeCons(std::vector<ConstraintPtr> &)
 }
 
 
+bool BqpdEngine::removeRows_(std::vector<ConstraintPtr> &delcons)
+{
+  BqpdData *d = fStart_;
+  fint *ptr = d->la + d->maxa + 1;
+  UInt n = d->n;
+  UInt m = d->m;
+  UInt nact = n - d->k;    // number of active constraints, first in ls.
+  UInt nact2 = 0;
+  UInt i, j, pos, start, end, cnt;
+  fint ind;
+  std::vector<int> newind(m, 0);
+
+  for (std::vector<ConstraintPtr>::iterator it=delcons.begin();
+       it!=delcons.end(); ++it) {
+    if ((*it)->getIndex() >= m) {
+      return false;
+    }
+    newind[(*it)->getIndex()] = -1;
+  }
+
+  // move the rows that are kept to the left. Bounds, residuals etc. of
+  // constraints are indexed by the constraint.
+  j = 0;
+  start = ptr[1];
+  pos = start;
+  for (i=0; i<m; ++i) {
+    end = ptr[i+2];
+    if (newind[i] >= 0) {
+      newind[i] = j;
+      for (UInt q=start; q<end; ++q, ++pos) {
+        d->a[pos-1] = d->a[q-1];
+        d->la[pos] = d->la[q];
+      }
+      ptr[j+2] = pos;
+      d->bl[n+j] = d->bl[n+i];
+      d->bu[n+j] = d->bu[n+i];
+      d->r[n+j]  = d->r[n+i];
+      d->w[n+j]  = d->w[n+i];
+      d->e[n+j]  = d->e[n+i];
+      ++j;
+    }
+    start = end;
+  }
+
+  // renumber the active and inactive sets. A removed constraint that was
+  // active increases the dimension of the null-space.
+  cnt = 0;
+  for (i=0; i<n+m; ++i) {
+    ind = abs(d->ls[i]);
+    if (ind > (fint) n) {
+      if (newind[ind-n-1] < 0) {
+        continue;
+      }
+      ind = n + newind[ind-n-1] + 1;
+    }
+    if (i < nact) {
+      ++nact2;
+    }
+    d->ls[cnt] = (d->ls[i] > 0) ? ind : -ind;
+    ++cnt;
+  }
+  d->m = j;
+  d->k = n - nact2;
+  return (d->k <= d->kmax);
+}
+
+
 void BqpdEngine::setGradient_()
 {
   UInt n = problem_->getNumVars();
-  UInt maxa = n + problem_->getSize()->linTerms;
+  UInt maxa = fStart_->maxa;
   UInt cnt = 1, ptr_pos = maxa+1;
   UInt m = problem_->getNumCons();
   double *values;       // gradient values.
@@ -223,7 +397,7 @@ void BqpdEngine::setGradient_()
   ObjectivePtr oPtr = problem_->getObjective();
   assert(oPtr);
   LinearFunctionPtr lf;
-  memset(la, 0, (maxa+m+3)*sizeof(fint));
+  memset(la, 0, (maxa+fStart_->mMax+3)*sizeof(fint));
   la[0] = maxa+1;
   la[ptr_pos] = 1;
   ++ptr_pos;
@@ -264,7 +438,7 @@ void BqpdEngine::setGradient_()
   }
   delete [] values;
   delete [] x;
-  assert(cnt==maxa+1);
+  assert(cnt<=maxa+1);
   assert(ptr_pos==maxa+m+3);
 }
 
@@ -382,6 +556,11 @@ EngineStatus BqpdEngine::solve()
     setConsBounds_();
   } else if (chkPt_) {
     mode = wsMode_;
+  } else if (true == rowsModed_) {
+    // bqpd takes the active set from ls but factorizes again.
+    mode = std::min(wsMode_, 2);
+    delete sol_;
+    sol_ = (SolutionPtr) new Solution(INFINITY, 0, problem_);
   } else if (false == bndRelaxed_ && bndChanges_ < 3) {
     mode = wsMode_;
   } else if (wsMode_ > 2) {
@@ -390,6 +569,7 @@ EngineStatus BqpdEngine::solve()
     mode = wsMode_;
   }
   consModed_ = false;
+  rowsModed_ = false;
   bndRelaxed_ = false;
   bndChanges_ = 0;
 
@@ -668,9 +848,31 @@ EngineStatus BqpdEngine::getStatus()
 }
   
 
-void BqpdEngine::changeBound(ConstraintPtr, BoundType, double)
+void BqpdEngine::changeBound(ConstraintPtr cons, BoundType lu,
+                             double new_val)
 {
-  consModed_ = true;
+  double *bl, *bu;
+
+  // with a checkpoint, bounds of constraints would be restored after solve.
+  if (!fStart_ || true==consModed_ || chkPt_ ||
+      cons->getIndex() >= fStart_->m) {
+    consModed_ = true;
+    return;
+  }
+  bl = fStart_->bl + fStart_->n + cons->getIndex();
+  bu = fStart_->bu + fStart_->n + cons->getIndex();
+  if ((lu == Lower && new_val < *bl) || (lu == Upper && new_val > *bu)) {
+    bndRelaxed_ = true;
+  }
+  if (lu == Lower) {
+    *bl = std::max(-infty_, new_val);
+  } else {
+    *bu = std::min(infty_, new_val);
+  }
+  if (*bl>*bu && *bl<*bu+bTol_) {
+    *bu = *bl+bTol_;
+  }
+  ++bndChanges_;
 }
 
 
@@ -815,23 +1017,26 @@ std::string BqpdEngine::getName() const
 // ----------------------------------------------------------------------- //
 // End of BqpdEngine Class.
 // ----------------------------------------------------------------------- //
-BqpdData::BqpdData(UInt n_t, UInt m_t, int kmax_t, UInt maxa_t, UInt lh1_t, 
-                   UInt nJac_t, bool zero)
+BqpdData::BqpdData(UInt n_t, UInt m_t, UInt m_max, int kmax_t, UInt maxa_t,
+                   UInt lh1_t, UInt nJac_t, bool zero)
  : n(n_t),
    m(m_t),
+   mMax(m_max),
    kmax(kmax_t),
    lh1(lh1_t),
    nJac(nJac_t),
    maxa(maxa_t),
+   mxwk(0),
+   mxiwk(0),
    peq(0),
    k(0)
 {
-  UInt nm     = n+m;
+  UInt nm     = n+mMax;
   UInt mlp    = 1000;      // Max level of degeneracy. 
-  UInt mxwk0  = 50000+10*(nJac+n+m);
+  UInt mxwk0  = 50000+10*(nJac+n+mMax);
   UInt mxiwk0 = 500000;    // Initial workspace
-  UInt mxwk   = 21*n + 8*m + mlp + lh1 + kmax*(kmax+9)/2 + mxwk0;
-  UInt mxiwk  = 13*n + 4*m + mlp + lh1 + kmax + 113 + mxiwk0;
+  mxwk        = 21*n + 8*mMax + mlp + lh1 + kmax*(kmax+9)/2 + mxwk0;
+  mxiwk       = 13*n + 4*mMax + mlp + lh1 + kmax + 113 + mxiwk0;
   //std::cout << "mxwk2 = " << mxwk << std::endl;
 
 
@@ -853,7 +1058,7 @@ BqpdData::BqpdData(UInt n_t, UInt m_t, int kmax_t, UInt maxa_t, UInt lh1_t,
 
   // storage for gradient and jacobian
   a     = new real[maxa+1];    // linear part of objective & Jacobian
-  la    = new fint[maxa+m+3];
+  la    = new fint[maxa+mMax+3];
 
   if (true==zero) {
     memset(info, 0, 100 * sizeof(int));
@@ -865,15 +1070,19 @@ BqpdData::BqpdData(UInt n_t, UInt m_t, int kmax_t, UInt maxa_t, UInt lh1_t,
 
 BqpdData* BqpdData::clone()
 {
-  BqpdData* lhs = new BqpdData(n, m, kmax, maxa, lh1, nJac, false);
+  return clone(mMax, maxa);
+}
+
+
+BqpdData* BqpdData::clone(UInt m_max, UInt maxa_t)
+{
+  bool same = (m_max==mMax && maxa_t==maxa);
+  BqpdData* lhs = new BqpdData(n, m, m_max, kmax, maxa_t, lh1+m_max-mMax,
+                               nJac+maxa_t-maxa, !same);
   UInt nm = n+m;
   UInt mlp    = 1000;      // Max level of degeneracy. 
-  UInt mxwk0  = 50000+10*(nJac+n+m);
-  UInt mxiwk0 = 500000;    // Initial workspace
-  UInt mxwk   = 21*n + 8*m + mlp + lh1 + kmax*(kmax+9)/2 + mxwk0;
-  UInt mxiwk  = 13*n + 4*m + mlp + lh1 + kmax + 113 + mxiwk0;
-  //std::cout << "mxwk1 = " << mxwk << std::endl;
 
+  assert(m_max>=mMax && maxa_t>=maxa);
   lhs->peq = peq;
   lhs->k   = k;
 
@@ -894,7 +1103,10 @@ BqpdData* BqpdData::clone()
   memcpy(lhs->ws, ws, mxwk*sizeof(real));
   memcpy(lhs->lws, lws, mxiwk*sizeof(fint));
   std::copy(a,    a    +  maxa+1,   lhs->a);
-  std::copy(la,   la   +  maxa+m+3, lhs->la);
+  // entries of la, then its pointers, which start at la[maxa+1].
+  std::copy(la,   la   +  maxa+1,   lhs->la);
+  std::copy(la+maxa+1, la+maxa+m+3, lhs->la+maxa_t+1);
+  lhs->la[0] = maxa_t+1;
 
   return lhs;
 }
@@ -902,16 +1114,15 @@ BqpdData* BqpdData::clone()
 
 void BqpdData::copyFrom(const BqpdData* rhs)
 {
-  UInt nm = n+m;
+  UInt nm;
   UInt mlp    = 1000;      // Max level of degeneracy. 
-  UInt mxwk0  = 50000+10*(nJac+n+m);
-  UInt mxiwk0 = 500000;    // Initial workspace
-  UInt mxwk   = 21*n + 8*m + mlp + lh1 + kmax*(kmax+9)/2 + mxwk0;
-  UInt mxiwk  = 13*n + 4*m + mlp + lh1 + kmax + 113 + mxiwk0;
   //std::cout << "mxwk4 = " << mxwk << std::endl;
 
   assert(kmax==rhs->kmax);
+  assert(mMax==rhs->mMax && maxa==rhs->maxa);
 
+  m   = rhs->m;
+  nm  = n+m;
   peq = rhs->peq;
   k   = rhs->k;
 
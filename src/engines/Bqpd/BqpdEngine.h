@@ -60,8 +60,22 @@ namespace Minotaur {
     /// Destroy.
     ~BqpdEngine();
 
-    // Implement Engine::addConstraint() */
-    void addConstraint(ConstraintPtr);
+    /**
+     * \brief Implement Engine::addConstraint().
+     *
+     * The linear part of the constraint is appended to the loaded data and
+     * the active set of the last solve is kept for the next one. The
+     * problem is reloaded only when bqpd has not been called yet or when a
+     * strong-branching checkpoint exists.
+     */
+    void addConstraint(ConstraintPtr c);
+
+    /**
+     * \brief Append a block of constraints like addConstraint(). The arrays
+     * are enlarged at most once for the whole block.
+     */
+    void addConstraints(ConstraintConstIterator cbeg,
+                        ConstraintConstIterator cend);
 
     // Change bound on a constraint.
     void changeBound(ConstraintPtr cons, BoundType lu, double new_val);
@@ -121,7 +135,10 @@ namespace Minotaur {
     // Convert 'min f' to 'min -f'.
     void negateObj();
 
-    // delete constraints.
+    /**
+     * \brief Delete constraints. The rows are removed from the loaded data
+     * in place, like in addConstraint().
+     */
     void removeCons(std::vector<ConstraintPtr> &delcons);
 
     // Implement Engine::resetIterationLimit().
@@ -154,7 +171,11 @@ namespace Minotaur {
     /// Checkpoint copy of fStart_.
     BqpdData *chkPt_;
 
-    /// If a constraint is modified, this is set to true. 
+    /**
+     * If a constraint or the objective is modified, this is set to true and
+     * the problem is reloaded from scratch in the next solve. Constraints
+     * that are added or removed do not set it.
+     */
     bool consModed_;
 
     /// Array to calculate dual solution for constraints.
@@ -196,6 +217,12 @@ namespace Minotaur {
      */
     bool resolveError_;
 
+    /**
+     * True if constraints were added to or removed from fStart_ since the
+     * last solve.
+     */
+    bool rowsModed_;
+
     /// Solution found by the engine. 
     SolutionPtr sol_;
 
@@ -211,12 +238,28 @@ namespace Minotaur {
     /// Mode used for warm starting: 1-6
     int wsMode_;
 
+    /// Append the linear part of a constraint to fStart_.
+    void addRow_(ConstraintPtr c);
+
     /// Free the memory allocated
     void freeProb_();
 
+    /**
+     * Move fStart_ to larger arrays that have space for m_max constraints
+     * and maxa nonzeros in the gradient and Jacobian.
+     */
+    void grow_(UInt m_max, UInt maxa);
+
     /// Allocate the data structures for Bqpd.
     void load_();
 
+    /**
+     * Remove the given constraints from fStart_ and renumber the active
+     * set. Returns false if the remaining active set can not be used by
+     * bqpd, in which case the problem must be reloaded.
+     */
+    bool removeRows_(std::vector<ConstraintPtr> &delcons);
+
     /// Copy constraint bounds from the problem.
     void setConsBounds_();
 
@@ -247,9 +290,14 @@ namespace Minotaur {
   /// Information for restarting from the previous optimal solution.
   class BqpdData {
   public: 
-    /// Constructor.
-    BqpdData(UInt n_t, UInt m_t, int kmax_t, UInt maxa_t, UInt lh1_t,
-             UInt nJac, bool zero=true);
+    /**
+     * \brief Constructor.
+     *
+     * Space is allocated for m_max constraints and maxa_t nonzeros in the
+     * gradient and Jacobian, of which m_t and the first few are used.
+     */
+    BqpdData(UInt n_t, UInt m_t, UInt m_max, int kmax_t, UInt maxa_t,
+             UInt lh1_t, UInt nJac, bool zero=true);
 
     /// Destroy.
     ~BqpdData();
@@ -257,6 +305,12 @@ namespace Minotaur {
     /// Allocate space and copy.
     BqpdData *clone();
 
+    /**
+     * Allocate space for m_max constraints and maxa_t nonzeros, which must
+     * not be smaller than the current space, and copy.
+     */
+    BqpdData *clone(UInt m_max, UInt maxa_t);
+
     /// Only copy. No space allocation.
     void copyFrom(const BqpdData* rhs);
 
@@ -269,6 +323,9 @@ namespace Minotaur {
     /// Number of constraints.
     UInt m;
 
+    /// Number of constraints for which space is allocated.
+    UInt mMax;
+
     /// kmax given to bqpd
     int kmax;
 
@@ -278,9 +335,15 @@ namespace Minotaur {
     /// Number of nonzeros in Jacobian.
     UInt nJac;
 
-    /// Size of a
+    /// Size of a. The pointers of la start at la[maxa+1].
     UInt maxa;
 
+    /// Size of ws.
+    UInt mxwk;
+
+    /// Size of lws.
+    UInt mxiwk;
+
     /// Initial point for solving QP.
     double *x;
 
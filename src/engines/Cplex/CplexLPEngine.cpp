@@ -197,6 +197,52 @@ void CplexLPEngine::addConstraint(ConstraintPtr con)
 }
 
 
+void CplexLPEngine::addConstraints(ConstraintConstIterator cbeg,
+                                   ConstraintConstIterator cend)
+{
+  std::vector<CPXNNZ> start;
+  std::vector<CPXDIM> cols;
+  std::vector<double> elems, conrhs;
+  std::vector<char*> conname;
+  std::vector<char> sense;
+  LinearFunctionPtr lf;
+  VariableGroupConstIterator it;
+  CPXNNZ nnz;
+
+  if (cbeg==cend) {
+    return;
+  }
+  for (ConstraintConstIterator cit=cbeg; cit!=cend; ++cit) {
+    start.push_back(cols.size());
+    lf = (*cit)->getLinearFunction();
+    for (it = lf->termsBegin(); it != lf->termsEnd(); ++it) {
+      cols.push_back(it->first->getIndex());
+      elems.push_back(it->second);
+    }
+    // same as addConstraint: rows are added as <= ub.
+    conrhs.push_back((*cit)->getUb());
+    sense.push_back('L');
+    conname.push_back(new char[(*cit)->getName().length() + 1]);
+    strcpy(conname.back(), (*cit)->getName().c_str());
+  }
+  nnz = cols.size();
+  // cols and elems are not empty even if all rows are.
+  cols.push_back(0);
+  elems.push_back(0.0);
+
+  cpxstatus_ = CPXXaddrows (cpxenv_, cpxlp_, 0, conrhs.size(), nnz,
+                            &conrhs[0], &sense[0], &start[0], &cols[0],
+                            &elems[0], NULL, &conname[0]);
+  if (cpxstatus_) {
+    assert(!"unable to add constraints!");
+  }
+  for (UInt i=0; i<conname.size(); ++i) {
+    delete [] conname[i];
+  }
+  consChanged_ = true;
+}
+
+
 void CplexLPEngine::changeBound(ConstraintPtr, BoundType, double)
 {
   assert(!"implement me!");
@@ -135,6 +135,10 @@ namespace Minotaur {
     // Implement Engine::addConstraint().
     void addConstraint(ConstraintPtr);
 
+    /// Add all new rows to cplex in one call to CPXXaddrows.
+    void addConstraints(ConstraintConstIterator cbeg,
+                        ConstraintConstIterator cend);
+
     // Change bounds on a constraint.
     void changeBound(ConstraintPtr cons, BoundType lu, double new_val);
 
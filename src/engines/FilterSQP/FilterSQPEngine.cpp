@@ -162,6 +162,19 @@ FilterSQPWarmStart::FilterSQPWarmStart(ConstFilterWSPtr warmSt)
 }
  
 
+bool FilterSQPWarmStart::equals(ConstWarmStartPtr ws) const
+{
+  ConstFilterWSPtr ws2 = dynamic_cast<const FilterSQPWarmStart*> (ws);
+  return (ws2 && sol_ && sol_->hasSameValues(ws2->sol_));
+}
+
+
+size_t FilterSQPWarmStart::getBytes() const
+{
+  return (sol_) ? sizeof(FilterSQPWarmStart)+sol_->getBytes() : 0;
+}
+
+
 SolutionPtr FilterSQPWarmStart::getPoint()
 {
   return sol_;
@@ -183,6 +196,18 @@ void FilterSQPWarmStart::setPoint(SolutionPtr sol)
 }
 
 
+bool FilterSQPWarmStart::spill(FILE *fp)
+{
+  return (sol_ && sol_->spill(fp));
+}
+
+
+bool FilterSQPWarmStart::unspill(FILE *fp)
+{
+  return (sol_ && sol_->unspill(fp));
+}
+
+
 void FilterSQPWarmStart::write(std::ostream &out) const
 {
   out << "FilterSQP warm start information:"  << std::endl;
@@ -205,8 +230,13 @@ FilterSQPEngine::FilterSQPEngine(EnvPtr env)
   lam_(0),
   lws_(0),
   lws2_(0),
+  lwsCap_(0),
+  maxaCap_(0),
   maxIterLimit_(1000),
+  mCap_(0),
   mlam_(0),
+  mxwkCap_(0),
+  rowsChanged_(false),
   rstat_(0),
   s_(0),
   saveSol_(true),
@@ -269,14 +299,23 @@ FilterSQPEngine::~FilterSQPEngine()
 
 void FilterSQPEngine::addConstraint(ConstraintPtr)
 {
-  consChanged_ = true;
+  rowsChanged_ = true;
+}
+
+
+void FilterSQPEngine::addConstraints(ConstraintConstIterator,
+                                     ConstraintConstIterator)
+{
+  rowsChanged_ = true;
 }
 
 
 void FilterSQPEngine::changeBound(ConstraintPtr cons, BoundType lu, 
                                   double new_val)
 {
-  if (bl_) {
+  // after rows change, all bounds are copied from the problem in the next
+  // solve and the indices may not match the arrays yet.
+  if (bl_ && false==rowsChanged_) {
     if (Lower == lu) {
       bl_[problem_->getNumVars()+cons->getIndex()] = new_val;
     } else {
@@ -348,6 +387,7 @@ void FilterSQPEngine::clear()
   }
   strBr_       = false;
   consChanged_ = true;
+  rowsChanged_ = false;
 }
 
 
@@ -620,7 +660,7 @@ void FilterSQPEngine::negateObj()
 
 void FilterSQPEngine::removeCons(std::vector<ConstraintPtr> &)
 {
-  consChanged_ = true;
+  rowsChanged_ = true;
 }
 
 
@@ -671,8 +711,10 @@ void FilterSQPEngine::setStorage_(int mxwk, int maxa)
 {
   UInt n = problem_->getNumVars();
   UInt m = problem_->getNumCons();
+  UInt lws_size = n+problem_->getHessian()->getNumNz()+3;
   UInt cnt;
   FunctionType ftype;
+  SolutionPtr sol;
 
   if (consChanged_) {
     if (sol_) {
@@ -690,31 +732,50 @@ void FilterSQPEngine::setStorage_(int mxwk, int maxa)
       freeStorage_();
       c_ = 0;
     }
+  } else if (rowsChanged_) {
+    // only the number of duals changes. Keep the primal point so that the
+    // next solve starts from the last solution.
+    sol = (SolutionPtr) new Solution(1E20, sol_->getPrimal(), problem_);
+    if (warmSt_ && warmSt_->getPoint()==sol_) {
+      warmSt_->setPoint(sol);
+    }
+    delete sol_;
+    sol_ = sol;
+    if (c_ && (m > mCap_ || (UInt) maxa > maxaCap_ || lws_size > lwsCap_ ||
+               mxwk > mxwkCap_)) {
+      freeStorage_();
+      c_ = 0;
+    }
   }
   if (!c_) {
-    c_     = new real[m];     // values of the constraint functions.
-    ws_    = new real[mxwk];  // workspace.
-    lws2_  = new fint[mxwk];  // workspace.
-    s_     = new real[n+m];   // scale.
-    x_     = new real[n];     // primal solution.
-    lam_   = new real[n+m];   // lagrange mults.
-    mlam_  = new real[m];   // lagrange mults.
-    a_     = new real[maxa];
-    rstat_ = new real[7];     // statistics.
-    istat_ = new fint[14];    // statistics.
-    bl_    = new real[n+m]; // lower bounds for variables and constraints.
-    bu_    = new real[n+m]; // upper bounds for variables and constraints.
-    cstype_= new char[m];   // is constraint ('L')linear or ('N')nonlinear
-    lws_   = new fint[n+problem_->getHessian()->getNumNz()+3];
-    la_    = new int[n + problem_->getJacobian()->getNumNz() + m + 3];
-    std::fill(c_, c_+m, 0.);
-    std::fill(ws_, ws_+mxwk, 0.);
-    std::fill(lws2_, lws2_+mxwk, 0);
-    std::fill(lam_, lam_+n+m, 0.);
-    std::fill(a_, a_+maxa, 0.);
+    // leave room for some cuts so that adding them does not reallocate.
+    mCap_    = m + m/4 + 16;
+    maxaCap_ = maxa + maxa/4 + 16;
+    lwsCap_  = lws_size;
+    mxwkCap_ = mxwk + 9*(mCap_-m);
+    c_     = new real[mCap_];     // values of the constraint functions.
+    ws_    = new real[mxwkCap_];  // workspace.
+    lws2_  = new fint[mxwkCap_];  // workspace.
+    s_     = new real[n+mCap_];   // scale.
+    x_     = new real[n];         // primal solution.
+    lam_   = new real[n+mCap_];   // lagrange mults.
+    mlam_  = new real[mCap_];     // lagrange mults.
+    a_     = new real[maxaCap_];
+    rstat_ = new real[7];         // statistics.
+    istat_ = new fint[14];        // statistics.
+    bl_    = new real[n+mCap_]; // lower bounds for variables and constraints.
+    bu_    = new real[n+mCap_]; // upper bounds for variables and constraints.
+    cstype_= new char[mCap_];   // is constraint ('L')linear or ('N')nonlinear
+    lws_   = new fint[lwsCap_];
+    la_    = new int[maxaCap_ + mCap_ + 3];
+    std::fill(c_, c_+mCap_, 0.);
+    std::fill(ws_, ws_+mxwkCap_, 0.);
+    std::fill(lws2_, lws2_+mxwkCap_, 0);
+    std::fill(lam_, lam_+n+mCap_, 0.);
+    std::fill(a_, a_+maxaCap_, 0.);
   }
 
-  if (consChanged_) {
+  if (consChanged_ || rowsChanged_) {
     for (UInt i=0; i<n+m; ++i) {
       s_[i] = 1.;
     }
@@ -870,7 +931,7 @@ void FilterSQPEngine::setStructure_()
 EngineStatus FilterSQPEngine::solve()
 {
 
-  if (consChanged_==true) {
+  if (consChanged_==true || rowsChanged_==true) {
     problem_->prepareForSolve();
   }
  
@@ -906,18 +967,14 @@ EngineStatus FilterSQPEngine::solve()
   const double *initial_point = 0;
 
   setStorage_(mxwk, maxa);
-  setStructure_();
+  if (consChanged_==true || rowsChanged_==true) {
+    // sparsity of the Jacobian and Hessian is the same otherwise.
+    setStructure_();
+  }
 
   if (useWs_ && warmSt_ && warmSt_->hasInfo()) {
-    // load warm start.
-    initial_point = warmSt_->getPoint()->getDualOfVars();
-    if (initial_point) {
-      std::copy(initial_point, initial_point+n, lam_);
-    }
-    initial_point = warmSt_->getPoint()->getDualOfCons();
-    if (initial_point) {
-      std::copy(initial_point, initial_point+m, lam_+n);
-    }
+    // load warm start. Only the primal point is used, the multipliers
+    // are computed again by filter.
     initial_point = warmSt_->getPoint()->getPrimal();
     if (initial_point) {
       std::copy(initial_point, initial_point + n, x_);
@@ -941,7 +998,7 @@ EngineStatus FilterSQPEngine::solve()
   }
 
   // reload bounds if necessary
-  if (true==consChanged_) {
+  if (true==consChanged_ || true==rowsChanged_) {
     setBounds_();
   }
 
@@ -970,6 +1027,7 @@ EngineStatus FilterSQPEngine::solve()
 	       bu_, s_, a_, la_, ws_, lws2_, lam_, cstype_, &user, iuser,
 	       &iterLimit_, istat_, rstat_, cstype_len);
   consChanged_ = false;
+  rowsChanged_ = false;
 
 #if SPEW
   logger_->msgStream(LogDebug) << me_ << "fail = " << ifail << std::endl;
@@ -50,6 +50,12 @@ namespace Minotaur {
     /// Destroy
     ~FilterSQPWarmStart();
 
+    // Implement WarmStart::equals().
+    bool equals(ConstWarmStartPtr ws) const;
+
+    // Implement WarmStart::getBytes().
+    size_t getBytes() const;
+
     /// Get solution.
     SolutionPtr getPoint();
 
@@ -64,6 +70,12 @@ namespace Minotaur {
      */
     void setPoint(SolutionPtr sol);
 
+    // Implement WarmStart::spill().
+    bool spill(FILE *fp);
+
+    // Implement WarmStart::unspill().
+    bool unspill(FILE *fp);
+
     // Implement WarmStart::write().
     void write(std::ostream &out) const;
 
@@ -91,6 +103,10 @@ namespace Minotaur {
     // Base class method
     void addConstraint(ConstraintPtr c);
 
+    // Base class method. The arrays are refilled once for the whole block.
+    void addConstraints(ConstraintConstIterator cbeg,
+                        ConstraintConstIterator cend);
+
     // Change bound on a constraint.
     void changeBound(ConstraintPtr cons, BoundType lu, double new_val);
 
@@ -207,8 +223,8 @@ namespace Minotaur {
     double *c_;
 
     /**
-     * If true, reallocate space in the next solve. Important, if
-     * constraints or objectives have changed.
+     * If true, reallocate space and discard the warm start in the next
+     * solve. Important, if constraints or objectives have changed.
      */
     bool consChanged_;
 
@@ -257,15 +273,28 @@ namespace Minotaur {
     /// Copy of lws_;
     int *lws2_;
 
+    /// Number of entries allocated in lws_.
+    UInt lwsCap_;
+
+    /// Number of entries allocated in a_. la_ has room for these and mCap_+3
+    /// pointers.
+    UInt maxaCap_;
+
     /// Max value of iterLimit_, when solving a relaxation
     const int maxIterLimit_;
 
+    /// Number of constraints for which row arrays (c_, bl_ etc.) have room.
+    UInt mCap_;
+
     /// String name used in log messages.
     static const std::string me_;
 
     /// Need to multiply lagrange multipliers by -1 in callback. Storage.
     double *mlam_;
 
+    /// Size of the workspaces ws_ and lws2_.
+    int mxwkCap_;
+
     /**
      * True if we want to save warm start information of the current
      * solution for the next solve. False, if no information needs to be
@@ -277,6 +306,13 @@ namespace Minotaur {
     /// Problem that is loaded, if any.
     ProblemPtr problem_;
 
+    /**
+     * True if constraints were added or removed since the last solve. The
+     * arrays are then refilled in place, and reallocated only if they are
+     * too small. The primal point of the warm start is kept.
+     */
+    bool rowsChanged_;
+
     /// Statistics.
     double *rstat_; 
 
@@ -120,6 +120,26 @@ IpoptSolution::~IpoptSolution()
 }
 
 
+size_t IpoptSolution::getBytes() const
+{
+  size_t bytes = Solution::getBytes() + sizeof(IpoptSolution)
+                 - sizeof(Solution);
+  if (dualXLow_) {
+    bytes += 2*n_*sizeof(double);
+  }
+  return bytes;
+}
+
+
+bool IpoptSolution::hasSameValues(ConstSolutionPtr sol) const
+{
+  ConstIpoptSolPtr sol2 = dynamic_cast<const IpoptSolution*> (sol);
+  return (sol2 && Solution::hasSameValues(sol2) &&
+          sameArr_(dualXLow_, sol2->dualXLow_, n_) &&
+          sameArr_(dualXUp_, sol2->dualXUp_, n_));
+}
+
+
 void IpoptSolution::setDualOfVars(const double *lower, const double *upper)
 {
   if (lower && upper) {
@@ -143,6 +163,27 @@ void IpoptSolution::setDualOfVars(const double *lower, const double *upper)
 }
 
 
+bool IpoptSolution::spill(FILE *fp)
+{
+  // write our own arrays first so that nothing is freed if any write fails.
+  if (!writeArr_(fp, dualXLow_, n_) || !writeArr_(fp, dualXUp_, n_) ||
+      !Solution::spill(fp)) {
+    return false;
+  }
+  delete [] dualXLow_;
+  delete [] dualXUp_;
+  dualXLow_ = dualXUp_ = 0;
+  return true;
+}
+
+
+bool IpoptSolution::unspill(FILE *fp)
+{
+  return (readArr_(fp, dualXLow_, n_) && readArr_(fp, dualXUp_, n_) &&
+          Solution::unspill(fp));
+}
+
+
 void IpoptSolution::write(std::ostream &out) const
 {
   const double *d;
@@ -208,6 +249,19 @@ IpoptWarmStart::~IpoptWarmStart()
 }
 
 
+bool IpoptWarmStart::equals(ConstWarmStartPtr ws) const
+{
+  ConstIpoptWarmStartPtr ws2 = dynamic_cast<const IpoptWarmStart*> (ws);
+  return (ws2 && sol_ && sol_->hasSameValues(ws2->sol_));
+}
+
+
+size_t IpoptWarmStart::getBytes() const
+{
+  return (sol_) ? sizeof(IpoptWarmStart)+sol_->getBytes() : 0;
+}
+
+
 IpoptSolPtr IpoptWarmStart::getPoint()
 {
   return sol_;
@@ -231,6 +285,18 @@ void IpoptWarmStart::setPoint(IpoptSolPtr sol)
 }
 
 
+bool IpoptWarmStart::spill(FILE *fp)
+{
+  return (sol_ && sol_->spill(fp));
+}
+
+
+bool IpoptWarmStart::unspill(FILE *fp)
+{
+  return (sol_ && sol_->unspill(fp));
+}
+
+
 void IpoptWarmStart::write(std::ostream &out) const
 {
   out << "Ipopt warm start information:"  << std::endl;
@@ -325,6 +391,13 @@ void IpoptEngine::addConstraint(ConstraintPtr)
 }
 
 
+void IpoptEngine::addConstraints(ConstraintConstIterator,
+                                 ConstraintConstIterator)
+{
+  consChanged_ = true;
+}
+
+
 void IpoptEngine::changeBound(ConstraintPtr, BoundType, double)
 {
   bndChanged_ = true;
@@ -91,12 +91,24 @@ namespace Minotaur {
      */
     const double * getUpperDualOfVars() const {return dualXUp_;};
 
+    // base class
+    size_t getBytes() const;
+
+    // base class
+    bool hasSameValues(ConstSolutionPtr sol) const;
+
     // base class
     void setDualOfVars(const double *) { assert(!"implement me!"); };
 
     /// Set duals of variable-bounds: both the lower and upper.
     void setDualOfVars(const double *lower, const double *upper);
 
+    // base class
+    bool spill(FILE *fp);
+
+    // base class
+    bool unspill(FILE *fp);
+
     /// Write to an output.
     void write(std::ostream &out) const;
 
@@ -125,6 +137,12 @@ namespace Minotaur {
     /// Destroy
     ~IpoptWarmStart();
 
+    // Implement WarmStart::equals().
+    bool equals(ConstWarmStartPtr ws) const;
+
+    // Implement WarmStart::getBytes().
+    size_t getBytes() const;
+
     /// Return the soluton that can be used as starting point.
     IpoptSolPtr getPoint();
 
@@ -139,6 +157,12 @@ namespace Minotaur {
      */
     void setPoint(IpoptSolPtr sol);
 
+    // Implement WarmStart::spill().
+    bool spill(FILE *fp);
+
+    // Implement WarmStart::unspill().
+    bool unspill(FILE *fp);
+
     // Implement WarmStart::write().
     void write(std::ostream &out) const;
 
@@ -165,6 +189,10 @@ namespace Minotaur {
     // Base class method
     void addConstraint(ConstraintPtr c);
 
+    // Base class method. Ipopt is set up again once for the whole block.
+    void addConstraints(ConstraintConstIterator cbeg,
+                        ConstraintConstIterator cend);
+
     void changeBound(ConstraintPtr cons, BoundType lu, double new_val);
 
     // Implement Engine::changeBound(VariablePtr, BoundType, double).
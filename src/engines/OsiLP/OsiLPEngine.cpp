@@ -186,6 +186,45 @@ void OsiLPEngine::addConstraint(ConstraintPtr con)
 }
 
 
+void OsiLPEngine::addConstraints(ConstraintConstIterator cbeg,
+                                 ConstraintConstIterator cend)
+{
+  std::vector<CoinBigIndex> starts;
+  std::vector<int> cols;
+  std::vector<double> elems, lb, ub;
+  LinearFunctionPtr lf;
+  VariableGroupConstIterator it;
+  UInt nz = 0;
+
+  if (cbeg==cend) {
+    return;
+  }
+  for (ConstraintConstIterator cit=cbeg; cit!=cend; ++cit) {
+    nz += (*cit)->getLinearFunction()->getNumTerms();
+  }
+  cols.reserve(nz);
+  elems.reserve(nz);
+  for (ConstraintConstIterator cit=cbeg; cit!=cend; ++cit) {
+    starts.push_back(cols.size());
+    lf = (*cit)->getLinearFunction();
+    for (it = lf->termsBegin(); it != lf->termsEnd(); ++it) {
+      cols.push_back(it->first->getIndex());
+      elems.push_back(it->second);
+    }
+    lb.push_back((*cit)->getLb());
+    ub.push_back((*cit)->getUb());
+  }
+  starts.push_back(cols.size());
+
+  // cols and elems are not empty even if all rows are.
+  cols.push_back(0);
+  elems.push_back(0.0);
+  osilp_->addRows(lb.size(), &starts[0], &cols[0], &elems[0], &lb[0],
+                  &ub[0]);
+  consChanged_ = true;
+}
+
+
 void OsiLPEngine::changeBound(ConstraintPtr cons, BoundType lu, double new_val)
 {
   if (Upper==lu) {
@@ -559,6 +598,7 @@ void OsiLPEngine::removeCons(std::vector<ConstraintPtr> &delcons)
     inds[i] = delcons[i]->getIndex();
   }
   osilp_->deleteRows(num, inds);
+  delete [] inds;
   consChanged_ = true;
 }
 
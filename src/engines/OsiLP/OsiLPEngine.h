@@ -109,6 +109,10 @@ namespace Minotaur {
     // Implement Engine::addConstraint().
     void addConstraint(ConstraintPtr);
 
+    /// Add all new rows to the LP solver in one call.
+    void addConstraints(ConstraintConstIterator cbeg,
+                        ConstraintConstIterator cend);
+
     // Change bounds on a constraint.
     void changeBound(ConstraintPtr cons, BoundType lu, double new_val);
 
@@ -181,8 +181,16 @@ namespace Minotaur {
     // Implement Engine::changeBound(VariablePtr, double, double).
     void changeBound(VariablePtr var, double new_lb, double new_ub);
 
-    // Implement Engine::addConstraint() */
-    void addConstraint(ConstraintPtr) {};
+    // Implement Engine::addConstraint(). The QP is set up again in the
+    // next solve.
+    void addConstraint(ConstraintPtr) { consModed_ = true; };
+
+    // Implement Engine::addConstraints(). One set up for the whole block.
+    void addConstraints(ConstraintConstIterator, ConstraintConstIterator)
+    { consModed_ = true; };
+
+    // Implement Engine::removeCons().
+    void removeCons(std::vector<ConstraintPtr> &) { consModed_ = true; };
 
     // change objective.
     void changeObj(FunctionPtr f, double cb);
@@ -17,6 +17,51 @@ CPPUNIT_TEST_SUITE_REGISTRATION(CGraphUT);
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(CGraphUT, "CGraphUT");
 using namespace Minotaur;
 
+void CGraphUT::testBatch()
+{
+  CNode *n0, *n1, *n2;
+  CGraph cgraph;
+  NlWork *w;
+  int error = 0;
+
+  VariablePtr v0 = new Variable(0, 0, 0.0, 10.0, Continuous, "x0");
+  VariablePtr v1 = new Variable(1, 1, 0.0, 10.0, Continuous, "x1");
+
+  // three points, one after the other.
+  double x[6] = {1.0, 2.0, 3.0, 0.5, 0.0, 1.0};
+  double f[3];
+  double g[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  double g2[2];
+
+  // x0^2*x1 + exp(x1)
+  n0 = cgraph.newNode(v0);
+  n1 = cgraph.newNode(v1);
+  n0 = cgraph.newNode(OpSqr, n0, 0);
+  n0 = cgraph.newNode(OpMult, n0, n1);
+  n2 = cgraph.newNode(OpExp, n1, 0);
+  n2 = cgraph.newNode(OpPlus, n0, n2);
+  cgraph.setOut(n2);
+  cgraph.finalize();
+
+  w = cgraph.newWork();
+  cgraph.evalBatch(x, 2, 3, f, w, &error);
+  CPPUNIT_ASSERT(0==error);
+  cgraph.evalGradientBatch(x, 2, 3, g, w, &error);
+  CPPUNIT_ASSERT(0==error);
+  for (UInt j=0; j<3; ++j) {
+    CPPUNIT_ASSERT(fabs(f[j] - cgraph.eval(x+2*j, &error))<1e-10);
+    g2[0] = g2[1] = 0.0;
+    cgraph.evalGradient(x+2*j, g2, &error);
+    CPPUNIT_ASSERT(fabs(g[2*j] - g2[0])<1e-10);
+    CPPUNIT_ASSERT(fabs(g[2*j+1] - g2[1])<1e-10);
+  }
+
+  delete w;
+  delete v0;
+  delete v1;
+}
+
+
 void CGraphUT::testIdentical()
 {
   VariablePtr v0 = new Variable(0, 0, 0.0, 10.0, Continuous, "x0");
@@ -146,6 +191,54 @@ void CGraphUT::testQuad()
 }
 
 
+void CGraphUT::testWork()
+{
+  CNode *n0, *n1, *n2;
+  CGraph cgraph;
+  NlWork *w1, *w2;
+  int error = 0;
+
+  VariablePtr v0 = new Variable(0, 0, 0.0, 10.0, Continuous, "x0");
+  VariablePtr v1 = new Variable(1, 1, 0.0, 10.0, Continuous, "x1");
+
+  double x[2] = {1.0, 2.0};
+  double y[2] = {3.0, 0.5};
+  double g[2] = {0.0, 0.0};
+
+  // x0^2*x1 + exp(x1)
+  n0 = cgraph.newNode(v0);
+  n1 = cgraph.newNode(v1);
+  n0 = cgraph.newNode(OpSqr, n0, 0);
+  n0 = cgraph.newNode(OpMult, n0, n1);
+  n2 = cgraph.newNode(OpExp, n1, 0);
+  n2 = cgraph.newNode(OpPlus, n0, n2);
+  cgraph.setOut(n2);
+  cgraph.finalize();
+
+  w1 = cgraph.newWork();
+  w2 = cgraph.newWork();
+  CPPUNIT_ASSERT(fabs(cgraph.eval(x, &error) - 2.0 - exp(2.0))<1e-10);
+  CPPUNIT_ASSERT(fabs(cgraph.evalWork(y, w1, &error) - 4.5 - exp(0.5))
+                 <1e-10);
+  CPPUNIT_ASSERT(fabs(cgraph.evalWork(x, w2, &error) - 2.0 - exp(2.0))
+                 <1e-10);
+  CPPUNIT_ASSERT(0==error);
+
+  // evaluating with a workspace does not change the graph.
+  CPPUNIT_ASSERT(fabs(n2->getVal() - 2.0 - exp(2.0))<1e-10);
+
+  cgraph.evalGradientWork(y, g, w1, &error);
+  CPPUNIT_ASSERT(0==error);
+  CPPUNIT_ASSERT(fabs(g[0]-3.0)<1e-10);
+  CPPUNIT_ASSERT(fabs(g[1]-9.0-exp(0.5))<1e-10);
+
+  delete w1;
+  delete w2;
+  delete v0;
+  delete v1;
+}
+
+
 // Local Variables: 
 // mode: c++ 
 // eval: (c-set-style "k&r") 
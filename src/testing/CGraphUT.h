@@ -24,14 +24,18 @@ public:
 
   void setUp() { }      // need not implement
   void tearDown() { }   // need not implement
+  void testBatch();
   void testIdentical();
   void testLin();
   void testQuad();
+  void testWork();
 
   CPPUNIT_TEST_SUITE(CGraphUT);
+  CPPUNIT_TEST(testBatch);
   CPPUNIT_TEST(testIdentical);
   CPPUNIT_TEST(testLin);
   CPPUNIT_TEST(testQuad);
+  CPPUNIT_TEST(testWork);
   CPPUNIT_TEST_SUITE_END();
 
 };
@@ -0,0 +1,119 @@
+// 
+//     MINOTAUR -- It's only 1/2 bull
+// 
+//     (C)opyright 2009 - 2017 The MINOTAUR Team.
+// 
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "MinotaurConfig.h"
+#include "CoverCutGenerator.h"
+#include "CoverCutGeneratorUT.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CoverCutGeneratorUT);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(CoverCutGeneratorUT,
+                                      "CoverCutGeneratorUT");
+
+using namespace Minotaur;
+
+// Sort items in nonincreasing c/a, as binaryKnapsackSolver expects.
+static bool ratioGreater(const std::pair<double, double> &i,
+                         const std::pair<double, double> &j)
+{
+  return i.first*j.second > j.first*i.second;
+}
+
+
+void CoverCutGeneratorUT::checkRandom_(bool intc, bool inta)
+{
+  CoverCutGenerator gen;
+  std::vector<std::pair<double, double> > items;
+  double c[12], a[12];
+  int x[12];
+  double b, z, best, asum, wx, cx;
+  UInt n;
+
+  srand(7);
+  for (UInt inst=0; inst<200; ++inst) {
+    n = 1 + rand()%12;
+    items.clear();
+    asum = 0.0;
+    for (UInt i=0; i<n; ++i) {
+      double ci = (intc) ? 1 + rand()%30 : 0.5 + 30.0*rand()/RAND_MAX;
+      double ai = (inta) ? 1 + rand()%20 : 0.5 + 20.0*rand()/RAND_MAX;
+      items.push_back(std::make_pair(ci, ai));
+      asum += ai;
+    }
+    std::sort(items.begin(), items.end(), ratioGreater);
+    for (UInt i=0; i<n; ++i) {
+      c[i] = items[i].first;
+      a[i] = items[i].second;
+    }
+    b = floor(asum*rand()/RAND_MAX);
+    if (false==inta) {
+      b += 0.25;
+    }
+
+    // enumerate all subsets.
+    best = 0.0;
+    for (UInt s=0; s<(1U<<n); ++s) {
+      wx = cx = 0.0;
+      for (UInt i=0; i<n; ++i) {
+        if (s & (1U<<i)) {
+          wx += a[i];
+          cx += c[i];
+        }
+      }
+      if (wx <= b && cx > best) {
+        best = cx;
+      }
+    }
+
+    CPPUNIT_ASSERT(1 == gen.binaryKnapsackSolver(n, b, c, a, z, x));
+    CPPUNIT_ASSERT(fabs(z - best) < 1e-8);
+    wx = cx = 0.0;
+    for (UInt i=0; i<n; ++i) {
+      CPPUNIT_ASSERT(0 == x[i] || 1 == x[i]);
+      wx += a[i]*x[i];
+      cx += c[i]*x[i];
+    }
+    CPPUNIT_ASSERT(wx <= b + 1e-6);
+    CPPUNIT_ASSERT(fabs(cx - z) < 1e-8);
+  }
+}
+
+
+// Neither profits nor weights are integers: branch-and-bound.
+void CoverCutGeneratorUT::testKnapBnb()
+{
+  checkRandom_(false, false);
+}
+
+
+// Integer weights: dynamic program over capacities.
+void CoverCutGeneratorUT::testKnapCap()
+{
+  checkRandom_(false, true);
+}
+
+
+// Integer profits: dynamic program over profits.
+void CoverCutGeneratorUT::testKnapProf()
+{
+  checkRandom_(true, false);
+  // when both are integers, the smaller table is used.
+  checkRandom_(true, true);
+}
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End: 
@@ -0,0 +1,55 @@
+// 
+//     MINOTAUR -- It's only 1/2 bull
+// 
+//     (C)opyright 2009 - 2017 The MINOTAUR Team.
+// 
+
+#ifndef COVERCUTGENERATORUT_H
+#define COVERCUTGENERATORUT_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Types.h>
+
+using namespace Minotaur;
+
+class CoverCutGeneratorUT : public CppUnit::TestCase {
+
+public:
+  CoverCutGeneratorUT(std::string name) : TestCase(name) {}
+  CoverCutGeneratorUT() {}
+
+  void setUp() { }      // need not implement
+  void tearDown() { }   // need not implement
+  void testKnapBnb();
+  void testKnapCap();
+  void testKnapProf();
+
+  CPPUNIT_TEST_SUITE(CoverCutGeneratorUT);
+  CPPUNIT_TEST(testKnapBnb);
+  CPPUNIT_TEST(testKnapCap);
+  CPPUNIT_TEST(testKnapProf);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  // Solve random instances with binaryKnapsackSolver and compare with
+  // enumeration. Profits (weights) are integers if intc (inta) is true.
+  void checkRandom_(bool intc, bool inta);
+};
+
+#endif
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End: 
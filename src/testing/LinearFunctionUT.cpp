@@ -257,6 +257,49 @@ void LinearFunctionTest::testFix()
 }
 
 
+
+void LinearFunctionTest::testFinalize()
+{
+  EnvPtr env = new Environment();
+  ProblemPtr p = new Problem(env);
+  VariablePtr v0 = p->newVariable(0.0, 1.0, Continuous);
+  VariablePtr v1 = p->newVariable(0.0, 1.0, Continuous);
+  VariablePtr v2 = p->newVariable(0.0, 1.0, Continuous);
+  LinearFunctionPtr lf = new LinearFunction();
+  double x[3] = {1.0, 10.0, 100.0};
+  double lb, ub;
+
+  lf->addTerm(v2, 3.0);
+  lf->addTerm(v1, 2.0);
+  CPPUNIT_ASSERT(320.0 == lf->eval(x));
+
+  lf->finalize();
+  CPPUNIT_ASSERT(320.0 == lf->eval(x));
+  CPPUNIT_ASSERT(2 == lf->getTermVars().size());
+  CPPUNIT_ASSERT(v1 == lf->getTermVars()[0]);
+  CPPUNIT_ASSERT(3.0 == lf->getTermCoeffs()[1]);
+
+  // changes after finalize() are seen at once.
+  lf->incTerm(v1, 1.0);
+  lf->addTerm(v0, -1.0);
+  CPPUNIT_ASSERT(329.0 == lf->eval(x));
+  lf->computeBounds(&lb, &ub);
+  CPPUNIT_ASSERT(-1.0 == lb && 6.0 == ub);
+  lf->removeVar(v0, 0.0);
+  CPPUNIT_ASSERT(330.0 == lf->eval(x));
+
+  // a function outside the problem still evaluates correctly after the
+  // variables are renumbered.
+  lf->finalize();
+  p->markDelete(v0);
+  p->delMarkedVars();
+  CPPUNIT_ASSERT(330.0 == lf->eval(x+1));
+
+  delete lf;
+  delete p;
+  delete env;
+}
+
 // Local Variables: 
 // mode: c++ 
 // eval: (c-set-style "k&r") 
@@ -0,0 +1,242 @@
+// 
+//     MINOTAUR -- It's only 1/2 bull
+// 
+//     (C)opyright 2009 - 2017 The MINOTAUR Team.
+// 
+
+#include <cmath>
+
+#include "MinotaurConfig.h"
+#include "Constraint.h"
+#include "Cut.h"
+#include "Environment.h"
+#include "Function.h"
+#include "LinearFunction.h"
+#include "ParCutStore.h"
+#include "ParCutStoreUT.h"
+#include "ParPseudoCosts.h"
+#include "Relaxation.h"
+#include "Variable.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ParCutStoreUT);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(ParCutStoreUT, "ParCutStoreUT");
+
+using namespace Minotaur;
+
+
+void ParCutStoreUT::setUp()
+{
+  env_ = new Environment();
+  for (UInt t=0; t<2; ++t) {
+    rel_[t] = new Relaxation(env_);
+    for (UInt i=0; i<4; ++i) {
+      rel_[t]->newVariable(0.0, 1.0, Continuous);
+    }
+  }
+}
+
+
+void ParCutStoreUT::tearDown()
+{
+  delete rel_[0];
+  delete rel_[1];
+  delete env_;
+}
+
+
+bool ParCutStoreUT::add_(ParCutStore *store, UInt t, UInt i, double a,
+                         UInt j, double b, double ub, double viol)
+{
+  LinearFunctionPtr lf = new LinearFunction();
+  FunctionPtr f;
+  CutPtr cut;
+  bool added;
+
+  lf->addTerm(rel_[t]->getVariable(i), a);
+  if (j != i) {
+    lf->addTerm(rel_[t]->getVariable(j), b);
+  }
+  f = new Function(lf);
+  cut = new Cut(rel_[t]->getNumVars(), f, -INFINITY, ub, false, false);
+  cut->getInfo()->fixedScore = viol;
+  added = store->add(cut, t);
+  delete cut;
+  delete f;
+  return added;
+}
+
+
+void ParCutStoreUT::testCursor()
+{
+  ParCutStore store(env_, 2);
+  ConstraintPtr c;
+
+  CPPUNIT_ASSERT(0 == store.addNewCuts(rel_[0], 0));
+  CPPUNIT_ASSERT(0 == store.addNewCuts(rel_[1], 1));
+  CPPUNIT_ASSERT(add_(&store, 0, 0, 1.0, 1, 1.0, 1.0, 0.0));
+  CPPUNIT_ASSERT(add_(&store, 0, 1, 1.0, 2, 1.0, 1.0, 0.0));
+  CPPUNIT_ASSERT(add_(&store, 1, 2, 1.0, 3, 1.0, 1.0, 0.0));
+
+  // a thread gets only the cuts of others, and each only once.
+  CPPUNIT_ASSERT(2 == store.addNewCuts(rel_[1], 1));
+  CPPUNIT_ASSERT(0 == store.addNewCuts(rel_[1], 1));
+  CPPUNIT_ASSERT(1 == store.addNewCuts(rel_[0], 0));
+  CPPUNIT_ASSERT(0 == store.addNewCuts(rel_[0], 0));
+
+  CPPUNIT_ASSERT(add_(&store, 0, 0, 2.0, 3, -1.0, 1.5, 0.0));
+  CPPUNIT_ASSERT(0 == store.addNewCuts(rel_[0], 0));
+  CPPUNIT_ASSERT(1 == store.addNewCuts(rel_[1], 1));
+  CPPUNIT_ASSERT(3 == rel_[1]->getNumCons());
+  CPPUNIT_ASSERT(1 == rel_[0]->getNumCons());
+
+  // newest first. The cut uses the variables of the relaxation it is
+  // added to.
+  c = rel_[1]->getConstraint(2);
+  CPPUNIT_ASSERT(1.5 == c->getUb());
+  CPPUNIT_ASSERT(2.0 == c->getLinearFunction()->
+                 getWeight(rel_[1]->getVariable(0)));
+  CPPUNIT_ASSERT(-1.0 == c->getLinearFunction()->
+                 getWeight(rel_[1]->getVariable(3)));
+  c = rel_[0]->getConstraint(0);
+  CPPUNIT_ASSERT(1.0 == c->getLinearFunction()->
+                 getWeight(rel_[0]->getVariable(2)));
+
+  // a thread not known to the store gets nothing.
+  CPPUNIT_ASSERT(0 == store.addNewCuts(rel_[0], 2));
+}
+
+
+void ParCutStoreUT::testDuplicate()
+{
+  ParCutStore store(env_, 2);
+
+  // a thread must give its relaxation first.
+  CPPUNIT_ASSERT(false == add_(&store, 0, 0, 1.0, 1, 2.0, 3.0, 0.0));
+  store.addNewCuts(rel_[0], 0);
+  store.addNewCuts(rel_[1], 1);
+  CPPUNIT_ASSERT(add_(&store, 0, 0, 1.0, 1, 2.0, 3.0, 0.0));
+  CPPUNIT_ASSERT(false == add_(&store, 0, 0, 1.0, 1, 2.0, 3.0, 0.0));
+  // same cut from another thread, terms in a different order.
+  CPPUNIT_ASSERT(false == add_(&store, 1, 1, 2.0, 0, 1.0, 3.0, 0.5));
+  CPPUNIT_ASSERT(1 == store.getNumCuts());
+
+  // a different bound or coefficient makes a different cut.
+  CPPUNIT_ASSERT(add_(&store, 1, 0, 1.0, 1, 2.0, 4.0, 0.0));
+  CPPUNIT_ASSERT(add_(&store, 1, 0, 1.0, 1, 2.5, 3.0, 0.0));
+  CPPUNIT_ASSERT(3 == store.getNumCuts());
+
+  // thread 0 gets the two cuts of thread 1, not its own.
+  CPPUNIT_ASSERT(2 == store.addNewCuts(rel_[0], 0));
+  CPPUNIT_ASSERT(1 == store.addNewCuts(rel_[1], 1));
+}
+
+
+void ParCutStoreUT::testMaxImport()
+{
+  ParCutStore store(env_, 2);
+  const UInt ncuts = 1200;
+  const UInt nimport = 1000;   // default of mcbnb_cut_import.
+  UInt score;
+
+  store.addNewCuts(rel_[0], 0);
+  store.addNewCuts(rel_[1], 1);
+  // x_0 <= i with violation (37i mod 1200)+1. Each score is used once.
+  for (UInt i=0; i<ncuts; ++i) {
+    score = (37*i)%ncuts + 1;
+    CPPUNIT_ASSERT(add_(&store, 0, 0, 1.0, 0, 0.0, (double) i,
+                        (double) score));
+  }
+  CPPUNIT_ASSERT(nimport == store.addNewCuts(rel_[1], 1));
+  CPPUNIT_ASSERT(nimport == rel_[1]->getNumCons());
+  for (UInt k=0; k<nimport; ++k) {
+    UInt i = (UInt) rel_[1]->getConstraint(k)->getUb();
+    CPPUNIT_ASSERT((37*i)%ncuts + 1 > ncuts - nimport);
+  }
+
+  // the cuts left out are not offered again.
+  CPPUNIT_ASSERT(0 == store.addNewCuts(rel_[1], 1));
+}
+
+
+void ParCutStoreUT::testVars()
+{
+  ParCutStore store(env_, 3);
+  RelaxationPtr rel = new Relaxation(env_);
+
+  // same number of variables as rel_[0], but one of another type.
+  for (UInt i=0; i<3; ++i) {
+    rel->newVariable(0.0, 1.0, Continuous);
+  }
+  rel->newVariable(0.0, 1.0, Binary);
+
+  store.addNewCuts(rel_[0], 0);
+  CPPUNIT_ASSERT(0 == store.addNewCuts(rel, 2));
+  CPPUNIT_ASSERT(add_(&store, 0, 0, 1.0, 1, 1.0, 1.0, 0.0));
+  CPPUNIT_ASSERT(0 == store.addNewCuts(rel, 2));
+  CPPUNIT_ASSERT(0 == rel->getNumCons());
+
+  // a variable added after the check is not shared.
+  rel_[0]->newVariable(0.0, 1.0, Continuous);
+  CPPUNIT_ASSERT(false == add_(&store, 0, 4, 1.0, 1, 1.0, 1.0, 0.0));
+
+  CPPUNIT_ASSERT(1 == store.addNewCuts(rel_[1], 1));
+  delete rel;
+}
+
+
+void ParCutStoreUT::testPseudoCosts()
+{
+  ParPseudoCosts pc(3);
+  UInt t_down, t_up;
+  double pc_down, pc_up;
+
+  CPPUNIT_ASSERT(3 == pc.getSize());
+  pc.get(1, &t_down, &t_up, &pc_down, &pc_up);
+  CPPUNIT_ASSERT(0 == t_down && 0 == t_up);
+  CPPUNIT_ASSERT(0.0 == pc_down && 0.0 == pc_up);
+
+  pc.add(1, 2.0, DownBranch);
+  pc.add(1, 4.0, DownBranch);
+  pc.add(1, 1.0, UpBranch);
+  pc.get(1, &t_down, &t_up, &pc_down, &pc_up);
+  CPPUNIT_ASSERT(2 == t_down && 1 == t_up);
+  CPPUNIT_ASSERT(fabs(pc_down - 3.0) < 1e-12);
+  CPPUNIT_ASSERT(fabs(pc_up - 1.0) < 1e-12);
+
+  // three more up observations with average 5.
+  pc.add(1, 5.0, 3, UpBranch);
+  pc.get(1, &t_down, &t_up, &pc_down, &pc_up);
+  CPPUNIT_ASSERT(2 == t_down && 4 == t_up);
+  CPPUNIT_ASSERT(fabs(pc_up - 4.0) < 1e-12);
+
+  // no observations and out of range indices are ignored.
+  pc.add(0, 7.0, 0, UpBranch);
+  pc.add(3, 7.0, DownBranch);
+  pc.get(0, &t_down, &t_up, &pc_down, &pc_up);
+  CPPUNIT_ASSERT(0 == t_down && 0 == t_up);
+  pc.get(3, &t_down, &t_up, &pc_down, &pc_up);
+  CPPUNIT_ASSERT(0 == t_down && 0 == t_up && 0.0 == pc_down);
+
+  // updates from several threads are not lost.
+#if USE_OPENMP
+#pragma omp parallel for num_threads(4)
+#endif
+  for (int i=0; i<4000; ++i) {
+    pc.add(2, (double) (i%4), (i%2) ? UpBranch : DownBranch);
+  }
+  pc.get(2, &t_down, &t_up, &pc_down, &pc_up);
+  CPPUNIT_ASSERT(2000 == t_down && 2000 == t_up);
+  CPPUNIT_ASSERT(fabs(pc_down - 1.0) < 1e-12);
+  CPPUNIT_ASSERT(fabs(pc_up - 2.0) < 1e-12);
+}
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End: 
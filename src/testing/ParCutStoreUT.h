@@ -0,0 +1,64 @@
+// 
+//     MINOTAUR -- It's only 1/2 bull
+// 
+//     (C)opyright 2009 - 2017 The MINOTAUR Team.
+// 
+
+#ifndef PARCUTSTOREUT_H
+#define PARCUTSTOREUT_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Types.h>
+
+using namespace Minotaur;
+
+class ParCutStoreUT : public CppUnit::TestCase {
+
+public:
+  ParCutStoreUT(std::string name) : TestCase(name) {}
+  ParCutStoreUT() {}
+
+  void setUp();
+  void tearDown();
+  void testCursor();
+  void testDuplicate();
+  void testMaxImport();
+  void testPseudoCosts();
+  void testVars();
+
+  CPPUNIT_TEST_SUITE(ParCutStoreUT);
+  CPPUNIT_TEST(testCursor);
+  CPPUNIT_TEST(testDuplicate);
+  CPPUNIT_TEST(testMaxImport);
+  CPPUNIT_TEST(testPseudoCosts);
+  CPPUNIT_TEST(testVars);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  EnvPtr env_;
+  // Relaxations of two threads, with the same variables.
+  RelaxationPtr rel_[2];
+
+  // Add the cut a*x_i + b*x_j <= ub, found by thread t with violation
+  // viol, to the store. Return the value of ParCutStore::add().
+  bool add_(ParCutStore *store, UInt t, UInt i, double a, UInt j, double b,
+            double ub, double viol);
+};
+
+#endif
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End: 
@@ -0,0 +1,264 @@
+// 
+//     MINOTAUR -- It's only 1/2 bull
+// 
+//     (C)opyright 2009 - 2017 The MINOTAUR Team.
+// 
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+#include "MinotaurConfig.h"
+#include "CGraph.h"
+#include "CNode.h"
+#include "Constraint.h"
+#include "Environment.h"
+#include "Function.h"
+#include "LinearFunction.h"
+#include "Objective.h"
+#include "Problem.h"
+#include "ProblemCache.h"
+#include "ProblemCacheUT.h"
+#include "QuadraticFunction.h"
+#include "SOS.h"
+#include "Variable.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ProblemCacheUT);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(ProblemCacheUT, "ProblemCacheUT");
+
+using namespace Minotaur;
+
+static const std::string cacheFile = "ProblemCacheUT.cache";
+static const std::string srcFile = "ProblemCacheUT.src";
+
+
+void ProblemCacheUT::setUp()
+{
+  VarVector vars;
+  LinearFunctionPtr lf;
+  QuadraticFunctionPtr qf;
+  CGraph *cg;
+  CNode *n0, *n1, *n2;
+  FunctionPtr f;
+  double weights[3] = {1.0, 2.0, 4.0};
+
+  env_ = new Environment();
+  p_ = new Problem(env_);
+  vars.push_back(p_->newVariable(0.0, 1.0, Binary, "b0"));
+  vars.push_back(p_->newVariable(-2.0, 5.0, Integer, "i1"));
+  vars.push_back(p_->newVariable(-INFINITY, 3.5, Continuous, "x2"));
+  p_->setInitVal(vars[2], 1.25);
+
+  // 2 b0 + 3 i1 <= 5
+  lf = new LinearFunction();
+  lf->addTerm(vars[0], 2.0);
+  lf->addTerm(vars[1], 3.0);
+  p_->newConstraint(new Function(lf), -INFINITY, 5.0, "lin");
+
+  // x2 + b0*i1 - 0.5 x2^2 in [-1, 4]
+  lf = new LinearFunction();
+  lf->addTerm(vars[2], 1.0);
+  qf = new QuadraticFunction();
+  qf->addTerm(vars[0], vars[1], 1.0);
+  qf->addTerm(vars[2], vars[2], -0.5);
+  p_->newConstraint(new Function(lf, qf), -1.0, 4.0, "quad");
+
+  // i1 + exp(x2)*b0 + (x2+1.5)^2 = 6
+  cg = new CGraph();
+  n0 = cg->newNode(vars[2]);
+  n1 = cg->newNode(OpExp, n0, 0);
+  n1 = cg->newNode(OpMult, n1, cg->newNode(vars[0]));
+  n2 = cg->newNode(OpPlus, n0, cg->newNode(1.5));
+  n2 = cg->newNode(OpSqr, n2, 0);
+  n1 = cg->newNode(OpPlus, n1, n2);
+  cg->setOut(n1);
+  cg->finalize();
+  lf = new LinearFunction();
+  lf->addTerm(vars[1], 1.0);
+  p_->newConstraint(new Function(lf, cg), 6.0, 6.0, "nonlin");
+
+  // max 4 b0 - i1 + b0*x2 + sqrt(x2+10)
+  cg = new CGraph();
+  n0 = cg->newNode(OpPlus, cg->newNode(vars[2]), cg->newNode(10.0));
+  cg->setOut(cg->newNode(OpSqrt, n0, 0));
+  cg->finalize();
+  lf = new LinearFunction();
+  lf->addTerm(vars[0], 4.0);
+  lf->addTerm(vars[1], -1.0);
+  qf = new QuadraticFunction();
+  qf->addTerm(vars[0], vars[2], 1.0);
+  f = new Function(lf, qf, cg);
+  p_->newObjective(f, 2.5, Maximize, "obj");
+
+  p_->newSOS(3, SOS1, weights, vars, 2, "s1");
+  vars.pop_back();
+  p_->newSOS(2, SOS2, weights, vars, 1, "s2");
+
+  writeSrc_(10);
+  remove(cacheFile.c_str());
+}
+
+
+void ProblemCacheUT::tearDown()
+{
+  remove(cacheFile.c_str());
+  remove(srcFile.c_str());
+  delete p_;
+  delete env_;
+}
+
+
+void ProblemCacheUT::writeSrc_(UInt n)
+{
+  std::ofstream out(srcFile.c_str());
+  out << std::string(n, 'a');
+}
+
+
+void ProblemCacheUT::testReadWrite()
+{
+  ProblemCache cache(env_);
+  ProblemPtr q;
+  UInt ndefs = 0;
+  int err1 = 0, err2 = 0;
+  double x[3];
+  SOSPtr s1, s2;
+
+  CPPUNIT_ASSERT(0 == cache.write(p_, cacheFile, srcFile, 7));
+  q = cache.read(cacheFile, srcFile, &ndefs);
+  CPPUNIT_ASSERT(q);
+  CPPUNIT_ASSERT(7 == ndefs);
+
+  CPPUNIT_ASSERT(p_->getNumVars() == q->getNumVars());
+  for (UInt i=0; i<p_->getNumVars(); ++i) {
+    VariablePtr v = p_->getVariable(i);
+    VariablePtr w = q->getVariable(i);
+    CPPUNIT_ASSERT(v->getLb() == w->getLb());
+    CPPUNIT_ASSERT(v->getUb() == w->getUb());
+    CPPUNIT_ASSERT(v->getType() == w->getType());
+    CPPUNIT_ASSERT(v->getName() == w->getName());
+    CPPUNIT_ASSERT(v->getInitVal() == w->getInitVal());
+  }
+
+  CPPUNIT_ASSERT(p_->getNumCons() == q->getNumCons());
+  for (UInt i=0; i<p_->getNumCons(); ++i) {
+    ConstraintPtr c = p_->getConstraint(i);
+    ConstraintPtr d = q->getConstraint(i);
+    CPPUNIT_ASSERT(c->getLb() == d->getLb());
+    CPPUNIT_ASSERT(c->getUb() == d->getUb());
+    CPPUNIT_ASSERT(c->getName() == d->getName());
+    CPPUNIT_ASSERT(c->getFunctionType() == d->getFunctionType());
+    CPPUNIT_ASSERT((0 == c->getQuadraticFunction()) ==
+                   (0 == d->getQuadraticFunction()));
+    CPPUNIT_ASSERT((0 == c->getNonlinearFunction()) ==
+                   (0 == d->getNonlinearFunction()));
+  }
+  CPPUNIT_ASSERT(q->getObjective());
+  CPPUNIT_ASSERT(Maximize == q->getObjective()->getObjectiveType());
+  CPPUNIT_ASSERT("obj" == q->getObjective()->getName());
+  CPPUNIT_ASSERT(q->getObjective()->getFunction()->getQuadraticFunction());
+  CPPUNIT_ASSERT(q->getObjective()->getFunction()->getNonlinearFunction());
+
+  // functions agree at a few points.
+  for (UInt k=0; k<5; ++k) {
+    x[0] = k%2;
+    x[1] = -2.0 + k;
+    x[2] = -1.0 + 0.7*k;
+    for (UInt i=0; i<p_->getNumCons(); ++i) {
+      double a1 = p_->getConstraint(i)->getActivity(x, &err1);
+      double a2 = q->getConstraint(i)->getActivity(x, &err2);
+      CPPUNIT_ASSERT(0 == err1 && 0 == err2);
+      CPPUNIT_ASSERT(fabs(a1 - a2) < 1e-12);
+    }
+    CPPUNIT_ASSERT(fabs(p_->getObjective()->eval(x, &err1) -
+                        q->getObjective()->eval(x, &err2)) < 1e-12);
+    CPPUNIT_ASSERT(0 == err1 && 0 == err2);
+  }
+
+  CPPUNIT_ASSERT(1 == q->sos1End()-q->sos1Begin());
+  CPPUNIT_ASSERT(1 == q->sos2End()-q->sos2Begin());
+  s1 = *(p_->sos1Begin());
+  s2 = *(q->sos1Begin());
+  CPPUNIT_ASSERT(3 == s2->getNz());
+  CPPUNIT_ASSERT(s1->getPriority() == s2->getPriority());
+  CPPUNIT_ASSERT(s1->getName() == s2->getName());
+  for (int j=0; j<3; ++j) {
+    CPPUNIT_ASSERT(s1->getWeights()[j] == s2->getWeights()[j]);
+    CPPUNIT_ASSERT((*(s1->varsBegin()+j))->getIndex() ==
+                   (*(s2->varsBegin()+j))->getIndex());
+  }
+  s2 = *(q->sos2Begin());
+  CPPUNIT_ASSERT(2 == s2->getNz());
+  CPPUNIT_ASSERT("s2" == s2->getName());
+  delete q;
+}
+
+
+void ProblemCacheUT::testStale()
+{
+  ProblemCache cache(env_);
+  ProblemPtr q;
+  UInt ndefs = 0;
+
+  // no cache yet.
+  CPPUNIT_ASSERT(0 == cache.read(cacheFile, srcFile, &ndefs));
+
+  CPPUNIT_ASSERT(0 == cache.write(p_, cacheFile, srcFile, 0));
+  q = cache.read(cacheFile, srcFile, &ndefs);
+  CPPUNIT_ASSERT(q);
+  delete q;
+
+  // the source file changed after the cache was written.
+  writeSrc_(11);
+  CPPUNIT_ASSERT(0 == cache.read(cacheFile, srcFile, &ndefs));
+
+  // a cache without a source file is not written.
+  remove(srcFile.c_str());
+  remove(cacheFile.c_str());
+  CPPUNIT_ASSERT(0 != cache.write(p_, cacheFile, srcFile, 0));
+}
+
+
+void ProblemCacheUT::testVersion()
+{
+  ProblemCache cache(env_);
+  ProblemPtr q;
+  UInt ndefs = 0;
+  UInt version = 0;
+  FILE *fp;
+
+  CPPUNIT_ASSERT(0 == cache.write(p_, cacheFile, srcFile, 0));
+
+  // the version follows the 8 bytes of magic.
+  fp = fopen(cacheFile.c_str(), "r+b");
+  CPPUNIT_ASSERT(fp);
+  CPPUNIT_ASSERT(0 == fseek(fp, 8, SEEK_SET));
+  CPPUNIT_ASSERT(1 == fread(&version, sizeof(UInt), 1, fp));
+  ++version;
+  CPPUNIT_ASSERT(0 == fseek(fp, 8, SEEK_SET));
+  CPPUNIT_ASSERT(1 == fwrite(&version, sizeof(UInt), 1, fp));
+  fclose(fp);
+  CPPUNIT_ASSERT(0 == cache.read(cacheFile, srcFile, &ndefs));
+
+  // restore it.
+  fp = fopen(cacheFile.c_str(), "r+b");
+  CPPUNIT_ASSERT(fp);
+  --version;
+  CPPUNIT_ASSERT(0 == fseek(fp, 8, SEEK_SET));
+  CPPUNIT_ASSERT(1 == fwrite(&version, sizeof(UInt), 1, fp));
+  fclose(fp);
+  q = cache.read(cacheFile, srcFile, &ndefs);
+  CPPUNIT_ASSERT(q);
+  delete q;
+}
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End: 
@@ -0,0 +1,57 @@
+// 
+//     MINOTAUR -- It's only 1/2 bull
+// 
+//     (C)opyright 2009 - 2017 The MINOTAUR Team.
+// 
+
+#ifndef PROBLEMCACHEUT_H
+#define PROBLEMCACHEUT_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Types.h>
+
+using namespace Minotaur;
+
+class ProblemCacheUT : public CppUnit::TestCase {
+
+public:
+  ProblemCacheUT(std::string name) : TestCase(name) {}
+  ProblemCacheUT() {}
+
+  void setUp();
+  void tearDown();
+  void testReadWrite();
+  void testStale();
+  void testVersion();
+
+  CPPUNIT_TEST_SUITE(ProblemCacheUT);
+  CPPUNIT_TEST(testReadWrite);
+  CPPUNIT_TEST(testStale);
+  CPPUNIT_TEST(testVersion);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  EnvPtr env_;
+  ProblemPtr p_;
+
+  // Write the source file of the cache with n bytes.
+  void writeSrc_(UInt n);
+};
+
+#endif
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End: 
@@ -0,0 +1,194 @@
+// 
+//     MINOTAUR -- It's only 1/2 bull
+// 
+//     (C)opyright 2009 - 2017 The MINOTAUR Team.
+// 
+
+#include <cmath>
+
+#include "MinotaurConfig.h"
+#include "Environment.h"
+#include "Problem.h"
+#include "Solution.h"
+#include "SolutionPool.h"
+#include "SolutionPoolUT.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SolutionPoolUT);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(SolutionPoolUT, "SolutionPoolUT");
+
+using namespace Minotaur;
+
+
+void SolutionPoolUT::setUp()
+{
+  int err = 0;
+
+  env_ = new Environment();
+  env_->startTimer(err); // the pool records when solutions are found.
+  p_ = new Problem(env_);
+  p_->newVariable(0.0, 10.0, Continuous);
+  p_->newVariable(0.0, 10.0, Continuous);
+  p_->newVariable(0.0, 10.0, Continuous);
+}
+
+
+void SolutionPoolUT::tearDown()
+{
+  delete p_;
+  delete env_;
+}
+
+
+void SolutionPoolUT::add_(SolutionPoolPtr pool, double a, double b,
+                          double c)
+{
+  double x[3];
+
+  x[0] = a;
+  x[1] = b;
+  x[2] = c;
+  pool->addSolution(x, a+b+c);
+}
+
+
+bool SolutionPoolUT::hasVals_(SolutionPoolPtr pool, const DoubleVector &vals)
+{
+  UInt i = 0;
+
+  if (pool->getNumSols() != vals.size()) {
+    return false;
+  }
+  for (SolutionIterator it=pool->solsBegin(); it!=pool->solsEnd();
+       ++it, ++i) {
+    if ((*it)->getObjValue() != vals[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+void SolutionPoolUT::testDuplicate()
+{
+  SolutionPoolPtr pool = new SolutionPool(env_, p_, 5);
+  DoubleVector vals;
+
+  add_(pool, 1.0, 2.0, 3.0);
+  add_(pool, 1.0, 2.0, 3.0);
+  add_(pool, 3.0, 2.0, 1.0); // same value, different point
+  add_(pool, 1.0, 2.0, 3.0);
+  vals.push_back(6.0);
+  vals.push_back(6.0);
+  CPPUNIT_ASSERT(hasVals_(pool, vals));
+  CPPUNIT_ASSERT(4 == pool->getNumSolsFound());
+
+  // the first one of a tie stays the best.
+  CPPUNIT_ASSERT(1.0 == pool->getBestSolution()->getPrimal()[0]);
+  delete pool;
+}
+
+
+void SolutionPoolUT::testListener()
+{
+  SolutionPoolPtr pool = new SolutionPool(env_, p_, 2);
+  SolPoolCounter l1, l2;
+
+  pool->addListener(&l1);
+  pool->addListener(&l2);
+  add_(pool, 2.0, 2.0, 2.0);
+  CPPUNIT_ASSERT(1 == l1.cnt && 6.0 == l1.last);
+  add_(pool, 3.0, 3.0, 3.0); // worse
+  CPPUNIT_ASSERT(1 == l1.cnt);
+  add_(pool, 1.0, 2.0, 2.0); // better
+  CPPUNIT_ASSERT(2 == l1.cnt && 5.0 == l1.last);
+  add_(pool, 1.0, 2.0, 2.0); // duplicate
+  add_(pool, 2.0, 1.0, 2.0); // ties with the best
+  add_(pool, 4.0, 4.0, 4.0); // rejected, pool is full
+  CPPUNIT_ASSERT(2 == l1.cnt && 5.0 == l1.last);
+  CPPUNIT_ASSERT(2 == l2.cnt && 5.0 == l2.last);
+  add_(pool, 0.0, 0.0, 1.0);
+  CPPUNIT_ASSERT(3 == l1.cnt && 1.0 == l1.last);
+  CPPUNIT_ASSERT(3 == l2.cnt && 1.0 == l2.last);
+  CPPUNIT_ASSERT(1.0 == pool->getBestSolutionValue());
+  delete pool;
+}
+
+
+void SolutionPoolUT::testOrder()
+{
+  SolutionPoolPtr pool = new SolutionPool(env_, p_, 10);
+  DoubleVector vals;
+
+  CPPUNIT_ASSERT(0 == pool->getBestSolution());
+  CPPUNIT_ASSERT(INFINITY == pool->getBestSolutionValue());
+
+  add_(pool, 5.0, 0.0, 0.0);
+  add_(pool, 3.0, 0.0, 0.0);
+  add_(pool, 4.0, 0.0, 0.0);
+  add_(pool, 1.0, 0.0, 0.0);
+  add_(pool, 9.0, 0.0, 0.0);
+  vals.push_back(1.0);
+  vals.push_back(3.0);
+  vals.push_back(4.0);
+  vals.push_back(5.0);
+  vals.push_back(9.0);
+  CPPUNIT_ASSERT(hasVals_(pool, vals));
+  CPPUNIT_ASSERT(1.0 == pool->getBestSolutionValue());
+  CPPUNIT_ASSERT(1.0 == pool->getBestSolution()->getObjValue());
+  CPPUNIT_ASSERT(5 == pool->getNumSolsFound());
+  delete pool;
+}
+
+
+void SolutionPoolUT::testTrim()
+{
+  SolutionPoolPtr pool = new SolutionPool(env_, p_, 3);
+  DoubleVector vals;
+  SolutionPtr first;
+
+  add_(pool, 100.0, 0.0, 0.0);
+  first = pool->getBestSolution();
+  for (UInt i=1; i<40; ++i) {
+    add_(pool, 100.0-i, 0.0, 0.0);
+  }
+  // dropped from the pool, but still valid.
+  CPPUNIT_ASSERT(100.0 == first->getObjValue());
+  vals.push_back(61.0);
+  vals.push_back(62.0);
+  vals.push_back(63.0);
+  CPPUNIT_ASSERT(hasVals_(pool, vals));
+  CPPUNIT_ASSERT(3 == pool->getNumSols());
+  CPPUNIT_ASSERT(3 == pool->getSizeLimit());
+
+  // not better than the worst one in a full pool.
+  add_(pool, 63.0, 0.0, 0.0);
+  add_(pool, 70.0, 0.0, 0.0);
+  CPPUNIT_ASSERT(hasVals_(pool, vals));
+  CPPUNIT_ASSERT(42 == pool->getNumSolsFound());
+
+  add_(pool, 62.5, 0.0, 0.0);
+  vals[2] = 62.5;
+  CPPUNIT_ASSERT(hasVals_(pool, vals));
+
+  pool->setSizeLimit(1);
+  vals.resize(1);
+  CPPUNIT_ASSERT(hasVals_(pool, vals));
+  add_(pool, 61.5, 0.0, 0.0);
+  CPPUNIT_ASSERT(hasVals_(pool, vals));
+  add_(pool, 60.0, 0.0, 0.0);
+  vals[0] = 60.0;
+  CPPUNIT_ASSERT(hasVals_(pool, vals));
+  CPPUNIT_ASSERT(60.0 == pool->getBestSolutionValue());
+  delete pool;
+}
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End: 
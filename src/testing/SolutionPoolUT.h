@@ -0,0 +1,71 @@
+// 
+//     MINOTAUR -- It's only 1/2 bull
+// 
+//     (C)opyright 2009 - 2017 The MINOTAUR Team.
+// 
+
+#ifndef SOLUTIONPOOLUT_H
+#define SOLUTIONPOOLUT_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <Types.h>
+#include <SolutionPool.h>
+
+using namespace Minotaur;
+
+// Count the calls of newIncumbent and remember the last value.
+class SolPoolCounter : public SolutionPoolListener {
+public:
+  SolPoolCounter() : cnt(0), last(0.0) {}
+  void newIncumbent(double value) { ++cnt; last = value; }
+  UInt cnt;
+  double last;
+};
+
+class SolutionPoolUT : public CppUnit::TestCase {
+
+public:
+  SolutionPoolUT(std::string name) : TestCase(name) {}
+  SolutionPoolUT() {}
+
+  void setUp();
+  void tearDown();
+  void testDuplicate();
+  void testListener();
+  void testOrder();
+  void testTrim();
+
+  CPPUNIT_TEST_SUITE(SolutionPoolUT);
+  CPPUNIT_TEST(testDuplicate);
+  CPPUNIT_TEST(testListener);
+  CPPUNIT_TEST(testOrder);
+  CPPUNIT_TEST(testTrim);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  EnvPtr env_;
+  ProblemPtr p_;
+
+  // Add the point (a, b, c) with objective value a+b+c.
+  void add_(SolutionPoolPtr pool, double a, double b, double c);
+  // Return true if the objective values in the pool are exactly vals.
+  bool hasVals_(SolutionPoolPtr pool, const DoubleVector &vals);
+};
+
+#endif
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End: 